@@ -0,0 +1,104 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/basic_observers.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace
+{
+struct Observer
+{
+    void frame_posted() { ++frames; }
+    std::atomic<unsigned long> frames{0};
+};
+
+struct Observers : mir::BasicObservers<Observer>
+{
+    using mir::BasicObservers<Observer>::add;
+    using mir::BasicObservers<Observer>::remove;
+
+    void frame_posted()
+    {
+        for_each([](std::shared_ptr<Observer> const& observer) { observer->frame_posted(); });
+    }
+};
+
+// Notify from several threads at once (as streams on different client
+// connections do) while another thread keeps adding and removing an observer.
+unsigned long notifications_per_second(unsigned observer_count, unsigned notifying_threads, std::chrono::seconds run_time)
+{
+    Observers observers;
+    for (auto i = 0u; i != observer_count; ++i)
+        observers.add(std::make_shared<Observer>());
+
+    std::atomic<bool> running{true};
+    std::atomic<unsigned long> notifications{0};
+    std::vector<std::thread> threads;
+
+    for (auto i = 0u; i != notifying_threads; ++i)
+    {
+        threads.emplace_back([&]
+            {
+                unsigned long count = 0;
+                while (running)
+                {
+                    observers.frame_posted();
+                    ++count;
+                }
+                notifications += count;
+            });
+    }
+
+    threads.emplace_back([&]
+        {
+            auto const transient = std::make_shared<Observer>();
+            while (running)
+            {
+                observers.add(transient);
+                std::this_thread::sleep_for(std::chrono::microseconds{100});
+                observers.remove(transient);
+            }
+        });
+
+    std::this_thread::sleep_for(run_time);
+    running = false;
+    for (auto& thread : threads)
+        thread.join();
+
+    return notifications / run_time.count();
+}
+}
+
+int main(int argc, char** argv)
+{
+    std::chrono::seconds const run_time{argc > 1 ? std::stoi(argv[1]) : 2};
+    auto const notifying_threads = std::max(2u, std::thread::hardware_concurrency()) - 1;
+
+    std::cout << notifying_threads << " notifying threads, " << run_time.count() << "s per run" << std::endl;
+
+    for (auto const observer_count : {1u, 4u, 16u})
+    {
+        std::cout << observer_count << " observers: "
+                  << notifications_per_second(observer_count, notifying_threads, run_time)
+                  << " notifications/s" << std::endl;
+    }
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/graphics/pixel_conversion.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+namespace mg = mir::graphics;
+namespace geom = mir::geometry;
+
+namespace
+{
+// What GLPixelBuffer did before the vector kernels, for comparison
+void reference_flip_and_swap(std::vector<uint32_t>& pixels, geom::Size size)
+{
+    auto const width = size.width.as_uint32_t();
+    auto const height = size.height.as_uint32_t();
+    std::vector<uint32_t> tmp(width);
+
+    auto const convert = [width](uint32_t const* src, uint32_t* dst)
+        {
+            for (uint32_t n = 0; n < width; n++)
+            {
+                auto const p = src[n];
+                dst[n] = ((p << 16) & 0x00ff0000) | (p & 0xff00ff00) | ((p >> 16) & 0x000000ff);
+            }
+        };
+
+    for (uint32_t i = 0; i < height / 2; i++)
+    {
+        tmp.assign(&pixels[i * width], &pixels[(i + 1) * width]);
+        convert(&pixels[(height - i - 1) * width], &pixels[i * width]);
+        convert(tmp.data(), &pixels[(height - i - 1) * width]);
+    }
+    if (height % 2 == 1)
+        convert(&pixels[(height / 2) * width], &pixels[(height / 2) * width]);
+}
+
+template<typename Operation>
+std::chrono::microseconds mean_time_of(int iterations, Operation const& operation)
+{
+    auto const start = std::chrono::steady_clock::now();
+    for (int i = 0; i != iterations; ++i)
+        operation();
+    auto const duration = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration_cast<std::chrono::microseconds>(duration) / iterations;
+}
+}
+
+int main(int argc, char** argv)
+{
+    if (argc > 2)
+    {
+        std::cout<<"Usage: "<<argv[0]<<" [iterations]"<<std::endl;
+        exit(1);
+    }
+
+    int const iterations = argc == 2 ? std::atoi(argv[1]) : 100;
+
+    std::vector<geom::Size> const resolutions{
+        {320, 240}, {1280, 720}, {1920, 1080}, {2560, 1440}, {3840, 2160}};
+
+    std::cout<<"Using "<<mg::pixel_conversion_kernels()<<" kernels"<<std::endl;
+
+    for (auto const& size : resolutions)
+    {
+        std::vector<uint32_t> pixels(size.width.as_uint32_t() * size.height.as_uint32_t(), 0x11223344);
+        geom::Stride const stride{size.width.as_uint32_t() * sizeof(uint32_t)};
+
+        auto const reference = mean_time_of(iterations, [&] { reference_flip_and_swap(pixels, size); });
+        auto const flip_and_swap = mean_time_of(iterations, [&] { mg::flip_rows_8888(pixels.data(), size, stride, true); });
+        auto const flip = mean_time_of(iterations, [&] { mg::flip_rows_8888(pixels.data(), size, stride, false); });
+
+        std::cout<<size.width<<"x"<<size.height<<": scalar flip+swap "<<reference.count()<<"us"
+                 <<", flip+swap "<<flip_and_swap.count()<<"us"
+                 <<", flip "<<flip.count()<<"us"<<std::endl;
+    }
+    exit(0);
+}
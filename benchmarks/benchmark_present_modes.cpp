@@ -0,0 +1,213 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/compositor/stream.h"
+#include "mir/frontend/client_buffers.h"
+#include "mir/graphics/buffer.h"
+#include "mir/test/doubles/stub_buffer.h"
+#include "mir/test/doubles/stub_frame_dropping_policy_factory.h"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace mc = mir::compositor;
+namespace mf = mir::frontend;
+namespace mg = mir::graphics;
+namespace mtd = mir::test::doubles;
+namespace geom = mir::geometry;
+
+using Clock = std::chrono::steady_clock;
+
+namespace
+{
+std::chrono::microseconds const vsync_period{16667};
+unsigned int const client_buffers{3};
+
+// The client's end of the stream: buffers the server has sent back wait here
+// until the client renders into them
+struct BufferPool : mf::ClientBuffers
+{
+    BufferPool()
+    {
+        for (auto i = 0u; i != client_buffers; ++i)
+        {
+            auto const buffer = std::make_shared<mtd::StubBuffer>();
+            buffers[buffer->id()] = buffer;
+            free.push_back(buffer);
+        }
+    }
+
+    mg::BufferID add_buffer(std::shared_ptr<mg::Buffer> const& buffer) override { return buffer->id(); }
+    void remove_buffer(mg::BufferID) override {}
+    std::shared_ptr<mg::Buffer> get(mg::BufferID id) const override { return buffers.at(id); }
+    void receive_buffer(mg::BufferID) override {}
+    void send_buffer_count_hint(mf::BufferStreamId, int) override {}
+    void send_present_feedback(mf::BufferStreamId, mf::PresentFeedback const&) override {}
+
+    void send_buffer(mg::BufferID id) override
+    {
+        std::lock_guard<decltype(mutex)> lock{mutex};
+        free.push_back(buffers.at(id));
+        cv.notify_one();
+    }
+
+    std::shared_ptr<mg::Buffer> acquire(std::atomic<bool> const& running)
+    {
+        std::unique_lock<decltype(mutex)> lock{mutex};
+        if (!cv.wait_for(lock, std::chrono::seconds{1}, [this, &running] { return !free.empty() || !running; }) ||
+            free.empty())
+        {
+            return nullptr;
+        }
+        auto const buffer = free.front();
+        free.pop_front();
+        return buffer;
+    }
+
+    std::map<mg::BufferID, std::shared_ptr<mg::Buffer>> buffers;
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<std::shared_ptr<mg::Buffer>> free;
+};
+
+struct Statistics
+{
+    std::vector<double> values;
+
+    void add(Clock::duration d)
+    {
+        values.push_back(std::chrono::duration<double, std::milli>(d).count());
+    }
+
+    double mean() const
+    {
+        double sum = 0;
+        for (auto v : values)
+            sum += v;
+        return values.empty() ? 0 : sum / values.size();
+    }
+
+    double stddev() const
+    {
+        auto const m = mean();
+        double sum = 0;
+        for (auto v : values)
+            sum += (v - m) * (v - m);
+        return values.empty() ? 0 : std::sqrt(sum / values.size());
+    }
+};
+
+void run(MirPresentMode mode, char const* name, std::chrono::seconds run_time)
+{
+    mtd::StubFrameDroppingPolicyFactory policy_factory;
+    auto const pool = std::make_shared<BufferPool>();
+    mc::Stream stream{policy_factory, pool, geom::Size{64, 64}, mir_pixel_format_abgr_8888};
+    stream.set_present_mode(mode);
+
+    std::mutex submitted_mutex;
+    std::map<mg::BufferID, Clock::time_point> submitted_at;
+    std::atomic<bool> running{true};
+    std::atomic<unsigned long> frames_submitted{0};
+
+    // Renders in a little under a vsync on average, but often takes longer
+    std::thread client{[&]
+        {
+            std::mt19937 random{42};
+            std::normal_distribution<double> render_ms{16.0, 5.0};
+            while (running)
+            {
+                auto const buffer = pool->acquire(running);
+                if (!buffer)
+                    continue;
+                std::this_thread::sleep_for(
+                    std::chrono::microseconds{static_cast<long>(std::max(render_ms(random), 1.0) * 1000)});
+                {
+                    std::lock_guard<decltype(submitted_mutex)> lock{submitted_mutex};
+                    submitted_at[buffer->id()] = Clock::now();
+                }
+                stream.submit_buffer(buffer);
+                ++frames_submitted;
+            }
+        }};
+
+    // An output that is recomposited every vsync, whether or not this stream
+    // has anything new to show
+    Statistics intervals, latencies;
+    unsigned long frames_shown{0};
+    mg::BufferID last_shown;
+    Clock::time_point last_change;
+    auto vsync = Clock::now();
+    auto const end = vsync + run_time;
+    while (vsync < end)
+    {
+        vsync += vsync_period;
+        std::this_thread::sleep_until(vsync);
+        if (!stream.has_submitted_buffer())
+            continue;
+
+        auto const now = Clock::now();
+        auto const id = stream.lock_compositor_buffer(&stream)->id();
+        if (id == last_shown)
+            continue;
+
+        if (frames_shown++)
+            intervals.add(now - last_change);
+        last_shown = id;
+        last_change = now;
+        std::lock_guard<decltype(submitted_mutex)> lock{submitted_mutex};
+        latencies.add(now - submitted_at[id]);
+    }
+
+    running = false;
+    pool->cv.notify_all();
+    client.join();
+
+    std::cout << std::left << std::setw(14) << name << std::right << std::fixed << std::setprecision(2)
+              << std::setw(10) << frames_submitted
+              << std::setw(8) << frames_shown
+              << std::setw(12) << intervals.mean()
+              << std::setw(12) << intervals.stddev()
+              << std::setw(12) << latencies.mean() << std::endl;
+}
+}
+
+int main(int argc, char** argv)
+{
+    std::chrono::seconds const run_time{argc > 1 ? std::stoi(argv[1]) : 5};
+
+    std::cout << "60Hz output, client rendering in 16+-5ms, " << run_time.count() << "s per mode" << std::endl;
+    std::cout << std::left << std::setw(14) << "mode" << std::right
+              << std::setw(10) << "submitted"
+              << std::setw(8) << "shown"
+              << std::setw(12) << "interval/ms"
+              << std::setw(12) << "judder/ms"
+              << std::setw(12) << "latency/ms" << std::endl;
+    run(mir_present_mode_fifo, "fifo", run_time);
+    run(mir_present_mode_fifo_relaxed, "fifo_relaxed", run_time);
+    run(mir_present_mode_mailbox, "mailbox", run_time);
+    run(mir_present_mode_immediate, "immediate", run_time);
+}
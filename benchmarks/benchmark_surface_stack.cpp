@@ -0,0 +1,165 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/scene/surface_stack.h"
+#include "mir/scene/scene_report.h"
+#include "mir/compositor/scene_element.h"
+#include "mir/test/doubles/stub_surface.h"
+#include "mir/test/doubles/stub_renderable.h"
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ms = mir::scene;
+namespace mc = mir::compositor;
+namespace mg = mir::graphics;
+namespace mi = mir::input;
+namespace mtd = mir::test::doubles;
+namespace geom = mir::geometry;
+
+namespace
+{
+struct NullSceneReport : ms::SceneReport
+{
+    void surface_created(BasicSurfaceId, std::string const&) override {}
+    void surface_added(BasicSurfaceId, std::string const&) override {}
+    void surface_removed(BasicSurfaceId, std::string const&) override {}
+    void surface_deleted(BasicSurfaceId, std::string const&) override {}
+};
+
+struct BenchmarkSurface : mtd::StubSurface
+{
+    BenchmarkSurface(geom::Rectangle const& area) :
+        area{area},
+        renderable{std::make_shared<mtd::StubRenderable>(area)}
+    {
+    }
+
+    bool visible() const override { return true; }
+    bool input_area_contains(geom::Point const& point) const override { return area.contains(point); }
+    mg::RenderableList generate_renderables(mc::CompositorID) const override { return {renderable}; }
+    int buffers_ready_for_compositor(void const*) const override { return 1; }
+
+    geom::Rectangle const area;
+    std::shared_ptr<mg::Renderable> const renderable;
+};
+
+struct Counter
+{
+    std::atomic<unsigned long> operations{0};
+    std::atomic<unsigned long> nanoseconds{0};
+
+    template<typename Operation>
+    void time(Operation const& operation)
+    {
+        auto const start = std::chrono::steady_clock::now();
+        operation();
+        auto const duration = std::chrono::steady_clock::now() - start;
+        nanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+        operations++;
+    }
+
+    void print(std::string const& name, std::chrono::seconds run_time) const
+    {
+        std::cout << name << ": "
+                  << operations / run_time.count() << " ops/s, "
+                  << (operations ? nanoseconds / operations : 0) << " ns/op" << std::endl;
+    }
+};
+}
+
+int main(int argc, char** argv)
+{
+    std::chrono::seconds const run_time{argc > 1 ? std::stoi(argv[1]) : 5};
+    int const outputs = 4;
+    int const surface_count = 100;
+    geom::Size const surface_size{320, 240};
+
+    ms::SurfaceStack stack{std::make_shared<NullSceneReport>()};
+
+    std::vector<int> compositor_ids(outputs);
+    for (auto& id : compositor_ids)
+        stack.register_compositor(&id);
+
+    std::vector<std::shared_ptr<ms::Surface>> surfaces;
+    for (int i = 0; i < surface_count; i++)
+    {
+        geom::Point const top_left{(i % 10) * 100, (i / 10) * 80};
+        surfaces.push_back(std::make_shared<BenchmarkSurface>(geom::Rectangle{top_left, surface_size}));
+        stack.add_surface(surfaces.back(), mi::InputReceptionMode::normal);
+    }
+
+    std::atomic<bool> running{true};
+    Counter compositing, input, shell;
+    std::vector<std::thread> threads;
+
+    for (auto& id : compositor_ids)
+    {
+        threads.emplace_back([&, cid = &id]
+            {
+                while (running)
+                {
+                    compositing.time([&]
+                        {
+                            stack.frames_pending(cid);
+                            for (auto const& element : stack.scene_elements_for(cid))
+                                element->rendered();
+                        });
+                }
+            });
+    }
+
+    threads.emplace_back([&]
+        {
+            int x = 0;
+            while (running)
+            {
+                input.time([&]
+                    {
+                        stack.surface_at({x, x / 2});
+                        stack.for_each([](std::shared_ptr<mi::Surface> const&) {});
+                    });
+                x = (x + 7) % 1000;
+            }
+        });
+
+    // Window management happens at human speed, but bursts of it should not
+    // stall compositing
+    threads.emplace_back([&]
+        {
+            int i = 0;
+            while (running)
+            {
+                shell.time([&] { stack.raise(surfaces[i]); });
+                i = (i + 1) % surface_count;
+                std::this_thread::sleep_for(std::chrono::milliseconds{1});
+            }
+        });
+
+    std::this_thread::sleep_for(run_time);
+    running = false;
+    for (auto& thread : threads)
+        thread.join();
+
+    std::cout << outputs << " outputs, " << surface_count << " surfaces, " << run_time.count() << "s" << std::endl;
+    compositing.print("compositor threads (frames_pending + scene_elements_for)", run_time);
+    input.print("input thread (surface_at + for_each)", run_time);
+    shell.print("shell thread (raise)", run_time);
+}
@@ -0,0 +1,169 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/events/event_builders.h"
+#include "mir/frontend/buffer_stream.h"
+#include "mir/graphics/buffer_properties.h"
+#include "mir/scene/session.h"
+#include "mir/scene/surface.h"
+#include "mir/scene/surface_creation_parameters.h"
+#include "mir/shell/shell.h"
+
+#include "mir_test_framework/async_server_runner.h"
+#include "mir_test_framework/executable_path.h"
+#include "mir_test_framework/headless_display_buffer_compositor_factory.h"
+#include "mir/test/doubles/null_event_sink.h"
+#include "mir/test/doubles/stub_buffer.h"
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace mev = mir::events;
+namespace mg = mir::graphics;
+namespace ms = mir::scene;
+namespace msh = mir::shell;
+namespace mtd = mir::test::doubles;
+namespace mtf = mir_test_framework;
+namespace geom = mir::geometry;
+
+namespace
+{
+struct Window
+{
+    std::shared_ptr<ms::Session> session;
+    mir::frontend::SurfaceId id;
+    std::shared_ptr<ms::Surface> surface;
+    geom::Point centre;
+};
+
+std::chrono::nanoseconds now()
+{
+    return std::chrono::steady_clock::now().time_since_epoch();
+}
+
+void pointer(msh::Shell& shell, MirPointerAction action, MirInputEventModifiers modifiers,
+    MirPointerButtons buttons, geom::Point position)
+{
+    auto const event = mev::make_event(
+        MirInputDeviceId{0}, now(), std::vector<uint8_t>{}, modifiers, action, buttons,
+        position.x.as_int(), position.y.as_int(), 0, 0, 0, 0);
+    shell.handle(*event);
+}
+
+template<typename Operation>
+void time(std::string const& name, int iterations, Operation const& operation)
+{
+    auto const start = std::chrono::steady_clock::now();
+    for (int i = 0; i != iterations; ++i)
+        operation(i);
+    auto const duration = std::chrono::steady_clock::now() - start;
+
+    std::cout << name << ": "
+              << std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count() / iterations
+              << " ns/op" << std::endl;
+}
+}
+
+int main(int argc, char** argv)
+{
+    int const iterations{argc > 1 ? std::stoi(argv[1]) : 10000};
+    int const session_count = 10;
+    int const window_count = 1000;
+    geom::Size const window_size{120, 90};
+
+    mtf::AsyncServerRunner runner;
+    runner.add_to_environment("MIR_SERVER_PLATFORM_GRAPHICS_LIB", mtf::server_platform("graphics-dummy.so").c_str());
+    runner.add_to_environment("MIR_SERVER_PLATFORM_INPUT_LIB", mtf::server_platform("input-stub.so").c_str());
+    runner.server.override_the_display_buffer_compositor_factory([]
+        {
+            return std::make_shared<mtf::HeadlessDisplayBufferCompositorFactory>();
+        });
+    runner.start_server();
+
+    auto const shell = runner.server.the_shell();
+    auto const sink = std::make_shared<mtd::NullEventSink>();
+
+    std::vector<std::shared_ptr<ms::Session>> sessions;
+    for (int i = 0; i != session_count; ++i)
+        sessions.push_back(shell->open_session(i + 1, "session " + std::to_string(i), sink));
+
+    std::vector<Window> windows;
+    for (int i = 0; i != window_count; ++i)
+    {
+        auto const& session = sessions[i % session_count];
+        auto const stream_id = session->create_buffer_stream(
+            mg::BufferProperties{window_size, mir_pixel_format_abgr_8888, mg::BufferUsage::software});
+
+        auto const params = ms::SurfaceCreationParameters()
+            .of_size(window_size)
+            .of_type(mir_window_type_normal)
+            .with_buffer_stream(stream_id);
+
+        auto const id = shell->create_surface(session, params, sink);
+        auto const surface = session->surface(id);
+
+        // Overlapping, so that clicks have to find the topmost window
+        geom::Point const top_left{(i % 40) * 40, (i / 40) * 30};
+        surface->move_to(top_left);
+        session->get_buffer_stream(stream_id)->submit_buffer(std::make_shared<mtd::StubBuffer>());
+
+        windows.push_back({session, id, surface, top_left + geom::Displacement{10, 10}});
+    }
+
+    std::cout << window_count << " windows in " << session_count << " sessions, "
+              << iterations << " iterations" << std::endl;
+
+    time("raise (each window in turn)", iterations, [&](int i)
+        {
+            auto const& window = windows[(i * 7) % window_count];
+            shell->raise_surface(window.session, window.surface, now().count());
+        });
+
+    time("raise (window already on top)", iterations, [&](int)
+        {
+            auto const& window = windows.front();
+            shell->raise_surface(window.session, window.surface, now().count());
+        });
+
+    time("click to focus", iterations, [&](int i)
+        {
+            auto const& window = windows[(i * 13) % window_count];
+            pointer(*shell, mir_pointer_action_button_down, mir_input_event_modifier_none,
+                mir_pointer_button_primary, window.centre);
+            pointer(*shell, mir_pointer_action_button_up, mir_input_event_modifier_none,
+                0, window.centre);
+        });
+
+    auto const& dragged = windows.back();
+    pointer(*shell, mir_pointer_action_button_down, mir_input_event_modifier_none,
+        mir_pointer_button_primary, dragged.centre);
+    time("alt-drag move", iterations, [&](int i)
+        {
+            geom::Point const position{dragged.centre.x.as_int() + i % 100, dragged.centre.y};
+            pointer(*shell, mir_pointer_action_motion, mir_input_event_modifier_alt,
+                mir_pointer_button_primary, position);
+        });
+    pointer(*shell, mir_pointer_action_button_up, mir_input_event_modifier_none, 0, dragged.centre);
+
+    for (auto const& window : windows)
+        shell->destroy_surface(window.session, window.id);
+    for (auto const& session : sessions)
+        shell->close_session(session);
+
+    runner.stop_server();
+}
@@ -0,0 +1,181 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/input/input_device_info.h"
+
+#include "mir_test_framework/headless_in_process_server.h"
+#include "mir_test_framework/fake_input_device.h"
+#include "mir_test_framework/stub_server_platform_factory.h"
+#include "mir_test_framework/temporary_environment_value.h"
+#include "mir/test/event_factory.h"
+#include "mir/test/signal.h"
+
+#include "mir_toolkit/mir_client_library.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+namespace mi = mir::input;
+namespace mis = mir::input::synthesis;
+namespace mt = mir::test;
+namespace mtf = mir_test_framework;
+
+using namespace std::chrono_literals;
+
+namespace
+{
+// A high-frequency touchscreen, as found on some gaming and pen hardware
+auto const event_interval = std::chrono::microseconds{125};
+int const motion_count{8000};
+
+struct Client
+{
+    Client(std::string const& connect_string)
+    {
+        connection = mir_connect_sync(connect_string.c_str(), "input-ring-latency");
+
+        auto const spec = mir_create_normal_window_spec(connection, 640, 480);
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+        mir_window_spec_set_pixel_format(spec, mir_pixel_format_abgr_8888);
+#pragma GCC diagnostic pop
+        mir_window_spec_set_state(spec, mir_window_state_fullscreen);
+        mir_window_spec_set_event_handler(spec, &handle_event, this);
+        window = mir_create_window_sync(spec);
+        mir_window_spec_release(spec);
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+        mir_buffer_stream_swap_buffers_sync(mir_window_get_buffer_stream(window));
+#pragma GCC diagnostic pop
+    }
+
+    ~Client()
+    {
+        mir_window_release_sync(window);
+        mir_connection_release(connection);
+    }
+
+    static void handle_event(MirWindow*, MirEvent const* event, void* context)
+    {
+        auto const received = std::chrono::steady_clock::now().time_since_epoch();
+        auto const self = static_cast<Client*>(context);
+
+        switch (mir_event_get_type(event))
+        {
+        case mir_event_type_window:
+        {
+            auto const window_event = mir_event_get_window_event(event);
+            if (mir_window_event_get_attribute(window_event) == mir_window_attrib_focus &&
+                mir_window_event_get_attribute_value(window_event) == mir_window_focus_state_focused)
+                self->focused.raise();
+            break;
+        }
+        case mir_event_type_input:
+        {
+            auto const input_event = mir_event_get_input_event(event);
+            if (mir_input_event_get_type(input_event) != mir_input_event_type_touch)
+                break;
+
+            // The fake device stamps its events from the steady clock
+            auto const latency = received - std::chrono::nanoseconds{mir_input_event_get_event_time(input_event)};
+
+            std::lock_guard<std::mutex> lock{self->mutex};
+            self->latencies.push_back(latency);
+            auto const touch_event = mir_input_event_get_touch_event(input_event);
+            if (mir_touch_event_action(touch_event, 0) == mir_touch_action_up)
+                self->all_received.raise();
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    MirConnection* connection;
+    MirWindow* window;
+    mt::Signal focused;
+    mt::Signal all_received;
+
+    std::mutex mutex;
+    std::vector<std::chrono::nanoseconds> latencies;
+};
+
+struct InputRingLatency : mtf::HeadlessInProcessServer
+{
+    std::unique_ptr<mtf::FakeInputDevice> fake_touch_screen{mtf::add_fake_input_device(
+        mi::InputDeviceInfo{"touchscreen", "touchscreen-uid",
+                            mi::DeviceCapability::touchscreen | mi::DeviceCapability::multitouch})};
+
+    std::vector<std::chrono::nanoseconds> measure(char const* use_ring)
+    {
+        mtf::TemporaryEnvironmentValue input_ring{"MIR_CLIENT_INPUT_RING", use_ring};
+        Client client{new_connection()};
+        EXPECT_TRUE(client.focused.wait_for(10s));
+
+        int const range{mtf::FakeInputDevice::maximum_touch_axis_value};
+        auto next = std::chrono::steady_clock::now();
+
+        fake_touch_screen->emit_event(mis::a_touch_event().at_position({range/2, range/2}));
+        for (int i = 0; i != motion_count; ++i)
+        {
+            next += event_interval;
+            std::this_thread::sleep_until(next);
+            fake_touch_screen->emit_event(mis::a_touch_event()
+                .with_action(mis::TouchParameters::Action::Move)
+                .at_position({(i * 7) % range, (i * 13) % range}));
+        }
+        fake_touch_screen->emit_event(mis::a_touch_event()
+            .with_action(mis::TouchParameters::Action::Release)
+            .at_position({range/2, range/2}));
+
+        EXPECT_TRUE(client.all_received.wait_for(30s));
+
+        std::lock_guard<std::mutex> lock{client.mutex};
+        return client.latencies;
+    }
+};
+
+void report(char const* name, std::vector<std::chrono::nanoseconds> latencies)
+{
+    if (latencies.empty())
+        return;
+
+    std::sort(latencies.begin(), latencies.end());
+    auto const total = std::accumulate(latencies.begin(), latencies.end(), std::chrono::nanoseconds{0});
+    auto const percentile = [&](double p) { return latencies[static_cast<size_t>(p * (latencies.size() - 1))]; };
+    auto const us = [](std::chrono::nanoseconds ns) { return ns.count() / 1000.0; };
+
+    std::cout << name << ": " << latencies.size() << " events"
+              << ", mean " << us(total / latencies.size()) << "us"
+              << ", p50 " << us(percentile(0.5)) << "us"
+              << ", p99 " << us(percentile(0.99)) << "us"
+              << ", max " << us(latencies.back()) << "us" << std::endl;
+}
+}
+
+TEST_F(InputRingLatency, touch_latency_at_8kHz)
+{
+    report("Socket", measure("0"));
+    report("Ring", measure("1"));
+}
@@ -0,0 +1,312 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "benchmark.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <regex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+namespace mb = mir_benchmarks;
+
+namespace
+{
+struct Registered
+{
+    unsigned long iterations;
+    mb::Benchmark benchmark;
+};
+
+// Ordered by name, so every run lists the results in the same order
+std::map<std::string, Registered>& registry()
+{
+    static std::map<std::string, Registered> benchmarks;
+    return benchmarks;
+}
+
+// Includes the time spent on server and client threads, as well as our own
+std::chrono::nanoseconds process_cpu_time()
+{
+    timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return std::chrono::seconds{ts.tv_sec} + std::chrono::nanoseconds{ts.tv_nsec};
+}
+
+struct Result
+{
+    std::string name;
+    std::string run_type;
+    unsigned long iterations;
+    double real_time;
+    double cpu_time;
+    double items_per_second;
+};
+
+std::string quoted(std::string const& text)
+{
+    std::string result{"\""};
+    for (auto const c : text)
+    {
+        if (c == '"' || c == '\\')
+        {
+            result += '\\';
+            result += c;
+        }
+        else if (static_cast<unsigned char>(c) < 0x20)
+        {
+            char escaped[8];
+            snprintf(escaped, sizeof escaped, "\\u%04x", c);
+            result += escaped;
+        }
+        else
+        {
+            result += c;
+        }
+    }
+    return result + "\"";
+}
+
+// The layout Google Benchmark's --benchmark_format=json uses, so that the
+// tools which compare its results can compare ours
+void print_json(std::vector<Result> const& results, char const* executable)
+{
+    char date[32];
+    auto const now = std::time(nullptr);
+    std::strftime(date, sizeof date, "%FT%T%z", std::localtime(&now));
+    char host[256] = "";
+    gethostname(host, sizeof host - 1);
+
+    std::cout << "{\n"
+              << "  \"context\": {\n"
+              << "    \"date\": " << quoted(date) << ",\n"
+              << "    \"host_name\": " << quoted(host) << ",\n"
+              << "    \"executable\": " << quoted(executable) << ",\n"
+              << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n"
+#ifdef NDEBUG
+              << "    \"library_build_type\": \"release\"\n"
+#else
+              << "    \"library_build_type\": \"debug\"\n"
+#endif
+              << "  },\n"
+              << "  \"benchmarks\": [";
+
+    char const* separator = "\n";
+    for (auto const& result : results)
+    {
+        std::cout << separator
+                  << "    {\n"
+                  << "      \"name\": " << quoted(result.name) << ",\n"
+                  << "      \"run_type\": " << quoted(result.run_type) << ",\n"
+                  << "      \"iterations\": " << result.iterations << ",\n"
+                  << "      \"real_time\": " << result.real_time << ",\n"
+                  << "      \"cpu_time\": " << result.cpu_time << ",\n";
+        if (result.items_per_second > 0)
+            std::cout << "      \"items_per_second\": " << result.items_per_second << ",\n";
+        std::cout << "      \"time_unit\": \"ns\"\n"
+                  << "    }";
+        separator = ",\n";
+    }
+    std::cout << "\n  ]\n}" << std::endl;
+}
+
+void print_console(std::vector<Result> const& results)
+{
+    std::cout << std::left << std::setw(48) << "benchmark" << std::right
+              << std::setw(12) << "iterations"
+              << std::setw(16) << "real ns/iter"
+              << std::setw(16) << "cpu ns/iter"
+              << std::setw(16) << "items/s" << std::endl;
+    for (auto const& result : results)
+    {
+        std::cout << std::left << std::setw(48) << result.name << std::right
+                  << std::setw(12) << result.iterations
+                  << std::setw(16) << result.real_time
+                  << std::setw(16) << result.cpu_time
+                  << std::setw(16) << result.items_per_second << std::endl;
+    }
+}
+
+Result run(std::string const& name, Registered const& registered, unsigned long iterations)
+{
+    mb::State state{iterations ? iterations : registered.iterations};
+    registered.benchmark(state);
+
+    auto const per_iteration = [&](std::chrono::nanoseconds total)
+        {
+            return static_cast<double>(total.count()) / state.iterations();
+        };
+    auto const seconds = std::chrono::duration<double>(state.real_time()).count();
+
+    return {name, "iteration", state.iterations(),
+            per_iteration(state.real_time()), per_iteration(state.cpu_time()),
+            seconds > 0 ? state.items_processed() / seconds : 0};
+}
+
+Result median_of(std::vector<Result> repetitions)
+{
+    auto const median = [&](double Result::* field)
+        {
+            std::sort(repetitions.begin(), repetitions.end(),
+                [field](Result const& a, Result const& b) { return a.*field < b.*field; });
+            auto const n = repetitions.size();
+            return n % 2 ? repetitions[n / 2].*field :
+                (repetitions[n / 2 - 1].*field + repetitions[n / 2].*field) / 2;
+        };
+
+    Result result = repetitions.front();
+    result.name += "_median";
+    result.run_type = "aggregate";
+    result.real_time = median(&Result::real_time);
+    result.cpu_time = median(&Result::cpu_time);
+    result.items_per_second = median(&Result::items_per_second);
+    return result;
+}
+
+void usage(char const* executable)
+{
+    std::cerr << "Usage: " << executable << " [options]\n"
+              << "  --filter=<regex>    run only the benchmarks whose names match\n"
+              << "  --iterations=<n>    run n iterations of each, rather than its own count\n"
+              << "  --repetitions=<n>   run each n times, and add the median\n"
+              << "  --format=<format>   json (the default) or console\n"
+              << "  --list              list the benchmarks" << std::endl;
+}
+}
+
+mb::State::State(unsigned long iterations) :
+    max_iterations{iterations}
+{
+}
+
+bool mb::State::keep_running()
+{
+    if (!started)
+    {
+        started = true;
+        resume_timing();
+        return max_iterations > 0;
+    }
+
+    if (++completed < max_iterations)
+        return true;
+
+    pause_timing();
+    return false;
+}
+
+void mb::State::pause_timing()
+{
+    if (!timing)
+        return;
+
+    real += std::chrono::steady_clock::now() - real_start;
+    cpu += process_cpu_time() - cpu_start;
+    timing = false;
+}
+
+void mb::State::resume_timing()
+{
+    if (timing)
+        return;
+
+    timing = true;
+    cpu_start = process_cpu_time();
+    real_start = std::chrono::steady_clock::now();
+}
+
+void mb::State::set_items_processed(unsigned long items)
+{
+    this->items = items;
+}
+
+mb::Registration::Registration(char const* name, unsigned long iterations, Benchmark const& benchmark)
+{
+    registry()[name] = {iterations, benchmark};
+}
+
+int main(int argc, char** argv)
+{
+    std::regex filter{".*"};
+    unsigned long iterations{0};
+    unsigned long repetitions{1};
+    bool json{true};
+    bool list{false};
+
+    try
+    {
+        for (auto i = 1; i != argc; ++i)
+        {
+            std::string const arg{argv[i]};
+            auto const value = arg.substr(arg.find('=') + 1);
+
+            if (arg.find("--filter=") == 0)
+                filter = std::regex{value};
+            else if (arg.find("--iterations=") == 0)
+                iterations = std::stoul(value);
+            else if (arg.find("--repetitions=") == 0)
+                repetitions = std::max(std::stoul(value), 1ul);
+            else if (arg == "--format=json" || arg == "--format=console")
+                json = value == "json";
+            else if (arg == "--list")
+                list = true;
+            else
+                throw std::invalid_argument{arg};
+        }
+    }
+    catch (std::exception const&)
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    std::vector<Result> results;
+    for (auto const& benchmark : registry())
+    {
+        if (!std::regex_search(benchmark.first, filter))
+            continue;
+
+        if (list)
+        {
+            std::cout << benchmark.first << std::endl;
+            continue;
+        }
+
+        std::vector<Result> runs;
+        for (auto i = 0ul; i != repetitions; ++i)
+            runs.push_back(run(benchmark.first, benchmark.second, iterations));
+
+        results.insert(results.end(), runs.begin(), runs.end());
+        if (repetitions > 1)
+            results.push_back(median_of(runs));
+    }
+
+    if (list)
+        return 0;
+
+    if (json)
+        print_json(results, argv[0]);
+    else
+        print_console(results);
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_BENCHMARKS_BENCHMARK_H_
+#define MIR_BENCHMARKS_BENCHMARK_H_
+
+#include <chrono>
+#include <functional>
+#include <string>
+
+namespace mir_benchmarks
+{
+/**
+ * Passed to each benchmark, which does its setup first and then times its
+ * work in a loop:
+ *
+ *     while (state.keep_running())
+ *         ...
+ *
+ * Each benchmark runs a fixed number of iterations, so every run does the
+ * same work and runs can be compared.
+ */
+class State
+{
+public:
+    explicit State(unsigned long iterations);
+
+    bool keep_running();
+
+    /// Excludes what follows from the timings, until resume_timing()
+    void pause_timing();
+    void resume_timing();
+
+    /// Counts units of work other than iterations (events, clients...)
+    void set_items_processed(unsigned long items);
+
+    unsigned long iterations() const { return max_iterations; }
+    unsigned long items_processed() const { return items; }
+    std::chrono::nanoseconds real_time() const { return real; }
+    std::chrono::nanoseconds cpu_time() const { return cpu; }
+
+private:
+    unsigned long const max_iterations;
+    unsigned long completed{0};
+    unsigned long items{0};
+    bool started{false};
+    bool timing{false};
+    std::chrono::steady_clock::time_point real_start;
+    std::chrono::nanoseconds cpu_start{0};
+    std::chrono::nanoseconds real{0};
+    std::chrono::nanoseconds cpu{0};
+};
+
+using Benchmark = std::function<void(State&)>;
+
+/// Adds a benchmark to those main() runs; use MIR_BENCHMARK() rather than this
+class Registration
+{
+public:
+    Registration(char const* name, unsigned long iterations, Benchmark const& benchmark);
+};
+}
+
+/**
+ * Defines a benchmark that runs the given number of iterations. The body
+ * has a mir_benchmarks::State& called state.
+ */
+#define MIR_BENCHMARK(name, iterations) \
+    static void name(mir_benchmarks::State& state); \
+    static mir_benchmarks::Registration const name##_registration{#name, iterations, &name}; \
+    static void name(mir_benchmarks::State& state)
+
+#endif /* MIR_BENCHMARKS_BENCHMARK_H_ */
@@ -0,0 +1,104 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "benchmark.h"
+
+#include "src/server/compositor/stream.h"
+#include "mir/frontend/client_buffers.h"
+#include "mir/graphics/buffer.h"
+#include "mir/test/doubles/stub_buffer.h"
+#include "mir/test/doubles/stub_frame_dropping_policy_factory.h"
+
+#include <boost/throw_exception.hpp>
+
+#include <deque>
+#include <map>
+#include <stdexcept>
+
+namespace mc = mir::compositor;
+namespace mf = mir::frontend;
+namespace mg = mir::graphics;
+namespace mtd = mir::test::doubles;
+namespace geom = mir::geometry;
+
+namespace
+{
+// Stands in for the client: buffers the stream sends back are free to submit again
+struct ClientBuffers : mf::ClientBuffers
+{
+    ClientBuffers(unsigned int count)
+    {
+        for (auto i = 0u; i != count; ++i)
+        {
+            auto const buffer = std::make_shared<mtd::StubBuffer>(geom::Size{1920, 1080});
+            buffers[buffer->id()] = buffer;
+            free.push_back(buffer);
+        }
+    }
+
+    mg::BufferID add_buffer(std::shared_ptr<mg::Buffer> const& buffer) override { return buffer->id(); }
+    void remove_buffer(mg::BufferID) override {}
+    std::shared_ptr<mg::Buffer> get(mg::BufferID id) const override { return buffers.at(id); }
+    void send_buffer(mg::BufferID id) override { free.push_back(buffers.at(id)); }
+    void receive_buffer(mg::BufferID) override {}
+    void send_buffer_count_hint(mf::BufferStreamId, int) override {}
+    void send_present_feedback(mf::BufferStreamId, mf::PresentFeedback const&) override {}
+
+    std::shared_ptr<mg::Buffer> render()
+    {
+        if (free.empty())
+            BOOST_THROW_EXCEPTION(std::logic_error("no buffer for the client to render into"));
+        auto const buffer = free.front();
+        free.pop_front();
+        return buffer;
+    }
+
+    std::map<mg::BufferID, std::shared_ptr<mg::Buffer>> buffers;
+    std::deque<std::shared_ptr<mg::Buffer>> free;
+};
+
+void submit_composite_release(mir_benchmarks::State& state, MirPresentMode mode, int outputs)
+{
+    mtd::StubFrameDroppingPolicyFactory policy_factory;
+    auto const client = std::make_shared<ClientBuffers>(3);
+    mc::Stream stream{policy_factory, client, geom::Size{1920, 1080}, mir_pixel_format_abgr_8888};
+    stream.set_present_mode(mode);
+
+    std::vector<int> compositors(outputs);
+    while (state.keep_running())
+    {
+        stream.submit_buffer(client->render());
+        // Each compositor releases the buffer once it has drawn it
+        for (auto& compositor : compositors)
+            stream.lock_compositor_buffer(&compositor);
+    }
+}
+}
+
+MIR_BENCHMARK(buffer_submit_composite_release_fifo, 200000)
+{
+    submit_composite_release(state, mir_present_mode_fifo, 1);
+}
+
+MIR_BENCHMARK(buffer_submit_composite_release_mailbox, 200000)
+{
+    submit_composite_release(state, mir_present_mode_mailbox, 1);
+}
+
+MIR_BENCHMARK(buffer_submit_composite_release_fifo_3_outputs, 200000)
+{
+    submit_composite_release(state, mir_present_mode_fifo, 3);
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "benchmark.h"
+#include "headless_server.h"
+
+#include "mir/graphics/display.h"
+#include "mir/graphics/display_configuration.h"
+#include "mir/shell/display_configuration_controller.h"
+
+#include <boost/throw_exception.hpp>
+
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace mb = mir_benchmarks;
+namespace mg = mir::graphics;
+
+using namespace std::chrono_literals;
+
+namespace
+{
+int const client_count{10};
+
+struct Notifications
+{
+    std::mutex mutex;
+    std::condition_variable changed;
+    int count{0};
+};
+
+void display_config_changed(MirConnection*, void* context)
+{
+    auto const notifications = static_cast<Notifications*>(context);
+    std::lock_guard<decltype(notifications->mutex)> lock{notifications->mutex};
+    ++notifications->count;
+    notifications->changed.notify_one();
+}
+}
+
+// From a shell setting the base configuration to every client knowing of it
+MIR_BENCHMARK(display_config_broadcast_10_clients, 200)
+{
+    mb::HeadlessServer server;
+    server.start();
+
+    Notifications notifications;
+    std::vector<MirConnection*> connections;
+    for (int i = 0; i != client_count; ++i)
+    {
+        connections.push_back(mb::connect(server, "display_config_broadcast"));
+        mir_connection_set_display_config_change_callback(
+            connections.back(), &display_config_changed, &notifications);
+    }
+
+    auto const controller = server.server.the_display_configuration_controller();
+    auto const display = server.server.the_display();
+
+    unsigned long changes{0};
+    while (state.keep_running())
+    {
+        state.pause_timing();
+        std::shared_ptr<mg::DisplayConfiguration> config = display->configuration();
+        auto const scale = changes % 2 ? 1.0f : 2.0f;
+        config->for_each_output([scale](mg::UserDisplayConfigurationOutput& output)
+            {
+                output.scale = scale;
+            });
+        {
+            std::lock_guard<decltype(notifications.mutex)> lock{notifications.mutex};
+            notifications.count = 0;
+        }
+        ++changes;
+        state.resume_timing();
+
+        controller->set_base_configuration(config);
+
+        std::unique_lock<decltype(notifications.mutex)> lock{notifications.mutex};
+        if (!notifications.changed.wait_for(lock, 10s, [&] { return notifications.count >= client_count; }))
+            BOOST_THROW_EXCEPTION(std::runtime_error{"Timed out waiting for clients to be notified"});
+    }
+    state.set_items_processed(changes * client_count);
+
+    for (auto const connection : connections)
+    {
+        mir_connection_set_display_config_change_callback(connection, [](MirConnection*, void*) {}, nullptr);
+        mir_connection_release(connection);
+    }
+}
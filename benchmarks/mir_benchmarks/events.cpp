@@ -0,0 +1,99 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "benchmark.h"
+
+#include "mir/events/event_builders.h"
+#include "mir/events/event_private.h"
+
+#include <linux/input.h>
+#include <xkbcommon/xkbcommon-keysyms.h>
+
+namespace mev = mir::events;
+
+namespace
+{
+std::chrono::nanoseconds const timestamp{1000000};
+std::vector<uint8_t> const cookie(24, 0x5a);
+
+mir::EventUPtr key_event()
+{
+    return mev::make_event(
+        MirInputDeviceId{1}, timestamp, cookie, mir_keyboard_action_down,
+        XKB_KEY_a, KEY_A, mir_input_event_modifier_none);
+}
+
+mir::EventUPtr pointer_event()
+{
+    return mev::make_event(
+        MirInputDeviceId{2}, timestamp, cookie, mir_input_event_modifier_none,
+        mir_pointer_action_motion, mir_pointer_button_primary,
+        640.0f, 480.0f, 0.0f, 0.0f, 3.0f, -2.0f);
+}
+
+// A two finger gesture plus a palm, as a touchscreen reports
+mir::EventUPtr touch_event()
+{
+    auto event = mev::make_event(MirInputDeviceId{3}, timestamp, cookie, mir_input_event_modifier_none);
+    mev::add_touch(*event, 0, mir_touch_action_change, mir_touch_tooltype_finger, 100, 200, 0.5, 8, 6, 7);
+    mev::add_touch(*event, 1, mir_touch_action_change, mir_touch_tooltype_finger, 300, 220, 0.6, 8, 6, 7);
+    mev::add_touch(*event, 2, mir_touch_action_down, mir_touch_tooltype_finger, 900, 700, 0.9, 40, 30, 35);
+    return event;
+}
+
+void serialize(mir_benchmarks::State& state, MirEvent const& event)
+{
+    while (state.keep_running())
+        MirEvent::serialize(&event);
+}
+
+void deserialize(mir_benchmarks::State& state, MirEvent const& event)
+{
+    auto const bytes = MirEvent::serialize(&event);
+    while (state.keep_running())
+        MirEvent::deserialize(bytes);
+}
+}
+
+MIR_BENCHMARK(event_serialize_key, 200000)
+{
+    serialize(state, *key_event());
+}
+
+MIR_BENCHMARK(event_serialize_pointer, 200000)
+{
+    serialize(state, *pointer_event());
+}
+
+MIR_BENCHMARK(event_serialize_touch, 200000)
+{
+    serialize(state, *touch_event());
+}
+
+MIR_BENCHMARK(event_deserialize_key, 200000)
+{
+    deserialize(state, *key_event());
+}
+
+MIR_BENCHMARK(event_deserialize_pointer, 200000)
+{
+    deserialize(state, *pointer_event());
+}
+
+MIR_BENCHMARK(event_deserialize_touch, 200000)
+{
+    deserialize(state, *touch_event());
+}
@@ -0,0 +1,174 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "headless_server.h"
+
+#include "mir_test_framework/executable_path.h"
+#include "mir_test_framework/headless_display_buffer_compositor_factory.h"
+#include "mir/input/input_device_hub.h"
+#include "mir/input/input_device_observer.h"
+
+#include <boost/throw_exception.hpp>
+
+#include <stdexcept>
+
+namespace mb = mir_benchmarks;
+namespace mi = mir::input;
+namespace mtf = mir_test_framework;
+
+using namespace std::chrono_literals;
+
+namespace
+{
+struct DeviceCounter : mi::InputDeviceObserver
+{
+    DeviceCounter(int expected) : expected{expected} {}
+
+    void device_added(std::shared_ptr<mi::Device> const&) override { ++count; }
+    void device_changed(std::shared_ptr<mi::Device> const&) override {}
+    void device_removed(std::shared_ptr<mi::Device> const&) override { --count; }
+    void changes_complete() override
+    {
+        if (count == expected)
+            all_added.raise();
+    }
+
+    int const expected;
+    int count{0};
+    mir::test::Signal all_added;
+};
+}
+
+mb::HeadlessServer::HeadlessServer() :
+    HeadlessServer{std::string{}}
+{
+}
+
+mb::HeadlessServer::HeadlessServer(std::string const& socket_file)
+{
+    add_to_environment("MIR_SERVER_PLATFORM_GRAPHICS_LIB", mtf::server_platform("graphics-dummy.so").c_str());
+    add_to_environment("MIR_SERVER_PLATFORM_INPUT_LIB", mtf::server_platform("input-stub.so").c_str());
+    add_to_environment("MIR_SERVER_ENABLE_KEY_REPEAT", "false");
+    if (socket_file.empty())
+        add_to_environment("MIR_SERVER_NO_FILE", "");
+    else
+        add_to_environment("MIR_SERVER_FILE", socket_file.c_str());
+    server.override_the_display_buffer_compositor_factory([]
+    {
+        return std::make_shared<mtf::HeadlessDisplayBufferCompositorFactory>();
+    });
+}
+
+mb::HeadlessServer::~HeadlessServer()
+{
+    if (started)
+        stop_server();
+}
+
+void mb::HeadlessServer::start()
+{
+    start_server();
+    started = true;
+}
+
+void mb::HeadlessServer::wait_for_input_devices(int count)
+{
+    // The stub input platform adds its devices from the input thread, once
+    // the server has started
+    auto const counter = std::make_shared<DeviceCounter>(count);
+    auto const hub = server.the_input_device_hub();
+    hub->add_observer(counter);
+    auto const added = counter->all_added.wait_for(10s);
+    hub->remove_observer(counter);
+
+    if (!added)
+        BOOST_THROW_EXCEPTION(std::runtime_error{"Timed out waiting for input devices"});
+}
+
+MirConnection* mb::connect(HeadlessServer& server, char const* name)
+{
+    auto const connection = mir_connect_sync(server.new_connection().c_str(), name);
+    if (!mir_connection_is_valid(connection))
+    {
+        auto const error = std::string{"Failed to connect to benchmark server: "} +
+            mir_connection_get_error_message(connection);
+        mir_connection_release(connection);
+        BOOST_THROW_EXCEPTION(std::runtime_error{error});
+    }
+    return connection;
+}
+
+mb::Client::Client(HeadlessServer& server, char const* name) :
+    connection{connect(server, name)}
+{
+
+    auto const spec = mir_create_normal_window_spec(connection, 640, 480);
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+    mir_window_spec_set_pixel_format(spec, mir_pixel_format_abgr_8888);
+#pragma GCC diagnostic pop
+    mir_window_spec_set_event_handler(spec, &handle_event, this);
+    mir_window_spec_set_name(spec, name);
+    window = mir_create_window_sync(spec);
+    mir_window_spec_release(spec);
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+    mir_buffer_stream_swap_buffers_sync(mir_window_get_buffer_stream(window));
+#pragma GCC diagnostic pop
+
+    if (!ready.wait_for(10s))
+    {
+        mir_window_release_sync(window);
+        mir_connection_release(connection);
+        BOOST_THROW_EXCEPTION(std::runtime_error{"Timed out waiting for window to be focused and exposed"});
+    }
+}
+
+mb::Client::~Client()
+{
+    mir_window_set_event_handler(window, [](MirWindow*, MirEvent const*, void*) {}, nullptr);
+    mir_window_release_sync(window);
+    mir_connection_release(connection);
+}
+
+void mb::Client::handle_event(MirWindow*, MirEvent const* event, void* context)
+{
+    auto const self = static_cast<Client*>(context);
+
+    switch (mir_event_get_type(event))
+    {
+    case mir_event_type_window:
+    {
+        auto const window_event = mir_event_get_window_event(event);
+        auto const attrib = mir_window_event_get_attribute(window_event);
+        auto const value = mir_window_event_get_attribute_value(window_event);
+
+        if (attrib == mir_window_attrib_focus && value == mir_window_focus_state_focused)
+            self->focused = true;
+        if (attrib == mir_window_attrib_visibility && value == mir_window_visibility_exposed)
+            self->exposed = true;
+        if (self->focused && self->exposed)
+            self->ready.raise();
+        break;
+    }
+    case mir_event_type_input:
+        self->on_input(mir_event_get_input_event(event));
+        break;
+    default:
+        break;
+    }
+}
@@ -0,0 +1,79 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_BENCHMARKS_HEADLESS_SERVER_H_
+#define MIR_BENCHMARKS_HEADLESS_SERVER_H_
+
+#include "mir_test_framework/async_server_runner.h"
+#include "mir/test/signal.h"
+#include "mir_toolkit/mir_client_library.h"
+
+#include <functional>
+#include <string>
+
+namespace mir_benchmarks
+{
+/**
+ * A server running in-process on the stub graphics and input platforms, as
+ * the acceptance tests' servers do. Add fake input devices before starting it.
+ */
+class HeadlessServer : public mir_test_framework::AsyncServerRunner
+{
+public:
+    /// A server only reachable through new_connection()
+    HeadlessServer();
+    /// A server that also listens on the given socket file
+    explicit HeadlessServer(std::string const& socket_file);
+    ~HeadlessServer();
+
+    void start();
+
+    /// Waits until the server has added the given number of input devices
+    void wait_for_input_devices(int count);
+
+private:
+    bool started{false};
+};
+
+/// Connects to the server, throwing if it cannot
+MirConnection* connect(HeadlessServer& server, char const* name);
+
+/// A client whose window has been shown, and has focus
+class Client
+{
+public:
+    Client(HeadlessServer& server, char const* name);
+    ~Client();
+
+    Client(Client const&) = delete;
+    Client& operator=(Client const&) = delete;
+
+    /// Called, on the client's event thread, for each input event the window gets
+    std::function<void(MirInputEvent const*)> on_input{[](MirInputEvent const*) {}};
+
+    MirConnection* const connection;
+    MirWindow* window{nullptr};
+
+private:
+    static void handle_event(MirWindow*, MirEvent const* event, void* context);
+
+    mir::test::Signal ready;
+    bool focused{false};
+    bool exposed{false};
+};
+}
+
+#endif /* MIR_BENCHMARKS_HEADLESS_SERVER_H_ */
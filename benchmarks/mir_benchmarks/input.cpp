@@ -0,0 +1,80 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "benchmark.h"
+#include "headless_server.h"
+
+#include "mir/input/input_device_info.h"
+#include "mir_test_framework/fake_input_device.h"
+#include "mir_test_framework/stub_server_platform_factory.h"
+#include "mir/test/event_factory.h"
+
+#include <boost/throw_exception.hpp>
+
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+
+#include <linux/input.h>
+
+namespace mb = mir_benchmarks;
+namespace mi = mir::input;
+namespace mis = mir::input::synthesis;
+namespace mtf = mir_test_framework;
+
+using namespace std::chrono_literals;
+
+// From the stub input platform, through the seat and dispatcher, to the
+// focused window's client
+MIR_BENCHMARK(input_dispatch_key_to_client, 2000)
+{
+    auto const keyboard = mtf::add_fake_input_device(mi::InputDeviceInfo{
+        "keyboard", "keyboard-uid", mi::DeviceCapability::keyboard | mi::DeviceCapability::alpha_numeric});
+
+    mb::HeadlessServer server;
+    server.start();
+    server.wait_for_input_devices(1);
+    mb::Client client{server, "input_dispatch"};
+
+    std::mutex mutex;
+    std::condition_variable delivered;
+    unsigned long received{0};
+    client.on_input = [&](MirInputEvent const* event)
+        {
+            if (mir_input_event_get_type(event) != mir_input_event_type_key)
+                return;
+            std::lock_guard<decltype(mutex)> lock{mutex};
+            ++received;
+            delivered.notify_one();
+        };
+
+    unsigned long sent{0};
+    while (state.keep_running())
+    {
+        if (sent % 2)
+            keyboard->emit_event(mis::a_key_up_event().of_scancode(KEY_A));
+        else
+            keyboard->emit_event(mis::a_key_down_event().of_scancode(KEY_A));
+        ++sent;
+
+        std::unique_lock<decltype(mutex)> lock{mutex};
+        if (!delivered.wait_for(lock, 10s, [&] { return received == sent; }))
+            BOOST_THROW_EXCEPTION(std::runtime_error{"Timed out waiting for key event"});
+    }
+    state.set_items_processed(sent);
+
+    client.on_input = [](MirInputEvent const*) {};
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "benchmark.h"
+#include "headless_server.h"
+
+#include "mir_test_framework/stub_graphics_platform_operation.h"
+
+#include <vector>
+
+namespace mb = mir_benchmarks;
+namespace mtf = mir_test_framework;
+
+namespace
+{
+void assign_reply(MirConnection*, MirPlatformMessage* reply, void* context)
+{
+    *static_cast<MirPlatformMessage**>(context) = reply;
+}
+}
+
+// A request the stub graphics platform answers at once, so that what is
+// timed is the trip through the client library, socket and frontend
+MIR_BENCHMARK(ipc_round_trip, 5000)
+{
+    mb::HeadlessServer server;
+    server.start();
+    auto const connection = mb::connect(server, "ipc_round_trip");
+
+    std::vector<int> const numbers{17, 25};
+    auto const request = mir_platform_message_create(
+        static_cast<unsigned int>(mtf::StubGraphicsPlatformOperation::add));
+    mir_platform_message_set_data(request, numbers.data(), sizeof(int) * numbers.size());
+
+    while (state.keep_running())
+    {
+        MirPlatformMessage* reply{nullptr};
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+        mir_wait_for(mir_connection_platform_operation(connection, request, assign_reply, &reply));
+#pragma GCC diagnostic pop
+        mir_platform_message_release(reply);
+    }
+
+    mir_platform_message_release(request);
+    mir_connection_release(connection);
+}
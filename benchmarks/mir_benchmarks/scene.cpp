@@ -0,0 +1,108 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "benchmark.h"
+
+#include "src/server/scene/surface_stack.h"
+#include "mir/scene/scene_report.h"
+#include "mir/compositor/scene_element.h"
+#include "mir/geometry/rectangle.h"
+#include "src/server/compositor/occlusion.h"
+#include "mir/test/doubles/stub_surface.h"
+#include "mir/test/doubles/stub_renderable.h"
+
+#include <vector>
+
+namespace ms = mir::scene;
+namespace mc = mir::compositor;
+namespace mg = mir::graphics;
+namespace mi = mir::input;
+namespace mtd = mir::test::doubles;
+namespace geom = mir::geometry;
+
+namespace
+{
+struct NullSceneReport : ms::SceneReport
+{
+    void surface_created(BasicSurfaceId, std::string const&) override {}
+    void surface_added(BasicSurfaceId, std::string const&) override {}
+    void surface_removed(BasicSurfaceId, std::string const&) override {}
+    void surface_deleted(BasicSurfaceId, std::string const&) override {}
+};
+
+struct BenchmarkSurface : mtd::StubSurface
+{
+    BenchmarkSurface(geom::Rectangle const& area) :
+        renderable{std::make_shared<mtd::StubRenderable>(area)}
+    {
+    }
+
+    bool visible() const override { return true; }
+    mg::RenderableList generate_renderables(mc::CompositorID) const override { return {renderable}; }
+    int buffers_ready_for_compositor(void const*) const override { return 1; }
+
+    std::shared_ptr<mg::Renderable> const renderable;
+};
+
+geom::Rectangle const output{{0, 0}, {1920, 1080}};
+
+// Windows cascaded across and beyond a 1080p output, so that some are
+// wholly hidden, some partly and some are offscreen
+struct Scene
+{
+    Scene(int surface_count)
+    {
+        stack.register_compositor(this);
+        for (int i = 0; i != surface_count; ++i)
+        {
+            geom::Point const top_left{(i % 10) * 200, (i / 10) * 120};
+            stack.add_surface(
+                std::make_shared<BenchmarkSurface>(geom::Rectangle{top_left, {640, 480}}),
+                mi::InputReceptionMode::normal);
+        }
+    }
+
+    ~Scene()
+    {
+        stack.unregister_compositor(this);
+    }
+
+    ms::SurfaceStack stack{std::make_shared<NullSceneReport>()};
+};
+}
+
+MIR_BENCHMARK(scene_snapshot_100_surfaces, 20000)
+{
+    Scene scene{100};
+
+    while (state.keep_running())
+    {
+        for (auto const& element : scene.stack.scene_elements_for(&scene))
+            element->rendered();
+    }
+}
+
+MIR_BENCHMARK(occlusion_100_surfaces, 20000)
+{
+    Scene scene{100};
+    auto const elements = scene.stack.scene_elements_for(&scene);
+
+    while (state.keep_running())
+    {
+        auto visible = elements;
+        mc::filter_occlusions_from(visible, output);
+    }
+}
@@ -0,0 +1,182 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "simulated_client.h"
+
+#include <boost/throw_exception.hpp>
+
+#include <cstring>
+#include <stdexcept>
+
+namespace mb = mir_benchmarks;
+
+using namespace std::chrono;
+
+namespace
+{
+auto const lost_after = seconds{1};
+}
+
+void mb::Samples::add(nanoseconds sample)
+{
+    std::lock_guard<decltype(mutex)> lock{mutex};
+    samples.push_back(sample);
+}
+
+auto mb::Samples::take() -> std::vector<nanoseconds>
+{
+    std::lock_guard<decltype(mutex)> lock{mutex};
+    std::vector<nanoseconds> result;
+    result.swap(samples);
+    return result;
+}
+
+void mb::KeyLatency::sent()
+{
+    std::lock_guard<decltype(mutex)> lock{mutex};
+    in_flight.push_back(steady_clock::now());
+}
+
+void mb::KeyLatency::received()
+{
+    auto const now = steady_clock::now();
+
+    std::lock_guard<decltype(mutex)> lock{mutex};
+    // Keys sent while no window had focus never arrive
+    while (!in_flight.empty() && now - in_flight.front() > lost_after)
+        in_flight.pop_front();
+
+    // Key events that we didn't send (if there is a real keyboard) aren't timed
+    if (in_flight.empty())
+        return;
+
+    samples.add(now - in_flight.front());
+    in_flight.pop_front();
+}
+
+mb::SimulatedClient::SimulatedClient(
+    std::string const& server,
+    Trace::Client const& script,
+    Samples& frame_times,
+    KeyLatency& key_latency) :
+    script(script),
+    frame_times(frame_times),
+    key_latency(key_latency),
+    connection{mir_connect_sync(server.c_str(), script.name.c_str())}
+{
+    if (!mir_connection_is_valid(connection))
+    {
+        auto const error = std::string{"Failed to connect to server: "} +
+            mir_connection_get_error_message(connection);
+        mir_connection_release(connection);
+        BOOST_THROW_EXCEPTION(std::runtime_error{error});
+    }
+
+    auto const spec = mir_create_normal_window_spec(
+        connection, script.size.width.as_int(), script.size.height.as_int());
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+    mir_window_spec_set_pixel_format(spec, mir_pixel_format_abgr_8888);
+    mir_window_spec_set_buffer_usage(spec, mir_buffer_usage_software);
+#pragma GCC diagnostic pop
+    mir_window_spec_set_event_handler(spec, &handle_event, this);
+    mir_window_spec_set_name(spec, script.name.c_str());
+    window = mir_create_window_sync(spec);
+    mir_window_spec_release(spec);
+
+    if (!mir_window_is_valid(window))
+    {
+        auto const error = std::string{"Failed to create window: "} + mir_window_get_error_message(window);
+        mir_window_release_sync(window);
+        mir_connection_release(connection);
+        BOOST_THROW_EXCEPTION(std::runtime_error{error});
+    }
+
+    // Clients show their window before anything else
+    submit_frame();
+
+    thread = std::thread{[this] { replay(); }};
+}
+
+mb::SimulatedClient::~SimulatedClient()
+{
+    {
+        std::lock_guard<decltype(mutex)> lock{mutex};
+        stopped = true;
+    }
+    stopping.notify_all();
+    thread.join();
+
+    mir_window_set_event_handler(window, [](MirWindow*, MirEvent const*, void*) {}, nullptr);
+    mir_window_release_sync(window);
+    mir_connection_release(connection);
+}
+
+void mb::SimulatedClient::replay()
+{
+    auto const period = script.disconnected - script.connected;
+    auto const start = steady_clock::now();
+
+    std::unique_lock<decltype(mutex)> lock{mutex};
+
+    if (script.submissions.empty() || period <= microseconds{0})
+    {
+        stopping.wait(lock, [this] { return stopped; });
+        return;
+    }
+
+    for (int repeat = 0; ; ++repeat)
+    {
+        for (auto const& submission : script.submissions)
+        {
+            auto const due = start + repeat * period + (submission - script.connected);
+            if (stopping.wait_until(lock, due, [this] { return stopped; }))
+                return;
+
+            lock.unlock();
+            submit_frame();
+            lock.lock();
+        }
+    }
+}
+
+void mb::SimulatedClient::submit_frame()
+{
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+    auto const stream = mir_window_get_buffer_stream(window);
+
+    // Drawing is the client's business, not the server's, so only enough
+    // is drawn to make each frame differ from the last
+    MirGraphicsRegion region;
+    if (mir_buffer_stream_get_graphics_region(stream, &region))
+        memset(region.vaddr, static_cast<int>(steady_clock::now().time_since_epoch().count()), region.stride);
+
+    auto const submitted = steady_clock::now();
+    mir_buffer_stream_swap_buffers_sync(stream);
+    frame_times.add(steady_clock::now() - submitted);
+#pragma GCC diagnostic pop
+}
+
+void mb::SimulatedClient::handle_event(MirWindow*, MirEvent const* event, void* context)
+{
+    if (mir_event_get_type(event) != mir_event_type_input)
+        return;
+
+    auto const input_event = mir_event_get_input_event(event);
+    if (mir_input_event_get_type(input_event) == mir_input_event_type_key)
+        static_cast<SimulatedClient*>(context)->key_latency.received();
+}
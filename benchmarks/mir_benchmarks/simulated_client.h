@@ -0,0 +1,97 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_BENCHMARKS_SIMULATED_CLIENT_H_
+#define MIR_BENCHMARKS_SIMULATED_CLIENT_H_
+
+#include "trace.h"
+#include "mir_toolkit/mir_client_library.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mir_benchmarks
+{
+/// Durations measured on several threads
+class Samples
+{
+public:
+    void add(std::chrono::nanoseconds sample);
+    /// Returns, and forgets, the samples added since the last call
+    std::vector<std::chrono::nanoseconds> take();
+
+private:
+    std::mutex mutex;
+    std::vector<std::chrono::nanoseconds> samples;
+};
+
+/// Times key events from being sent to the server until a client gets them
+class KeyLatency
+{
+public:
+    void sent();
+    void received();
+
+    Samples samples;
+
+private:
+    std::mutex mutex;
+    std::deque<std::chrono::steady_clock::time_point> in_flight;
+};
+
+/**
+ * A client with a software (shared memory) buffered window, submitting
+ * buffers when a traced client did, over and over, until destroyed.
+ * The time each submission takes to give the client its next buffer is
+ * added to frame_times.
+ */
+class SimulatedClient
+{
+public:
+    SimulatedClient(
+        std::string const& server,
+        Trace::Client const& script,
+        Samples& frame_times,
+        KeyLatency& key_latency);
+    ~SimulatedClient();
+
+    SimulatedClient(SimulatedClient const&) = delete;
+    SimulatedClient& operator=(SimulatedClient const&) = delete;
+
+private:
+    static void handle_event(MirWindow*, MirEvent const* event, void* context);
+    void replay();
+    void submit_frame();
+
+    Trace::Client const& script;
+    Samples& frame_times;
+    KeyLatency& key_latency;
+
+    MirConnection* const connection;
+    MirWindow* window{nullptr};
+
+    std::mutex mutex;
+    std::condition_variable stopping;
+    bool stopped{false};
+    std::thread thread;
+};
+}
+
+#endif /* MIR_BENCHMARKS_SIMULATED_CLIENT_H_ */
@@ -0,0 +1,106 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "benchmark.h"
+#include "touch_trace.h"
+
+#include "src/server/input/surface_input_dispatcher.h"
+#include "mir/input/validator.h"
+#include "mir/input/surface.h"
+#include "mir/test/doubles/stub_input_scene.h"
+
+#include <boost/throw_exception.hpp>
+
+#include <cstdlib>
+#include <fstream>
+#include <stdexcept>
+
+namespace mb = mir_benchmarks;
+namespace mi = mir::input;
+namespace mtd = mir::test::doubles;
+namespace geom = mir::geometry;
+
+namespace
+{
+MirInputDeviceId const touchscreen{7};
+
+// The recording named by MIR_BENCHMARKS_TOUCH_TRACE, or ten fingers on a table
+std::vector<mir::EventUPtr> touch_trace()
+{
+    auto const recording = getenv("MIR_BENCHMARKS_TOUCH_TRACE");
+    if (!recording)
+        return mb::synthetic_touch_trace(touchscreen);
+
+    std::ifstream in{recording};
+    if (!in)
+        BOOST_THROW_EXCEPTION(std::runtime_error{std::string{"Cannot read "} + recording});
+    return mb::read_touch_trace(in, touchscreen);
+}
+
+// A window covering the screen, that discards what it is sent
+struct Window : mi::Surface
+{
+    std::string name() const override { return "touch"; }
+    geom::Rectangle input_bounds() const override { return {{0, 0}, {65536, 65536}}; }
+    bool input_area_contains(geom::Point const&) const override { return true; }
+    std::shared_ptr<mir::graphics::CursorImage> cursor_image() const override { return {}; }
+    mi::InputReceptionMode reception_mode() const override { return mi::InputReceptionMode::normal; }
+    void consume(MirEvent const*) override {}
+};
+
+struct OneWindowScene : mtd::StubInputScene
+{
+    void for_each(std::function<void(std::shared_ptr<mi::Surface> const&)> const& exec) override
+    {
+        exec(window);
+    }
+
+    std::shared_ptr<mi::Surface> const window{std::make_shared<Window>()};
+};
+}
+
+// Checking that each contact goes down before it changes and up before it
+// vanishes, as every touch event is
+MIR_BENCHMARK(input_validate_touch_trace, 200)
+{
+    auto const trace = touch_trace();
+    mi::Validator validator{[](MirEvent const&) {}};
+
+    while (state.keep_running())
+    {
+        for (auto const& event : trace)
+            validator.validate_and_dispatch(*event);
+    }
+    state.set_items_processed(state.iterations() * trace.size());
+}
+
+// ...and then finding the window that owns each gesture and delivering to it
+MIR_BENCHMARK(input_dispatch_touch_trace, 200)
+{
+    auto const trace = touch_trace();
+    mi::SurfaceInputDispatcher dispatcher{std::make_shared<OneWindowScene>()};
+    dispatcher.start();
+    mi::Validator validator{[&](MirEvent const& event) { dispatcher.dispatch(event); }};
+
+    while (state.keep_running())
+    {
+        for (auto const& event : trace)
+            validator.validate_and_dispatch(*event);
+    }
+    state.set_items_processed(state.iterations() * trace.size());
+
+    dispatcher.stop();
+}
@@ -0,0 +1,206 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "touch_trace.h"
+
+#include <boost/throw_exception.hpp>
+
+#include <array>
+#include <cmath>
+#include <istream>
+#include <sstream>
+#include <stdexcept>
+
+#include <linux/input.h>
+
+namespace mb = mir_benchmarks;
+namespace mev = mir::events;
+
+using namespace std::chrono;
+
+namespace
+{
+std::vector<uint8_t> const no_cookie;
+
+struct Slot
+{
+    enum class State { empty, landed, touching, lifted };
+
+    State state{State::empty};
+    int tracking_id{-1};
+    float x{0}, y{0}, pressure{0}, major{0}, minor{0};
+};
+
+// The most contacts a MirTouchEvent carries
+size_t const max_slots{16};
+
+mir::EventUPtr touch_event(MirInputDeviceId device, nanoseconds time, std::array<Slot, max_slots>& slots)
+{
+    auto event = mev::make_event(device, time, no_cookie, mir_input_event_modifier_none);
+
+    for (auto& slot : slots)
+    {
+        MirTouchAction action;
+        switch (slot.state)
+        {
+        case Slot::State::empty:
+            continue;
+        case Slot::State::landed:
+            action = mir_touch_action_down;
+            slot.state = Slot::State::touching;
+            break;
+        case Slot::State::touching:
+            action = mir_touch_action_change;
+            break;
+        case Slot::State::lifted:
+            action = mir_touch_action_up;
+            slot.state = Slot::State::empty;
+            break;
+        }
+
+        mev::add_touch(*event, slot.tracking_id, action, mir_touch_tooltype_finger,
+                       slot.x, slot.y, slot.pressure, slot.major, slot.minor, 0);
+    }
+
+    return event;
+}
+}
+
+std::vector<mir::EventUPtr> mb::read_touch_trace(std::istream& in, MirInputDeviceId device)
+{
+    std::vector<mir::EventUPtr> events;
+    std::array<Slot, max_slots> slots;
+    size_t slot{0};
+    bool reported{false};
+
+    std::string line;
+    while (std::getline(in, line))
+    {
+        if (line.compare(0, 3, "E: ") != 0)
+            continue;
+
+        double seconds{0};
+        std::string type, code, value;
+        std::istringstream fields{line.substr(3)};
+        if (!(fields >> seconds >> type >> code >> value))
+            BOOST_THROW_EXCEPTION(std::runtime_error{"Invalid evemu event: \"" + line + "\""});
+
+        auto const ev_type = std::stoi(type, nullptr, 16);
+        auto const ev_code = std::stoi(code, nullptr, 16);
+        auto const ev_value = std::stoi(value);
+
+        if (ev_type == EV_SYN && ev_code == SYN_REPORT)
+        {
+            if (reported)
+                events.push_back(touch_event(device, duration_cast<nanoseconds>(duration<double>{seconds}), slots));
+            reported = false;
+            continue;
+        }
+
+        if (ev_type != EV_ABS)
+            continue;
+
+        if (ev_code == ABS_MT_SLOT)
+        {
+            // Contacts beyond what an event can carry all land in the last slot
+            slot = std::min(static_cast<size_t>(std::max(ev_value, 0)), max_slots - 1);
+            continue;
+        }
+
+        auto& current = slots[slot];
+        switch (ev_code)
+        {
+        case ABS_MT_TRACKING_ID:
+            if (ev_value < 0)
+            {
+                if (current.state != Slot::State::empty)
+                    current.state = Slot::State::lifted;
+            }
+            else
+            {
+                current.state = Slot::State::landed;
+                current.tracking_id = ev_value;
+            }
+            break;
+        case ABS_MT_POSITION_X:
+            current.x = ev_value;
+            break;
+        case ABS_MT_POSITION_Y:
+            current.y = ev_value;
+            break;
+        case ABS_MT_PRESSURE:
+            current.pressure = ev_value;
+            break;
+        case ABS_MT_TOUCH_MAJOR:
+            current.major = ev_value;
+            break;
+        case ABS_MT_TOUCH_MINOR:
+            current.minor = ev_value;
+            break;
+        default:
+            continue;
+        }
+        reported = true;
+    }
+
+    if (events.empty())
+        BOOST_THROW_EXCEPTION(std::runtime_error{"No multi-touch events in the recording"});
+
+    return events;
+}
+
+std::vector<mir::EventUPtr> mb::synthetic_touch_trace(MirInputDeviceId device)
+{
+    int const fingers{10};
+    int const moving_frames{240};
+    nanoseconds const frame{1000000000 / 120};
+
+    std::vector<mir::EventUPtr> events;
+    std::array<Slot, max_slots> slots;
+    nanoseconds time{0};
+
+    auto const place = [&](int finger, int step)
+        {
+            slots[finger].x = 200 + 150 * finger + 100 * std::sin(step / 30.0);
+            slots[finger].y = 400 + 20 * (finger % 5) + 100 * std::cos(step / 30.0);
+            slots[finger].pressure = 0.5f;
+            slots[finger].major = 8;
+            slots[finger].minor = 6;
+        };
+
+    for (int finger = 0; finger != fingers; ++finger)
+    {
+        slots[finger].state = Slot::State::landed;
+        slots[finger].tracking_id = finger;
+        place(finger, 0);
+        events.push_back(touch_event(device, time += frame, slots));
+    }
+
+    for (int step = 1; step <= moving_frames; ++step)
+    {
+        for (int finger = 0; finger != fingers; ++finger)
+            place(finger, step);
+        events.push_back(touch_event(device, time += frame, slots));
+    }
+
+    for (int finger = 0; finger != fingers; ++finger)
+    {
+        slots[finger].state = Slot::State::lifted;
+        events.push_back(touch_event(device, time += frame, slots));
+    }
+
+    return events;
+}
@@ -0,0 +1,47 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_BENCHMARKS_TOUCH_TRACE_H_
+#define MIR_BENCHMARKS_TOUCH_TRACE_H_
+
+#include "mir/events/event_builders.h"
+
+#include <iosfwd>
+#include <vector>
+
+namespace mir_benchmarks
+{
+/**
+ * Reads the touch events of an evemu-record recording of a multi-touch
+ * (protocol B) touchscreen:
+ *
+ *   E: 0.000000 0003 002f 0000	# EV_ABS / ABS_MT_SLOT            0
+ *   E: 0.000000 0003 0039 0123	# EV_ABS / ABS_MT_TRACKING_ID     123
+ *   E: 0.000000 0003 0035 0412	# EV_ABS / ABS_MT_POSITION_X      412
+ *   E: 0.000000 0003 0036 0300	# EV_ABS / ABS_MT_POSITION_Y      300
+ *   E: 0.000000 0000 0000 0000	# ------------ SYN_REPORT (0) ----------
+ *
+ * Each report that touches a slot becomes a touch event carrying every
+ * contact: down where a tracking id began, up where one ended, and
+ * changed otherwise. Other lines are ignored.
+ */
+std::vector<mir::EventUPtr> read_touch_trace(std::istream& in, MirInputDeviceId device);
+
+/// Ten fingers landing one by one, moving together for two seconds at 120Hz, and lifting one by one
+std::vector<mir::EventUPtr> synthetic_touch_trace(MirInputDeviceId device);
+}
+
+#endif /* MIR_BENCHMARKS_TOUCH_TRACE_H_ */
@@ -0,0 +1,280 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "trace.h"
+
+#include <boost/throw_exception.hpp>
+
+#include <algorithm>
+#include <ctime>
+#include <istream>
+#include <map>
+#include <ostream>
+#include <regex>
+#include <sstream>
+#include <stdexcept>
+#include <tuple>
+
+namespace mb = mir_benchmarks;
+namespace geom = mir::geometry;
+
+using namespace std::chrono;
+
+namespace
+{
+geom::Size parse_size(std::string const& text)
+{
+    int width{0}, height{0};
+    char x{0};
+    std::istringstream in{text};
+    if (!(in >> width >> x >> height) || x != 'x' || width <= 0 || height <= 0)
+        BOOST_THROW_EXCEPTION(std::runtime_error{"Invalid surface size: \"" + text + "\""});
+
+    return geom::Size{width, height};
+}
+
+// Appends to, and keeps track of, the clients connected in a log
+class Clients
+{
+public:
+    Clients(mb::Trace& trace, geom::Size surface_size) :
+        trace(trace),
+        surface_size{surface_size}
+    {
+    }
+
+    mb::Trace::Client& connect(std::string const& name, microseconds time)
+    {
+        connected[name].push_back(trace.clients.size());
+        trace.clients.push_back({name, surface_size, time, microseconds{-1}, {}, {}});
+        return trace.clients.back();
+    }
+
+    // Calls made by clients that connected before the log began are theirs
+    // from the start of the trace
+    mb::Trace::Client& find(std::string const& name)
+    {
+        auto const i = connected.find(name);
+        if (i == connected.end() || i->second.empty())
+            return connect(name, microseconds{0});
+
+        return trace.clients[i->second.back()];
+    }
+
+    void disconnect(std::string const& name, microseconds time)
+    {
+        find(name).disconnected = time;
+        connected[name].pop_back();
+    }
+
+private:
+    mb::Trace& trace;
+    geom::Size const surface_size;
+    std::map<std::string, std::vector<size_t>> connected;
+};
+
+void finish(mb::Trace& trace)
+{
+    for (auto& client : trace.clients)
+    {
+        if (client.disconnected < microseconds{0})
+            client.disconnected = trace.length;
+    }
+}
+}
+
+mb::Trace mb::read_trace(std::istream& in)
+{
+    Trace trace;
+    std::map<std::string, size_t> ids;
+
+    auto const client = [&](std::string const& id) -> Trace::Client&
+        {
+            auto const i = ids.find(id);
+            if (i == ids.end())
+                BOOST_THROW_EXCEPTION(std::runtime_error{"Trace event for unknown client \"" + id + "\""});
+            return trace.clients[i->second];
+        };
+
+    std::string line;
+    for (int line_number = 1; std::getline(in, line); ++line_number)
+    {
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        std::istringstream event{line};
+        long long time;
+        std::string id, type;
+        if (!(event >> time >> id >> type))
+        {
+            BOOST_THROW_EXCEPTION(std::runtime_error{
+                "Invalid trace event on line " + std::to_string(line_number) + ": \"" + line + "\""});
+        }
+
+        microseconds const when{time};
+        trace.length = std::max(trace.length, when);
+
+        if (type == "connect")
+        {
+            std::string size, name;
+            event >> size >> std::ws;
+            std::getline(event, name);
+            ids[id] = trace.clients.size();
+            trace.clients.push_back({name, parse_size(size), when, microseconds{-1}, {}, {}});
+        }
+        else if (type == "submit")
+        {
+            client(id).submissions.push_back(when);
+        }
+        else if (type == "rpc")
+        {
+            std::string method;
+            event >> method;
+            client(id).requests.emplace_back(when, method);
+        }
+        else if (type == "disconnect")
+        {
+            client(id).disconnected = when;
+        }
+        else if (type == "key")
+        {
+            trace.keys.push_back(when);
+        }
+        else
+        {
+            BOOST_THROW_EXCEPTION(std::runtime_error{
+                "Unknown trace event on line " + std::to_string(line_number) + ": \"" + type + "\""});
+        }
+    }
+
+    finish(trace);
+    return trace;
+}
+
+void mb::write_trace(Trace const& trace, std::ostream& out)
+{
+    // Events at the same time keep the order they are listed in here
+    std::vector<std::tuple<microseconds, size_t, std::string>> events;
+    auto const add = [&](microseconds time, std::string const& event)
+        {
+            events.emplace_back(time, events.size(), event);
+        };
+
+    for (size_t i = 0; i != trace.clients.size(); ++i)
+    {
+        auto const& client = trace.clients[i];
+        auto const id = std::to_string(i + 1) + " ";
+
+        add(client.connected, id + "connect " + std::to_string(client.size.width.as_int()) + "x" +
+                              std::to_string(client.size.height.as_int()) + " " + client.name);
+        for (auto const& submission : client.submissions)
+            add(submission, id + "submit");
+        for (auto const& request : client.requests)
+            add(request.first, id + "rpc " + request.second);
+        add(client.disconnected, id + "disconnect");
+    }
+
+    for (auto const& key : trace.keys)
+        add(key, "- key");
+
+    std::sort(events.begin(), events.end());
+
+    out << "# mir_workload trace\n";
+    for (auto const& event : events)
+        out << std::get<0>(event).count() << ' ' << std::get<2>(event) << '\n';
+}
+
+mb::Trace mb::trace_from_log(std::istream& log, geom::Size surface_size)
+{
+    // As written by the default logger
+    std::regex const log_line{R"(^\[(\d{4}-\d\d-\d\d \d\d:\d\d:\d\d)\.(\d{6})\] (?:<\w+> )?([\w:]+): (.*)$)"};
+    std::regex const session_call{R"(^session_(\w+?)(?:_called)?\("([^",]*))"};
+
+    Trace trace;
+    Clients clients{trace, surface_size};
+    bool started{false};
+    microseconds start{0};
+
+    std::string line;
+    while (std::getline(log, line))
+    {
+        std::smatch match;
+        if (!std::regex_match(line, match, log_line))
+            continue;
+
+        auto const component = match[3].str();
+        auto const message = match[4].str();
+
+        bool const session_event = component == "frontend::SessionMediator";
+        bool const key_event = component == "input" && message.compare(0, 19, "Published key event") == 0;
+        if (!session_event && !key_event)
+            continue;
+
+        std::tm calendar{};
+        if (!strptime(match[1].str().c_str(), "%Y-%m-%d %H:%M:%S", &calendar))
+            continue;
+
+        microseconds const logged{duration_cast<microseconds>(seconds{timegm(&calendar)}) +
+                                  microseconds{std::stoll(match[2].str())}};
+        if (!started)
+        {
+            start = logged;
+            started = true;
+        }
+
+        auto const time = logged - start;
+        trace.length = std::max(trace.length, time);
+
+        if (key_event)
+        {
+            trace.keys.push_back(time);
+            continue;
+        }
+
+        std::smatch call;
+        if (!std::regex_search(message, call, session_call))
+            continue;
+
+        auto const method = call[1].str();
+        auto const name = call[2].str();
+
+        if (method == "connect")
+            clients.connect(name, time);
+        else if (method == "disconnect")
+            clients.disconnect(name, time);
+        else if (method == "submit_buffer")
+            clients.find(name).submissions.push_back(time);
+        else
+            clients.find(name).requests.emplace_back(time, method);
+    }
+
+    finish(trace);
+    return trace;
+}
+
+mb::Trace mb::synthetic_trace(geom::Size surface_size)
+{
+    Trace trace;
+    trace.length = seconds{1};
+    trace.clients.push_back({"synthetic", surface_size, microseconds{0}, trace.length, {}, {}});
+
+    for (int frame = 0; frame != 60; ++frame)
+        trace.clients.back().submissions.push_back(microseconds{frame * 1000000 / 60});
+    for (int key = 0; key != 10; ++key)
+        trace.keys.push_back(milliseconds{key * 100});
+
+    return trace;
+}
@@ -0,0 +1,76 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_BENCHMARKS_TRACE_H_
+#define MIR_BENCHMARKS_TRACE_H_
+
+#include "mir/geometry/size.h"
+
+#include <chrono>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace mir_benchmarks
+{
+/**
+ * The traffic of a server's clients, to be replayed by mir_workload.
+ *
+ * As text, there is one event per line: the microseconds since the trace
+ * began, the client ("-" for input), the event and any argument to it.
+ *
+ *   # mir_workload trace
+ *   0 1 connect 640x480 terminal
+ *   16667 1 submit
+ *   20000 - key
+ *   40000 1 rpc configure_surface
+ *   900000 1 disconnect
+ */
+struct Trace
+{
+    struct Client
+    {
+        std::string name;
+        mir::geometry::Size size;
+        std::chrono::microseconds connected;
+        std::chrono::microseconds disconnected;
+        /// When the client submitted buffers
+        std::vector<std::chrono::microseconds> submissions;
+        /// The other requests the client made, and when
+        std::vector<std::pair<std::chrono::microseconds, std::string>> requests;
+    };
+
+    std::vector<Client> clients;
+    /// When key events were sent to clients
+    std::vector<std::chrono::microseconds> keys;
+    std::chrono::microseconds length{0};
+};
+
+Trace read_trace(std::istream& in);
+void write_trace(Trace const& trace, std::ostream& out);
+
+/**
+ * Records a trace from the log of a server run with
+ * --session-mediator-report=log and --input-report=log. The reports don't
+ * say how big clients' surfaces are, so every client gets surface_size.
+ */
+Trace trace_from_log(std::istream& log, mir::geometry::Size surface_size);
+
+/// A client submitting a surface_size buffer at 60Hz, and a key pressed every 100ms
+Trace synthetic_trace(mir::geometry::Size surface_size);
+}
+
+#endif /* MIR_BENCHMARKS_TRACE_H_ */
@@ -0,0 +1,441 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "headless_server.h"
+#include "simulated_client.h"
+#include "trace.h"
+
+#include "mir/input/input_device_info.h"
+#include "mir_test_framework/fake_input_device.h"
+#include "mir_test_framework/stub_server_platform_factory.h"
+#include "mir/test/event_factory.h"
+
+#include <boost/throw_exception.hpp>
+
+#include <linux/input.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+
+namespace mb = mir_benchmarks;
+namespace mi = mir::input;
+namespace mis = mir::input::synthesis;
+namespace mtf = mir_test_framework;
+namespace geom = mir::geometry;
+
+using namespace std::chrono;
+
+namespace
+{
+auto const warm_up = seconds{1};
+
+void usage(char const* executable)
+{
+    std::cerr << "Usage: " << executable << " record [--size=<width>x<height>] < <server log> > <trace>\n"
+              << "   or: " << executable << " replay [options]\n"
+              << "Record reads the log of a server run with --session-mediator-report=log\n"
+              << "and --input-report=log. Replay options:\n"
+              << "  --trace=<file>          the trace to replay (a client at 60Hz if none)\n"
+              << "  --size=<width>x<height> the size of the client without a trace (640x480)\n"
+              << "  --clients=<n>[,<n>...]  how many clients to measure (1,2,4,8,16,32)\n"
+              << "  --duration=<seconds>    how long to measure each client count for (10)\n"
+              << "  --connect=<socket>      replay to this server, rather than a headless one,\n"
+              << "  --server-pid=<pid>      ...which is this process" << std::endl;
+}
+
+geom::Size parse_size(std::string const& text)
+{
+    int width{0}, height{0};
+    char x{0};
+    std::istringstream in{text};
+    if (!(in >> width >> x >> height) || x != 'x' || width <= 0 || height <= 0)
+        throw std::invalid_argument{text};
+
+    return geom::Size{width, height};
+}
+
+std::vector<size_t> parse_counts(std::string const& text)
+{
+    std::vector<size_t> counts;
+    std::istringstream in{text};
+    for (std::string count; std::getline(in, count, ',');)
+        counts.push_back(std::stoul(count));
+
+    if (counts.empty() || std::count(counts.begin(), counts.end(), 0))
+        throw std::invalid_argument{text};
+
+    // Clients are only ever added
+    std::sort(counts.begin(), counts.end());
+    counts.erase(std::unique(counts.begin(), counts.end()), counts.end());
+    return counts;
+}
+
+struct Usage
+{
+    nanoseconds cpu;
+    long rss_kib;
+};
+
+Usage usage_of(pid_t pid)
+{
+    Usage usage{nanoseconds{0}, 0};
+    auto const proc = "/proc/" + std::to_string(pid);
+
+    // utime and stime are the 12th and 13th fields after the (parenthesised) command
+    std::ifstream stat_file{proc + "/stat"};
+    std::string stat;
+    std::getline(stat_file, stat);
+    std::istringstream fields{stat.substr(stat.rfind(')') + 2)};
+    std::string skip;
+    for (int i = 0; i != 11; ++i)
+        fields >> skip;
+    unsigned long long utime{0}, stime{0};
+    if (!(fields >> utime >> stime))
+        BOOST_THROW_EXCEPTION(std::runtime_error{"Failed to read CPU time of server process " + std::to_string(pid)});
+    usage.cpu = duration_cast<nanoseconds>(seconds{utime + stime}) / sysconf(_SC_CLK_TCK);
+
+    std::ifstream status{proc + "/status"};
+    for (std::string line; std::getline(status, line);)
+    {
+        if (line.compare(0, 6, "VmRSS:") == 0)
+            usage.rss_kib = std::stol(line.substr(6));
+    }
+
+    return usage;
+}
+
+double milliseconds_at(std::vector<nanoseconds>& samples, double percentile)
+{
+    if (samples.empty())
+        return 0;
+
+    std::sort(samples.begin(), samples.end());
+    auto const rank = std::min(samples.size() - 1, static_cast<size_t>(percentile / 100 * samples.size()));
+    return duration<double, std::milli>(samples[rank]).count();
+}
+
+/**
+ * A headless server in a process of its own, so that its CPU time and
+ * memory aren't the clients'. It presses a key whenever asked to.
+ */
+class ServerProcess
+{
+public:
+    explicit ServerProcess(std::string const& socket_file)
+    {
+        int command_pipe[2], ready_pipe[2];
+        if (pipe(command_pipe) || pipe(ready_pipe))
+            BOOST_THROW_EXCEPTION(std::system_error(errno, std::system_category(), "Failed to create pipes"));
+
+        pid = fork();
+        if (pid < 0)
+            BOOST_THROW_EXCEPTION(std::system_error(errno, std::system_category(), "Failed to fork server"));
+
+        if (pid == 0)
+        {
+            close(command_pipe[1]);
+            close(ready_pipe[0]);
+            _exit(serve(socket_file, command_pipe[0], ready_pipe[1]));
+        }
+
+        close(command_pipe[0]);
+        close(ready_pipe[1]);
+        commands = command_pipe[1];
+
+        char started{0};
+        auto const got = read(ready_pipe[0], &started, 1);
+        close(ready_pipe[0]);
+        if (got != 1)
+        {
+            close(commands);
+            waitpid(pid, nullptr, 0);
+            BOOST_THROW_EXCEPTION(std::runtime_error{"Headless server failed to start"});
+        }
+    }
+
+    ~ServerProcess()
+    {
+        close(commands);
+        waitpid(pid, nullptr, 0);
+    }
+
+    void press_key()
+    {
+        char const key{'k'};
+        if (write(commands, &key, 1) != 1)
+            BOOST_THROW_EXCEPTION(std::runtime_error{"Headless server has gone away"});
+    }
+
+    pid_t pid;
+
+private:
+    static int serve(std::string const& socket_file, int commands, int ready)
+    try
+    {
+        auto const keyboard = mtf::add_fake_input_device(mi::InputDeviceInfo{
+            "keyboard", "keyboard-uid", mi::DeviceCapability::keyboard | mi::DeviceCapability::alpha_numeric});
+
+        mb::HeadlessServer server{socket_file};
+        server.start();
+        server.wait_for_input_devices(1);
+
+        char const started{'r'};
+        if (write(ready, &started, 1) != 1)
+            return 1;
+        close(ready);
+
+        // A key goes down, and then comes up
+        bool down{true};
+        for (char command; read(commands, &command, 1) == 1; down = !down)
+        {
+            if (down)
+                keyboard->emit_event(mis::a_key_down_event().of_scancode(KEY_A));
+            else
+                keyboard->emit_event(mis::a_key_up_event().of_scancode(KEY_A));
+        }
+
+        return 0;
+    }
+    catch (std::exception const& error)
+    {
+        std::cerr << "Headless server failed: " << error.what() << std::endl;
+        return 1;
+    }
+
+    int commands;
+};
+
+/// Presses keys, from a thread of its own, when the trace did
+class KeyReplay
+{
+public:
+    KeyReplay(mb::Trace const& trace, ServerProcess& server, mb::KeyLatency& latency) :
+        thread{[&trace, &server, &latency, this]
+            {
+                if (trace.keys.empty() || trace.length <= microseconds{0})
+                    return;
+
+                auto const start = steady_clock::now();
+                std::unique_lock<decltype(mutex)> lock{mutex};
+                for (int repeat = 0; ; ++repeat)
+                {
+                    for (auto const& key : trace.keys)
+                    {
+                        if (stopping.wait_until(lock, start + repeat * trace.length + key, [this] { return stopped; }))
+                            return;
+
+                        latency.sent();
+                        server.press_key();
+                    }
+                }
+            }}
+    {
+    }
+
+    ~KeyReplay()
+    {
+        {
+            std::lock_guard<decltype(mutex)> lock{mutex};
+            stopped = true;
+        }
+        stopping.notify_all();
+        thread.join();
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable stopping;
+    bool stopped{false};
+    std::thread thread;
+};
+
+int record(int argc, char** argv)
+{
+    geom::Size size{640, 480};
+
+    for (auto i = 2; i != argc; ++i)
+    {
+        std::string const arg{argv[i]};
+        if (arg.find("--size=") == 0)
+            size = parse_size(arg.substr(7));
+        else
+            throw std::invalid_argument{arg};
+    }
+
+    auto const trace = mb::trace_from_log(std::cin, size);
+    mb::write_trace(trace, std::cout);
+
+    std::cerr << "Recorded " << trace.clients.size() << " clients and " << trace.keys.size()
+              << " key events over " << duration<double>(trace.length).count() << "s" << std::endl;
+    return 0;
+}
+
+int replay(int argc, char** argv)
+{
+    std::string trace_file;
+    geom::Size size{640, 480};
+    std::vector<size_t> counts{1, 2, 4, 8, 16, 32};
+    seconds measured{10};
+    std::string socket;
+    pid_t server_pid{0};
+
+    for (auto i = 2; i != argc; ++i)
+    {
+        std::string const arg{argv[i]};
+        auto const value = arg.substr(arg.find('=') + 1);
+
+        if (arg.find("--trace=") == 0)
+            trace_file = value;
+        else if (arg.find("--size=") == 0)
+            size = parse_size(value);
+        else if (arg.find("--clients=") == 0)
+            counts = parse_counts(value);
+        else if (arg.find("--duration=") == 0)
+            measured = seconds{std::max(std::stoul(value), 1ul)};
+        else if (arg.find("--connect=") == 0)
+            socket = value;
+        else if (arg.find("--server-pid=") == 0)
+            server_pid = std::stoi(value);
+        else
+            throw std::invalid_argument{arg};
+    }
+
+    if (socket.empty() != (server_pid == 0))
+        throw std::invalid_argument{"--connect and --server-pid go together"};
+
+    auto const trace = [&]
+        {
+            if (trace_file.empty())
+                return mb::synthetic_trace(size);
+
+            std::ifstream in{trace_file};
+            if (!in)
+                BOOST_THROW_EXCEPTION(std::runtime_error{"Failed to open " + trace_file});
+            return mb::read_trace(in);
+        }();
+
+    if (trace.clients.empty())
+        BOOST_THROW_EXCEPTION(std::runtime_error{"The trace has no clients to replay"});
+
+    size_t requests{0};
+    for (auto const& client : trace.clients)
+        requests += client.requests.size();
+    if (requests)
+        std::cerr << "Not replaying " << requests << " requests other than buffer submissions" << std::endl;
+
+    // We'd rather hear that the headless server has gone than die with it
+    signal(SIGPIPE, SIG_IGN);
+
+    // The server process must be forked before any threads are started
+    std::unique_ptr<ServerProcess> headless;
+    if (socket.empty())
+    {
+        socket = std::string{getenv("XDG_RUNTIME_DIR") ? getenv("XDG_RUNTIME_DIR") : "/tmp"} +
+                 "/mir_workload_" + std::to_string(getpid());
+        headless = std::make_unique<ServerProcess>(socket);
+        server_pid = headless->pid;
+    }
+
+    mb::Samples frame_times;
+    mb::KeyLatency key_latency;
+    std::vector<std::unique_ptr<mb::SimulatedClient>> clients;
+    std::unique_ptr<KeyReplay> keys;
+
+    std::cout << "clients  server_cpu_%  server_rss_MiB    frames  frame_p50_ms  frame_p90_ms  frame_p99_ms"
+                 "      keys  key_p50_ms  key_p99_ms" << std::endl;
+
+    for (auto const count : counts)
+    {
+        while (clients.size() < count)
+        {
+            clients.push_back(std::make_unique<mb::SimulatedClient>(
+                socket, trace.clients[clients.size() % trace.clients.size()], frame_times, key_latency));
+        }
+
+        // Only the headless server can be sent keys, and only once a window can have focus
+        if (headless && !keys)
+            keys = std::make_unique<KeyReplay>(trace, *headless, key_latency);
+
+        std::this_thread::sleep_for(warm_up);
+        frame_times.take();
+        key_latency.samples.take();
+
+        auto const before = usage_of(server_pid);
+        auto const start = steady_clock::now();
+        std::this_thread::sleep_for(measured);
+        auto const after = usage_of(server_pid);
+        auto const elapsed = steady_clock::now() - start;
+
+        auto frames = frame_times.take();
+        auto key_times = key_latency.samples.take();
+
+        std::cout << std::fixed << std::setprecision(2)
+                  << std::setw(7) << count
+                  << std::setw(14) << 100.0 * (after.cpu - before.cpu).count() / nanoseconds{elapsed}.count()
+                  << std::setw(16) << after.rss_kib / 1024.0
+                  << std::setw(10) << frames.size()
+                  << std::setw(14) << milliseconds_at(frames, 50)
+                  << std::setw(14) << milliseconds_at(frames, 90)
+                  << std::setw(14) << milliseconds_at(frames, 99)
+                  << std::setw(10) << key_times.size()
+                  << std::setw(12) << milliseconds_at(key_times, 50)
+                  << std::setw(12) << milliseconds_at(key_times, 99) << std::endl;
+    }
+
+    keys.reset();
+    clients.clear();
+    return 0;
+}
+}
+
+int main(int argc, char** argv)
+try
+{
+    std::string const mode{argc > 1 ? argv[1] : ""};
+
+    try
+    {
+        if (mode == "record")
+            return record(argc, argv);
+        if (mode == "replay")
+            return replay(argc, argv);
+    }
+    catch (std::invalid_argument const&)
+    {
+    }
+
+    usage(argv[0]);
+    return 1;
+}
+catch (std::exception const& error)
+{
+    std::cerr << "mir_workload: " << error.what() << std::endl;
+    return 1;
+}
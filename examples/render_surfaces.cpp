@@ -393,6 +393,8 @@ public:
                 void add_buffer(mg::Buffer&) override {}
                 void remove_buffer(mg::Buffer&) override {}
                 void update_buffer(mg::Buffer&) override {}
+                void send_buffer_count_hint(mf::BufferStreamId, int) override {}
+                void send_present_feedback(mf::BufferStreamId, mf::PresentFeedback const&) override {}
                 void error_buffer(geom::Size, MirPixelFormat, std::string const&) override {}
             };
 
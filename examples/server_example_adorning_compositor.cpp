@@ -244,6 +244,7 @@ void me::AdorningDisplayBufferCompositor::composite(compositor::SceneElementSequ
         glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
         glDisableVertexAttribArray(uvCoord);
         glDisableVertexAttribArray(vPositionAttr);
+        texture_source->rendering_finished();
     }
 
     report->renderables_in_frame(this, renderable_list);
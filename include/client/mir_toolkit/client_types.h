@@ -25,6 +25,7 @@
 #include <mir_toolkit/common.h>
 
 #include <stddef.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 /**
@@ -111,6 +112,36 @@ typedef void (*MirBufferStreamCallback)(
 typedef MirBufferStreamCallback mir_buffer_stream_callback
     __attribute__((deprecated("Use MirBufferStreamCallback instead")));
 
+/**
+ * What became of a frame submitted to a buffer stream.
+ */
+typedef struct MirPresentFeedback
+{
+    /** The id of the buffer the frame was submitted in */
+    int buffer_id;
+    /** Which frame of the stream this is, counting from 1 */
+    uint64_t frame;
+    /** Whether it was composited, shown directly or dropped */
+    MirPresentResult result;
+    /** The output's frame counter when it was shown (0 if dropped) */
+    int64_t msc;
+    /** The clock that timestamp is measured against */
+    int clock_id;
+    /** When it was shown, in nanoseconds (0 if dropped) */
+    int64_t timestamp;
+    /** The refresh period of the output it was shown on, in nanoseconds */
+    int64_t refresh;
+} MirPresentFeedback;
+
+/**
+ * Callback for learning what became of the frames submitted to a buffer stream.
+ *   \param [in] stream       The buffer stream the frame was submitted to
+ *   \param [in] feedback     What became of it
+ *   \param [in,out] context  The context provided by the client
+ */
+typedef void (*MirPresentFeedbackCallback)(
+    MirBufferStream* stream, MirPresentFeedback const* feedback, void* context);
+
 /**
  * Callback for handling of window events.
  *   \param [in] window     The window on which an event has occurred
@@ -265,15 +296,6 @@ typedef enum MirBufferLayout
     mir_buffer_layout_linear  = 1,
 } MirBufferLayout;
 
-typedef enum MirPresentMode
-{
-    mir_present_mode_immediate, //same as VK_PRESENT_MODE_IMMEDIATE_KHR
-    mir_present_mode_mailbox, //same as VK_PRESENT_MODE_MAILBOX_KHR
-    mir_present_mode_fifo, //same as VK_PRESENT_MODE_FIFO_KHR
-    mir_present_mode_fifo_relaxed, //same as VK_PRESENT_MODE_FIFO_RELAXED_KHR
-    mir_present_mode_num_modes
-} MirPresentMode;
-
 /**
  * Retrieved information about a MirWindow. This is most useful for learning
  * how and where to write to a 'mir_buffer_usage_software' surface.
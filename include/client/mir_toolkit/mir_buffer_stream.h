@@ -277,6 +277,21 @@ void mir_buffer_stream_set_size(MirBufferStream* stream, int width, int height);
  */
 void mir_buffer_stream_get_size(MirBufferStream* stream, int* width, int* height);
 
+/**
+ * Ask to be told what became of each frame submitted to the stream from
+ * now on: whether it reached the screen (and when), or was dropped.
+ *
+ * The callback is called from a thread of the client library's choosing,
+ * once for each frame. This function does not wait for the server, so it
+ * may be called from within the callback (e.g. to stop the feedback).
+ *
+ * \param [in] stream    The buffer stream
+ * \param [in] callback  The callback, or NULL to stop the feedback
+ * \param [in] context   User data passed to the callback
+ */
+void mir_buffer_stream_set_present_feedback_callback(
+    MirBufferStream* stream, MirPresentFeedbackCallback callback, void* context);
+
 #ifdef __cplusplus
 }
 /**@}*/
@@ -517,6 +517,17 @@ MirFormFactor mir_output_get_form_factor(MirOutput const* output);
  */
 bool mir_output_is_gamma_supported(MirOutput const* client_output);
 
+/** Gets whether the monitor can vary its refresh rate to follow the frames
+ *  it is given (VESA Adaptive Sync, FreeSync)
+ *
+ * The server decides when to use this; it does so for fullscreen windows
+ * whose buffers it can scan out directly.
+ *
+ * \param [in]  output  The MirOutput to query
+ * \returns     true if the output can vary its refresh rate
+ */
+bool mir_output_is_variable_refresh_capable(MirOutput const* output);
+
 /** Gets the gamma size
  *
  * \param [in]  output  The MirOutput to query
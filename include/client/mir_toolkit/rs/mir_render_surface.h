@@ -172,7 +172,9 @@ bool mir_connection_present_mode_supported(
  *
  *  \pre    mir_connection_present_mode_supported must indicate that the mode is supported
  *  \param [in] chain   The chain
- *  \param [in] mode    The mode to change to
+ *  \param [in] mode    The mode to change to. mir_present_mode_immediate
+ *                      shows each buffer at the next composition, as the
+ *                      server never tears
  */
 void mir_presentation_chain_set_mode(
     MirPresentationChain* chain, MirPresentMode mode);
@@ -458,6 +458,28 @@ typedef enum MirOutputGammaSupported
     mir_output_gamma_supported
 } MirOutputGammaSupported;
 
+/**
+ * How the buffers submitted to a presentation chain are shown
+ */
+typedef enum MirPresentMode
+{
+    mir_present_mode_immediate, //same as VK_PRESENT_MODE_IMMEDIATE_KHR
+    mir_present_mode_mailbox, //same as VK_PRESENT_MODE_MAILBOX_KHR
+    mir_present_mode_fifo, //same as VK_PRESENT_MODE_FIFO_KHR
+    mir_present_mode_fifo_relaxed, //same as VK_PRESENT_MODE_FIFO_RELAXED_KHR
+    mir_present_mode_num_modes
+} MirPresentMode;
+
+/**
+ * What became of a frame submitted to a buffer stream
+ */
+typedef enum MirPresentResult
+{
+    mir_present_result_composited, /**< Drawn into the output's frame */
+    mir_present_result_bypassed,   /**< Scanned out directly from the client's buffer */
+    mir_present_result_dropped     /**< Replaced by a later frame before it was shown */
+} MirPresentResult;
+
 /**@}*/
 
 #endif
@@ -190,7 +190,8 @@ public:
 
     /**
      * Returns timing information for the last frame displayed on a given
-     * output.
+     * output. This may wait for a frame that has been posted but not yet
+     * shown.
      *
      * Frame timing will be provided to clients only when they request it.
      * This is to ensure idle clients never get woken by unwanted events.
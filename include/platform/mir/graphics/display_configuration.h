@@ -130,6 +130,10 @@ struct DisplayConfigurationOutput
     /** EDID of the display, if non-empty */
     std::vector<uint8_t> edid;
 
+    /** Whether the output can vary its refresh rate to follow the frames it
+        is given (VESA Adaptive Sync, FreeSync) */
+    bool variable_refresh_capable{false};
+
     /** The logical rectangle occupied by the output, based on its position,
         current mode and orientation (rotation) */
     geometry::Rectangle extents() const;
@@ -162,6 +166,7 @@ struct UserDisplayConfigurationOutput
     GammaCurves& gamma;
     MirOutputGammaSupported const& gamma_supported;
     std::vector<uint8_t const> const& edid;
+    bool const& variable_refresh_capable;
 
     UserDisplayConfigurationOutput(DisplayConfigurationOutput& master);
     geometry::Rectangle extents() const;
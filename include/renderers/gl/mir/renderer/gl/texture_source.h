@@ -41,7 +41,13 @@ public:
     //add synchronization points to the command stream to ensure resources
     //are present during the draw. Will not upload texture.
     //should be called if an already uploaded texture is reused.
-    virtual void secure_for_render() = 0;
+    //returns false if the content could not be made ready in time, in which
+    //case it should not be sampled this frame.
+    virtual bool secure_for_render() = 0;
+    //add synchronization points to the command stream after the draws that
+    //used the texture, so the buffer can be released without waiting for them.
+    //called once per frame, after the frame's draws have been issued.
+    virtual void rendering_finished() = 0;
 
 protected:
     TextureSource() = default;
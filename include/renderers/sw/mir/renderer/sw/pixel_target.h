@@ -0,0 +1,75 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_RENDERER_SW_PIXEL_TARGET_H_
+#define MIR_RENDERER_SW_PIXEL_TARGET_H_
+
+#include "mir/geometry/dimensions.h"
+#include "mir/geometry/rectangles.h"
+#include "mir/geometry/size.h"
+#include "mir_toolkit/common.h"
+
+namespace mir
+{
+namespace renderer
+{
+namespace software
+{
+
+/**
+ * A display buffer whose frames are drawn by the CPU, offered (through
+ * DisplayBuffer::native_display_buffer()) by displays that can be
+ * composited without GL.
+ */
+class PixelTarget
+{
+public:
+    virtual ~PixelTarget() = default;
+
+    struct Pixels
+    {
+        unsigned char* data;
+        geometry::Size size;
+        geometry::Stride stride;
+        MirPixelFormat format;
+        /**
+         * The number of frames since this buffer was last drawn into (as with
+         * EGL_EXT_buffer_age), so 1 if it holds the frame on screen. Zero if
+         * its contents are undefined.
+         */
+        unsigned age;
+    };
+
+    /** Returns the buffer in which to draw the next frame */
+    virtual Pixels back_buffer() = 0;
+    /**
+     * Hands the frame drawn in the back buffer over to be shown.
+     * \param [in] damage   the areas of the view that differ from the
+     *                      previous frame; the rest may be left as it was
+     */
+    virtual void swap_buffers(geometry::Rectangles const& damage) = 0;
+
+protected:
+    PixelTarget() = default;
+    PixelTarget(PixelTarget const&) = delete;
+    PixelTarget& operator=(PixelTarget const&) = delete;
+};
+
+}
+}
+}
+
+#endif /* MIR_RENDERER_SW_PIXEL_TARGET_H_ */
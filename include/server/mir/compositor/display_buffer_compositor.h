@@ -21,6 +21,10 @@
 #define MIR_COMPOSITOR_DISPLAY_BUFFER_COMPOSITOR_H_
 
 #include "mir/compositor/scene.h"
+#include "mir/graphics/frame.h"
+
+#include <chrono>
+#include <functional>
 
 namespace mir
 {
@@ -34,6 +38,16 @@ public:
 
     virtual void composite(SceneElementSequence&& scene_sequence) = 0;
 
+    /**
+     * Called once the frame last composited has been posted.
+     *  \param [in] flip     says when it reached the screen, as best the display
+     *                       knows; this may wait for the flip, so only call it
+     *                       if the answer is needed
+     *  \param [in] refresh  the refresh period of the output showing it
+     */
+    virtual void frame_posted(
+        std::function<graphics::Frame()> const& /*flip*/, std::chrono::nanoseconds /*refresh*/) {}
+
 protected:
     DisplayBufferCompositor() = default;
     DisplayBufferCompositor& operator=(DisplayBufferCompositor const&) = delete;
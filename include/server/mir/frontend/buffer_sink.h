@@ -20,6 +20,7 @@
 #define MIR_FRONTEND_BUFFER_SINK_H_
 
 #include "mir/frontend/buffer_stream_id.h"
+#include "mir/frontend/present_feedback.h"
 #include "mir/graphics/platform_ipc_operations.h"
 #include "mir/graphics/buffer_properties.h"
 #include <string>
@@ -39,6 +40,10 @@ public:
     virtual void error_buffer(geometry::Size req_size, MirPixelFormat req_format, std::string const& error_msg) = 0;
     virtual void remove_buffer(graphics::Buffer&) = 0;
     virtual void update_buffer(graphics::Buffer&) = 0;
+    // Suggests how many buffers the client should keep for the stream; 0 lets the client decide
+    virtual void send_buffer_count_hint(frontend::BufferStreamId id, int buffer_count) = 0;
+    // Tells the client what became of a frame it submitted to the stream
+    virtual void send_present_feedback(frontend::BufferStreamId id, PresentFeedback const& feedback) = 0;
 
 protected:
     BufferSink() = default;
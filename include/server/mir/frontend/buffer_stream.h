@@ -62,6 +62,10 @@ public:
     //TODO: framedropping for swapinterval-0 can probably be effectively managed from the client
     //      side once we only support the NBS system.
     virtual void allow_framedropping(bool) = 0;
+    /// Shows buffers as the client asked when it chose a presentation mode
+    virtual void set_present_mode(MirPresentMode mode) = 0;
+    /// Whether to tell the client what became of each frame it submits
+    virtual void set_present_feedback(bool enabled) = 0;
     virtual void set_scale(float scale) = 0;
     virtual bool suitable_for_cursor() const = 0;
 protected:
@@ -20,6 +20,8 @@
 #define MIR_FRONTEND_CLIENT_BUFFERS_H_
 
 #include "mir/graphics/buffer_id.h"
+#include "mir/frontend/buffer_stream_id.h"
+#include "mir/frontend/present_feedback.h"
 #include <memory>
 
 namespace mir
@@ -35,6 +37,8 @@ public:
     virtual std::shared_ptr<graphics::Buffer> get(graphics::BufferID) const = 0;
     virtual void send_buffer(graphics::BufferID id) = 0;
     virtual void receive_buffer(graphics::BufferID id) = 0;
+    virtual void send_buffer_count_hint(frontend::BufferStreamId id, int buffer_count) = 0;
+    virtual void send_present_feedback(frontend::BufferStreamId id, PresentFeedback const& feedback) = 0;
 
     ClientBuffers(ClientBuffers const&) = delete;
     ClientBuffers& operator=(ClientBuffers const&) = delete;
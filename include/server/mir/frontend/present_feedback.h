@@ -0,0 +1,46 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_FRONTEND_PRESENT_FEEDBACK_H_
+#define MIR_FRONTEND_PRESENT_FEEDBACK_H_
+
+#include "mir/graphics/buffer_id.h"
+#include "mir/graphics/frame.h"
+#include "mir_toolkit/common.h"
+
+#include <chrono>
+#include <cstdint>
+
+namespace mir
+{
+namespace frontend
+{
+/// What became of a frame a client submitted to a buffer stream
+struct PresentFeedback
+{
+    graphics::BufferID buffer;
+    /// The frame's position among those submitted to the stream, counting from 1
+    uint64_t frame;
+    MirPresentResult result;
+    /// The page flip that first showed the frame; zero for dropped frames
+    graphics::Frame flip;
+    /// The refresh period of the output that showed it; zero if unknown
+    std::chrono::nanoseconds refresh;
+};
+}
+}
+
+#endif /* MIR_FRONTEND_PRESENT_FEEDBACK_H_ */
@@ -59,6 +59,20 @@ public:
     virtual void register_session(frontend::Session const* session, std::function<void()> const& pinger) = 0;
     virtual void unregister_session(frontend::Session const* session) = 0;
     virtual void pong_received(frontend::Session const* received_for) = 0;
+    /**
+     * Gets a function to call for each message (of any kind) received from
+     * a session
+     *
+     * \note Traffic from a session shows it is responsive just as a pong
+     *       does, so sessions that have been heard from recently need not
+     *       be pinged.
+     * \note The function is called for every message, so it records the
+     *       activity without looking the session up. It must not outlive
+     *       the detector.
+     * \return The function, or an empty function if the session is not
+     *         registered
+     */
+    virtual std::function<void()> activity_recorder(frontend::Session const* session) = 0;
 
     virtual void register_observer(std::shared_ptr<Observer> const& observer) = 0;
     virtual void unregister_observer(std::shared_ptr<Observer> const& observer) = 0;
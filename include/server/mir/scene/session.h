@@ -40,6 +40,10 @@ public:
     virtual pid_t process_id() const = 0;
 
     virtual void take_snapshot(SnapshotCallback const& snapshot_taken) = 0;
+    /// Takes a snapshot scaled down (on the GPU, preserving aspect ratio) to
+    /// fit within max_size. A zero dimension leaves that dimension unconstrained,
+    /// so {256, 0} asks for a thumbnail 256 pixels wide.
+    virtual void take_snapshot(geometry::Size const& max_size, SnapshotCallback const& snapshot_taken) = 0;
     virtual std::shared_ptr<Surface> default_surface() const = 0;
     virtual void set_lifecycle_state(MirLifecycleState state) = 0;
 
@@ -114,6 +114,15 @@ private:
 
     FullscreenSurfaces fullscreen_surfaces;
 
+    // Where each surface is in its session's surfaces and its parent's
+    // children, kept as they change so that removal needn't search. Removal
+    // moves the last entry into the gap, so neither list keeps creation order.
+    using SurfacePositions = std::map<std::weak_ptr<scene::Surface>, std::vector<std::weak_ptr<scene::Surface>>::size_type,
+        std::owner_less<std::weak_ptr<scene::Surface>>>;
+
+    SurfacePositions position_in_session;
+    SurfacePositions position_among_siblings;
+
     bool resizing = false;
     bool left_resize = false;
     bool top_resize = false;
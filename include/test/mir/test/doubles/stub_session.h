@@ -40,6 +40,7 @@ struct StubSession : scene::Session
     pid_t process_id() const override;
 
     void take_snapshot(scene::SnapshotCallback const& snapshot_taken) override;
+    void take_snapshot(geometry::Size const& max_size, scene::SnapshotCallback const& snapshot_taken) override;
 
     std::shared_ptr<scene::Surface> default_surface() const override;
 
@@ -51,6 +51,28 @@ namespace geom = mir::geometry;
 
 namespace gp = google::protobuf;
 
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+void mcl::fill_buffer_request(
+    mp::BufferStreamParameters& request, mcl::ClientPlatform& platform,
+    geom::Size size, MirPixelFormat format, int usage)
+{
+    request.set_width(size.width.as_int());
+    request.set_height(size.height.as_int());
+
+    if (usage == mir_buffer_usage_hardware)
+    {
+        request.set_native_format(platform.native_format_for(format));
+        request.set_flags(platform.native_flags_for(static_cast<MirBufferUsage>(usage), size));
+    }
+    else
+    {
+        request.set_pixel_format(format);
+        request.set_buffer_usage(usage);
+    }
+}
+#pragma GCC diagnostic pop
+
 namespace
 {
 class Requests : public mcl::ServerBufferRequests
@@ -65,31 +87,22 @@ public:
         platform(platform)
     {
     }
-#pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
     void allocate_buffer(geom::Size size, MirPixelFormat format, int usage) override
+    {
+        allocate_buffers(size, format, usage, 1);
+    }
+
+    void allocate_buffers(geom::Size size, MirPixelFormat format, int usage, unsigned int count) override
     {
         mp::BufferAllocation request;
         request.mutable_id()->set_value(stream_id);
-        auto buf_params = request.add_buffer_requests();
-        buf_params->set_width(size.width.as_int());
-        buf_params->set_height(size.height.as_int());
+        for (auto i = 0u; i < count; i++)
+            mcl::fill_buffer_request(*request.add_buffer_requests(), *platform, size, format, usage);
 
-        if (usage == mir_buffer_usage_hardware)
-        {
-            buf_params->set_native_format(platform->native_format_for(format));
-            buf_params->set_flags(platform->native_flags_for(static_cast<MirBufferUsage>(usage), size));
-        }
-        else
-        {
-            buf_params->set_pixel_format(format);
-            buf_params->set_buffer_usage(usage);
-        }
         auto protobuf_void = std::make_shared<mp::Void>();
         server.allocate_buffers(&request, protobuf_void.get(),
             google::protobuf::NewCallback(Requests::ignore_response, protobuf_void));
     }
-#pragma GCC diagnostic pop
     void free_buffer(int buffer_id) override
     {
         mp::BufferRelease request;
@@ -106,6 +119,7 @@ public:
         mp::BufferRequest request;
         request.mutable_id()->set_value(stream_id);
         request.mutable_buffer()->set_buffer_id(buffer.rpc_id());
+        auto const fence_fds = mcl::pack_buffer_update(buffer.client_buffer().get(), *request.mutable_buffer());
 
         auto protobuf_void = std::make_shared<mp::Void>();
         server.submit_buffer(&request, protobuf_void.get(),
@@ -149,8 +163,9 @@ struct BufferDepository
         std::shared_ptr<mcl::ServerBufferRequests> const& requests,
         std::weak_ptr<mcl::SurfaceMap> const& surface_map,
         geom::Size size, MirPixelFormat format, int usage,
-        unsigned int initial_nbuffers) :
-        vault(factory, mirbuffer_factory, requests, surface_map, size, format, usage, initial_nbuffers),
+        unsigned int initial_nbuffers, unsigned int preallocated_nbuffers) :
+        vault(factory, mirbuffer_factory, requests, surface_map, size, format, usage,
+              initial_nbuffers, preallocated_nbuffers),
         current(nullptr),
         size_(size)
     {
@@ -237,6 +252,11 @@ struct BufferDepository
         vault.set_interval(interval);
     }
 
+    void set_buffer_count_hint(int buffer_count)
+    {
+        vault.set_buffer_count_hint(std::max(0, buffer_count));
+    }
+
     // Future must be before vault, to ensure vault's destruction marks future
     // as ready.
     mir::client::NoTLSFuture<std::shared_ptr<mcl::MirBuffer>> future;
@@ -315,7 +335,7 @@ mcl::BufferStream::BufferStream(
             std::make_shared<Requests>(server, protobuf_bs->id().value(), client_platform),
             map,
             ideal_buffer_size, static_cast<MirPixelFormat>(protobuf_bs->pixel_format()), 
-            protobuf_bs->buffer_usage(), nbuffers);
+            protobuf_bs->buffer_usage(), nbuffers, protobuf_bs->preallocated_buffers());
 
         egl_native_window_ = client_platform->create_egl_native_window(this);
 
@@ -603,6 +623,46 @@ void mcl::BufferStream::buffer_unavailable()
     buffer_depository->lost_connection(); 
 }
 
+void mcl::BufferStream::set_buffer_count_hint(int buffer_count)
+{
+    buffer_depository->set_buffer_count_hint(buffer_count);
+}
+
+void mcl::BufferStream::set_present_feedback_callback(MirPresentFeedbackCallback callback, void* context)
+{
+    {
+        std::lock_guard<decltype(mutex)> lock(mutex);
+        present_feedback_callback = callback;
+        present_feedback_context = context;
+    }
+
+    // Don't wait for the server's reply: this may be called from within the
+    // callback, on the thread that would deliver that reply. Feedback that
+    // arrives after the callback is cleared is dropped in present_feedback().
+    interval_config.set_present_feedback(callback != nullptr);
+}
+
+void mcl::BufferStream::present_feedback(mp::PresentFeedback const& feedback)
+{
+    std::unique_lock<decltype(mutex)> lock(mutex);
+    auto const callback = present_feedback_callback;
+    auto const context = present_feedback_context;
+    lock.unlock();
+
+    if (!callback)
+        return;
+
+    MirPresentFeedback const info{
+        feedback.buffer_id(),
+        feedback.frame(),
+        static_cast<MirPresentResult>(feedback.result()),
+        feedback.sequence(),
+        feedback.clock_id(),
+        feedback.timestamp(),
+        feedback.refresh()};
+    callback(this, &info, context);
+}
+
 void mcl::BufferStream::set_size(geom::Size sz)
 {
     buffer_depository->set_size(sz);
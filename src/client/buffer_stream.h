@@ -127,6 +127,9 @@ public:
 
     void buffer_available(mir::protobuf::Buffer const& buffer) override;
     void buffer_unavailable() override;
+    void set_buffer_count_hint(int buffer_count) override;
+    void set_present_feedback_callback(MirPresentFeedbackCallback callback, void* context) override;
+    void present_feedback(mir::protobuf::PresentFeedback const& feedback) override;
     void set_size(geometry::Size) override;
     geometry::Size size() const override;
     MirWaitHandle* set_scale(float scale) override;
@@ -158,6 +161,8 @@ private:
     bool using_client_side_vsync;
     BufferStreamConfiguration interval_config;
     float scale_;
+    MirPresentFeedbackCallback present_feedback_callback{nullptr};
+    void* present_feedback_context{nullptr};
 
     std::shared_ptr<mir::client::PerfReport> const perf_report;
     std::shared_ptr<void> egl_native_window_;
@@ -183,6 +188,10 @@ private:
     mir::time::PosixTimestamp last_vsync;
 };
 
+// Describes a stream buffer to the server, using native parameters for hardware buffers
+void fill_buffer_request(
+    protobuf::BufferStreamParameters& request, ClientPlatform& platform,
+    geometry::Size size, MirPixelFormat format, int usage);
 }
 }
 
@@ -33,6 +33,7 @@ void mcl::BufferStreamConfiguration::on_swap_interval_set(int interval)
 {
     std::unique_lock<decltype(mutex)> lock(mutex);
     swap_interval_ = interval;
+    present_mode_ = interval == 0 ? mir_present_mode_mailbox : mir_present_mode_fifo;
     interval_wait_handle.result_received();
 }
 
@@ -59,3 +60,55 @@ MirWaitHandle* mcl::BufferStreamConfiguration::set_swap_interval(int interval)
     return &interval_wait_handle;
 }
 
+
+void mcl::BufferStreamConfiguration::on_present_mode_set(MirPresentMode mode)
+{
+    std::unique_lock<decltype(mutex)> lock(mutex);
+    present_mode_ = mode;
+    swap_interval_ = (mode == mir_present_mode_mailbox || mode == mir_present_mode_immediate) ? 0 : 1;
+    interval_wait_handle.result_received();
+}
+
+MirWaitHandle* mcl::BufferStreamConfiguration::set_present_mode(MirPresentMode mode)
+{
+    std::unique_lock<decltype(mutex)> lock(mutex);
+    if (mode == present_mode_)
+        return nullptr;
+    lock.unlock();
+
+    mir::protobuf::StreamConfiguration configuration;
+    configuration.mutable_id()->set_value(id.as_value());
+    configuration.set_present_mode(mode);
+    // Servers that predate present modes only understand the swap interval
+    configuration.set_swapinterval((mode == mir_present_mode_mailbox || mode == mir_present_mode_immediate) ? 0 : 1);
+    interval_wait_handle.expect_result();
+    server.configure_buffer_stream(&configuration, protobuf_void.get(),
+        google::protobuf::NewCallback(this, &mcl::BufferStreamConfiguration::on_present_mode_set, mode));
+
+    return &interval_wait_handle;
+}
+
+void mcl::BufferStreamConfiguration::on_present_feedback_set(bool)
+{
+    feedback_wait_handle.result_received();
+}
+
+MirWaitHandle* mcl::BufferStreamConfiguration::set_present_feedback(bool enabled)
+{
+    std::unique_lock<decltype(mutex)> lock(mutex);
+    if (enabled == present_feedback_)
+        return nullptr;
+    // Record what was asked for rather than what was acknowledged, so that
+    // toggling again before the reply arrives still reaches the server.
+    present_feedback_ = enabled;
+    lock.unlock();
+
+    mir::protobuf::StreamConfiguration configuration;
+    configuration.mutable_id()->set_value(id.as_value());
+    configuration.set_present_feedback(enabled);
+    feedback_wait_handle.expect_result();
+    server.configure_buffer_stream(&configuration, protobuf_void.get(),
+        google::protobuf::NewCallback(this, &mcl::BufferStreamConfiguration::on_present_feedback_set, enabled));
+
+    return &feedback_wait_handle;
+}
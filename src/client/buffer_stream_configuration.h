@@ -22,6 +22,7 @@
 #include "mir_protobuf.pb.h"
 #include "mir/frontend/buffer_stream_id.h"
 #include "mir_wait_handle.h"
+#include "mir_toolkit/common.h"
 #include <mutex>
 
 namespace mir
@@ -37,13 +38,22 @@ public:
     void on_swap_interval_set(int interval);
     int swap_interval() const;
     MirWaitHandle* set_swap_interval(int interval);
+
+    void on_present_mode_set(MirPresentMode mode);
+    MirWaitHandle* set_present_mode(MirPresentMode mode);
+
+    void on_present_feedback_set(bool enabled);
+    MirWaitHandle* set_present_feedback(bool enabled);
 private:
     rpc::DisplayServer& server;
     frontend::BufferStreamId id;
     std::unique_ptr<protobuf::Void> protobuf_void{std::make_unique<protobuf::Void>()};
     MirWaitHandle interval_wait_handle;
+    MirWaitHandle feedback_wait_handle;
     std::mutex mutable mutex;
     int swap_interval_ = 1;
+    MirPresentMode present_mode_ = mir_present_mode_fifo;
+    bool present_feedback_ = false;
 };
 
 }
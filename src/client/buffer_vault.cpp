@@ -61,6 +61,18 @@ mcl::BufferVault::BufferVault(
     std::shared_ptr<ServerBufferRequests> const& server_requests,
     std::weak_ptr<SurfaceMap> const& surface_map,
     geom::Size size, MirPixelFormat format, int usage, unsigned int initial_nbuffers) :
+    BufferVault(platform_factory, buffer_factory, server_requests, surface_map,
+        size, format, usage, initial_nbuffers, 0)
+{
+}
+
+mcl::BufferVault::BufferVault(
+    std::shared_ptr<ClientBufferFactory> const& platform_factory,
+    std::shared_ptr<AsyncBufferFactory> const& buffer_factory,
+    std::shared_ptr<ServerBufferRequests> const& server_requests,
+    std::weak_ptr<SurfaceMap> const& surface_map,
+    geom::Size size, MirPixelFormat format, int usage,
+    unsigned int initial_nbuffers, unsigned int preallocated_nbuffers) :
     platform_factory(platform_factory),
     buffer_factory(buffer_factory),
     server_requests(server_requests),
@@ -73,8 +85,11 @@ mcl::BufferVault::BufferVault(
     needed_buffer_count(initial_nbuffers),
     initial_buffer_count(initial_nbuffers)
 {
+    auto const preallocated = std::min<size_t>(preallocated_nbuffers, initial_buffer_count);
     for (auto i = 0u; i < initial_buffer_count; i++)
-        alloc_buffer(size, format, usage);
+        expect_buffer(size, format, usage);
+    if (initial_buffer_count > preallocated)
+        server_requests->allocate_buffers(size, format, usage, initial_buffer_count - preallocated);
 }
 
 mcl::BufferVault::~BufferVault()
@@ -98,13 +113,18 @@ mcl::BufferVault::~BufferVault()
 }
 
 void mcl::BufferVault::alloc_buffer(geom::Size size, MirPixelFormat format, int usage)
+{
+    expect_buffer(size, format, usage);
+    server_requests->allocate_buffer(size, format, usage);
+}
+
+void mcl::BufferVault::expect_buffer(geom::Size size, MirPixelFormat format, int usage)
 {
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
     buffer_factory->expect_buffer(platform_factory, nullptr, size, format, static_cast<MirBufferUsage>(usage),
         incoming_buffer, this);
 #pragma GCC diagnostic pop
-    server_requests->allocate_buffer(size, format, usage);
 }
 
 void mcl::BufferVault::free_buffer(int free_id)
@@ -328,28 +348,56 @@ void mcl::BufferVault::set_interval(int i)
         return;
     interval = i;
 
+    needed_buffer_count = wanted_buffer_count(lk);
     if (i == 0)
     {
         current_buffer_count++;
-        needed_buffer_count++;
         lk.unlock();
         alloc_buffer(size, format, usage);
     }
     else
     {
-        needed_buffer_count = initial_buffer_count;
-        while (current_buffer_count > needed_buffer_count)
-        {
-            auto it = std::find_if(buffers.begin(), buffers.end(),
-                [](auto const& entry) { return entry.second == Owner::Self; });
-            if (it == buffers.end())
-                break;
-            current_buffer_count--;
-            int id = it->first;
-            buffers.erase(it);
-            lk.unlock();
-            free_buffer(id);
-            lk.lock();
-        }
+        free_surplus_buffers(lk);
+    }
+}
+
+void mcl::BufferVault::set_buffer_count_hint(unsigned int count)
+{
+    std::unique_lock<std::mutex> lk(mutex);
+
+    if (count == buffer_count_hint)
+        return;
+    buffer_count_hint = count;
+
+    // Growing happens lazily, as withdraw() finds itself short of a buffer
+    needed_buffer_count = wanted_buffer_count(lk);
+    free_surplus_buffers(lk);
+}
+
+size_t mcl::BufferVault::wanted_buffer_count(std::unique_lock<std::mutex> const&) const
+{
+    size_t const min_buffer_count = 2;
+    auto count = initial_buffer_count;
+    if (buffer_count_hint)
+        count = std::min(count, std::max(min_buffer_count, buffer_count_hint));
+    if (interval == 0)
+        count++;
+    return count;
+}
+
+void mcl::BufferVault::free_surplus_buffers(std::unique_lock<std::mutex>& lk)
+{
+    while (current_buffer_count > needed_buffer_count)
+    {
+        auto it = std::find_if(buffers.begin(), buffers.end(),
+            [](auto const& entry) { return entry.second == Owner::Self; });
+        if (it == buffers.end())
+            break;
+        current_buffer_count--;
+        int id = it->first;
+        buffers.erase(it);
+        lk.unlock();
+        free_buffer(id);
+        lk.lock();
     }
 }
@@ -42,6 +42,12 @@ class ServerBufferRequests
 {
 public:
     virtual void allocate_buffer(geometry::Size size, MirPixelFormat format, int usage) = 0;
+    // Requests count identical buffers, in as few round trips as the transport allows
+    virtual void allocate_buffers(geometry::Size size, MirPixelFormat format, int usage, unsigned int count)
+    {
+        for (auto i = 0u; i < count; i++)
+            allocate_buffer(size, format, usage);
+    }
     virtual void free_buffer(int buffer_id) = 0;
     virtual void submit_buffer(MirBuffer&) = 0;
     virtual ~ServerBufferRequests() = default;
@@ -63,6 +69,15 @@ public:
         std::weak_ptr<SurfaceMap> const&,
         geometry::Size size, MirPixelFormat format, int usage,
         unsigned int initial_nbuffers);
+    // preallocated_nbuffers of the initial buffers have already been requested
+    // on our behalf (eg: alongside surface creation), and will just arrive.
+    BufferVault(
+        std::shared_ptr<ClientBufferFactory> const&,
+        std::shared_ptr<AsyncBufferFactory> const&,
+        std::shared_ptr<ServerBufferRequests> const&,
+        std::weak_ptr<SurfaceMap> const&,
+        geometry::Size size, MirPixelFormat format, int usage,
+        unsigned int initial_nbuffers, unsigned int preallocated_nbuffers);
     ~BufferVault();
 
     NoTLSFuture<std::shared_ptr<MirBuffer>> withdraw();
@@ -74,6 +89,8 @@ public:
     void disconnected();
     void set_scale(float scale);
     void set_interval(int);
+    // 0 drops the hint, going back to initial_nbuffers
+    void set_buffer_count_hint(unsigned int);
 
 private:
     enum class Owner;
@@ -82,10 +99,13 @@ private:
     void trigger_callback(std::unique_lock<std::mutex> lk);
 
     void alloc_buffer(geometry::Size size, MirPixelFormat format, int usage);
+    void expect_buffer(geometry::Size size, MirPixelFormat format, int usage);
     void free_buffer(int free_id);
     void realloc_buffer(int free_id, geometry::Size size, MirPixelFormat format, int usage);
     std::shared_ptr<MirBuffer> checked_buffer_from_map(int id);
     void set_size(std::unique_lock<std::mutex> const& lk, geometry::Size new_size);
+    size_t wanted_buffer_count(std::unique_lock<std::mutex> const& lk) const;
+    void free_surplus_buffers(std::unique_lock<std::mutex>& lk);
 
 
     std::shared_ptr<ClientBufferFactory> const platform_factory;
@@ -105,6 +125,7 @@ private:
     size_t const initial_buffer_count;
     int last_received_id = 0;
     int interval = 1;
+    size_t buffer_count_hint = 0;
     MirWaitHandle swap_buffers_wait_handle;
     std::function<void()> deferred_cb;
 };
@@ -320,6 +320,11 @@ bool mir_output_is_gamma_supported(MirOutput const* output)
     return output->gamma_supported();
 }
 
+bool mir_output_is_variable_refresh_capable(MirOutput const* output)
+{
+    return output->variable_refresh_capable();
+}
+
 void mir_output_get_gamma(MirOutput const* output,
                           uint16_t* red,
                           uint16_t* green,
@@ -126,4 +126,7 @@ mir::geometry::Size mcl::ErrorStream::size() const
 
 void mcl::ErrorStream::buffer_available(mir::protobuf::Buffer const&) {}
 void mcl::ErrorStream::buffer_unavailable() {}
+void mcl::ErrorStream::set_buffer_count_hint(int) {}
+void mcl::ErrorStream::set_present_feedback_callback(MirPresentFeedbackCallback, void*) {}
+void mcl::ErrorStream::present_feedback(mir::protobuf::PresentFeedback const&) {}
 void mcl::ErrorStream::set_size(mir::geometry::Size) {}
@@ -51,6 +51,9 @@ public:
     bool valid() const override;
     void buffer_available(mir::protobuf::Buffer const& buffer) override;
     void buffer_unavailable() override;
+    void set_buffer_count_hint(int buffer_count) override;
+    void set_present_feedback_callback(MirPresentFeedbackCallback callback, void* context) override;
+    void present_feedback(mir::protobuf::PresentFeedback const& feedback) override;
     void set_size(geometry::Size) override;
     geometry::Size size() const override;
     MirWaitHandle* set_scale(float) override;
@@ -0,0 +1,134 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "event_ring_reader.h"
+#include "mir/input/event_ring.h"
+#include "mir/events/event_private.h"
+
+#include <sys/eventfd.h>
+
+namespace mcl = mir::client;
+namespace md = mir::dispatch;
+namespace mev = mir::events;
+namespace mi = mir::input;
+
+mcl::EventRingReader::EventRingReader(
+    Fd const& ring_fd,
+    Fd const& wake_fd,
+    std::function<void(MirEvent&)> const& handler) :
+    ring{mi::EventRing::open(ring_fd)},
+    wake_fd{wake_fd},
+    handler{handler}
+{
+}
+
+mcl::EventRingReader::~EventRingReader() = default;
+
+mir::Fd mcl::EventRingReader::watch_fd() const
+{
+    return wake_fd;
+}
+
+md::FdEvents mcl::EventRingReader::relevant_events() const
+{
+    return md::FdEvent::readable;
+}
+
+void mcl::EventRingReader::socket_event(MirEvent const& event)
+{
+    {
+        std::lock_guard<decltype(mutex)> lock{mutex};
+        from_socket.push_back(mev::clone_event(event));
+    }
+    eventfd_write(wake_fd, 1);
+}
+
+void mcl::EventRingReader::resumed()
+{
+    {
+        std::lock_guard<decltype(mutex)> lock{mutex};
+        from_socket.push_back(EventUPtr{nullptr, nullptr});
+    }
+    eventfd_write(wake_fd, 1);
+}
+
+bool mcl::EventRingReader::dispatch(md::FdEvents events)
+{
+    if (events & md::FdEvent::error)
+        return false;
+
+    // wake_fd stays readable until we've run out of events and cleared it
+    while (!dispatch_one())
+        ;
+
+    return true;
+}
+
+// Returns true once it has handled an event or found there are none left
+bool mcl::EventRingReader::dispatch_one()
+{
+    if (paused)
+    {
+        EventUPtr next{nullptr, nullptr};
+        {
+            std::lock_guard<decltype(mutex)> lock{mutex};
+            if (from_socket.empty())
+            {
+                // Anything queued after we look will write wake_fd again
+                eventfd_t count;
+                eventfd_read(wake_fd, &count);
+                return from_socket.empty();
+            }
+            next = std::move(from_socket.front());
+            from_socket.pop_front();
+        }
+
+        if (!next)
+        {
+            paused = false;
+            return false;
+        }
+
+        handler(*next);
+        return true;
+    }
+
+    switch (ring->read(buffer))
+    {
+    case mi::EventRing::Entry::event:
+        if (auto const event = MirEvent::deserialize(buffer))
+            handler(*event);
+        return true;
+
+    case mi::EventRing::Entry::barrier:
+        // The events that follow are on the socket, until the server resumes the ring
+        paused = true;
+        return false;
+
+    case mi::EventRing::Entry::none:
+        break;
+    }
+
+    eventfd_t count;
+    eventfd_read(wake_fd, &count);
+
+    if (ring->arm_wakeup())
+        return true;
+
+    // Events arrived as we cleared wake_fd; keep it readable until they're read
+    eventfd_write(wake_fd, 1);
+    return false;
+}
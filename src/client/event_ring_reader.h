@@ -0,0 +1,74 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_CLIENT_EVENT_RING_READER_H_
+#define MIR_CLIENT_EVENT_RING_READER_H_
+
+#include "mir/dispatch/dispatchable.h"
+#include "mir/events/event_builders.h"
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace mir
+{
+namespace input { class EventRing; }
+namespace client
+{
+/**
+ * Reads a surface's input events from the ring the server shares with us,
+ * and merges in those that the server had to send over the socket (after a
+ * barrier in the ring, until the server says the ring has resumed).
+ */
+class EventRingReader : public dispatch::Dispatchable
+{
+public:
+    EventRingReader(
+        Fd const& ring_fd,
+        Fd const& wake_fd,
+        std::function<void(MirEvent&)> const& handler);
+    ~EventRingReader();
+
+    Fd watch_fd() const override;
+    bool dispatch(dispatch::FdEvents events) override;
+    dispatch::FdEvents relevant_events() const override;
+
+    /// An input event that arrived on the socket
+    void socket_event(MirEvent const& event);
+    /// The server has put the following input events back in the ring
+    void resumed();
+
+private:
+    bool dispatch_one();
+
+    std::unique_ptr<input::EventRing> const ring;
+    Fd const wake_fd;
+    std::function<void(MirEvent&)> const handler;
+
+    std::mutex mutex;
+    std::deque<EventUPtr> from_socket; // A null entry marks a resume
+
+    // Only touched while dispatching
+    bool paused{false};
+    std::string buffer;
+};
+}
+}
+
+#endif /* MIR_CLIENT_EVENT_RING_READER_H_ */
@@ -265,6 +265,8 @@ void mev::add_touch(MirEvent &event, MirTouchId touch_id, MirTouchAction action,
 {
     auto tev = event.to_input()->to_touch();
     auto current_index = tev->pointer_count();
+    if (current_index == mir::capnp::TouchScreenEvent::MAX_COUNT)
+        return;
     tev->set_pointer_count(current_index + 1);
 
     tev->set_id(current_index, touch_id);
@@ -237,6 +237,18 @@ catch (std::exception const& ex)
     return nullptr;
 }
 
+void mir_buffer_stream_set_present_feedback_callback(
+    MirBufferStream* buffer_stream, MirPresentFeedbackCallback callback, void* context)
+try
+{
+    mir::require(buffer_stream);
+    buffer_stream->set_present_feedback_callback(callback, context);
+}
+catch (std::exception const& ex)
+{
+    MIR_LOG_UNCAUGHT_EXCEPTION(ex);
+}
+
 int mir_buffer_stream_get_swapinterval(MirBufferStream* buffer_stream)
 try
 {
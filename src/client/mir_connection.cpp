@@ -108,6 +108,12 @@ size_t get_nbuffers_from_env()
     return 3u;
 }
 
+bool get_input_ring_from_env()
+{
+    const char* input_ring_opt = getenv("MIR_CLIENT_INPUT_RING");
+    return input_ring_opt && strcmp(input_ring_opt, "0");
+}
+
 struct OnScopeExit
 {
     ~OnScopeExit() { f(); }
@@ -320,7 +326,8 @@ MirConnection::MirConnection(std::string const& error_message) :
     server(nullptr),
     debug(nullptr),
     error_message(error_message),
-    nbuffers(get_nbuffers_from_env())
+    nbuffers(get_nbuffers_from_env()),
+    input_ring(get_input_ring_from_env())
 {
 }
 
@@ -350,7 +357,8 @@ MirConnection::MirConnection(
         event_handler_register(conf.the_event_handler_register()),
         pong_callback(google::protobuf::NewPermanentCallback(&google::protobuf::DoNothing)),
         eventloop{new md::ThreadedDispatcher{"RPC Thread", std::dynamic_pointer_cast<md::Dispatchable>(channel)}},
-        nbuffers(get_nbuffers_from_env())
+        nbuffers(get_nbuffers_from_env()),
+        input_ring(get_input_ring_from_env())
 {
     connect_result->set_error("connect not called");
     {
@@ -387,7 +395,28 @@ MirWaitHandle* MirConnection::create_surface(
     auto response = std::make_shared<mp::Surface>();
     auto c = std::make_shared<MirConnection::SurfaceCreationRequest>(callback, context, spec);
     c->wh->expect_result();
-    auto const message = serialize_spec(spec);
+    auto message = serialize_spec(spec);
+
+    // The server will create a default stream; have it allocate that stream's
+    // buffers straight away rather than waiting to be asked once we've seen the reply.
+    // The server only does so if the shell keeps the size we ask for.
+    if (platform && !spec.streams.is_set() &&
+        spec.width.is_set() && spec.height.is_set() && spec.buffer_usage.is_set() &&
+        spec.pixel_format.is_set() && spec.pixel_format.value() != mir_pixel_format_invalid)
+    {
+        mir::geometry::Size const size{spec.width.value(), spec.height.value()};
+        for (auto i = 0; i < nbuffers; i++)
+        {
+            mcl::fill_buffer_request(
+                *message.mutable_initial_buffers()->add_buffer_requests(), *platform,
+                size, spec.pixel_format.value(), spec.buffer_usage.value());
+        }
+    }
+
+    // High-frequency input is cheaper to read from shared memory than the socket
+    if (input_ring)
+        message.set_input_ring(true);
+
     {
         std::lock_guard<decltype(mutex)> lock(mutex);
         surface_requests.emplace_back(c);
@@ -863,6 +892,24 @@ void MirConnection::available_surface_formats(
     }
 }
 
+bool MirConnection::present_mode_supported(MirPresentMode mode)
+{
+    std::lock_guard<decltype(mutex)> lock(mutex);
+    if (connect_result->has_error())
+        return false;
+
+    // Servers that predate present modes can still queue or drop frames
+    if (connect_result->present_mode_size() == 0)
+        return mode == mir_present_mode_fifo || mode == mir_present_mode_mailbox;
+
+    for (auto const supported : connect_result->present_mode())
+    {
+        if (supported == static_cast<unsigned int>(mode))
+            return true;
+    }
+    return false;
+}
+
 void MirConnection::stream_created(StreamCreationRequest* request_raw)
 {
     std::shared_ptr<StreamCreationRequest> request {nullptr};
@@ -139,6 +139,7 @@ public:
     std::unique_ptr<mir::protobuf::DisplayConfiguration> snapshot_display_configuration() const;
     void available_surface_formats(MirPixelFormat* formats,
                                    unsigned int formats_size, unsigned int& valid_formats);
+    bool present_mode_supported(MirPresentMode mode);
 
     std::shared_ptr<MirBufferStream> make_consumer_stream(
        mir::protobuf::BufferStream const& protobuf_bs);
@@ -376,6 +377,7 @@ private:
     bool validate_user_display_config(MirDisplayConfiguration const* config);
 
     int const nbuffers;
+    bool const input_ring;
     mir::optional_value<MirExtensionWindowCoordinateTranslationV1> translation_ext;
     mir::optional_value<MirExtensionGraphicsModuleV1> graphics_module_extension;
 
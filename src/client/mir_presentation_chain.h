@@ -35,6 +35,7 @@ public:
     //In the future, the only mode will be dropping
     virtual void set_dropping_mode() = 0;
     virtual void set_queueing_mode() = 0;
+    virtual void set_present_mode(MirPresentMode mode) = 0;
 
 protected:
     MirPresentationChain(MirPresentationChain const&) = delete;
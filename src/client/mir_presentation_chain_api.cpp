@@ -93,9 +93,16 @@ catch (std::exception const& ex)
 }
 
 bool mir_connection_present_mode_supported(
-    MirConnection*, MirPresentMode mode)
+    MirConnection* connection, MirPresentMode mode)
+try
+{
+    mir::require(connection);
+    return connection->present_mode_supported(mode);
+}
+catch (std::exception const& ex)
 {
-    return mode == mir_present_mode_fifo || mode == mir_present_mode_mailbox;
+    MIR_LOG_UNCAUGHT_EXCEPTION(ex);
+    return false;
 }
 
 void mir_presentation_chain_set_mode(
@@ -103,10 +110,7 @@ void mir_presentation_chain_set_mode(
 try
 {
     mir::require(chain && mir_connection_present_mode_supported(chain->connection(), mode));
-    if (mode == mir_present_mode_fifo)
-        chain->set_queueing_mode();
-    if (mode == mir_present_mode_mailbox)
-        chain->set_dropping_mode();
+    chain->set_present_mode(mode);
 }
 catch (std::exception const& ex)
 {
@@ -22,6 +22,7 @@
 #include "make_protobuf_object.h"
 #include "mir_protobuf.pb.h"
 #include "connection_surface_map.h"
+#include "event_ring_reader.h"
 
 #include "mir_toolkit/mir_client_library.h"
 #include "mir_toolkit/mir_blob.h"
@@ -194,6 +195,18 @@ MirSurface::MirSurface(
             spec.event_handler.value().context);
     }
 
+    if (surface->fd_size() == 2)
+    {
+        // The server passes our input events through shared memory
+        input_ring = std::make_shared<mcl::EventRingReader>(
+            mir::Fd{mir::IntOwnedFd{surface->fd(0)}},
+            mir::Fd{mir::IntOwnedFd{surface->fd(1)}},
+            [this](MirEvent& e) { process_event(e); });
+        input_ring_thread = std::make_unique<md::ThreadedDispatcher>("Input ring", input_ring);
+        // The reader owns them now; don't close them again on destruction
+        surface->clear_fd();
+    }
+
     std::lock_guard<decltype(handle_mutex)> lock(handle_mutex);
     valid_surfaces.insert(this);
 
@@ -202,6 +215,9 @@ MirSurface::MirSurface(
 
 MirSurface::~MirSurface()
 {
+    // Before taking the lock, as the thread may be waiting for it in process_event()
+    input_ring_thread.reset();
+
     StreamSet old_streams;
 
     {
@@ -478,6 +494,21 @@ void MirSurface::set_event_handler(MirWindowEventCallback callback,
 }
 
 void MirSurface::handle_event(MirEvent& e)
+{
+    // Input events that didn't fit in the ring must be taken in turn with those in it
+    if (input_ring && mir_event_get_type(&e) == mir_event_type_input)
+        input_ring->socket_event(e);
+    else
+        process_event(e);
+}
+
+void MirSurface::input_ring_resumed()
+{
+    if (input_ring)
+        input_ring->resumed();
+}
+
+void MirSurface::process_event(MirEvent& e)
 {
     std::unique_lock<decltype(mutex)> lock(mutex);
 
@@ -70,6 +70,7 @@ class DisplayServerDebug;
 }
 
 class ClientBuffer;
+class EventRingReader;
 class MirBufferStreamFactory;
 
 struct MemoryRegion;
@@ -209,6 +210,7 @@ public:
     void set_event_handler(MirWindowEventCallback callback,
                            void* context);
     void handle_event(MirEvent& e);
+    void input_ring_resumed();
 
     void request_and_wait_for_configure(MirWindowAttrib a, int value);
 
@@ -228,6 +230,7 @@ private:
     std::mutex mutable mutex; // Protects all members of *this
 
     void configure_frame_clock();
+    void process_event(MirEvent& e);
     void on_configured();
     void on_cursor_configured();
     void acquired_persistent_id(MirWindowIdCallback callback, void* context);
@@ -270,6 +273,10 @@ private:
 
     std::shared_ptr<mir::dispatch::ThreadedDispatcher> input_thread;
 
+    // Set only in the constructor, if the server shares an input event ring with us
+    std::shared_ptr<mir::client::EventRingReader> input_ring;
+    std::unique_ptr<mir::dispatch::ThreadedDispatcher> input_ring_thread;
+
     //a bit batty, but the creation handle has to exist for as long as the MirSurface does,
     //as we don't really manage the lifetime of MirWaitHandle sensibly.
     std::shared_ptr<MirWaitHandle> const creation_handle;
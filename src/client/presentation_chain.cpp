@@ -60,9 +60,11 @@ static void ignore_response(mp::Void* response)
 void mcl::PresentationChain::submit_buffer(MirBuffer* buffer)
 {
     mp::BufferRequest request;
+    std::vector<mir::Fd> fence_fds;
     {
         request.mutable_id()->set_value(stream_id);
         request.mutable_buffer()->set_buffer_id(buffer->rpc_id());
+        fence_fds = mcl::pack_buffer_update(buffer->client_buffer().get(), *request.mutable_buffer());
         buffer->submitted();
     }
 
@@ -87,12 +89,16 @@ char const* mcl::PresentationChain::error_msg() const
 
 void mcl::PresentationChain::set_dropping_mode()
 {
-    if (auto wh = interval_config.set_swap_interval(0))
-        wh->wait_for_all();
+    set_present_mode(mir_present_mode_mailbox);
 }
 
 void mcl::PresentationChain::set_queueing_mode()
 {
-    if (auto wh = interval_config.set_swap_interval(1))
+    set_present_mode(mir_present_mode_fifo);
+}
+
+void mcl::PresentationChain::set_present_mode(MirPresentMode mode)
+{
+    if (auto wh = interval_config.set_present_mode(mode))
         wh->wait_for_all();
 }
@@ -55,6 +55,7 @@ public:
     char const* error_msg() const override;
     void set_dropping_mode() override;
     void set_queueing_mode() override;
+    void set_present_mode(MirPresentMode mode) override;
 
 private:
 
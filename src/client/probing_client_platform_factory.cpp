@@ -1,14 +1,46 @@
 #include "probing_client_platform_factory.h"
 #include "mir/client_platform.h"
+#include "mir/client_context.h"
 #include "mir/shared_library.h"
 #include "mir/shared_library_prober.h"
 #include "mir/shared_library_prober_report.h"
 
 #include <boost/exception/all.hpp>
+#include <boost/filesystem.hpp>
+#include <cstring>
 #include <stdexcept>
 
 namespace mcl = mir::client;
 
+namespace
+{
+// Server graphics modules describe themselves as "mir:<client module>[-<variant>]"
+// (e.g. "mir:mesa", "mir:eglstream-kms") and the matching client module is
+// installed as "<client module>.so.<client platform ABI>".
+std::string client_module_filename_for(mcl::ClientContext* context)
+{
+    MirModuleProperties server_graphics_module;
+    memset(&server_graphics_module, 0, sizeof server_graphics_module);
+    context->populate_graphics_module(server_graphics_module);
+
+    if (!server_graphics_module.name)
+        return {};
+
+    std::string const prefix{"mir:"};
+    std::string const name{server_graphics_module.name};
+
+    if (name.compare(0, prefix.size(), prefix) != 0)
+        return {};
+
+    auto const module = name.substr(prefix.size(), name.find('-') - prefix.size());
+
+    if (module.empty())
+        return {};
+
+    return module + ".so." + MIR_CLIENT_PLATFORM_ABI_STRING;
+}
+}
+
 mcl::ProbingClientPlatformFactory::ProbingClientPlatformFactory(
     std::shared_ptr<mir::SharedLibraryProberReport> const& rep,
     StringList const& force_libs,
@@ -64,8 +96,38 @@ mcl::ProbingClientPlatformFactory::create_client_platform(mcl::ClientContext* co
     }
     else
     {
-        for (auto const& path : platform_paths)
-            select_libraries_for_path(path, module_selector, *shared_library_prober_report);
+        // Try the module the server told us about first: that avoids loading
+        // (and running the constructors of) every module in the platform path.
+        auto const hinted_module = client_module_filename_for(context);
+
+        if (!hinted_module.empty())
+        {
+            for (auto const& path : platform_paths)
+            {
+                auto const filename = boost::filesystem::path{path} / hinted_module;
+
+                boost::system::error_code ec;
+                if (!boost::filesystem::is_regular_file(filename, ec))
+                    continue;
+
+                try
+                {
+                    shared_library_prober_report->loading_library(filename);
+                    if (module_selector(std::make_shared<mir::SharedLibrary>(filename.string())) == Selection::quit)
+                        break;
+                }
+                catch (std::runtime_error const& err)
+                {
+                    shared_library_prober_report->loading_failed(filename, err);
+                }
+            }
+        }
+
+        if (platform_modules.empty())
+        {
+            for (auto const& path : platform_paths)
+                select_libraries_for_path(path, module_selector, *shared_library_prober_report);
+        }
     }
 
     for (auto& module : platform_modules)
@@ -19,6 +19,7 @@
 #include "mir_toolkit/mir_native_buffer.h"
 #include "mir_protobuf.pb.h"
 #include "protobuf_to_native_buffer.h"
+#include "mir/client_buffer.h"
 
 std::unique_ptr<MirBufferPackage> mir::client::protobuf_to_native_buffer(
     mir::protobuf::Buffer const& buffer)
@@ -48,3 +49,23 @@ std::unique_ptr<MirBufferPackage> mir::client::protobuf_to_native_buffer(
     }
     return package;
 }
+
+std::vector<mir::Fd> mir::client::pack_buffer_update(ClientBuffer* buffer, mir::protobuf::Buffer& request)
+{
+    std::vector<Fd> fds;
+    if (!buffer)
+        return fds;
+
+    MirBufferPackage update{};
+    buffer->fill_update_msg(update);
+
+    for (int i = 0; i != update.fd_items; ++i)
+    {
+        fds.emplace_back(update.fd[i]);
+        request.add_fd(update.fd[i]);
+    }
+    if (update.fd_items)
+        request.set_flags(update.flags);
+
+    return fds;
+}
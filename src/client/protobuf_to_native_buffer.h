@@ -18,7 +18,9 @@
 
 #ifndef MIR_CLIENT_PROTOBUF_TO_NATIVE_BUFFER_H_
 #define MIR_CLIENT_PROTOBUF_TO_NATIVE_BUFFER_H_
+#include "mir/fd.h"
 #include <memory>
+#include <vector>
 class MirBufferPackage;
 namespace mir
 {
@@ -28,7 +30,13 @@ class Buffer;
 }
 namespace client
 {
+class ClientBuffer;
 std::unique_ptr<MirBufferPackage> protobuf_to_native_buffer(protobuf::Buffer const& buffer);
+
+/// Packs the parts of a submitted buffer that change with each submission
+/// (i.e. an acquire fence) into the request. The returned fds must be kept
+/// open until the request has been sent.
+std::vector<Fd> pack_buffer_update(ClientBuffer* buffer, protobuf::Buffer& request);
 }
 }
 #endif /* MIR_CLIENT_PROTOBUF_TO_NATIVE_BUFFER_H_ */
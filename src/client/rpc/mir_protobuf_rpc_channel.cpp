@@ -364,6 +364,8 @@ void mclr::MirProtobufRpcChannel::process_event_sequence(std::string const& even
                         break;
                     case mp::BufferOperation::remove:
                         map->erase(buffer_id);
+                        for(auto i = 0; i < seq.buffer_request().buffer().fd_size(); i++)
+                            close(seq.buffer_request().buffer().fd(i));
                         break;
                     default:
                         BOOST_THROW_EXCEPTION(std::runtime_error("unknown buffer operation"));
@@ -385,6 +387,33 @@ void mclr::MirProtobufRpcChannel::process_event_sequence(std::string const& even
 
     }
 
+    if (seq.has_buffer_stream_hint())
+    {
+        if (auto map = surface_map.lock())
+        {
+            mf::BufferStreamId stream_id(seq.buffer_stream_hint().id().value());
+            if (auto stream = map->stream(stream_id))
+                stream->set_buffer_count_hint(seq.buffer_stream_hint().buffer_count());
+        }
+    }
+
+    if (seq.has_present_feedback())
+    {
+        if (auto map = surface_map.lock())
+        {
+            mf::BufferStreamId stream_id(seq.present_feedback().id().value());
+            if (auto stream = map->stream(stream_id))
+                stream->present_feedback(seq.present_feedback());
+        }
+    }
+
+    if (seq.has_input_ring_resumed())
+    {
+        if (auto map = surface_map.lock())
+            if (auto surf = map->surface(mf::SurfaceId(seq.input_ring_resumed().value())))
+                surf->input_ring_resumed();
+    }
+
     int const nevents = seq.event_size();
     for (int i = 0; i != nevents; ++i)
     {
@@ -234,6 +234,19 @@ void mcl::ScreencastStream::buffer_unavailable()
 {
 }
 
+void mcl::ScreencastStream::set_buffer_count_hint(int)
+{
+}
+
+void mcl::ScreencastStream::set_present_feedback_callback(MirPresentFeedbackCallback, void*)
+{
+    BOOST_THROW_EXCEPTION(std::logic_error("Screencasts do not present their frames"));
+}
+
+void mcl::ScreencastStream::present_feedback(mir::protobuf::PresentFeedback const&)
+{
+}
+
 char const * mcl::ScreencastStream::get_error_message() const
 {
     std::lock_guard<decltype(mutex)> lock(mutex);
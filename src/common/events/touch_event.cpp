@@ -19,6 +19,8 @@
 #include <boost/throw_exception.hpp>
 #include "mir/events/touch_event.h"
 
+#include <algorithm>
+
 MirTouchEvent::MirTouchEvent()
 {
     event.initInput();
@@ -37,9 +39,12 @@ MirTouchEvent::MirTouchEvent(MirInputDeviceId id,
 
     auto tev = event.getInput().getTouch();
     tev.initContacts(mir::capnp::TouchScreenEvent::MAX_COUNT);
-    tev.setCount(contacts.size());
 
-    for (size_t i = 0; i < contacts.size(); ++i)
+    // An event has room for MAX_COUNT contacts; any more a device reports are dropped here
+    auto const count = std::min<size_t>(contacts.size(), mir::capnp::TouchScreenEvent::MAX_COUNT);
+    tev.setCount(count);
+
+    for (size_t i = 0; i < count; ++i)
     {
         using ContactType = mir::capnp::TouchScreenEvent::Contact;
         auto& contact = contacts[i];
@@ -0,0 +1,237 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/input/event_ring.h"
+
+#include <boost/throw_exception.hpp>
+
+#include <atomic>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#ifndef MFD_CLOEXEC
+#define MFD_CLOEXEC 0x0001U
+#define MFD_ALLOW_SEALING 0x0002U
+#endif
+
+#ifndef F_ADD_SEALS
+#define F_ADD_SEALS (F_LINUX_SPECIFIC_BASE + 9)
+#define F_SEAL_SEAL 0x0001
+#define F_SEAL_SHRINK 0x0002
+#define F_SEAL_GROW 0x0004
+#endif
+
+namespace mi = mir::input;
+
+namespace
+{
+std::uint32_t const ring_magic{0x4d495252}; // "MIRR"
+std::uint32_t const ring_version{1};
+
+enum class Kind : std::uint32_t { event = 1, barrier = 2 };
+
+struct SlotHeader
+{
+    Kind kind;
+    std::uint32_t length;
+};
+
+std::size_t const max_payload{mi::EventRing::slot_size - sizeof(SlotHeader)};
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2 && ATOMIC_INT_LOCK_FREE == 2,
+              "the ring's atomics must be lock free to be shared between processes");
+
+std::size_t ring_size(std::size_t header_size, std::size_t slot_count)
+{
+    return header_size + slot_count * mi::EventRing::slot_size;
+}
+}
+
+struct mi::EventRing::Header
+{
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint32_t slot_size;
+    std::uint32_t slot_count;
+
+    // Only the server writes head, and only the client writes tail
+    alignas(64) std::atomic<std::uint64_t> head;
+    alignas(64) std::atomic<std::uint64_t> tail;
+
+    // Set by the client before it sleeps, cleared by the server when it wakes it
+    std::atomic<std::uint32_t> reader_waiting;
+};
+
+std::size_t const mi::EventRing::slot_size;
+std::size_t const mi::EventRing::default_slot_count;
+
+auto mi::EventRing::create(std::size_t slot_count) -> std::unique_ptr<EventRing>
+{
+    if (slot_count < 2 || (slot_count & (slot_count - 1)))
+        BOOST_THROW_EXCEPTION(std::logic_error("Input event ring size must be a power of two"));
+
+    Fd fd{static_cast<int>(syscall(SYS_memfd_create, "mir-input-event-ring", MFD_CLOEXEC | MFD_ALLOW_SEALING))};
+    if (fd < 0)
+        BOOST_THROW_EXCEPTION((std::system_error{errno, std::system_category(), "Failed to create input event ring"}));
+
+    auto const size = ring_size(sizeof(Header), slot_count);
+    if (ftruncate(fd, size) < 0)
+        BOOST_THROW_EXCEPTION((std::system_error{errno, std::system_category(), "Failed to size input event ring"}));
+
+    // The client could otherwise shrink the file and fault the server
+    if (fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) < 0)
+        BOOST_THROW_EXCEPTION((std::system_error{errno, std::system_category(), "Failed to seal input event ring"}));
+
+    std::unique_ptr<EventRing> ring{new EventRing{fd, size}};
+    auto const header = ring->header;
+    header->magic = ring_magic;
+    header->version = ring_version;
+    header->slot_size = slot_size;
+    header->slot_count = slot_count;
+    header->head = 0;
+    header->tail = 0;
+    header->reader_waiting = 1;
+    ring->slot_count = slot_count;
+
+    return ring;
+}
+
+auto mi::EventRing::open(Fd const& fd) -> std::unique_ptr<EventRing>
+{
+    struct stat info;
+    if (fstat(fd, &info) < 0)
+        BOOST_THROW_EXCEPTION((std::system_error{errno, std::system_category(), "Failed to query input event ring"}));
+
+    if (static_cast<std::size_t>(info.st_size) < sizeof(Header))
+        BOOST_THROW_EXCEPTION(std::runtime_error("Input event ring is too small"));
+
+    std::unique_ptr<EventRing> ring{new EventRing{fd, static_cast<std::size_t>(info.st_size)}};
+    auto const header = ring->header;
+    auto const slot_count = header->slot_count;
+
+    if (header->magic != ring_magic || header->version != ring_version || header->slot_size != slot_size ||
+        slot_count < 2 || (slot_count & (slot_count - 1)) || ring->size < ring_size(sizeof(Header), slot_count))
+    {
+        BOOST_THROW_EXCEPTION(std::runtime_error("Incompatible input event ring"));
+    }
+    ring->slot_count = slot_count;
+
+    return ring;
+}
+
+mi::EventRing::EventRing(Fd const& fd, std::size_t size) :
+    fd_{fd},
+    size{size},
+    header{[&]
+        {
+            auto const mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+            if (mapping == MAP_FAILED)
+                BOOST_THROW_EXCEPTION((std::system_error{errno, std::system_category(), "Failed to map input event ring"}));
+            return static_cast<Header*>(mapping);
+        }()}
+{
+}
+
+mi::EventRing::~EventRing()
+{
+    munmap(header, size);
+}
+
+mir::Fd mi::EventRing::fd() const
+{
+    return fd_;
+}
+
+char* mi::EventRing::slot(std::uint64_t index) const
+{
+    return reinterpret_cast<char*>(header + 1) + (index & (slot_count - 1)) * slot_size;
+}
+
+bool mi::EventRing::write(std::string const& event)
+{
+    auto const head = header->head.load(std::memory_order_relaxed);
+    auto const tail = header->tail.load(std::memory_order_acquire);
+
+    // head - tail also exceeds the limit if the client has scribbled on tail
+    if (event.size() > max_payload || head - tail >= slot_count - 1)
+        return false;
+
+    auto const target = slot(head);
+    SlotHeader const slot_header{Kind::event, static_cast<std::uint32_t>(event.size())};
+    memcpy(target, &slot_header, sizeof slot_header);
+    memcpy(target + sizeof slot_header, event.data(), event.size());
+
+    // Sequentially consistent, so that either we see the reader arm its
+    // wakeup in take_wakeup() or it sees this event in arm_wakeup()
+    header->head.store(head + 1, std::memory_order_seq_cst);
+    return true;
+}
+
+void mi::EventRing::write_barrier()
+{
+    auto const head = header->head.load(std::memory_order_relaxed);
+    if (head - header->tail.load(std::memory_order_acquire) >= slot_count)
+        return;
+
+    SlotHeader const slot_header{Kind::barrier, 0};
+    memcpy(slot(head), &slot_header, sizeof slot_header);
+    header->head.store(head + 1, std::memory_order_seq_cst);
+}
+
+bool mi::EventRing::empty() const
+{
+    return header->head.load(std::memory_order_relaxed) == header->tail.load(std::memory_order_acquire);
+}
+
+bool mi::EventRing::take_wakeup()
+{
+    return header->reader_waiting.load(std::memory_order_seq_cst) &&
+           header->reader_waiting.exchange(0, std::memory_order_seq_cst);
+}
+
+auto mi::EventRing::read(std::string& event) -> Entry
+{
+    auto const tail = header->tail.load(std::memory_order_relaxed);
+    if (header->head.load(std::memory_order_acquire) == tail)
+        return Entry::none;
+
+    SlotHeader slot_header;
+    auto const source = slot(tail);
+    memcpy(&slot_header, source, sizeof slot_header);
+
+    auto entry = Entry::barrier;
+    if (slot_header.kind == Kind::event && slot_header.length <= max_payload)
+    {
+        event.assign(source + sizeof slot_header, slot_header.length);
+        entry = Entry::event;
+    }
+
+    header->tail.store(tail + 1, std::memory_order_release);
+    return entry;
+}
+
+bool mi::EventRing::arm_wakeup()
+{
+    header->reader_waiting.store(1, std::memory_order_seq_cst);
+    return header->head.load(std::memory_order_seq_cst) == header->tail.load(std::memory_order_relaxed);
+}
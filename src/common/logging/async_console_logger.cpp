@@ -0,0 +1,771 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/logging/async_console_logger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cerrno>
+#include <cstdarg>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <type_traits>
+
+namespace ml = mir::logging;
+
+namespace
+{
+std::atomic<std::uint64_t> next_logger_id{0};
+
+// While messages keep arriving the writer drains the rings this often
+auto const drain_interval = std::chrono::milliseconds{10};
+
+/*
+ * Messages given as a format are stored with their arguments: each integer,
+ * floating point or pointer argument (including '*' widths and precisions)
+ * as 8 bytes, and each string argument as a copy with its terminator. The
+ * writer walks the format again to find them.
+ */
+struct Conversion
+{
+    enum class Length { none, hh, h, l, ll, j, z, t, L };
+
+    char const* start;      // The '%'
+    char const* modifiers;  // The length modifier, if any
+    char const* end;        // Past the conversion specifier
+    bool width_arg;
+    bool precision_arg;
+    int precision;          // -1 unless given in the format
+    Length length;
+    char specifier;
+};
+
+enum class Scan { end, conversion, unsupported };
+
+// Positional arguments, %n, wide characters and long double are not deferred
+Scan next_conversion(char const*& p, Conversion& c)
+{
+    while (*p && *p != '%')
+        ++p;
+
+    if (!*p)
+        return Scan::end;
+
+    c.start = p++;
+
+    while (*p && strchr("-+ #0'I", *p))
+        ++p;
+
+    c.width_arg = *p == '*';
+    if (c.width_arg)
+        ++p;
+    else
+        while (*p >= '0' && *p <= '9')
+            ++p;
+
+    if (*p == '$')
+        return Scan::unsupported;
+
+    c.precision = -1;
+    c.precision_arg = false;
+    if (*p == '.')
+    {
+        ++p;
+        c.precision_arg = *p == '*';
+        if (c.precision_arg)
+            ++p;
+        else
+            for (c.precision = 0; *p >= '0' && *p <= '9'; ++p)
+                c.precision = c.precision * 10 + (*p - '0');
+    }
+
+    using Length = Conversion::Length;
+    c.modifiers = p;
+    switch (*p)
+    {
+    case 'h': ++p; c.length = *p == 'h' ? (++p, Length::hh) : Length::h; break;
+    case 'l': ++p; c.length = *p == 'l' ? (++p, Length::ll) : Length::l; break;
+    case 'q': ++p; c.length = Length::ll; break;
+    case 'j': ++p; c.length = Length::j; break;
+    case 'z': ++p; c.length = Length::z; break;
+    case 't': ++p; c.length = Length::t; break;
+    case 'L': ++p; c.length = Length::L; break;
+    default: c.length = Length::none; break;
+    }
+
+    c.specifier = *p;
+    if (!*p)
+        return Scan::unsupported;
+    c.end = ++p;
+
+    switch (c.specifier)
+    {
+    case 'd': case 'i': case 'o': case 'u': case 'x': case 'X':
+        return c.length == Length::L ? Scan::unsupported : Scan::conversion;
+
+    case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+        return c.length == Length::none || c.length == Length::l ? Scan::conversion : Scan::unsupported;
+
+    case 'c': case 's': case 'p':
+        return c.length == Length::none ? Scan::conversion : Scan::unsupported;
+
+    case 'm': case '%':
+        return Scan::conversion;
+
+    default:
+        return Scan::unsupported;
+    }
+}
+
+template<typename T>
+void put(std::vector<char>& args, T value)
+{
+    static_assert(sizeof(T) == 8, "arguments are stored in 8 bytes");
+    auto const offset = args.size();
+    args.resize(offset + sizeof value);
+    memcpy(args.data() + offset, &value, sizeof value);
+}
+
+void put_string(std::vector<char>& args, char const* string, int precision)
+{
+    if (!string)
+        string = "(null)";
+
+    auto const length = precision < 0 ? strlen(string) : strnlen(string, precision);
+    args.insert(args.end(), string, string + length);
+    args.push_back('\0');
+}
+
+long long signed_arg(Conversion::Length length, va_list& va)
+{
+    using Length = Conversion::Length;
+    switch (length)
+    {
+    case Length::hh: return static_cast<signed char>(va_arg(va, int));
+    case Length::h: return static_cast<short>(va_arg(va, int));
+    case Length::l: return va_arg(va, long);
+    case Length::ll: return va_arg(va, long long);
+    case Length::j: return va_arg(va, intmax_t);
+    case Length::z: return va_arg(va, ssize_t);
+    case Length::t: return va_arg(va, ptrdiff_t);
+    default: return va_arg(va, int);
+    }
+}
+
+unsigned long long unsigned_arg(Conversion::Length length, va_list& va)
+{
+    using Length = Conversion::Length;
+    switch (length)
+    {
+    case Length::hh: return static_cast<unsigned char>(va_arg(va, unsigned));
+    case Length::h: return static_cast<unsigned short>(va_arg(va, unsigned));
+    case Length::l: return va_arg(va, unsigned long);
+    case Length::ll: return va_arg(va, unsigned long long);
+    case Length::j: return va_arg(va, uintmax_t);
+    case Length::z: return va_arg(va, size_t);
+    case Length::t: return static_cast<std::make_unsigned<ptrdiff_t>::type>(va_arg(va, ptrdiff_t));
+    default: return va_arg(va, unsigned);
+    }
+}
+
+// Returns false (having consumed some of va) if format cannot be deferred
+bool capture(char const* format, va_list& va, std::vector<char>& args)
+{
+    auto const saved_errno = errno;
+    Conversion c;
+    Scan scan;
+
+    while ((scan = next_conversion(format, c)) == Scan::conversion)
+    {
+        if (c.width_arg)
+            put<long long>(args, va_arg(va, int));
+        if (c.precision_arg)
+        {
+            c.precision = va_arg(va, int);
+            put<long long>(args, c.precision);
+        }
+
+        switch (c.specifier)
+        {
+        case 'd': case 'i':
+            put(args, signed_arg(c.length, va));
+            break;
+        case 'o': case 'u': case 'x': case 'X':
+            put(args, unsigned_arg(c.length, va));
+            break;
+        case 'c':
+            put<long long>(args, va_arg(va, int));
+            break;
+        case 'p':
+            put<long long>(args, reinterpret_cast<intptr_t>(va_arg(va, void*)));
+            break;
+        case 's':
+            put_string(args, va_arg(va, char const*), c.precision);
+            break;
+        case 'm':
+            put_string(args, strerror(saved_errno), -1);
+            break;
+        case '%':
+            break;
+        default:
+            put(args, va_arg(va, double));
+            break;
+        }
+    }
+
+    return scan == Scan::end;
+}
+
+template<typename... Args>
+void append_formatted(std::string& out, char const* spec, Args... args)
+{
+    char buffer[256];
+    auto const length = snprintf(buffer, sizeof buffer, spec, args...);
+    if (length < 0)
+        return;
+
+    if (static_cast<size_t>(length) < sizeof buffer)
+    {
+        out.append(buffer, length);
+    }
+    else
+    {
+        auto const offset = out.size();
+        out.resize(offset + length + 1);
+        snprintf(&out[offset], length + 1, spec, args...);
+        out.resize(offset + length);
+    }
+}
+
+template<typename T>
+void append_conversion(std::string& out, std::string const& spec, int const* stars, int nstars, T value)
+{
+    switch (nstars)
+    {
+    case 0: append_formatted(out, spec.c_str(), value); break;
+    case 1: append_formatted(out, spec.c_str(), stars[0], value); break;
+    default: append_formatted(out, spec.c_str(), stars[0], stars[1], value); break;
+    }
+}
+
+template<typename T>
+T get(char const*& args)
+{
+    T value;
+    memcpy(&value, args, sizeof value);
+    args += sizeof value;
+    return value;
+}
+
+char const* get_string(char const*& args)
+{
+    auto const string = args;
+    args += strlen(string) + 1;
+    return string;
+}
+
+void format_deferred(char const* format, char const* args, std::string& out)
+{
+    Conversion c;
+    std::string spec;
+    auto literal = format;
+
+    for (; next_conversion(format, c) == Scan::conversion; literal = format)
+    {
+        out.append(literal, c.start);
+
+        int stars[2];
+        int nstars{0};
+        if (c.width_arg)
+            stars[nstars++] = get<long long>(args);
+        if (c.precision_arg)
+            stars[nstars++] = get<long long>(args);
+
+        spec.assign(c.start, c.modifiers);
+        switch (c.specifier)
+        {
+        case 'd': case 'i':
+            spec.append("ll").push_back(c.specifier);
+            append_conversion(out, spec, stars, nstars, get<long long>(args));
+            break;
+        case 'o': case 'u': case 'x': case 'X':
+            spec.append("ll").push_back(c.specifier);
+            append_conversion(out, spec, stars, nstars, get<unsigned long long>(args));
+            break;
+        case 'c':
+            spec.push_back(c.specifier);
+            append_conversion(out, spec, stars, nstars, static_cast<int>(get<long long>(args)));
+            break;
+        case 'p':
+            spec.push_back(c.specifier);
+            append_conversion(out, spec, stars, nstars, reinterpret_cast<void*>(static_cast<intptr_t>(get<long long>(args))));
+            break;
+        case 's':
+            spec.push_back(c.specifier);
+            append_conversion(out, spec, stars, nstars, get_string(args));
+            break;
+        case 'm':
+            out.append(get_string(args));
+            break;
+        case '%':
+            out.push_back('%');
+            break;
+        default:
+            spec.push_back(c.specifier);
+            append_conversion(out, spec, stars, nstars, get<double>(args));
+            break;
+        }
+    }
+
+    out.append(literal);
+}
+
+void write_all(int fd, std::string const& data)
+{
+    for (size_t written = 0; written < data.size();)
+    {
+        auto const result = ::write(fd, data.data() + written, data.size() - written);
+        if (result < 0 && errno == EINTR)
+            continue;
+        if (result <= 0)
+            return;
+        written += result;
+    }
+}
+
+size_t ring_capacity(size_t requested)
+{
+    size_t capacity{1024};
+    while (capacity < requested)
+        capacity *= 2;
+    return capacity;
+}
+}
+
+struct ml::AsyncConsoleLogger::Record
+{
+    enum class Kind : std::uint8_t { padding, text, deferred };
+
+    // Records are allocated in multiples of sizeof(Record) so that a
+    // padding record always fits at the end of the ring
+    std::uint32_t size;
+    Kind kind;
+    Severity severity;
+    std::uint32_t length;
+    timespec time;
+
+    char* payload() { return reinterpret_cast<char*>(this + 1); }
+};
+
+/*
+ * A single-producer, single-consumer ring of variable length records. Only
+ * the thread that owns the ring writes to it and only the writer thread
+ * reads from it, so neither needs a lock.
+ */
+class ml::AsyncConsoleLogger::Ring
+{
+    static_assert((sizeof(Record) & (sizeof(Record) - 1)) == 0, "record size must be a power of two");
+
+public:
+    explicit Ring(size_t capacity) :
+        capacity{capacity},
+        data{new Record[capacity / sizeof(Record)]}
+    {
+    }
+
+    // Producer side
+    Record* reserve(size_t payload_size)
+    {
+        auto const size = (sizeof(Record) + payload_size + sizeof(Record) - 1) & ~(sizeof(Record) - 1);
+        auto const pos = head.load(std::memory_order_relaxed);
+        auto const contiguous = capacity - (pos & (capacity - 1));
+        auto const padding = contiguous < size ? contiguous : 0;
+
+        if (padding + size > capacity - (pos - tail.load(std::memory_order_acquire)))
+            return nullptr;
+
+        if (padding)
+        {
+            auto const pad = at(pos);
+            pad->size = padding;
+            pad->kind = Record::Kind::padding;
+        }
+
+        auto const record = at(pos + padding);
+        record->size = size;
+        reserved = padding + size;
+        return record;
+    }
+
+    // Returns the number of bytes in use
+    size_t commit()
+    {
+        auto const pos = head.load(std::memory_order_relaxed) + reserved;
+        head.store(pos, std::memory_order_seq_cst);
+        return pos - tail.load(std::memory_order_relaxed);
+    }
+
+    void retire() { retired_.store(true, std::memory_order_release); }
+
+    // Consumer side
+    std::uint64_t begin() const { return tail.load(std::memory_order_relaxed); }
+    std::uint64_t end() const { return head.load(std::memory_order_seq_cst); }
+
+    Record* at(std::uint64_t pos) const
+    {
+        return reinterpret_cast<Record*>(reinterpret_cast<char*>(data.get()) + (pos & (capacity - 1)));
+    }
+
+    void release(std::uint64_t pos) { tail.store(pos, std::memory_order_release); }
+
+    bool retired() const { return retired_.load(std::memory_order_acquire); }
+
+    // Owner side
+    void abandon() { abandoned_.store(true, std::memory_order_release); }
+    bool abandoned() const { return abandoned_.load(std::memory_order_acquire); }
+
+private:
+    size_t const capacity;
+    std::unique_ptr<Record[]> const data;
+    size_t reserved{0};
+    std::atomic<std::uint64_t> head{0};
+    std::atomic<std::uint64_t> tail{0};
+    std::atomic<bool> retired_{false};
+    std::atomic<bool> abandoned_{false};
+};
+
+std::size_t const ml::AsyncConsoleLogger::default_buffer_size;
+
+ml::AsyncConsoleLogger::AsyncConsoleLogger(size_t buffer_size_per_thread, int out_fd, int err_fd) :
+    buffer_size{ring_capacity(buffer_size_per_thread)},
+    out_fd{out_fd},
+    err_fd{err_fd},
+    id{next_logger_id++},
+    writer{[this] { run_writer(); }}
+{
+}
+
+ml::AsyncConsoleLogger::~AsyncConsoleLogger()
+{
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        stopping = true;
+    }
+    wake_writer.notify_all();
+    writer.join();
+
+    for (auto const& ring : rings)
+        ring->abandon();
+}
+
+auto ml::AsyncConsoleLogger::ring_for_this_thread() -> Ring&
+{
+    struct ThreadRings
+    {
+        ~ThreadRings()
+        {
+            for (auto const& ring : rings)
+                ring.second->retire();
+        }
+
+        std::vector<std::pair<std::uint64_t, std::shared_ptr<Ring>>> rings;
+    };
+    static thread_local ThreadRings this_thread;
+
+    auto& mine = this_thread.rings;
+    for (auto i = mine.begin(); i != mine.end();)
+    {
+        if (i->first == id)
+            return *i->second;
+
+        if (i->second->abandoned())
+            i = mine.erase(i);
+        else
+            ++i;
+    }
+
+    auto const ring = std::make_shared<Ring>(buffer_size);
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        rings.push_back(ring);
+    }
+    mine.emplace_back(id, ring);
+    return *ring;
+}
+
+auto ml::AsyncConsoleLogger::reserve(Severity severity, size_t payload_size) -> Record*
+{
+    auto const record = ring_for_this_thread().reserve(payload_size);
+    if (!record)
+    {
+        dropped_messages.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    record->severity = severity;
+    record->length = payload_size;
+    clock_gettime(CLOCK_REALTIME, &record->time);
+    return record;
+}
+
+void ml::AsyncConsoleLogger::commit()
+{
+    auto const used = ring_for_this_thread().commit();
+
+    if (writer_idle.load(std::memory_order_seq_cst) && writer_idle.exchange(false))
+    {
+        // Taking the lock ensures the writer is either waiting or has yet to
+        // check whether it should wait
+        { std::lock_guard<std::mutex> lock{mutex}; }
+        wake_writer.notify_one();
+    }
+    else if (used > buffer_size / 2)
+    {
+        wake_writer.notify_one();
+    }
+}
+
+void ml::AsyncConsoleLogger::log(Severity severity, std::string const& message, std::string const& component)
+{
+    auto const component_size = component.size() + 1;
+    auto const record = reserve(severity, component_size + message.size());
+    if (!record)
+        return;
+
+    record->kind = Record::Kind::text;
+    memcpy(record->payload(), component.c_str(), component_size);
+    memcpy(record->payload() + component_size, message.data(), message.size());
+    commit();
+}
+
+void ml::AsyncConsoleLogger::log(char const* component, Severity severity, char const* format, ...)
+{
+    static thread_local std::vector<char> args;
+    args.clear();
+
+    va_list va;
+    va_start(va, format);
+    va_list deferred;
+    va_copy(deferred, va);
+    auto const captured = capture(format, deferred, args);
+    va_end(deferred);
+
+    if (!captured)
+    {
+        char message[4096];
+        vsnprintf(message, sizeof message, format, va);
+        va_end(va);
+        log(severity, std::string{message}, std::string{component});
+        return;
+    }
+    va_end(va);
+
+    auto const component_size = strlen(component) + 1;
+    auto const format_size = strlen(format) + 1;
+    auto const record = reserve(severity, component_size + format_size + args.size());
+    if (!record)
+        return;
+
+    auto const payload = record->payload();
+    record->kind = Record::Kind::deferred;
+    memcpy(payload, component, component_size);
+    memcpy(payload + component_size, format, format_size);
+    std::copy(args.begin(), args.end(), payload + component_size + format_size);
+    commit();
+}
+
+void ml::AsyncConsoleLogger::flush()
+{
+    std::unique_lock<std::mutex> lock{mutex};
+    auto const request = ++flush_requests;
+    writer_idle = false;
+    wake_writer.notify_one();
+    written.wait(lock, [&] { return flushes_done >= request; });
+}
+
+std::uint64_t ml::AsyncConsoleLogger::dropped() const
+{
+    return dropped_messages.load(std::memory_order_relaxed);
+}
+
+void ml::AsyncConsoleLogger::run_writer()
+{
+    std::unique_lock<std::mutex> lock{mutex};
+
+    for (;;)
+    {
+        auto const stop = stopping;
+        auto const request = flush_requests;
+        auto const current = rings;
+
+        lock.unlock();
+        auto const wrote = write_pending(current);
+        lock.lock();
+
+        // Rings whose threads have exited won't fill again
+        rings.erase(
+            std::remove_if(rings.begin(), rings.end(),
+                [](std::shared_ptr<Ring> const& ring)
+                {
+                    return ring->retired() && ring->begin() == ring->end();
+                }),
+            rings.end());
+
+        flushes_done = request;
+        written.notify_all();
+
+        if (stop)
+            break;
+
+        auto const woken = [this] { return stopping || flush_requests != flushes_done; };
+
+        if (wrote)
+        {
+            wake_writer.wait_for(lock, drain_interval, woken);
+        }
+        else
+        {
+            // Nothing is being logged: sleep until a logging thread wakes us
+            writer_idle.store(true, std::memory_order_seq_cst);
+
+            auto const pending = std::any_of(rings.begin(), rings.end(),
+                [](std::shared_ptr<Ring> const& ring) { return ring->begin() != ring->end(); });
+
+            if (!pending)
+                wake_writer.wait(lock, [&] { return woken() || !writer_idle; });
+
+            writer_idle = false;
+        }
+    }
+}
+
+bool ml::AsyncConsoleLogger::write_pending(std::vector<std::shared_ptr<Ring>> const& rings)
+{
+    static char const* const lut[5] =
+    {
+        "<CRITICAL> ",
+        "<ERROR> ",
+        "<WARNING> ",
+        "",
+        "<DEBUG> "
+    };
+
+    struct Cursor
+    {
+        Ring* ring;
+        std::uint64_t pos;
+        std::uint64_t end;
+
+        Record* next()
+        {
+            while (pos != end && ring->at(pos)->kind == Record::Kind::padding)
+                pos += ring->at(pos)->size;
+            return pos != end ? ring->at(pos) : nullptr;
+        }
+    };
+
+    std::vector<Cursor> cursors;
+    for (auto const& ring : rings)
+        cursors.push_back(Cursor{ring.get(), ring->begin(), ring->end()});
+
+    std::string batch;
+    int batch_fd{out_fd};
+    std::string line;
+    time_t line_second{-1};
+    char now[32];
+    bool wrote{false};
+
+    auto const start_line = [&](Severity severity, timespec const& time, char const* component)
+    {
+        if (time.tv_sec != line_second)
+        {
+            struct tm local;
+            line_second = time.tv_sec;
+            strftime(now, sizeof now, "%F %T", localtime_r(&line_second, &local));
+        }
+
+        char fraction[16];
+        snprintf(fraction, sizeof fraction, ".%06d", static_cast<int>(time.tv_nsec / 1000));
+
+        line.assign("[").append(now).append(fraction).append("] ");
+        line.append(lut[static_cast<int>(severity)]).append(component).append(": ");
+    };
+
+    auto const end_line = [&](Severity severity)
+    {
+        line.push_back('\n');
+
+        auto const fd = severity < Severity::informational ? err_fd : out_fd;
+        if (fd != batch_fd)
+        {
+            write_all(batch_fd, batch);
+            batch.clear();
+            batch_fd = fd;
+        }
+        batch.append(line);
+        wrote = true;
+    };
+
+    for (;;)
+    {
+        Cursor* earliest{nullptr};
+        Record* record{nullptr};
+        for (auto& cursor : cursors)
+        {
+            if (auto const next = cursor.next())
+            {
+                if (!record ||
+                    next->time.tv_sec < record->time.tv_sec ||
+                    (next->time.tv_sec == record->time.tv_sec && next->time.tv_nsec < record->time.tv_nsec))
+                {
+                    earliest = &cursor;
+                    record = next;
+                }
+            }
+        }
+
+        if (!record)
+            break;
+
+        auto const component = record->payload();
+        auto const message = component + strlen(component) + 1;
+        start_line(record->severity, record->time, component);
+        if (record->kind == Record::Kind::text)
+            line.append(message, component + record->length);
+        else
+            format_deferred(message, message + strlen(message) + 1, line);
+        end_line(record->severity);
+
+        earliest->pos += record->size;
+        earliest->ring->release(earliest->pos);
+    }
+
+    auto const drops = dropped_messages.load(std::memory_order_relaxed);
+    if (drops != reported_drops)
+    {
+        timespec time;
+        clock_gettime(CLOCK_REALTIME, &time);
+        start_line(Severity::warning, time, "logging");
+        line.append(std::to_string(drops - reported_drops)).append(" messages dropped");
+        end_line(Severity::warning);
+        reported_drops = drops;
+    }
+
+    write_all(batch_fd, batch);
+    return wrote;
+}
@@ -63,10 +63,8 @@ bool greater_soname_version(boost::filesystem::path const& lhs, boost::filesyste
 }
 }
 
-void mir::select_libraries_for_path(
-    std::string const& path,
-    std::function<Selection(std::shared_ptr<mir::SharedLibrary> const&)> const& selector,
-    mir::SharedLibraryProberReport& report)
+std::vector<std::string>
+mir::library_filenames_for_path(std::string const& path, mir::SharedLibraryProberReport& report)
 {
     report.probing_path(path);
     // We use the error_code overload because we want to throw a std::system_error
@@ -89,12 +87,24 @@ void mir::select_libraries_for_path(
 
     std::sort(libraries.begin(), libraries.end(), &greater_soname_version);
 
-    for(auto& lib : libraries)
+    std::vector<std::string> result;
+    for (auto const& lib : libraries)
+        result.push_back(lib.string());
+
+    return result;
+}
+
+void mir::select_libraries_for_path(
+    std::string const& path,
+    std::function<Selection(std::shared_ptr<mir::SharedLibrary> const&)> const& selector,
+    mir::SharedLibraryProberReport& report)
+{
+    for(auto& lib : library_filenames_for_path(path, report))
     {
         try
         {
             report.loading_library(lib);
-            auto const shared_lib = std::make_shared<mir::SharedLibrary>(lib.string());
+            auto const shared_lib = std::make_shared<mir::SharedLibrary>(lib);
 
             if (selector(shared_lib) == Selection::quit)
                 return;
@@ -0,0 +1,273 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define MIR_LOG_COMPONENT "GL"
+
+#include "mir/gl/program_binary_cache.h"
+#include "mir/log.h"
+
+#include MIR_SERVER_GL_H
+#include MIR_SERVER_GLEXT_H
+#include <EGL/egl.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+// The OES (GLES) and core (desktop GL) entry points share their signatures
+// and enum values, so we define our own rather than depend on either header
+#ifndef GL_PROGRAM_BINARY_LENGTH_OES
+#define GL_PROGRAM_BINARY_LENGTH_OES 0x8741
+#endif
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS_OES
+#define GL_NUM_PROGRAM_BINARY_FORMATS_OES 0x87FE
+#endif
+
+namespace mgl = mir::gl;
+
+namespace
+{
+char const file_magic[] = "MIRGLPB1";
+
+template<typename Function>
+Function resolve(char const* oes_name, char const* core_name)
+{
+    auto function = eglGetProcAddress(oes_name);
+    if (!function)
+        function = eglGetProcAddress(core_name);
+    return reinterpret_cast<Function>(function);
+}
+
+bool has_extension(char const* name)
+{
+    auto const extensions = reinterpret_cast<char const*>(glGetString(GL_EXTENSIONS));
+    return extensions && strstr(extensions, name);
+}
+
+std::string gl_string(GLenum name)
+{
+    auto const value = reinterpret_cast<char const*>(glGetString(name));
+    return value ? value : "";
+}
+
+// FNV-1a: stable across runs and builds, unlike std::hash
+uint64_t stable_hash(std::string const& key)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : key)
+    {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+void write_u32(std::ostream& out, uint32_t value)
+{
+    out.write(reinterpret_cast<char const*>(&value), sizeof value);
+}
+
+bool read_u32(std::istream& in, uint32_t& value)
+{
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof value));
+}
+}
+
+struct mgl::ProgramBinaryCache::Extension
+{
+    typedef void (*GetProgramBinary)(GLuint, GLsizei, GLsizei*, GLenum*, void*);
+    typedef void (*ProgramBinary)(GLuint, GLenum, void const*, GLint);
+
+    GetProgramBinary const get_program_binary;
+    ProgramBinary const program_binary;
+};
+
+mgl::ProgramBinaryCache::ProgramBinaryCache(std::string const& directory) :
+    directory{directory}
+{
+}
+
+mgl::ProgramBinaryCache::~ProgramBinaryCache() = default;
+
+bool mgl::ProgramBinaryCache::supported(std::lock_guard<std::mutex> const&)
+{
+    if (!probed)
+    {
+        probed = true;
+
+        // Drivers may expose the extension yet support no binary formats
+        GLint formats{0};
+        if (has_extension("GL_OES_get_program_binary") || has_extension("GL_ARB_get_program_binary"))
+            glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS_OES, &formats);
+
+        auto const get_program_binary =
+            resolve<Extension::GetProgramBinary>("glGetProgramBinaryOES", "glGetProgramBinary");
+        auto const program_binary =
+            resolve<Extension::ProgramBinary>("glProgramBinaryOES", "glProgramBinary");
+
+        if (formats > 0 && get_program_binary && program_binary)
+        {
+            extension.reset(new Extension{get_program_binary, program_binary});
+            driver = gl_string(GL_VENDOR) + '\n' + gl_string(GL_RENDERER) + '\n' +
+                gl_string(GL_VERSION) + '\n' + gl_string(GL_SHADING_LANGUAGE_VERSION);
+        }
+    }
+
+    return extension != nullptr;
+}
+
+bool mgl::ProgramBinaryCache::load(
+    GLuint program, GLchar const* vertex_shader, GLchar const* fragment_shader)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    if (!supported(lock))
+        return false;
+
+    auto const key = key_for(vertex_shader, fragment_shader);
+    auto cached = binaries.find(key);
+    if (cached == binaries.end())
+    {
+        Binary binary;
+        if (!read(key, binary))
+            return false;
+        cached = binaries.emplace(key, std::move(binary)).first;
+    }
+
+    auto const& binary = cached->second;
+    extension->program_binary(program, binary.format, binary.data.data(), binary.data.size());
+
+    GLint linked{GL_FALSE};
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    if (linked == GL_TRUE)
+        return true;
+
+    // Drivers may reject binaries for reasons their version strings don't
+    // reveal (e.g. a rebuilt driver or a different GPU revision)
+    mir::log_info("Discarding GL program binary rejected by the driver");
+    binaries.erase(cached);
+    if (!directory.empty())
+        unlink(path_for(key).c_str());
+    return false;
+}
+
+void mgl::ProgramBinaryCache::store(
+    GLuint program, GLchar const* vertex_shader, GLchar const* fragment_shader)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+    if (!supported(lock))
+        return;
+
+    GLint length{0};
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH_OES, &length);
+    if (length <= 0)
+        return;
+
+    Binary binary{0, std::vector<char>(length)};
+    GLsizei written{0};
+    extension->get_program_binary(program, length, &written, &binary.format, binary.data.data());
+    if (written <= 0)
+        return;
+    binary.data.resize(written);
+
+    auto const key = key_for(vertex_shader, fragment_shader);
+    write(key, binary);
+    binaries[key] = std::move(binary);
+}
+
+std::string mgl::ProgramBinaryCache::key_for(
+    GLchar const* vertex_shader, GLchar const* fragment_shader) const
+{
+    return driver + '\0' + vertex_shader + '\0' + fragment_shader;
+}
+
+std::string mgl::ProgramBinaryCache::path_for(std::string const& key) const
+{
+    char name[32];
+    snprintf(name, sizeof name, "%016llx.bin", static_cast<unsigned long long>(stable_hash(key)));
+    return directory + "/" + name;
+}
+
+bool mgl::ProgramBinaryCache::read(std::string const& key, Binary& binary) const
+{
+    if (directory.empty())
+        return false;
+
+    std::ifstream in{path_for(key), std::ios::binary};
+
+    char magic[sizeof file_magic - 1];
+    if (!in.read(magic, sizeof magic) || memcmp(magic, file_magic, sizeof magic) != 0)
+        return false;
+
+    // The full key guards against hash collisions and stale driver builds
+    uint32_t key_size{0};
+    if (!read_u32(in, key_size) || key_size != key.size())
+        return false;
+    std::string stored_key(key_size, '\0');
+    if (!in.read(&stored_key[0], key_size) || stored_key != key)
+        return false;
+
+    uint32_t format{0};
+    uint32_t size{0};
+    if (!read_u32(in, format) || !read_u32(in, size) || size == 0)
+        return false;
+    std::vector<char> data(size);
+    if (!in.read(data.data(), size))
+        return false;
+
+    binary.format = format;
+    binary.data = std::move(data);
+    return true;
+}
+
+void mgl::ProgramBinaryCache::write(std::string const& key, Binary const& binary) const
+{
+    if (directory.empty())
+        return;
+
+    mkdir(directory.c_str(), 0700);
+
+    // Write then rename, so that concurrent servers never read a partial file
+    auto const path = path_for(key);
+    auto const temporary = path + "." + std::to_string(getpid()) + ".tmp";
+    {
+        std::ofstream out{temporary, std::ios::binary | std::ios::trunc};
+        out.write(file_magic, sizeof file_magic - 1);
+        write_u32(out, key.size());
+        out.write(key.data(), key.size());
+        write_u32(out, binary.format);
+        write_u32(out, binary.data.size());
+        out.write(binary.data.data(), binary.data.size());
+        out.close();
+
+        if (!out)
+        {
+            mir::log_warning("Failed to write GL program binary to \"%s\"", temporary.c_str());
+            unlink(temporary.c_str());
+            return;
+        }
+    }
+
+    if (rename(temporary.c_str(), path.c_str()) != 0)
+    {
+        mir::log_warning("Failed to save GL program binary as \"%s\": %s", path.c_str(), strerror(errno));
+        unlink(temporary.c_str());
+    }
+}
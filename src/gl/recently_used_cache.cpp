@@ -18,6 +18,7 @@
  */
 
 #include "recently_used_cache.h"
+#include "mir/gl/shared_textures.h"
 #include "mir/graphics/buffer.h"
 #include "mir/renderer/gl/texture_source.h"
 
@@ -29,12 +30,16 @@ namespace mgl = mir::gl;
 namespace geom = mir::geometry;
 namespace mrgl = mir::renderer::gl;
 
+mgl::RecentlyUsedCache::RecentlyUsedCache(std::shared_ptr<SharedTextures> const& shared_textures) :
+    shared_textures{shared_textures}
+{
+}
+
 std::shared_ptr<mgl::Texture> mgl::RecentlyUsedCache::load(mg::Renderable const& renderable)
 {
     auto const& buffer = renderable.buffer();
     auto buffer_id = buffer->id();
     auto& texture = textures[renderable.id()];
-    texture.texture->bind();
 
     auto const texture_source = dynamic_cast<mrgl::TextureSource*>(buffer->native_buffer_base());
     if (!texture_source)
@@ -42,11 +47,38 @@ std::shared_ptr<mgl::Texture> mgl::RecentlyUsedCache::load(mg::Renderable const&
 
     if ((texture.last_bound_buffer != buffer_id) || (!texture.valid_binding))
     {
-        texture_source->bind();
-        texture.resource = buffer;
+        if (!texture_source->secure_for_render())
+        {
+            // The client has not finished drawing the new buffer. Rather than
+            // sample it half drawn, keep showing the one we still hold.
+            if (!texture.resource || !texture.valid_binding)
+                BOOST_THROW_EXCEPTION(std::runtime_error("Buffer content is not ready to render"));
+
+            texture.texture->bind();
+            texture.used = true;
+            return texture.texture;
+        }
+
+        if (shared_textures)
+        {
+            texture.texture = shared_textures->load(buffer, *texture_source);
+        }
+        else
+        {
+            if (!texture.texture)
+                texture.texture = std::make_shared<Texture>();
+            texture.texture->bind();
+            texture_source->bind();
+        }
         texture.last_bound_buffer = buffer_id;
     }
-    texture_source->secure_for_render();
+    else
+    {
+        texture.texture->bind();
+        // Even if resubmitted with new content, it is all we have to show
+        texture_source->secure_for_render();
+    }
+    texture.resource = buffer;
 
     texture.valid_binding = true;
     texture.used = true;
@@ -57,7 +89,10 @@ std::shared_ptr<mgl::Texture> mgl::RecentlyUsedCache::load(mg::Renderable const&
 void mgl::RecentlyUsedCache::invalidate()
 {
     for (auto &t : textures)
+    {
         t.second.valid_binding = false;
+        t.second.resource.reset();
+    }
 }
 
 void mgl::RecentlyUsedCache::drop_unused()
@@ -66,9 +101,14 @@ void mgl::RecentlyUsedCache::drop_unused()
     while (t != textures.end())
     {
         auto& tex = t->second;
-        tex.resource.reset();
         if (tex.used)
         {
+            // Only what was sampled this frame needs to know when we are done
+            if (tex.resource)
+            {
+                if (auto const texture_source = dynamic_cast<mrgl::TextureSource*>(tex.resource->native_buffer_base()))
+                    texture_source->rendering_finished();
+            }
             tex.used = false;
             ++t;
         }
@@ -31,9 +31,16 @@ namespace mir
 namespace graphics { class Buffer; }
 namespace gl
 {
+class SharedTextures;
+
 class RecentlyUsedCache : public TextureCache
 {
 public:
+    RecentlyUsedCache() = default;
+    /// Loads buffers through textures shared with the other caches of the
+    /// GL share group
+    explicit RecentlyUsedCache(std::shared_ptr<SharedTextures> const& shared_textures);
+
     std::shared_ptr<Texture> load(graphics::Renderable const& renderable) override;
     void invalidate() override;
     void drop_unused() override;
@@ -41,16 +48,15 @@ public:
 private:
     struct Entry
     {
-        Entry()
-         : texture(std::make_shared<Texture>())
-        {}
         std::shared_ptr<Texture> texture;
         graphics::BufferID last_bound_buffer;
         bool used{true};
         bool valid_binding{false};
+        /// The buffer the texture shows, held until the next one is ready
         std::shared_ptr<graphics::Buffer> resource;
     };
 
+    std::shared_ptr<SharedTextures> const shared_textures;
     std::unordered_map<graphics::Renderable::ID, Entry> textures;
 };
 }
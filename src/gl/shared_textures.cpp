@@ -0,0 +1,175 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/gl/shared_textures.h"
+#include "mir/gl/texture.h"
+#include "mir/graphics/buffer.h"
+#include "mir/renderer/gl/texture_source.h"
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include <algorithm>
+#include <cstring>
+#include <future>
+
+namespace mg = mir::graphics;
+namespace mgl = mir::gl;
+namespace mrgl = mir::renderer::gl;
+
+struct mgl::SharedTextures::FenceSync
+{
+    FenceSync() :
+        create{reinterpret_cast<PFNEGLCREATESYNCKHRPROC>(eglGetProcAddress("eglCreateSyncKHR"))},
+        destroy{reinterpret_cast<PFNEGLDESTROYSYNCKHRPROC>(eglGetProcAddress("eglDestroySyncKHR"))},
+        client_wait{reinterpret_cast<PFNEGLCLIENTWAITSYNCKHRPROC>(eglGetProcAddress("eglClientWaitSyncKHR"))}
+    {
+    }
+
+    bool available_on(EGLDisplay display) const
+    {
+        if (!create || !destroy || !client_wait || display == EGL_NO_DISPLAY)
+            return false;
+
+        auto const extensions = eglQueryString(display, EGL_EXTENSIONS);
+        return extensions && strstr(extensions, "EGL_KHR_fence_sync");
+    }
+
+    PFNEGLCREATESYNCKHRPROC const create;
+    PFNEGLDESTROYSYNCKHRPROC const destroy;
+    PFNEGLCLIENTWAITSYNCKHRPROC const client_wait;
+};
+
+class mgl::SharedTextures::Upload
+{
+public:
+    Upload(std::shared_ptr<FenceSync const> const& fence_sync) :
+        fence_sync{fence_sync},
+        done{promise.get_future().share()}
+    {
+    }
+
+    ~Upload()
+    {
+        if (fence != EGL_NO_SYNC_KHR)
+            fence_sync->destroy(display, fence);
+    }
+
+    // Called by the loading context once the texture's content is queued
+    void loaded()
+    {
+        display = eglGetCurrentDisplay();
+        if (fence_sync->available_on(display))
+            fence = fence_sync->create(display, EGL_SYNC_FENCE_KHR, nullptr);
+
+        // Other contexts may only sample what this one has finished writing:
+        // flush so the fence signals without waiting for our next swap
+        if (fence != EGL_NO_SYNC_KHR)
+            glFlush();
+        else
+            glFinish();
+
+        promise.set_value();
+    }
+
+    void failed()
+    {
+        promise.set_exception(std::current_exception());
+    }
+
+    // Called by other contexts before they sample the texture
+    void wait_for_load() const
+    {
+        done.get();
+        if (fence != EGL_NO_SYNC_KHR)
+            fence_sync->client_wait(display, fence, 0, EGL_FOREVER_KHR);
+    }
+
+    Texture texture;
+
+private:
+    std::shared_ptr<FenceSync const> const fence_sync;
+    std::promise<void> promise;
+    std::shared_future<void> const done;
+    EGLDisplay display{EGL_NO_DISPLAY};
+    EGLSyncKHR fence{EGL_NO_SYNC_KHR};
+};
+
+mgl::SharedTextures::SharedTextures() :
+    fence_sync{std::make_shared<FenceSync>()}
+{
+}
+
+mgl::SharedTextures::~SharedTextures() = default;
+
+std::shared_ptr<mgl::Texture> mgl::SharedTextures::load(
+    std::shared_ptr<mg::Buffer> const& buffer,
+    mrgl::TextureSource& source)
+{
+    std::shared_ptr<Upload> upload;
+    bool load_here{false};
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+
+        for (auto e = entries.begin(); e != entries.end();)
+        {
+            if (e->second.upload.expired())
+                e = entries.erase(e);
+            else
+                ++e;
+        }
+
+        auto& entry = entries[buffer->id()];
+        auto& holders = entry.holders;
+        holders.erase(
+            std::remove_if(holders.begin(), holders.end(),
+                [](std::weak_ptr<mg::Buffer> const& holder) { return holder.expired(); }),
+            holders.end());
+
+        upload = entry.upload.lock();
+        if (!upload || holders.empty())
+        {
+            // Nobody has held the buffer since it was last loaded, so its
+            // client may have refilled it
+            upload = std::make_shared<Upload>(fence_sync);
+            entry.upload = upload;
+            load_here = true;
+        }
+        holders.push_back(buffer);
+    }
+
+    if (load_here)
+    {
+        try
+        {
+            upload->texture.bind();
+            source.bind();
+        }
+        catch (...)
+        {
+            upload->failed();
+            throw;
+        }
+        upload->loaded();
+    }
+    else
+    {
+        upload->wait_for_load();
+        upload->texture.bind();
+    }
+
+    return {upload, &upload->texture};
+}
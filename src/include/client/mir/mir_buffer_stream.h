@@ -64,6 +64,7 @@ namespace mir
 namespace protobuf
 {
 class Buffer;
+class PresentFeedback;
 }
 namespace client
 {
@@ -113,6 +114,11 @@ public:
 
     virtual void buffer_available(mir::protobuf::Buffer const& buffer) = 0;
     virtual void buffer_unavailable() = 0;
+    // The server's suggestion for how many buffers to keep; 0 means use our own choice
+    virtual void set_buffer_count_hint(int buffer_count) = 0;
+    // What became of a frame, for streams that asked to be told
+    virtual void set_present_feedback_callback(MirPresentFeedbackCallback callback, void* context) = 0;
+    virtual void present_feedback(mir::protobuf::PresentFeedback const& feedback) = 0;
 protected:
     MirBufferStream() = default;
     MirBufferStream(const MirBufferStream&) = delete;
@@ -0,0 +1,97 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_INPUT_EVENT_RING_H_
+#define MIR_INPUT_EVENT_RING_H_
+
+#include "mir/fd.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace mir
+{
+namespace input
+{
+/**
+ * A single-producer, single-consumer ring of serialized input events in
+ * shared memory, through which the server passes a surface's input events
+ * to its client without a message per event.
+ *
+ * The server creates the ring in a sealed memfd (so the client cannot
+ * shrink it under the server) and writes to it; the client maps it and
+ * reads from it. Events are stored in fixed-size slots. An event that
+ * does not fit goes over the socket instead, preceded in the ring by a
+ * barrier telling the client where the socket takes over.
+ */
+class EventRing
+{
+public:
+    static std::size_t const slot_size = 1024;
+    static std::size_t const default_slot_count = 256;
+
+    /// Creates a ring for the server to write to
+    static std::unique_ptr<EventRing> create(std::size_t slot_count = default_slot_count);
+    /// Maps a ring created by the server, for the client to read from
+    static std::unique_ptr<EventRing> open(Fd const& fd);
+
+    ~EventRing();
+
+    Fd fd() const;
+
+    // Writer side
+
+    /**
+     * Appends an event. Returns false if the event is larger than a slot,
+     * or if the ring is full: the last free slot is kept for a barrier.
+     */
+    bool write(std::string const& event);
+    /// Marks that the events following those in the ring are on the socket
+    void write_barrier();
+    bool empty() const;
+    /// Returns true if the reader has gone to sleep and must be woken
+    bool take_wakeup();
+
+    // Reader side
+
+    enum class Entry { none, event, barrier };
+    Entry read(std::string& event);
+    /**
+     * Asks to be woken by the writer's next event. Returns false (and the
+     * writer may not wake us) if events arrived in the meantime.
+     */
+    bool arm_wakeup();
+
+private:
+    struct Header;
+
+    EventRing(Fd const& fd, std::size_t size);
+    EventRing(EventRing const&) = delete;
+    EventRing& operator=(EventRing const&) = delete;
+
+    char* slot(std::uint64_t index) const;
+
+    Fd const fd_;
+    std::size_t const size;
+    Header* const header;
+    std::size_t slot_count{0};
+};
+}
+}
+
+#endif /* MIR_INPUT_EVENT_RING_H_ */
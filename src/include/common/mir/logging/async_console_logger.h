@@ -0,0 +1,100 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_LOGGING_ASYNC_CONSOLE_LOGGER_H_
+#define MIR_LOGGING_ASYNC_CONSOLE_LOGGER_H_
+
+#include "mir/logging/logger.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+namespace mir
+{
+namespace logging
+{
+/**
+ * Writes the same lines as DumbConsoleLogger, but from a thread of its own
+ * so that logging never blocks the thread being observed.
+ *
+ * Each logging thread appends to a ring buffer of its own without taking a
+ * lock. Messages given as a printf-style format are stored with their
+ * arguments unformatted and only formatted by the writer thread. When a
+ * thread's ring is full its messages are dropped and counted rather than
+ * waiting for the writer; the count is reported in the output.
+ */
+class AsyncConsoleLogger : public Logger
+{
+public:
+    static std::size_t const default_buffer_size = 64 * 1024;
+
+    explicit AsyncConsoleLogger(
+        std::size_t buffer_size_per_thread = default_buffer_size,
+        int out_fd = STDOUT_FILENO,
+        int err_fd = STDERR_FILENO);
+    ~AsyncConsoleLogger();
+
+    void log(Severity severity, std::string const& message, std::string const& component) override;
+    void log(char const* component, Severity severity, char const* format, ...) override
+        __attribute__ ((format (printf, 4, 5)));
+
+    /// Blocks until every message logged before the call has been written
+    void flush();
+
+    /// The number of messages dropped so far because a ring was full
+    std::uint64_t dropped() const;
+
+private:
+    class Ring;
+    struct Record;
+
+    Ring& ring_for_this_thread();
+    Record* reserve(Severity severity, std::size_t payload_size);
+    void commit();
+    void run_writer();
+    bool write_pending(std::vector<std::shared_ptr<Ring>> const& rings);
+
+    std::size_t const buffer_size;
+    int const out_fd;
+    int const err_fd;
+    std::uint64_t const id;
+
+    std::atomic<std::uint64_t> dropped_messages{0};
+    std::uint64_t reported_drops{0};
+
+    std::mutex mutex;
+    std::condition_variable wake_writer;
+    std::condition_variable written;
+    std::vector<std::shared_ptr<Ring>> rings;
+    std::uint64_t flush_requests{0};
+    std::uint64_t flushes_done{0};
+    bool stopping{false};
+    std::atomic<bool> writer_idle{false};
+
+    std::thread writer;
+};
+}
+}
+
+#endif // MIR_LOGGING_ASYNC_CONSOLE_LOGGER_H_
@@ -31,6 +31,9 @@ class SharedLibrary;
 
 std::vector<std::shared_ptr<SharedLibrary>> libraries_for_path(std::string const& path, SharedLibraryProberReport& report);
 
+// The filenames of the libraries in path, in the order they would be probed, without loading them
+std::vector<std::string> library_filenames_for_path(std::string const& path, SharedLibraryProberReport& report);
+
 // The selector can tell select_libraries_for_path() to persist or quit after each library
 enum class Selection { persist, quit };
 
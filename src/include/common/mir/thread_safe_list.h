@@ -20,34 +20,43 @@
 #ifndef MIR_THREAD_SAFE_LIST_H_
 #define MIR_THREAD_SAFE_LIST_H_
 
-#include "mir/recursive_read_write_mutex.h"
-
 #include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 namespace mir
 {
 
 /*
  * Requirements for type 'Element'
- *  - for_each():
- *    - copy-assignable
  *  - add():
- *    - copy-assignable
- *    - operator bool: returns whether this is a valid element
+ *    - copy-constructible
  *  - remove(), remove_all():
- *    - copy-assignable
- *    - Element{}: default construction should create an invalid element
  *    - bool operator==: equality of elements
- *    - bool operator!=: inequality of elements
- *  - clear():
- *    - copy-assignable
- *    - Element{}: default construction should create an invalid element
+ *
+ * The list is copy-on-write: add() and the removal functions publish a new
+ * snapshot of the items under a mutex, and for_each() walks whichever
+ * snapshot was current when it started. for_each() never waits for a writer,
+ * but it is not lock-free: the std::atomic_load() of the snapshot takes one
+ * of libstdc++'s internal mutexes for the duration of the copy, and each item
+ * visited costs an atomic increment and decrement of its count of callers.
+ *
+ * Removal is still seen by iterations that are in progress: a removed item
+ * is skipped by any for_each() that has not yet reached it, and the removal
+ * functions block while another thread is calling f() for a removed item.
+ * A thread may remove the item it is being called for (or any other) from
+ * inside f().
  */
 
 template<class Element>
 class ThreadSafeList
 {
 public:
+    ThreadSafeList();
+
     void add(Element const& element);
     void remove(Element const& element);
     unsigned int remove_all(Element const& element);
@@ -57,128 +66,153 @@ public:
 private:
     struct ListItem
     {
-        ListItem() {}
-        RecursiveReadWriteMutex mutex;
-        Element element;
-        std::atomic<ListItem*> next{nullptr};
+        ListItem(Element const& element) : element{element} {}
+        Element const element;
+        std::atomic<bool> removed{false};
+        std::atomic<unsigned int> callers{0};
+
+        // Only used once the item is removed, to wake the remover
+        std::mutex mutex;
+        std::condition_variable call_finished;
+    };
+
+    using Items = std::vector<std::shared_ptr<ListItem>>;
+
+    // Tracks the items this thread is currently calling f() for, innermost
+    // first. The caller is registered before for_each() checks for removal
+    // so that a concurrent removal either sees the call or is seen by it.
+    struct CallInFlight
+    {
+        CallInFlight(ListItem& item) : item{item}, outer{in_flight}
+        {
+            ++item.callers;
+            in_flight = this;
+        }
 
-        ~ListItem() { delete next.load(); }
-    } head;
+        ~CallInFlight()
+        {
+            in_flight = outer;
+            --item.callers;
+
+            // Either the remover sees the decrement or we see the removal
+            if (item.removed)
+            {
+                std::lock_guard<std::mutex> lock{item.mutex};
+                item.call_finished.notify_all();
+            }
+        }
+
+        ListItem& item;
+        CallInFlight const* const outer;
+    };
+    static thread_local CallInFlight const* in_flight;
+
+    template<typename Predicate>
+    unsigned int remove_if(Predicate const& should_remove, bool first_only);
+    static void wait_for_other_callers(ListItem& item);
+
+    std::mutex mutex; // Serializes writers only
+    std::shared_ptr<Items const> items;
 };
 
+template<class Element>
+thread_local typename ThreadSafeList<Element>::CallInFlight const* ThreadSafeList<Element>::in_flight{nullptr};
+
+template<class Element>
+ThreadSafeList<Element>::ThreadSafeList() :
+    items{std::make_shared<Items const>()}
+{
+}
+
 template<class Element>
 void ThreadSafeList<Element>::for_each(
     std::function<void(Element const& element)> const& f)
 {
-    ListItem* current_item = &head;
+    auto const snapshot = std::atomic_load(&items);
 
-    while (current_item)
+    for (auto const& item : *snapshot)
     {
-        RecursiveReadLock lock{current_item->mutex};
-
-        // We need to take a copy in case we recursively remove during call
-        if (auto const copy_of_element = current_item->element) f(copy_of_element);
-
-        current_item = current_item->next;
+        CallInFlight const call{*item};
+        if (!item->removed) f(item->element);
     }
 }
 
 template<class Element>
 void ThreadSafeList<Element>::add(Element const& element)
 {
-    ListItem* current_item = &head;
-
-    do
-    {
-        // Note: we release the read lock to avoid two threads calling add at
-        // the same time mutually blocking the other's upgrade to write lock.
-        {
-            RecursiveReadLock lock{current_item->mutex};
-            if (current_item->element) continue;
-        }
-
-        RecursiveWriteLock lock{current_item->mutex};
-
-        if (!current_item->element)
-        {
-            current_item->element = element;
-            return;
-        }
-    }
-    while (current_item->next && (current_item = current_item->next));
+    std::lock_guard<std::mutex> lock{mutex};
 
-    // No empty Items so append a new one
-    auto new_item = new ListItem;
-    new_item->element = element;
-
-    for (ListItem* expected{nullptr};
-        !current_item->next.compare_exchange_weak(expected, new_item);
-        expected = nullptr)
-    {
-        if (expected) current_item = expected;
-    }
+    auto const next = std::make_shared<Items>(*items);
+    next->push_back(std::make_shared<ListItem>(element));
+    std::atomic_store(&items, std::shared_ptr<Items const>{next});
 }
 
 template<class Element>
 void ThreadSafeList<Element>::remove(Element const& element)
 {
-    ListItem* current_item = &head;
-
-    do
-    {
-        {
-            RecursiveReadLock lock{current_item->mutex};
-            if (current_item->element != element) continue;
-        }
+    remove_if([&](Element const& candidate) { return candidate == element; }, true);
+}
 
-        RecursiveWriteLock lock{current_item->mutex};
+template<class Element>
+unsigned int ThreadSafeList<Element>::remove_all(Element const& element)
+{
+    return remove_if([&](Element const& candidate) { return candidate == element; }, false);
+}
 
-        if (current_item->element == element)
-        {
-            current_item->element = Element{};
-            return;
-        }
-    }
-    while ((current_item = current_item->next));
+template<class Element>
+void ThreadSafeList<Element>::clear()
+{
+    remove_if([](Element const&) { return true; }, false);
 }
 
 template<class Element>
-unsigned int ThreadSafeList<Element>::remove_all(Element const& element)
+template<typename Predicate>
+unsigned int ThreadSafeList<Element>::remove_if(Predicate const& should_remove, bool first_only)
 {
-    ListItem* current_item = &head;
-    auto removed = 0u;
+    Items removed;
 
-    do
     {
-        {
-            RecursiveReadLock lock{current_item->mutex};
-            if (current_item->element != element) continue;
-        }
+        std::lock_guard<std::mutex> lock{mutex};
 
-        RecursiveWriteLock lock{current_item->mutex};
+        auto const next = std::make_shared<Items>();
+        next->reserve(items->size());
 
-        if (current_item->element == element)
+        for (auto const& item : *items)
         {
-            current_item->element = Element{};
-            ++removed;
+            if ((!first_only || removed.empty()) && should_remove(item->element))
+            {
+                item->removed = true;
+                removed.push_back(item);
+            }
+            else
+            {
+                next->push_back(item);
+            }
         }
+
+        if (removed.empty())
+            return 0;
+
+        std::atomic_store(&items, std::shared_ptr<Items const>{next});
     }
-    while ((current_item = current_item->next));
 
-    return removed;
+    for (auto const& item : removed)
+        wait_for_other_callers(*item);
+
+    return removed.size();
 }
 
 template<class Element>
-void ThreadSafeList<Element>::clear()
+void ThreadSafeList<Element>::wait_for_other_callers(ListItem& item)
 {
-    ListItem* current_item = &head;
-
-    do
-    {
-        RecursiveWriteLock lock{current_item->mutex};
-        current_item->element = Element{};
-    }
-    while ((current_item = current_item->next));
+    // Calls made by this thread (i.e. we're removing from inside f()) can't
+    // complete until we return, so don't wait for those.
+    auto own_calls = 0u;
+    for (auto frame = in_flight; frame; frame = frame->outer)
+        if (&frame->item == &item) ++own_calls;
+
+    std::unique_lock<std::mutex> lock{item.mutex};
+    item.call_finished.wait(lock, [&] { return item.callers <= own_calls; });
 }
 
 }
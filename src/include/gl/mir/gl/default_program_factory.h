@@ -26,9 +26,15 @@ namespace mir
 {
 namespace gl
 {
+class SharedTextures;
+
 class DefaultProgramFactory : public ProgramFactory
 {
 public:
+    DefaultProgramFactory() = default;
+    /// Creates texture caches that share textures through shared_textures
+    explicit DefaultProgramFactory(std::shared_ptr<SharedTextures> const& shared_textures);
+
     std::unique_ptr<Program> create_gl_program(std::string const&, std::string const&) const override;
     std::unique_ptr<TextureCache> create_texture_cache() const override;
 
@@ -40,6 +46,7 @@ private:
      * have the same or shared EGL contexts.
      */
     std::mutex mutable mutex;
+    std::shared_ptr<SharedTextures> const shared_textures;
 };
 }
 }
@@ -0,0 +1,90 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_GL_PROGRAM_BINARY_CACHE_H_
+#define MIR_GL_PROGRAM_BINARY_CACHE_H_
+
+#include MIR_SERVER_GL_H
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mir
+{
+namespace gl
+{
+/**
+ * Linked program binaries (GL_OES_get_program_binary), kept in memory for
+ * the GL contexts of a share group and, given a directory, on disk so that
+ * later runs can skip compiling and linking shaders.
+ *
+ * Binaries are keyed on the shader sources and on the identity of the GL
+ * driver that produced them. A binary the driver rejects is discarded and
+ * the caller falls back to building the program from source.
+ */
+class ProgramBinaryCache
+{
+public:
+    /// An empty directory keeps binaries in memory only
+    explicit ProgramBinaryCache(std::string const& directory);
+    ~ProgramBinaryCache();
+
+    /**
+     * Loads program with a cached binary of vertex_shader and
+     * fragment_shader. Must be called with a current GL context.
+     * \returns true if program is now linked; false if the caller needs to
+     *          build it from source
+     */
+    bool load(GLuint program, GLchar const* vertex_shader, GLchar const* fragment_shader);
+
+    /**
+     * Saves the binary of program, freshly linked from vertex_shader and
+     * fragment_shader. Must be called with a current GL context.
+     */
+    void store(GLuint program, GLchar const* vertex_shader, GLchar const* fragment_shader);
+
+private:
+    ProgramBinaryCache(ProgramBinaryCache const&) = delete;
+    ProgramBinaryCache& operator=(ProgramBinaryCache const&) = delete;
+
+    struct Extension;
+    struct Binary
+    {
+        GLenum format;
+        std::vector<char> data;
+    };
+
+    bool supported(std::lock_guard<std::mutex> const&);
+    std::string key_for(GLchar const* vertex_shader, GLchar const* fragment_shader) const;
+    std::string path_for(std::string const& key) const;
+    bool read(std::string const& key, Binary& binary) const;
+    void write(std::string const& key, Binary const& binary) const;
+
+    std::string const directory;
+
+    std::mutex mutex;
+    bool probed{false};
+    std::unique_ptr<Extension const> extension;
+    std::string driver;
+    std::unordered_map<std::string, Binary> binaries;
+};
+}
+}
+
+#endif /* MIR_GL_PROGRAM_BINARY_CACHE_H_ */
@@ -0,0 +1,78 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_GL_SHARED_TEXTURES_H_
+#define MIR_GL_SHARED_TEXTURES_H_
+
+#include "mir/graphics/buffer_id.h"
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace mir
+{
+namespace graphics { class Buffer; }
+namespace renderer { namespace gl { class TextureSource; } }
+namespace gl
+{
+class Texture;
+
+/**
+ * Textures loaded from buffers, shared by the GL contexts of a share group
+ * (i.e. the compositors of each output) so that a buffer shown on several
+ * outputs is uploaded or imported once rather than once per output.
+ *
+ * A buffer's content only changes once every compositor has released it,
+ * so a texture is reused for as long as some compositor still holds the
+ * buffer it was loaded from.
+ */
+class SharedTextures
+{
+public:
+    SharedTextures();
+    ~SharedTextures();
+
+    /**
+     * Returns the texture holding the content of buffer, loading it from
+     * source if need be, and leaves it bound. Must be called with a current
+     * GL context in the share group.
+     */
+    std::shared_ptr<Texture> load(
+        std::shared_ptr<graphics::Buffer> const& buffer,
+        renderer::gl::TextureSource& source);
+
+private:
+    SharedTextures(SharedTextures const&) = delete;
+    SharedTextures& operator=(SharedTextures const&) = delete;
+
+    struct FenceSync;
+    class Upload;
+    struct Entry
+    {
+        std::weak_ptr<Upload> upload;
+        std::vector<std::weak_ptr<graphics::Buffer>> holders;
+    };
+
+    std::shared_ptr<FenceSync const> const fence_sync;
+    std::mutex mutex;
+    std::unordered_map<graphics::BufferID, Entry> entries;
+};
+}
+}
+
+#endif /* MIR_GL_SHARED_TEXTURES_H_ */
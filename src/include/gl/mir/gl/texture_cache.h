@@ -35,7 +35,9 @@ public:
 
     /**
      * Loads texture from the renderable. Must be called with a current GL
-     * context.
+     * context. If the renderable's buffer is not ready to render, the
+     * texture keeps showing the one before (and the cache holds that buffer
+     * for as long as it does).
      *   \param [in] renderable
      *       The Renderable that needs to be used as a texture
      *   \returns
@@ -45,15 +47,18 @@ public:
 
     /**
      * Mark all entries in the cache as out-of-date to ensure fresh textures
-     * are loaded next time. This function _must_ be implemented in a way that
+     * are loaded next time, releasing the buffers they were loaded from.
+     * This function _must_ be implemented in a way that
      * does not require a GL context, as it will typically be called without
      * one.
      */
     virtual void invalidate() = 0;
 
     /**
-     * Free textures that were not used (loaded) since the last
-     * drop/invalidate. Must be called with a current GL context.
+     * Free textures (and release the buffers) that were not used (loaded)
+     * since the last drop, and let the buffers of those that were know that
+     * rendering from them has been issued. Must be called with a current GL
+     * context, after the frame's draws.
      */
     virtual void drop_unused() = 0;
 
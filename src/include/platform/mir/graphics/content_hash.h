@@ -0,0 +1,53 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_GRAPHICS_CONTENT_HASH_H_
+#define MIR_GRAPHICS_CONTENT_HASH_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace mir
+{
+namespace graphics
+{
+
+/**
+ * A 64-bit hash of count bytes of pixels (or anything else), for telling
+ * whether content has changed since it was last seen. It is not a
+ * cryptographic hash: a client that contrives a collision only keeps its
+ * own update off the screen.
+ *
+ * The fastest implementation the running CPU supports (AVX2, SSE2, NEON or
+ * plain C++) is picked on first use; all give the same hash.
+ */
+uint64_t content_hash(void const* data, size_t count);
+
+/// The name of the kernel in use ("avx2", "sse2", "neon" or "scalar")
+char const* content_hash_kernel();
+
+/// The kernels the running CPU supports, the one in use first
+std::vector<char const*> content_hash_kernels();
+
+/// content_hash() worked out with the named kernel, so that kernels can be
+/// checked against each other
+uint64_t content_hash(void const* data, size_t count, char const* kernel);
+
+}
+}
+
+#endif /* MIR_GRAPHICS_CONTENT_HASH_H_ */
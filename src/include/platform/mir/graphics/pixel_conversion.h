@@ -0,0 +1,57 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_GRAPHICS_PIXEL_CONVERSION_H_
+#define MIR_GRAPHICS_PIXEL_CONVERSION_H_
+
+#include "mir/geometry/size.h"
+#include "mir/geometry/dimensions.h"
+
+#include <cstddef>
+
+namespace mir
+{
+namespace graphics
+{
+
+/*!
+ * \name 32bpp pixel conversion
+ *
+ * Row kernels for moving pixels between GL and Mir layouts. The fastest
+ * implementation the running CPU supports (AVX2, SSE2, NEON or plain C++)
+ * is picked on first use.
+ * \{
+ */
+
+/// Copies count 4-byte pixels from src to dst, exchanging the first and third
+/// byte of each (so abgr_8888 becomes argb_8888, and vice versa).
+/// src may be the same as dst, but the two must not otherwise overlap.
+void copy_swapping_red_and_blue(void const* src, void* dst, size_t count);
+
+/// Reverses the order of the rows of a 4-byte-per-pixel image in place,
+/// optionally exchanging red and blue as copy_swapping_red_and_blue() does.
+void flip_rows_8888(void* pixels, geometry::Size size, geometry::Stride stride, bool swap_red_and_blue);
+
+/// The name of the kernels in use ("avx2", "sse2", "neon" or "scalar")
+char const* pixel_conversion_kernels();
+/*!
+ * \}
+ */
+
+}
+}
+
+#endif /* MIR_GRAPHICS_PIXEL_CONVERSION_H_ */
@@ -21,11 +21,14 @@
 
 #include <vector>
 #include <memory>
+#include <string>
 #include "mir/shared_library.h"
 #include "mir/options/program_option.h"
 
 namespace mir
 {
+class SharedLibraryProberReport;
+
 namespace graphics
 {
 class Platform;
@@ -34,6 +37,22 @@ std::shared_ptr<SharedLibrary> module_for_device(
          std::vector<std::shared_ptr<SharedLibrary>> const& modules,
          options::ProgramOption const& options);
 
+/**
+ * Selects the graphics platform module from the libraries in \a path, using
+ * \a cache_file to avoid loading and probing every one of them.
+ *
+ * The cache records the name, size and modification time of every library in
+ * \a path, the DRM device nodes, $DISPLAY and the host socket, together with
+ * the module selected and its priority. While none of these has changed only
+ * the selected module is loaded and probed; if its probe no longer yields the
+ * recorded priority all the libraries are probed and the cache is rewritten.
+ */
+std::shared_ptr<SharedLibrary> module_for_device(
+         std::string const& path,
+         std::string const& cache_file,
+         options::ProgramOption const& options,
+         SharedLibraryProberReport& report);
+
 }
 }
 
@@ -51,6 +51,13 @@ extern char const* const cursor_opt;
 extern char const* const fatal_except_opt;
 extern char const* const debug_opt;
 extern char const* const composite_delay_opt;
+extern char const* const parallel_outputs_opt;
+extern char const* const skip_unchanged_frames_opt;
+extern char const* const gl_program_cache_opt;
+extern char const* const renderer_opt;
+extern char const* const async_log_opt;
+extern char const* const input_dispatch_queue_opt;
+extern char const* const input_reader_priority_opt;
 extern char const* const enable_key_repeat_opt;
 
 extern char const* const name_opt;
@@ -65,6 +72,7 @@ extern char const* const lttng_opt_value;
 extern char const* const platform_graphics_lib;
 extern char const* const platform_input_lib;
 extern char const* const platform_path;
+extern char const* const platform_probe_cache_opt;
 
 class Configuration
 {
@@ -0,0 +1,51 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_GRAPHICS_PARTIAL_OVERLAY_H_
+#define MIR_GRAPHICS_PARTIAL_OVERLAY_H_
+
+#include "mir/graphics/renderable.h"
+
+namespace mir
+{
+namespace graphics
+{
+/**
+ * Implemented by native display buffers that can overlay the top of a scene
+ * they can't overlay in full, leaving the rest to be composited beneath it.
+ */
+class PartialOverlay
+{
+public:
+    virtual ~PartialOverlay() = default;
+
+    /**
+     * Overlays as many of the topmost renderables in renderlist as possible
+     * once the next frame is swapped.
+     * \returns the renderables beneath those, which the caller must
+     *          composite (and swap) as usual
+     */
+    virtual RenderableList overlay_top(RenderableList const& renderlist) = 0;
+
+protected:
+    PartialOverlay() = default;
+    PartialOverlay(PartialOverlay const&) = delete;
+    PartialOverlay& operator=(PartialOverlay const&) = delete;
+};
+}
+}
+
+#endif /* MIR_GRAPHICS_PARTIAL_OVERLAY_H_ */
@@ -21,9 +21,10 @@
 
 #include "mir/events/contact_state.h"
 
+#include <array>
+#include <functional>
 #include <memory>
 #include <unordered_map>
-#include <vector>
 #include <mutex>
 
 namespace mir
@@ -37,16 +38,39 @@ public:
 
     void validate_and_dispatch(MirEvent const& event);
 
+    /// The most contacts a touch event carries; building an event drops any beyond this
+    static size_t const max_contacts = 16;
+
 private:
+    /// The contacts of a touch event, held inline so that validating needs no allocation
+    class Contacts
+    {
+    public:
+        events::ContactState* begin() { return contacts.data(); }
+        events::ContactState* end() { return contacts.data() + count; }
+        events::ContactState const* begin() const { return contacts.data(); }
+        events::ContactState const* end() const { return contacts.data() + count; }
+        size_t size() const { return count; }
+        bool contains(MirTouchId id) const;
+
+        void push_back(events::ContactState const& contact);
+        void erase(events::ContactState* contact);
+
+    private:
+        std::array<events::ContactState, max_contacts> contacts;
+        size_t count{0};
+    };
+
     std::mutex state_guard;
     std::function<void(MirEvent const&)> const dispatch_valid_event;
-    std::unordered_map<MirInputDeviceId, std::vector<events::ContactState>> last_event_by_device;
+    std::unordered_map<MirInputDeviceId, Contacts> last_event_by_device;
 
     void handle_touch_event(MirEvent const& event);
     void ensure_stream_validity_locked(std::lock_guard<std::mutex> const& lg,
-                                       std::vector<events::ContactState> const& new_state,
-                                       std::vector<events::ContactState> & last_state,
-                                       std::function<void(std::vector<events::ContactState> const&)> const&);
+                                       MirInputEvent const* event,
+                                       Contacts const& new_state,
+                                       Contacts& last_state);
+    void dispatch_synthesized(MirInputEvent const* event, Contacts const& contacts);
 };
 }
 }
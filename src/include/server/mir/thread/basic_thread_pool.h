@@ -21,6 +21,7 @@
 
 #include <functional>
 #include <future>
+#include <list>
 #include <vector>
 #include <memory>
 #include <mutex>
@@ -39,21 +40,54 @@ public:
 
     std::future<void> run(std::function<void()> const& task);
 
+    /**
+     * Runs tasks with the same (non-null) id, one at a time, on the same
+     * thread. A thread keeps serving its id until the pool is shrunk.
+     */
     typedef void const* TaskId;
     std::future<void> run(std::function<void()> const& task, TaskId id);
 
+    /**
+     * Runs task once all of the dependencies are ready. The task waits in
+     * the pool meanwhile, not on a thread of its own; if a dependency
+     * failed, the task is skipped and the returned future holds the
+     * exception instead.
+     *
+     * Dependencies must be futures of tasks run by this pool: the pool
+     * looks for the tasks it holds back only when one of its own finishes.
+     */
+    std::future<void> run_after(
+        std::vector<std::shared_future<void>> const& dependencies,
+        std::function<void()> const& task);
+    std::future<void> run_after(
+        std::vector<std::shared_future<void>> const& dependencies,
+        std::function<void()> const& task,
+        TaskId id);
+
     void shrink();
 
 private:
     BasicThreadPool(BasicThreadPool const&) = delete;
     BasicThreadPool& operator=(BasicThreadPool const&) = delete;
 
+    struct HeldTask
+    {
+        std::vector<std::shared_future<void>> dependencies;
+        std::function<void()> task;
+        TaskId id;
+        std::promise<void> done;
+    };
+
     std::future<void> run(WorkerThread* t, std::function<void()> const& task, TaskId id);
+    void queue(WorkerThread* t, std::function<void()> const& task, std::promise<void>&& done, TaskId id);
+    void release_held_tasks_locked();
+    void task_done();
     WorkerThread *find_thread_by(TaskId id);
-    WorkerThread *find_idle_thread();
+    WorkerThread *find_idle_thread(TaskId id);
 
     std::mutex mutex;
     int const min_threads;
+    std::list<HeldTask> held_tasks;
     std::vector<std::unique_ptr<WorkerThread>> threads;
 };
 
@@ -0,0 +1,292 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/graphics/content_hash.h"
+
+#include <boost/throw_exception.hpp>
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define MIR_CONTENT_HASH_X86
+#include <immintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define MIR_CONTENT_HASH_NEON
+#include <arm_neon.h>
+#endif
+
+namespace mg = mir::graphics;
+
+/*
+ * The hash runs four 64-bit lanes over the data, 32-byte stripe by stripe.
+ * Each 8-byte word of a stripe goes into its neighbouring lane as is, and
+ * into its own lane as the product of its halves, once mixed with a key.
+ * The lanes are scrambled after each block of stripes, so that later words
+ * can't cancel out earlier ones, and avalanched together at the end. The
+ * kernels only differ in how many lanes they work on at once.
+ */
+namespace
+{
+size_t const stripe_size{32};
+size_t const stripes_per_block{16};
+
+uint64_t const key[4]{0xbe4ba423396cfeb8, 0x1cad21f72c81017c, 0xdb979083e96dd4de, 0x1f67b3b7a4a44072};
+uint32_t const prime32{0x9e3779b1};
+uint64_t const prime64_1{0x9e3779b185ebca87};
+uint64_t const prime64_2{0xc2b2ae3d27d4eb4f};
+
+typedef void (*AccumulateKernel)(uint64_t* acc, uint8_t const* data, size_t stripes);
+
+struct Kernel
+{
+    AccumulateKernel accumulate;
+    char const* name;
+};
+
+inline bool ends_block(size_t stripe)
+{
+    return (stripe + 1) % stripes_per_block == 0;
+}
+
+void accumulate_stripe(uint64_t* acc, uint8_t const* stripe)
+{
+    for (size_t i = 0; i != 4; ++i)
+    {
+        uint64_t word;
+        memcpy(&word, stripe + 8 * i, sizeof word);
+        auto const keyed = word ^ key[i];
+        acc[i ^ 1] += word;
+        acc[i] += (keyed & 0xffffffff) * (keyed >> 32);
+    }
+}
+
+void accumulate_scalar(uint64_t* acc, uint8_t const* data, size_t stripes)
+{
+    for (size_t s = 0; s != stripes; ++s)
+    {
+        accumulate_stripe(acc, data + s * stripe_size);
+
+        if (ends_block(s))
+        {
+            for (size_t i = 0; i != 4; ++i)
+                acc[i] = (acc[i] ^ (acc[i] >> 47) ^ key[i]) * prime32;
+        }
+    }
+}
+
+#ifdef MIR_CONTENT_HASH_X86
+// Multiplies each 64-bit lane by a 32-bit constant, modulo 2^64
+__attribute__((target("sse2")))
+inline __m128i mul64_sse2(__m128i x, __m128i constant)
+{
+    auto const lo = _mm_mul_epu32(x, constant);
+    auto const hi = _mm_mul_epu32(_mm_srli_epi64(x, 32), constant);
+    return _mm_add_epi64(lo, _mm_slli_epi64(hi, 32));
+}
+
+__attribute__((target("sse2")))
+void accumulate_sse2(uint64_t* acc, uint8_t const* data, size_t stripes)
+{
+    __m128i lanes[2]{
+        _mm_loadu_si128(reinterpret_cast<__m128i const*>(acc)),
+        _mm_loadu_si128(reinterpret_cast<__m128i const*>(acc + 2))};
+    __m128i const keys[2]{
+        _mm_loadu_si128(reinterpret_cast<__m128i const*>(key)),
+        _mm_loadu_si128(reinterpret_cast<__m128i const*>(key + 2))};
+    auto const prime = _mm_set1_epi32(prime32);
+
+    for (size_t s = 0; s != stripes; ++s)
+    {
+        for (size_t j = 0; j != 2; ++j)
+        {
+            auto const words = _mm_loadu_si128(reinterpret_cast<__m128i const*>(data + s * stripe_size + 16 * j));
+            auto const keyed = _mm_xor_si128(words, keys[j]);
+            auto const product = _mm_mul_epu32(keyed, _mm_srli_epi64(keyed, 32));
+            auto const swapped = _mm_shuffle_epi32(words, _MM_SHUFFLE(1, 0, 3, 2));
+            lanes[j] = _mm_add_epi64(lanes[j], _mm_add_epi64(product, swapped));
+        }
+
+        if (ends_block(s))
+        {
+            for (size_t j = 0; j != 2; ++j)
+            {
+                auto const mixed = _mm_xor_si128(_mm_xor_si128(lanes[j], _mm_srli_epi64(lanes[j], 47)), keys[j]);
+                lanes[j] = mul64_sse2(mixed, prime);
+            }
+        }
+    }
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(acc), lanes[0]);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(acc + 2), lanes[1]);
+}
+
+__attribute__((target("avx2")))
+void accumulate_avx2(uint64_t* acc, uint8_t const* data, size_t stripes)
+{
+    auto lanes = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(acc));
+    auto const keys = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(key));
+    auto const prime = _mm256_set1_epi32(prime32);
+
+    for (size_t s = 0; s != stripes; ++s)
+    {
+        auto const words = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(data + s * stripe_size));
+        auto const keyed = _mm256_xor_si256(words, keys);
+        auto const product = _mm256_mul_epu32(keyed, _mm256_srli_epi64(keyed, 32));
+        // Shuffles work within 128-bit halves, so each word meets its neighbour
+        auto const swapped = _mm256_shuffle_epi32(words, _MM_SHUFFLE(1, 0, 3, 2));
+        lanes = _mm256_add_epi64(lanes, _mm256_add_epi64(product, swapped));
+
+        if (ends_block(s))
+        {
+            auto const mixed = _mm256_xor_si256(_mm256_xor_si256(lanes, _mm256_srli_epi64(lanes, 47)), keys);
+            auto const lo = _mm256_mul_epu32(mixed, prime);
+            auto const hi = _mm256_mul_epu32(_mm256_srli_epi64(mixed, 32), prime);
+            lanes = _mm256_add_epi64(lo, _mm256_slli_epi64(hi, 32));
+        }
+    }
+
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(acc), lanes);
+}
+#endif
+
+#ifdef MIR_CONTENT_HASH_NEON
+void accumulate_neon(uint64_t* acc, uint8_t const* data, size_t stripes)
+{
+    uint64x2_t lanes[2]{vld1q_u64(acc), vld1q_u64(acc + 2)};
+    uint64x2_t const keys[2]{vld1q_u64(key), vld1q_u64(key + 2)};
+    auto const prime = vdup_n_u32(prime32);
+
+    for (size_t s = 0; s != stripes; ++s)
+    {
+        for (size_t j = 0; j != 2; ++j)
+        {
+            auto const words = vreinterpretq_u64_u8(vld1q_u8(data + s * stripe_size + 16 * j));
+            auto const keyed = veorq_u64(words, keys[j]);
+            auto const product = vmull_u32(vmovn_u64(keyed), vshrn_n_u64(keyed, 32));
+            auto const swapped = vextq_u64(words, words, 1);
+            lanes[j] = vaddq_u64(lanes[j], vaddq_u64(product, swapped));
+        }
+
+        if (ends_block(s))
+        {
+            for (size_t j = 0; j != 2; ++j)
+            {
+                auto const mixed = veorq_u64(veorq_u64(lanes[j], vshrq_n_u64(lanes[j], 47)), keys[j]);
+                auto const lo = vmull_u32(vmovn_u64(mixed), prime);
+                auto const hi = vmull_u32(vshrn_n_u64(mixed, 32), prime);
+                lanes[j] = vaddq_u64(lo, vshlq_n_u64(hi, 32));
+            }
+        }
+    }
+
+    vst1q_u64(acc, lanes[0]);
+    vst1q_u64(acc + 2, lanes[1]);
+}
+#endif
+
+// Murmur3's finaliser: each bit of the input flips each bit of the output half the time
+inline uint64_t avalanche(uint64_t h)
+{
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccd;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53;
+    h ^= h >> 33;
+    return h;
+}
+
+// Fastest first
+std::vector<Kernel> supported_kernels()
+{
+    std::vector<Kernel> kernels;
+#if defined(MIR_CONTENT_HASH_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        kernels.push_back({accumulate_avx2, "avx2"});
+    if (__builtin_cpu_supports("sse2"))
+        kernels.push_back({accumulate_sse2, "sse2"});
+#elif defined(MIR_CONTENT_HASH_NEON)
+    kernels.push_back({accumulate_neon, "neon"});
+#endif
+    kernels.push_back({accumulate_scalar, "scalar"});
+    return kernels;
+}
+
+std::vector<Kernel> const& kernels()
+{
+    static auto const supported = supported_kernels();
+    return supported;
+}
+
+Kernel const& kernel()
+{
+    return kernels().front();
+}
+
+uint64_t hash_with(Kernel const& kernel, void const* data, size_t count)
+{
+    auto const bytes = static_cast<uint8_t const*>(data);
+    uint64_t acc[4]{prime32, prime64_1, prime64_2, prime64_1 ^ prime64_2};
+
+    auto const stripes = count / stripe_size;
+    kernel.accumulate(acc, bytes, stripes);
+
+    // The last part-stripe is padded with zeros; the count tells it apart
+    if (auto const rest = count % stripe_size)
+    {
+        uint8_t last[stripe_size]{};
+        memcpy(last, bytes + stripes * stripe_size, rest);
+        accumulate_stripe(acc, last);
+    }
+
+    auto hash = count * prime64_1;
+    for (auto lane : acc)
+        hash = (hash ^ avalanche(lane)) * prime64_2;
+
+    return avalanche(hash);
+}
+}
+
+uint64_t mg::content_hash(void const* data, size_t count)
+{
+    return hash_with(kernel(), data, count);
+}
+
+uint64_t mg::content_hash(void const* data, size_t count, char const* kernel)
+{
+    for (auto const& supported : kernels())
+    {
+        if (strcmp(supported.name, kernel) == 0)
+            return hash_with(supported, data, count);
+    }
+
+    BOOST_THROW_EXCEPTION(std::invalid_argument{std::string{"Content hash kernel not supported: "} + kernel});
+}
+
+char const* mg::content_hash_kernel()
+{
+    return kernel().name;
+}
+
+std::vector<char const*> mg::content_hash_kernels()
+{
+    std::vector<char const*> names;
+    for (auto const& supported : kernels())
+        names.push_back(supported.name);
+    return names;
+}
@@ -119,6 +119,7 @@ std::ostream& mg::operator<<(std::ostream& out, mg::DisplayConfigurationOutput c
     out << "\tscale: " << val.scale << std::endl;
     out << "\tform factor: " << as_string(val.form_factor) << std::endl;
     out << "\torientation: " << val.orientation << '\n';
+    out << "\tvariable refresh: " << (val.variable_refresh_capable ? "capable" : "incapable") << '\n';
     out << "}" << std::endl;
 
     return out;
@@ -297,7 +298,8 @@ mg::UserDisplayConfigurationOutput::UserDisplayConfigurationOutput(
         subpixel_arrangement(master.subpixel_arrangement),
         gamma(master.gamma),
         gamma_supported(master.gamma_supported),
-        edid(*reinterpret_cast<std::vector<uint8_t const>*>(&master.edid))
+        edid(*reinterpret_cast<std::vector<uint8_t const>*>(&master.edid)),
+        variable_refresh_capable(master.variable_refresh_capable)
 {
 }
 
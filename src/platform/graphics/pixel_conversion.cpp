@@ -0,0 +1,188 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/graphics/pixel_conversion.h"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define MIR_PIXEL_CONVERSION_X86
+#include <immintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define MIR_PIXEL_CONVERSION_NEON
+#include <arm_neon.h>
+#endif
+
+namespace mg = mir::graphics;
+namespace geom = mir::geometry;
+
+namespace
+{
+typedef void (*SwapKernel)(uint8_t const* src, uint8_t* dst, size_t count);
+
+struct Kernels
+{
+    SwapKernel swap_red_and_blue;
+    char const* name;
+};
+
+inline uint32_t swap_red_and_blue(uint32_t p)
+{
+    return ((p << 16) & 0x00ff0000) | /* Move R to new position */
+           ((p) & 0xff00ff00) |       /* G and A remain at same position */
+           ((p >> 16) & 0x000000ff);  /* Move B to new position */
+}
+
+void swap_scalar(uint8_t const* src, uint8_t* dst, size_t count)
+{
+    for (size_t i = 0; i != count; ++i)
+    {
+        uint32_t p;
+        memcpy(&p, src + 4 * i, sizeof p);
+        p = swap_red_and_blue(p);
+        memcpy(dst + 4 * i, &p, sizeof p);
+    }
+}
+
+#ifdef MIR_PIXEL_CONVERSION_X86
+__attribute__((target("sse2")))
+void swap_sse2(uint8_t const* src, uint8_t* dst, size_t count)
+{
+    auto const green_alpha = _mm_set1_epi32(0xff00ff00);
+    auto const red_blue = _mm_set1_epi32(0x00ff00ff);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        auto const p = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + 4 * i));
+        auto const rb = _mm_and_si128(p, red_blue);
+        auto const br = _mm_or_si128(_mm_slli_epi32(rb, 16), _mm_srli_epi32(rb, 16));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4 * i),
+                         _mm_or_si128(_mm_and_si128(p, green_alpha), br));
+    }
+
+    swap_scalar(src + 4 * i, dst + 4 * i, count - i);
+}
+
+__attribute__((target("avx2")))
+void swap_avx2(uint8_t const* src, uint8_t* dst, size_t count)
+{
+    auto const shuffle = _mm256_setr_epi8(
+        2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+        2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        auto const p = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(src + 4 * i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 4 * i), _mm256_shuffle_epi8(p, shuffle));
+    }
+
+    swap_scalar(src + 4 * i, dst + 4 * i, count - i);
+}
+#endif
+
+#ifdef MIR_PIXEL_CONVERSION_NEON
+void swap_neon(uint8_t const* src, uint8_t* dst, size_t count)
+{
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        auto p = vld4q_u8(src + 4 * i);
+        auto const r = p.val[0];
+        p.val[0] = p.val[2];
+        p.val[2] = r;
+        vst4q_u8(dst + 4 * i, p);
+    }
+
+    swap_scalar(src + 4 * i, dst + 4 * i, count - i);
+}
+#endif
+
+Kernels select_kernels()
+{
+#if defined(MIR_PIXEL_CONVERSION_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return {swap_avx2, "avx2"};
+    if (__builtin_cpu_supports("sse2"))
+        return {swap_sse2, "sse2"};
+#elif defined(MIR_PIXEL_CONVERSION_NEON)
+    return {swap_neon, "neon"};
+#endif
+    return {swap_scalar, "scalar"};
+}
+
+Kernels const& kernels()
+{
+    static Kernels const selected = select_kernels();
+    return selected;
+}
+}
+
+void mg::copy_swapping_red_and_blue(void const* src, void* dst, size_t count)
+{
+    kernels().swap_red_and_blue(static_cast<uint8_t const*>(src), static_cast<uint8_t*>(dst), count);
+}
+
+void mg::flip_rows_8888(void* pixels, geom::Size size, geom::Stride stride, bool swap_red_and_blue)
+{
+    auto const width = size.width.as_uint32_t();
+    auto const height = size.height.as_uint32_t();
+    auto const stride_bytes = stride.as_uint32_t();
+    auto const row_bytes = width * 4;
+    auto const swap = kernels().swap_red_and_blue;
+    auto const base = static_cast<uint8_t*>(pixels);
+
+    if (height == 0)
+        return;
+
+    std::vector<uint8_t> tmp(row_bytes);
+
+    uint32_t top = 0;
+    uint32_t bottom = height - 1;
+    for (; top < bottom; ++top, --bottom)
+    {
+        auto const top_row = base + size_t{top} * stride_bytes;
+        auto const bottom_row = base + size_t{bottom} * stride_bytes;
+
+        if (swap_red_and_blue)
+        {
+            swap(top_row, tmp.data(), width);
+            swap(bottom_row, top_row, width);
+        }
+        else
+        {
+            memcpy(tmp.data(), top_row, row_bytes);
+            memcpy(top_row, bottom_row, row_bytes);
+        }
+        memcpy(bottom_row, tmp.data(), row_bytes);
+    }
+
+    /* Process middle line if there is one */
+    if (top == bottom && swap_red_and_blue)
+    {
+        auto const middle_row = base + size_t{top} * stride_bytes;
+        swap(middle_row, middle_row, width);
+    }
+}
+
+char const* mg::pixel_conversion_kernels()
+{
+    return kernels().name;
+}
@@ -19,9 +19,148 @@
 #include "mir/log.h"
 #include "mir/graphics/platform.h"
 #include "mir/graphics/platform_probe.h"
+#include "mir/options/configuration.h"
+#include "mir/shared_library_prober.h"
 
+#include <boost/filesystem.hpp>
 #include <boost/throw_exception.hpp>
 
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace mg = mir::graphics;
+
+namespace
+{
+char const* const cache_header = "mir-platform-probe-cache 2";
+
+auto probe(mir::SharedLibrary const& module, mir::options::ProgramOption const& options)
+-> mg::PlatformPriority
+{
+    auto probe = module.load_function<mg::PlatformProbe>(
+         "probe_graphics_platform",
+         MIR_SERVER_GRAPHICS_PLATFORM_VERSION);
+
+    return probe(options);
+}
+
+void describe(mir::SharedLibrary const& module)
+{
+    auto describe = module.load_function<mg::DescribeModule>(
+        "describe_graphics_module",
+        MIR_SERVER_GRAPHICS_PLATFORM_VERSION);
+    auto desc = describe();
+    mir::log_info("Found graphics driver: %s (version %d.%d.%d)",
+                  desc->name,
+                  desc->major_version,
+                  desc->minor_version,
+                  desc->micro_version);
+}
+
+// One line per library: "<size> <modification time> <filename>"
+auto signature_of(std::vector<std::string> const& libraries) -> std::vector<std::string>
+{
+    std::vector<std::string> signature;
+
+    for (auto const& library : libraries)
+    {
+        boost::system::error_code ec;
+        auto const size = boost::filesystem::file_size(library, ec);
+        auto const mtime = boost::filesystem::last_write_time(library, ec);
+
+        std::ostringstream line;
+        line << (ec ? 0 : size) << ' ' << (ec ? 0 : mtime) << ' ' << library;
+        signature.push_back(line.str());
+    }
+
+    return signature;
+}
+
+// What the platform probes look at besides the libraries themselves: the
+// display devices present, and whether a host server is available to nest in.
+// A change to any of these can make another platform the better choice.
+auto environment_signature(mir::options::ProgramOption const& options) -> std::vector<std::string>
+{
+    std::vector<std::string> signature;
+
+    auto const display = getenv("DISPLAY");
+    signature.push_back(std::string{"env DISPLAY="} + (display ? display : ""));
+
+    signature.push_back(std::string{"option "} + mir::options::host_socket_opt + "=" +
+        (options.is_set(mir::options::host_socket_opt) ?
+            options.get<std::string>(mir::options::host_socket_opt) : ""));
+
+    std::vector<std::string> devices;
+    boost::system::error_code ec;
+    for (boost::filesystem::directory_iterator i{"/dev/dri", ec}, end; !ec && i != end; i.increment(ec))
+        devices.push_back("device " + i->path().string());
+
+    std::sort(devices.begin(), devices.end());
+    signature.insert(signature.end(), devices.begin(), devices.end());
+
+    return signature;
+}
+
+struct CachedSelection
+{
+    mg::PlatformPriority priority;
+    std::string library;
+};
+
+auto read_cache(std::string const& cache_file, std::vector<std::string> const& signature)
+-> std::unique_ptr<CachedSelection>
+{
+    std::ifstream in{cache_file};
+    std::string line;
+
+    if (!std::getline(in, line) || line != cache_header)
+        return {};
+
+    uint32_t priority;
+    std::string library;
+    if (!(in >> priority) || !std::getline(in >> std::ws, library))
+        return {};
+
+    std::vector<std::string> cached_signature;
+    while (std::getline(in, line))
+        cached_signature.push_back(line);
+
+    if (cached_signature != signature)
+        return {};
+
+    return std::unique_ptr<CachedSelection>{
+        new CachedSelection{static_cast<mg::PlatformPriority>(priority), library}};
+}
+
+void write_cache(
+    std::string const& cache_file,
+    std::vector<std::string> const& signature,
+    mg::PlatformPriority priority,
+    std::string const& library)
+{
+    // Write and rename so that a concurrently starting server never reads a partial cache
+    auto const temp_file = cache_file + ".new";
+    {
+        std::ofstream out{temp_file, std::ios::trunc};
+        out << cache_header << '\n' << priority << ' ' << library << '\n';
+        for (auto const& line : signature)
+            out << line << '\n';
+
+        if (!out.flush())
+        {
+            mir::log_warning("Failed to write platform probe cache: %s", temp_file.c_str());
+            return;
+        }
+    }
+
+    if (rename(temp_file.c_str(), cache_file.c_str()) != 0)
+        mir::log_warning("Failed to write platform probe cache: %s", cache_file.c_str());
+}
+}
+
 std::shared_ptr<mir::SharedLibrary>
 mir::graphics::module_for_device(std::vector<std::shared_ptr<SharedLibrary>> const& modules, mir::options::ProgramOption const& options)
 {
@@ -31,26 +170,14 @@ mir::graphics::module_for_device(std::vector<std::shared_ptr<SharedLibrary>> con
     {
         try
         {
-            auto probe = module->load_function<PlatformProbe>(
-                 "probe_graphics_platform",
-                 MIR_SERVER_GRAPHICS_PLATFORM_VERSION);
-
-            auto module_priority = probe(options);
+            auto module_priority = probe(*module, options);
             if (module_priority > best_priority_so_far)
             {
                 best_priority_so_far = module_priority;
                 best_module_so_far = module;
             }
 
-            auto describe = module->load_function<DescribeModule>(
-                "describe_graphics_module",
-                MIR_SERVER_GRAPHICS_PLATFORM_VERSION);
-            auto desc = describe();
-            mir::log_info("Found graphics driver: %s (version %d.%d.%d)",
-                          desc->name,
-                          desc->major_version,
-                          desc->minor_version,
-                          desc->micro_version);
+            describe(*module);
         }
         catch (std::runtime_error const&)
         {
@@ -62,3 +189,74 @@ mir::graphics::module_for_device(std::vector<std::shared_ptr<SharedLibrary>> con
     }
     BOOST_THROW_EXCEPTION((std::runtime_error{"Failed to find platform for current system"}));
 }
+
+std::shared_ptr<mir::SharedLibrary>
+mir::graphics::module_for_device(
+    std::string const& path,
+    std::string const& cache_file,
+    mir::options::ProgramOption const& options,
+    mir::SharedLibraryProberReport& report)
+{
+    auto const libraries = mir::library_filenames_for_path(path, report);
+    if (libraries.empty())
+    {
+        BOOST_THROW_EXCEPTION((std::runtime_error{"Failed to find any platform plugins in: " + path}));
+    }
+
+    auto signature = signature_of(libraries);
+    auto const environment = environment_signature(options);
+    signature.insert(signature.end(), environment.begin(), environment.end());
+
+    if (auto const cached = read_cache(cache_file, signature))
+    {
+        try
+        {
+            report.loading_library(cached->library);
+            auto const module = std::make_shared<mir::SharedLibrary>(cached->library);
+
+            if (probe(*module, options) == cached->priority)
+            {
+                describe(*module);
+                return module;
+            }
+        }
+        catch (std::runtime_error const& err)
+        {
+            report.loading_failed(cached->library, err);
+        }
+
+        mir::log_info("Platform probe cache is stale, probing all platform plugins");
+    }
+
+    mir::graphics::PlatformPriority best_priority_so_far = mir::graphics::unsupported;
+    std::shared_ptr<mir::SharedLibrary> best_module_so_far;
+    std::string best_library_so_far;
+    for (auto const& library : libraries)
+    {
+        try
+        {
+            report.loading_library(library);
+            auto const module = std::make_shared<mir::SharedLibrary>(library);
+
+            auto module_priority = probe(*module, options);
+            if (module_priority > best_priority_so_far)
+            {
+                best_priority_so_far = module_priority;
+                best_module_so_far = module;
+                best_library_so_far = library;
+            }
+
+            describe(*module);
+        }
+        catch (std::runtime_error const& err)
+        {
+            report.loading_failed(library, err);
+        }
+    }
+    if (best_priority_so_far > mir::graphics::unsupported)
+    {
+        write_cache(cache_file, signature, best_priority_so_far, best_library_so_far);
+        return best_module_so_far;
+    }
+    BOOST_THROW_EXCEPTION((std::runtime_error{"Failed to find platform for current system"}));
+}
@@ -53,6 +53,13 @@ char const* const mo::cursor_opt                  = "cursor";
 char const* const mo::fatal_except_opt            = "on-fatal-error-except";
 char const* const mo::debug_opt                   = "debug";
 char const* const mo::composite_delay_opt         = "composite-delay";
+char const* const mo::parallel_outputs_opt        = "parallel-outputs";
+char const* const mo::skip_unchanged_frames_opt   = "skip-unchanged-frames";
+char const* const mo::gl_program_cache_opt        = "gl-program-cache";
+char const* const mo::renderer_opt                = "renderer";
+char const* const mo::async_log_opt               = "async-log";
+char const* const mo::input_dispatch_queue_opt    = "input-dispatch-queue";
+char const* const mo::input_reader_priority_opt   = "input-reader-priority";
 char const* const mo::enable_key_repeat_opt       = "enable-key-repeat";
 
 char const* const mo::off_opt_value = "off";
@@ -62,6 +69,7 @@ char const* const mo::lttng_opt_value = "lttng";
 char const* const mo::platform_graphics_lib = "platform-graphics-lib";
 char const* const mo::platform_input_lib = "platform-input-lib";
 char const* const mo::platform_path = "platform-path";
+char const* const mo::platform_probe_cache_opt = "platform-probe-cache";
 
 namespace
 {
@@ -152,6 +160,10 @@ mo::DefaultConfiguration::DefaultConfiguration(
             "Library to use for platform input support (default: input-stub.so)")
         (platform_path, po::value<std::string>()->default_value(MIR_SERVER_PLATFORM_PATH),
             "Directory to look for platform libraries (default: " MIR_SERVER_PLATFORM_PATH ")")
+        (platform_probe_cache_opt, po::value<std::string>(),
+            "File in which to cache the result of probing the platform libraries. "
+            "The cache is revalidated against the libraries' modification times, the DRM devices present, "
+            "$DISPLAY and the host socket. (default: no cache)")
         (enable_input_opt, po::value<bool>()->default_value(enable_input_default),
             "Enable input.")
         (compositor_report_opt, po::value<std::string>()->default_value(off_opt_value),
@@ -181,6 +193,36 @@ mo::DefaultConfiguration::DefaultConfiguration(
             "frames from clients before compositing). Higher values result in "
             "lower latency but risk causing frame skipping. "
             "Default: A negative value means decide automatically.")
+        (parallel_outputs_opt, po::value<bool>()->default_value(false),
+            "Prepare the scene once per frame for all the outputs that are "
+            "synchronised together, then cull and draw each of them on a "
+            "thread of its own. Only platforms that synchronise outputs "
+            "together (android) gain from this; on mesa each output is "
+            "composited on its own already, so it does nothing there.")
+        (skip_unchanged_frames_opt, po::value<bool>()->default_value(false),
+            "Hand a client's shm buffer straight back, without compositing, "
+            "when its pixels are the same as those of the frame before. Saves "
+            "redrawing still content, but clients that draw as fast as their "
+            "buffers come back lose their pacing while it stays still.")
+        (gl_program_cache_opt, po::value<std::string>(),
+            "Directory in which to cache compiled GL programs, so that later "
+            "runs on the same driver start compositing sooner. (default: no cache)")
+        (renderer_opt, po::value<std::string>()->default_value("gl"),
+            "Compositing renderer [{gl,software}]. The software renderer draws "
+            "offscreen outputs and, with mesa-kms, outputs in dumb buffers "
+            "using the CPU, and only redraws what changes.")
+        (async_log_opt, po::value<int>(),
+            "Write log messages from a thread of their own, buffering up to this "
+            "many KiB per logging thread. Messages that do not fit are dropped "
+            "and counted. (default: log synchronously)")
+        (input_dispatch_queue_opt, po::value<int>(),
+            "Dispatch input events from a thread of their own, queuing up to this "
+            "many events read from devices, so that slow event filters or clients "
+            "don't hold up reading them. (default: dispatch as they are read)")
+        (input_reader_priority_opt, po::value<int>(),
+            "Read input devices from a thread with this SCHED_FIFO real-time "
+            "priority [1-99], which needs CAP_SYS_NICE. Requires --input-dispatch-queue, "
+            "so that only reading runs real-time. (default: normal scheduling)")
         (name_opt, po::value<std::string>(),
             "When nested, the name Mir uses when registering with the host.")
         (nested_passthrough_opt, po::value<bool>()->default_value(true),
@@ -214,6 +256,9 @@ void mo::DefaultConfiguration::add_platform_options()
         (platform_path,
          po::value<std::string>()->default_value(MIR_SERVER_PLATFORM_PATH),
         "");
+    program_options.add_options()
+        (platform_probe_cache_opt,
+         po::value<std::string>(), "");
     mo::ProgramOption options;
     options.parse_arguments(program_options, argc, argv);
 
@@ -234,8 +279,16 @@ void mo::DefaultConfiguration::add_platform_options()
         {
             mir::logging::NullSharedLibraryProberReport null_report;
             auto const plugin_path = env_libpath ? env_libpath : options.get<std::string>(platform_path);
-            auto plugins = mir::libraries_for_path(plugin_path, null_report);
-            platform_graphics_library = mir::graphics::module_for_device(plugins, options);
+            if (options.is_set(platform_probe_cache_opt))
+            {
+                platform_graphics_library = mir::graphics::module_for_device(
+                    plugin_path, options.get<std::string>(platform_probe_cache_opt), options, null_report);
+            }
+            else
+            {
+                auto plugins = mir::libraries_for_path(plugin_path, null_report);
+                platform_graphics_library = mir::graphics::module_for_device(plugins, options);
+            }
         }
 
         auto add_platform_options = platform_graphics_library->load_function<mir::graphics::AddPlatformOptions>("add_graphics_platform_options", MIR_SERVER_GRAPHICS_PLATFORM_VERSION);
@@ -210,13 +210,18 @@ mg::NativeBufferBase* mga::Buffer::native_buffer_base()
     return this;
 }
 
-void mga::Buffer::secure_for_render()
+bool mga::Buffer::secure_for_render()
 {
     std::unique_lock<std::mutex> lk(content_lock);
     secure_for_render(lk);
+    return true;
 }
 
 void mga::Buffer::secure_for_render(std::unique_lock<std::mutex> const&)
 {
     native_buffer->lock_for_gpu();
 }
+
+void mga::Buffer::rendering_finished()
+{
+}
@@ -63,7 +63,8 @@ public:
     MirPixelFormat pixel_format() const override;
     void gl_bind_to_texture() override;
     void bind() override;
-    void secure_for_render() override;
+    bool secure_for_render() override;
+    void rendering_finished() override;
 
     void bind_for_write() override;
 
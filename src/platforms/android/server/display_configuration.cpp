@@ -69,7 +69,8 @@ mg::DisplayConfigurationOutput make_virtual_config()
         subpixel_arrangement,
         {},
         mir_output_gamma_unsupported,
-        {}
+        {},
+        false
     };
 }
 }
@@ -179,7 +179,8 @@ mg::DisplayConfigurationOutput populate_config(
         mir_subpixel_arrangement_unknown,
         {},
         mir_output_gamma_unsupported,
-        {}
+        {},
+        false
     };
 }
 
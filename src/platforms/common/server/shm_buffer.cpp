@@ -180,6 +180,11 @@ void mgc::ShmBuffer::bind()
     gl_bind_to_texture();
 }
 
-void mgc::ShmBuffer::secure_for_render()
+bool mgc::ShmBuffer::secure_for_render()
+{
+    return true;
+}
+
+void mgc::ShmBuffer::rendering_finished()
 {
 }
@@ -51,7 +51,8 @@ public:
     MirPixelFormat pixel_format() const override;
     void gl_bind_to_texture() override;
     void bind() override;
-    void secure_for_render() override;
+    bool secure_for_render() override;
+    void rendering_finished() override;
     void write(unsigned char const* data, size_t size) override;
     void read(std::function<void(unsigned char const*)> const& do_with_pixels) override;
     NativeBufferBase* native_buffer_base() override;
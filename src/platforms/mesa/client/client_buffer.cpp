@@ -27,7 +27,9 @@
 #include <stdexcept>
 
 #include <errno.h>
+#include <poll.h>
 #include <sys/mman.h>
+#include <unistd.h>
 
 namespace mcl=mir::client;
 namespace mclm=mir::client::mesa;
@@ -76,6 +78,18 @@ struct ShmMemoryRegion : mcl::MemoryRegion
     size_t const size_in_bytes;
 };
 
+bool wait_for(mir::Fd const& fence, std::chrono::milliseconds timeout)
+{
+    pollfd pfd{fence, POLLIN, 0};
+    int const timeout_ms = timeout.count() < 0 ? -1 : timeout.count();
+
+    int result;
+    while ((result = poll(&pfd, 1, timeout_ms)) < 0 && (errno == EINTR || errno == EAGAIN))
+        ;
+
+    return result != 0;
+}
+
 std::shared_ptr<mir::graphics::mesa::NativeBuffer> to_native_buffer(
     MirBufferPackage const& package, bool gbm, uint32_t native_format, uint32_t native_flags)
 {
@@ -147,6 +161,8 @@ mclm::ClientBuffer::~ClientBuffer() noexcept
 
 std::shared_ptr<mcl::MemoryRegion> mclm::ClientBuffer::secure_for_cpu_write()
 {
+    wait_for_access(mir_read_write, std::chrono::milliseconds{-1});
+
     int const buffer_fd = creation_package->fd[0];
 
     return std::make_shared<ShmMemoryRegion>(buffer_file_ops,
@@ -177,14 +193,81 @@ std::shared_ptr<mir::graphics::NativeBuffer> mclm::ClientBuffer::native_buffer_h
     return creation_package;
 }
 
-void mclm::ClientBuffer::update_from(MirBufferPackage const&)
+void mclm::ClientBuffer::update_from(MirBufferPackage const& update_package)
 {
+    // The server may still be reading from the buffer it has returned
+    if ((update_package.flags & mir_buffer_flag_fenced) && (update_package.fd_items != 0))
+        associate_fence(Fd{update_package.fd[0]}, mir_read);
 }
 
 void mclm::ClientBuffer::fill_update_msg(MirBufferPackage& package)
 {
     package.data_items = 0;
     package.fd_items = 0;
+    package.flags = 0;
+
+    std::lock_guard<std::mutex> lock{fence_mutex};
+
+    // Only the client's own writes need to be waited for by the server
+    if (content_fence != Fd::invalid && fenced_access == mir_read_write)
+    {
+        package.flags = mir_buffer_flag_fenced;
+        package.fd[0] = dup(content_fence);
+        package.fd_items = 1;
+    }
+
+    // The buffer is the server's until it is returned
+    content_fence = Fd{};
+    fenced_access = mir_none;
+}
+
+int mclm::ClientBuffer::fence() const
+{
+    std::lock_guard<std::mutex> lock{fence_mutex};
+    return content_fence;
+}
+
+void mclm::ClientBuffer::associate_fence(Fd const& fence, MirBufferAccess access)
+{
+    std::lock_guard<std::mutex> lock{fence_mutex};
+
+    if (fence == Fd::invalid || access == mir_none)
+    {
+        content_fence = Fd{};
+        fenced_access = mir_none;
+    }
+    else
+    {
+        content_fence = fence;
+        fenced_access = access;
+    }
+}
+
+bool mclm::ClientBuffer::wait_for_access(MirBufferAccess access, std::chrono::milliseconds timeout)
+{
+    Fd fence;
+    {
+        std::lock_guard<std::mutex> lock{fence_mutex};
+
+        // Concurrent reads don't need to wait for each other
+        if (access == mir_read && fenced_access == mir_read)
+            return true;
+        fence = content_fence;
+    }
+
+    if (fence == Fd::invalid)
+        return true;
+
+    if (!wait_for(fence, timeout))
+        return false;
+
+    std::lock_guard<std::mutex> lock{fence_mutex};
+    if (content_fence == fence)
+    {
+        content_fence = Fd{};
+        fenced_access = mir_none;
+    }
+    return true;
 }
 
 MirBufferPackage* mclm::ClientBuffer::package() const
@@ -22,9 +22,13 @@
 
 #include "mir/aging_buffer.h"
 #include "mir_toolkit/mir_client_library.h"
+#include "mir_toolkit/extensions/fenced_buffers.h"
 #include "mir/geometry/rectangle.h"
+#include "mir/fd.h"
 #include "native_buffer.h"
 
+#include <chrono>
+#include <mutex>
 #include <vector>
 #include <memory>
 
@@ -61,12 +65,25 @@ public:
     MirBufferPackage* package() const;
     void egl_image_creation_parameters(EGLenum*, EGLClientBuffer*, EGLint**);
 
+    /// The fence protecting the buffer's content (ownership is retained)
+    int fence() const;
+    /// Replaces the fence protecting the buffer's content with one for access
+    /// (taking ownership). An invalid fence or mir_none clears it.
+    void associate_fence(Fd const& fence, MirBufferAccess access);
+    /// Waits until the buffer can be used for access
+    /// \returns false if timeout expired first
+    bool wait_for_access(MirBufferAccess access, std::chrono::milliseconds timeout);
+
 private:
     std::shared_ptr<BufferFileOps> const buffer_file_ops;
     std::shared_ptr<graphics::mesa::NativeBuffer> const creation_package;
     geometry::Rectangle const rect;
     MirPixelFormat const buffer_pf;
     std::vector<EGLint> egl_image_attrs;
+
+    std::mutex mutable fence_mutex;
+    Fd content_fence;
+    MirBufferAccess fenced_access{mir_none};
 };
 
 }
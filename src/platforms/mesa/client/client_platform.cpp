@@ -18,6 +18,7 @@
 
 #include "mir_toolkit/mir_client_library.h"
 #include "client_platform.h"
+#include "client_buffer.h"
 #include "client_buffer_factory.h"
 #include "mesa_native_display_container.h"
 #include "native_surface.h"
@@ -28,11 +29,13 @@
 #include "mir/mir_buffer.h"
 #include "mir/weak_egl.h"
 #include "mir/platform_message.h"
+#include "mir/uncaught.h"
 #include "mir_toolkit/mesa/platform_operation.h"
 #include "native_buffer.h"
 #include "gbm_format_conversions.h"
 
 #include <boost/throw_exception.hpp>
+#include <chrono>
 #include <stdexcept>
 #include <cstring>
 #include <mutex>
@@ -274,6 +277,66 @@ catch (...)
 {
     return 0;
 }
+mclm::ClientBuffer& mesa_client_buffer(MirBuffer* b)
+{
+    auto const buffer = reinterpret_cast<mcl::MirBuffer*>(b);
+    auto const client_buffer = dynamic_cast<mclm::ClientBuffer*>(buffer->client_buffer().get());
+    if (!client_buffer)
+        BOOST_THROW_EXCEPTION(std::invalid_argument("not a mesa buffer"));
+    return *client_buffer;
+}
+
+bool validate_access(MirBufferAccess access)
+{
+    return access == mir_none || access == mir_read || access == mir_read_write;
+}
+
+int get_fence(MirBuffer* b) noexcept
+try
+{
+    if (!b)
+        std::abort();
+    return mesa_client_buffer(b).fence();
+}
+catch (std::exception const& ex)
+{
+    MIR_LOG_UNCAUGHT_EXCEPTION(ex);
+    return mir::Fd::invalid;
+}
+
+void associate_fence(MirBuffer* b, int fence, MirBufferAccess access) noexcept
+try
+{
+    if (!b || !validate_access(access))
+        std::abort();
+    mesa_client_buffer(b).associate_fence(
+        fence <= mir::Fd::invalid ? mir::Fd{} : mir::Fd{fence}, access);
+}
+catch (std::exception const& ex)
+{
+    MIR_LOG_UNCAUGHT_EXCEPTION(ex);
+}
+
+int wait_for_access(MirBuffer* b, MirBufferAccess access, int timeout) noexcept
+try
+{
+    if (!b || !validate_access(access))
+        std::abort();
+
+    // could use std::chrono::floor once we're using C++17
+    auto const ns = std::chrono::nanoseconds(timeout);
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(ns);
+    if (ms > ns)
+        ms = ms - std::chrono::milliseconds{1};
+
+    return mesa_client_buffer(b).wait_for_access(access, timeout < 0 ? std::chrono::milliseconds{-1} : ms) ? 0 : -1;
+}
+catch (std::exception const& ex)
+{
+    MIR_LOG_UNCAUGHT_EXCEPTION(ex);
+    return -1;
+}
+
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
 MirBufferStream* get_hw_stream(
@@ -307,7 +370,8 @@ mclm::ClientPlatform::ClientPlatform(
       gbm_buffer1{allocate_buffer_gbm_legacy},
       gbm_buffer2{allocate_buffer_gbm, allocate_buffer_gbm_sync,
                  is_gbm_importable, import_fd, buffer_stride, buffer_format, buffer_flags, buffer_age},
-      hw_stream{get_hw_stream}
+      hw_stream{get_hw_stream},
+      fence_extension{get_fence, associate_fence, wait_for_access}
 {
 }
 
@@ -434,6 +498,8 @@ void* mclm::ClientPlatform::request_interface(char const* extension_name, int ve
         return &gbm_buffer1;
     if (!strcmp(extension_name, "mir_extension_gbm_buffer") && (version == 2))
         return &gbm_buffer2;
+    if (!strcmp(extension_name, "mir_extension_fenced_buffers") && (version == 1))
+        return &fence_extension;
     if (!strcmp(extension_name, "mir_extension_hardware_buffer_stream") && (version == 1))
         return &hw_stream;
 
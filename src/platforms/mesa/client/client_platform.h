@@ -23,6 +23,7 @@
 #include "mir_toolkit/extensions/set_gbm_device.h"
 #include "mir_toolkit/extensions/gbm_buffer.h"
 #include "mir_toolkit/extensions/hardware_buffer_stream.h"
+#include "mir_toolkit/extensions/fenced_buffers.h"
 
 struct gbm_device;
 
@@ -71,6 +72,7 @@ private:
     MirExtensionGbmBufferV1 gbm_buffer1;
     MirExtensionGbmBufferV2 gbm_buffer2;
     MirExtensionHardwareBufferStreamV1 hw_stream;
+    MirExtensionFencedBuffersV1 fence_extension;
 };
 
 }
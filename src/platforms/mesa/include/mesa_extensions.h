@@ -36,7 +36,8 @@ inline std::vector<ExtensionDescription> mesa_extensions()
         { "mir_extension_graphics_module", { 1 } },
         { "mir_extension_mesa_drm_auth", { 1 } },
         { "mir_extension_set_gbm_device", { 1 } },
-        { "mir_extension_hardware_buffer_stream", { 1 } }
+        { "mir_extension_hardware_buffer_stream", { 1 } },
+        { "mir_extension_fenced_buffers", { 1 } }
     };
 }
 }
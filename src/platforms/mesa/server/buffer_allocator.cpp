@@ -25,6 +25,7 @@
 #include "display_helpers.h"
 #include "software_buffer.h"
 #include "gbm_format_conversions.h"
+#include "native_fence_ops.h"
 #include "mir/graphics/egl_extensions.h"
 #include "mir/graphics/egl_error.h"
 #include "mir/graphics/buffer_properties.h"
@@ -207,6 +208,7 @@ mgm::BufferAllocator::BufferAllocator(
     mgm::BufferImportMethod const buffer_import_method)
     : device(device),
       egl_extensions(std::make_shared<mg::EGLExtensions>()),
+      fence_ops(std::make_shared<mgm::EGLNativeFenceOps>()),
       bypass_option(buffer_import_method == mgm::BufferImportMethod::dma_buf ?
                         mgm::BypassOption::prohibited :
                         bypass_option),
@@ -273,7 +275,7 @@ std::shared_ptr<mg::Buffer> mgm::BufferAllocator::alloc_buffer(
     std::shared_ptr<gbm_bo> bo{bo_raw, GBMBODeleter()};
 
     return std::make_shared<GBMBuffer>(
-        bo, native_flags, make_texture_binder(buffer_import_method, bo, egl_extensions));
+        bo, native_flags, make_texture_binder(buffer_import_method, bo, egl_extensions), fence_ops);
 } 
 
 std::shared_ptr<mg::Buffer> mgm::BufferAllocator::alloc_software_buffer(
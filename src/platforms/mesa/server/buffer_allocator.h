@@ -39,6 +39,7 @@ struct EGLExtensions;
 
 namespace mesa
 {
+class NativeFenceOps;
 
 enum class BufferImportMethod
 {
@@ -63,6 +64,7 @@ private:
 
     gbm_device* const device;
     std::shared_ptr<EGLExtensions> const egl_extensions;
+    std::shared_ptr<NativeFenceOps> const fence_ops;
 
     BypassOption const bypass_option;
     BufferImportMethod const buffer_import_method;
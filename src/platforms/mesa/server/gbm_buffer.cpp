@@ -22,6 +22,7 @@
 #include "buffer_texture_binder.h"
 #include "native_buffer.h"
 #include "gbm_format_conversions.h"
+#include "native_fence_ops.h"
 
 #include <fcntl.h>
 #include <xf86drm.h>
@@ -37,11 +38,13 @@ namespace geom=mir::geometry;
 
 mgm::GBMBuffer::GBMBuffer(std::shared_ptr<gbm_bo> const& handle,
                           uint32_t bo_flags,
-                          std::unique_ptr<mgc::BufferTextureBinder> texture_binder)
+                          std::unique_ptr<mgc::BufferTextureBinder> texture_binder,
+                          std::shared_ptr<NativeFenceOps> const& fence_ops)
     : gbm_handle{handle},
       bo_flags{bo_flags},
       texture_binder{std::move(texture_binder)},
-      prime_fd{-1}
+      prime_fd{-1},
+      fence_ops{fence_ops}
 {
     auto device = gbm_bo_get_device(gbm_handle.get());
     auto gem_handle = gbm_bo_get_handle(gbm_handle.get()).u32;
@@ -79,7 +82,8 @@ MirPixelFormat mgm::GBMBuffer::pixel_format() const
 
 void mgm::GBMBuffer::gl_bind_to_texture()
 {
-    texture_binder->gl_bind_to_texture();
+    bind();
+    secure_for_render();
 }
 
 std::shared_ptr<mg::NativeBuffer> mgm::GBMBuffer::native_buffer_handle() const
@@ -104,13 +108,51 @@ mg::NativeBufferBase* mgm::GBMBuffer::native_buffer_base()
     return this;
 }
 
-void mgm::GBMBuffer::secure_for_render()
+bool mgm::GBMBuffer::secure_for_render()
+{
+    Fd fence;
+    {
+        std::lock_guard<std::mutex> lock{fence_mutex};
+        fence = acquire_fence;
+    }
+
+    // Each GL context sampling the buffer needs to wait, so the fence is kept
+    // until the client replaces it with its next submission.
+    return fence_ops->wait_in_command_stream(fence);
+}
+
+void mgm::GBMBuffer::rendering_finished()
 {
+    auto const fence = fence_ops->fence_for_issued_commands();
+    if (fence == Fd::invalid)
+        return;
+
+    // The buffer may be on more than one output, in which case the client
+    // has to wait for all of them
+    std::lock_guard<std::mutex> lock{fence_mutex};
+    release_fence = fence_ops->merge(release_fence, fence);
+}
+
+void mgm::GBMBuffer::set_acquire_fence(Fd const& fence)
+{
+    std::lock_guard<std::mutex> lock{fence_mutex};
+    acquire_fence = fence;
+    // The client has had the buffer back since, so a fence for reads still
+    // pending from before would be of no use to it
+    release_fence = Fd{};
+}
+
+mir::Fd mgm::GBMBuffer::take_release_fence()
+{
+    std::lock_guard<std::mutex> lock{fence_mutex};
+    auto const fence = release_fence;
+    release_fence = Fd{};
+    return fence;
 }
 
 void mgm::GBMBuffer::bind()
 {
-    gl_bind_to_texture();
+    texture_binder->gl_bind_to_texture();
 }
 
 void mgm::GBMBuffer::bind_for_write()
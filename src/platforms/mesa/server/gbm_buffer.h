@@ -23,10 +23,12 @@
 #include "mir/graphics/buffer_basic.h"
 #include "mir/renderer/gl/texture_source.h"
 #include "mir/renderer/gl/texture_target.h"
+#include "mir/fd.h"
 
 #include <gbm.h>
 
 #include <memory>
+#include <mutex>
 #include <limits>
 
 namespace mir
@@ -40,6 +42,7 @@ class BufferTextureBinder;
 
 namespace mesa
 {
+class NativeFenceOps;
 
 class GBMBuffer: public BufferBasic, public NativeBufferBase,
                  public renderer::gl::TextureSource,
@@ -48,7 +51,8 @@ class GBMBuffer: public BufferBasic, public NativeBufferBase,
 public:
     GBMBuffer(std::shared_ptr<gbm_bo> const& handle,
               uint32_t bo_flags,
-              std::unique_ptr<common::BufferTextureBinder> texture_binder);
+              std::unique_ptr<common::BufferTextureBinder> texture_binder,
+              std::shared_ptr<NativeFenceOps> const& fence_ops);
     GBMBuffer(const GBMBuffer&) = delete;
     ~GBMBuffer();
 
@@ -64,17 +68,32 @@ public:
 
     virtual void gl_bind_to_texture() override;
     virtual void bind() override;
-    virtual void secure_for_render() override;
+    virtual bool secure_for_render() override;
+    void rendering_finished() override;
 
     void bind_for_write() override;
 
     NativeBufferBase* native_buffer_base() override;
 
+    /// Sets the fence the client's rendering must finish by before we sample
+    /// the buffer (or clears it, given an invalid Fd). Called on submission,
+    /// so any release fence not yet taken is stale and is discarded.
+    void set_acquire_fence(Fd const& fence);
+
+    /// Takes the fence that our rendering from the buffer will finish by, for
+    /// returning the buffer to the client. Invalid if there is none.
+    Fd take_release_fence();
+
 private:
     std::shared_ptr<gbm_bo> const gbm_handle;
     uint32_t bo_flags;
     std::unique_ptr<common::BufferTextureBinder> const texture_binder;
     int prime_fd;
+
+    std::shared_ptr<NativeFenceOps> const fence_ops;
+    std::mutex fence_mutex;
+    Fd acquire_fence;
+    Fd release_fence;
 };
 
 }
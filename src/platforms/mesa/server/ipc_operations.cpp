@@ -29,12 +29,14 @@
 #include "ipc_operations.h"
 #include "mir_toolkit/mesa/platform_operation.h"
 #include "native_buffer.h"
+#include "gbm_buffer.h"
 
 #include <boost/throw_exception.hpp>
 #include <boost/exception/get_error_info.hpp>
 #include <boost/exception/errinfo_errno.hpp>
 
 #include <cstring>
+#include <unistd.h>
 
 namespace mg = mir::graphics;
 namespace mgm = mir::graphics::mesa;
@@ -49,6 +51,13 @@ mir::ModuleProperties const description = {
     mir::libname()
 };
 
+// The fences are part of the buffer's synchronization state rather than its
+// content, so they're updated through a buffer that is otherwise const here
+mgm::GBMBuffer* to_gbm_buffer(mg::Buffer const& buffer)
+{
+    return dynamic_cast<mgm::GBMBuffer*>(const_cast<mg::Buffer&>(buffer).native_buffer_base());
+}
+
 struct MesaPlatformIPCPackage : public mg::PlatformIPCPackage
 {
     MesaPlatformIPCPackage(int drm_auth_fd) :
@@ -90,10 +99,30 @@ void mgm::IpcOperations::pack_buffer(
         packer.pack_flags(native_handle->flags);
         packer.pack_size(buffer.size());
     }
+    else if (auto const gbm_buffer = to_gbm_buffer(buffer))
+    {
+        // Returning the buffer: the client may write to it once our
+        // rendering from it has finished
+        auto const release_fence = gbm_buffer->take_release_fence();
+        if (release_fence != mir::Fd::invalid)
+        {
+            packer.pack_flags(mir_buffer_flag_fenced);
+            packer.pack_fd(release_fence);
+        }
+    }
 }
 
-void mgm::IpcOperations::unpack_buffer(BufferIpcMessage&, Buffer const&) const
+void mgm::IpcOperations::unpack_buffer(BufferIpcMessage& message, Buffer const& buffer) const
 {
+    auto const gbm_buffer = to_gbm_buffer(buffer);
+    if (!gbm_buffer)
+        return;
+
+    auto const fds = message.fds();
+    if ((message.flags() & mir_buffer_flag_fenced) && !fds.empty())
+        gbm_buffer->set_acquire_fence(mir::Fd{dup(fds[0])});
+    else
+        gbm_buffer->set_acquire_fence(mir::Fd{});
 }
 
 mg::PlatformOperationMessage mgm::IpcOperations::platform_operation(
@@ -23,6 +23,7 @@
 #include "kms_display_configuration.h"
 #include "mir/geometry/rectangle.h"
 #include "mir/graphics/cursor_image.h"
+#include "mir/graphics/content_hash.h"
 
 #include <xf86drm.h>
 #include <drm/drm.h>
@@ -185,15 +186,24 @@ void mgm::Cursor::show(CursorImage const& cursor_image)
     std::lock_guard<std::mutex> lg(guard);
 
     auto const& size = cursor_image.size();
+    auto const count = size.width.as_uint32_t() * size.height.as_uint32_t() * sizeof(uint32_t);
+    auto const new_image_hash = content_hash(cursor_image.as_argb_8888(), count);
 
-    if (size != geometry::Size{buffer_width, buffer_height})
+    // Clients often set the image the cursor already has: don't upload it again
+    if (!image_written || new_image_hash != image_hash || size != image_size)
     {
-        pad_and_write_image_data_locked(lg, cursor_image);
-    }
-    else
-    {
-        auto const count = size.width.as_uint32_t() * size.height.as_uint32_t() * sizeof(uint32_t);
-        write_buffer_data_locked(lg, cursor_image.as_argb_8888(), count);
+        image_written = false;
+        if (size != geometry::Size{buffer_width, buffer_height})
+        {
+            pad_and_write_image_data_locked(lg, cursor_image);
+        }
+        else
+        {
+            write_buffer_data_locked(lg, cursor_image.as_argb_8888(), count);
+        }
+        image_written = true;
+        image_hash = new_image_hash;
+        image_size = size;
     }
     hotspot = cursor_image.hotspot();
     
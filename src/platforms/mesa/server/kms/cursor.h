@@ -113,6 +113,11 @@ private:
     uint32_t buffer_width;
     uint32_t buffer_height;
 
+    /// Whether the buffer holds an image of image_size with the content_hash() image_hash
+    bool image_written{false};
+    uint64_t image_hash{0};
+    geometry::Size image_size;
+
     std::shared_ptr<CurrentConfiguration> const current_configuration;
 };
 }
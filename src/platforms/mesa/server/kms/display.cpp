@@ -20,6 +20,7 @@
 #include "cursor.h"
 #include "platform.h"
 #include "display_buffer.h"
+#include "dumb_display_buffer.h"
 #include "kms_display_configuration.h"
 #include "kms_output.h"
 #include "kms_page_flipper.h"
@@ -173,6 +174,8 @@ mgm::Display::Display(std::vector<std::shared_ptr<helpers::DRMHelper>> const& dr
                       std::shared_ptr<helpers::GBMHelper> const& gbm,
                       std::shared_ptr<VirtualTerminal> const& vt,
                       mgm::BypassOption bypass_option,
+                      mgm::VariableRefreshOption variable_refresh_option,
+                      mgm::RendererOption renderer_option,
                       std::shared_ptr<DisplayConfigurationPolicy> const& initial_conf_policy,
                       std::shared_ptr<GLConfig> const& gl_config,
                       std::shared_ptr<DisplayReport> const& listener)
@@ -200,6 +203,8 @@ mgm::Display::Display(std::vector<std::shared_ptr<helpers::DRMHelper>> const& dr
       current_display_configuration{output_container},
       dirty_configuration{false},
       bypass_option(bypass_option),
+      variable_refresh_option(variable_refresh_option),
+      renderer_option(renderer_option),
       gl_config{gl_config}
 {
     vt->set_graphics_mode();
@@ -445,6 +450,12 @@ mg::Frame mgm::Display::last_frame_on(unsigned output_id) const
 {
     auto output = current_display_configuration.get_output_for(
         DisplayConfigurationOutputId{static_cast<int>(output_id)});
+    /*
+     * In clone mode DisplayBuffer::post() returns without waiting for the
+     * flip it scheduled; wait for it here so the answer is for the frame
+     * last posted and not the one before.
+     */
+    output->wait_for_page_flip();
     return output->last_frame();
 }
 
@@ -486,7 +497,7 @@ void mgm::Display::configure_locked(
     bool const comp{
         (&kms_conf != &current_display_configuration) &&
         compatible(kms_conf, current_display_configuration)};
-    std::vector<std::unique_ptr<DisplayBuffer>> display_buffers_new;
+    std::vector<std::unique_ptr<KMSDisplayBuffer>> display_buffers_new;
 
     if (!comp)
     {
@@ -566,6 +577,13 @@ void mgm::Display::configure_locked(
 
                 for (auto const& group : kms_output_groups)
                 {
+                    if (renderer_option == RendererOption::software)
+                    {
+                        display_buffers_new.push_back(
+                            std::make_unique<DumbDisplayBuffer>(listener, group, bounding_rect, transformation));
+                        continue;
+                    }
+
                     /*
                      * In a hybrid setup a scanout surface needs to be allocated differently if it
                      * needs to be able to be shared across GPUs. This likely reduces performance.
@@ -578,6 +596,7 @@ void mgm::Display::configure_locked(
 
                     auto db = std::make_unique<DisplayBuffer>(
                         bypass_option,
+                        variable_refresh_option,
                         listener,
                         group,
                         GBMOutputSurface{
@@ -55,7 +55,7 @@ class DRMHelper;
 class GBMHelper;
 }
 
-class DisplayBuffer;
+class KMSDisplayBuffer;
 class VirtualTerminal;
 class KMSOutput;
 class Cursor;
@@ -69,6 +69,8 @@ public:
             std::shared_ptr<helpers::GBMHelper> const& gbm,
             std::shared_ptr<VirtualTerminal> const& vt,
             BypassOption bypass_option,
+            VariableRefreshOption variable_refresh_option,
+            RendererOption renderer_option,
             std::shared_ptr<DisplayConfigurationPolicy> const& initial_conf_policy,
             std::shared_ptr<GLConfig> const& gl_config,
             std::shared_ptr<DisplayReport> const& listener);
@@ -112,7 +114,7 @@ private:
     std::shared_ptr<DisplayReport> const listener;
     mir::udev::Monitor monitor;
     helpers::EGLHelper shared_egl;
-    std::vector<std::unique_ptr<DisplayBuffer>> display_buffers;
+    std::vector<std::unique_ptr<KMSDisplayBuffer>> display_buffers;
     std::shared_ptr<KMSOutputContainer> const output_container;
     mutable RealKMSDisplayConfiguration current_display_configuration;
     mutable std::atomic<bool> dirty_configuration;
@@ -122,6 +124,8 @@ private:
         std::lock_guard<decltype(configuration_mutex)> const&);
 
     BypassOption bypass_option;
+    VariableRefreshOption const variable_refresh_option;
+    RendererOption const renderer_option;
     std::weak_ptr<Cursor> cursor;
     std::shared_ptr<GLConfig> const gl_config;
 };
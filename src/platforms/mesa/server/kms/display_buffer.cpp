@@ -485,6 +485,7 @@ public:
 
 mgm::DisplayBuffer::DisplayBuffer(
     mgm::BypassOption option,
+    mgm::VariableRefreshOption variable_refresh_option,
     std::shared_ptr<DisplayReport> const& listener,
     std::vector<std::shared_ptr<KMSOutput>> const& outputs,
     GBMOutputSurface&& surface_gbm,
@@ -492,6 +493,7 @@ mgm::DisplayBuffer::DisplayBuffer(
     glm::mat2 const& transformation)
     : listener(listener),
       bypass_option(option),
+      variable_refresh_option(variable_refresh_option),
       outputs(outputs),
       surface{std::move(surface_gbm)},
       area(area),
@@ -666,6 +668,19 @@ void mgm::DisplayBuffer::post()
             fatal_error("Failed to get front buffer object");
     }
 
+    /*
+     * A bypassed client posts its frames as they are ready, so outputs that
+     * can should refresh when they arrive instead of at the mode's fixed
+     * rate: a 24Hz video then has no judder, and there are fewer refreshes.
+     * Composited frames go back to the fixed rate, where the compositor's
+     * own timing assumes it is.
+     */
+    if (variable_refresh_option == mgm::VariableRefreshOption::allowed)
+    {
+        for (auto& output : outputs)
+            output->set_variable_refresh(bypass_buf != nullptr);
+    }
+
     /*
      * Try to schedule a page flip as first preference to avoid tearing.
      * [will complete in a background thread]
@@ -19,8 +19,7 @@
 #ifndef MIR_GRAPHICS_MESA_DISPLAY_BUFFER_H_
 #define MIR_GRAPHICS_MESA_DISPLAY_BUFFER_H_
 
-#include "mir/graphics/display_buffer.h"
-#include "mir/graphics/display.h"
+#include "kms_display_buffer.h"
 #include "mir/renderer/gl/render_target.h"
 #include "display_helpers.h"
 #include "egl_helper.h"
@@ -93,13 +92,12 @@ private:
     GBMSurfaceUPtr surface;
 };
 
-class DisplayBuffer : public graphics::DisplayBuffer,
-                      public graphics::DisplaySyncGroup,
-                      public graphics::NativeDisplayBuffer,
+class DisplayBuffer : public KMSDisplayBuffer,
                       public renderer::gl::RenderTarget
 {
 public:
     DisplayBuffer(BypassOption bypass_options,
+                  VariableRefreshOption variable_refresh_option,
                   std::shared_ptr<DisplayReport> const& listener,
                   std::vector<std::shared_ptr<KMSOutput>> const& outputs,
                   GBMOutputSurface&& surface_gbm,
@@ -122,9 +120,9 @@ public:
     glm::mat2 transformation() const override;
     NativeDisplayBuffer* native_display_buffer() override;
 
-    void set_transformation(glm::mat2 const& t, geometry::Rectangle const& a);
-    void schedule_set_crtc();
-    void wait_for_page_flip();
+    void set_transformation(glm::mat2 const& t, geometry::Rectangle const& a) override;
+    void schedule_set_crtc() override;
+    void wait_for_page_flip() override;
 
 private:
     bool schedule_page_flip(FBHandle const& bufobj);
@@ -135,6 +133,7 @@ private:
     FBHandle* bypass_bufobj{nullptr};
     std::shared_ptr<DisplayReport> const listener;
     BypassOption bypass_option;
+    VariableRefreshOption const variable_refresh_option;
 
     std::vector<std::shared_ptr<KMSOutput>> outputs;
 
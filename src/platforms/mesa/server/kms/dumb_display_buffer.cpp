@@ -0,0 +1,338 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "dumb_display_buffer.h"
+#include "fb_handle.h"
+#include "kms_output.h"
+#include "mir/graphics/display_report.h"
+#include "mir/log.h"
+
+#include <boost/throw_exception.hpp>
+
+#include <xf86drm.h>
+#include <xf86drmMode.h>
+#include <sys/mman.h>
+
+#include <cmath>
+#include <cstring>
+#include <system_error>
+
+namespace mg = mir::graphics;
+namespace mgm = mg::mesa;
+namespace geom = mir::geometry;
+
+class mgm::DumbDisplayBuffer::ScanoutBuffer
+{
+public:
+    ScanoutBuffer(int drm_fd, geom::Size size) :
+        drm_fd{drm_fd}
+    {
+        drm_mode_create_dumb create{};
+        create.width = size.width.as_uint32_t();
+        create.height = size.height.as_uint32_t();
+        create.bpp = 32;
+        if (drmIoctl(drm_fd, DRM_IOCTL_MODE_CREATE_DUMB, &create))
+        {
+            BOOST_THROW_EXCEPTION(
+                std::system_error(errno, std::system_category(), "Failed to create dumb buffer"));
+        }
+
+        handle = create.handle;
+        stride = geom::Stride{create.pitch};
+        length = create.size;
+
+        try
+        {
+            uint32_t fb_id;
+            if (drmModeAddFB(drm_fd, create.width, create.height, 24, 32, create.pitch, handle, &fb_id))
+            {
+                BOOST_THROW_EXCEPTION(
+                    std::system_error(errno, std::system_category(), "Failed to add framebuffer for dumb buffer"));
+            }
+            fb = std::make_unique<FBHandle>(drm_fd, fb_id);
+
+            drm_mode_map_dumb map{};
+            map.handle = handle;
+            if (drmIoctl(drm_fd, DRM_IOCTL_MODE_MAP_DUMB, &map))
+            {
+                BOOST_THROW_EXCEPTION(
+                    std::system_error(errno, std::system_category(), "Failed to map dumb buffer"));
+            }
+
+            auto const mapping = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, drm_fd, map.offset);
+            if (mapping == MAP_FAILED)
+            {
+                BOOST_THROW_EXCEPTION(
+                    std::system_error(errno, std::system_category(), "Failed to map dumb buffer"));
+            }
+            pixels = static_cast<unsigned char*>(mapping);
+        }
+        catch (...)
+        {
+            fb.reset();
+            destroy();
+            throw;
+        }
+
+        // Whatever was in the memory before is not for showing
+        memset(pixels, 0, length);
+    }
+
+    ~ScanoutBuffer()
+    {
+        munmap(pixels, length);
+        fb.reset();
+        destroy();
+    }
+
+    FBHandle const& framebuffer() const { return *fb; }
+
+    unsigned char* pixels;
+    geom::Stride stride;
+
+private:
+    void destroy()
+    {
+        drm_mode_destroy_dumb destroy{};
+        destroy.handle = handle;
+        drmIoctl(drm_fd, DRM_IOCTL_MODE_DESTROY_DUMB, &destroy);
+    }
+
+    int const drm_fd;
+    uint32_t handle;
+    size_t length;
+    std::unique_ptr<FBHandle> fb;
+};
+
+namespace
+{
+geom::Size physical_size_of(geom::Rectangle const& area, glm::mat2 const& transformation)
+{
+    auto const size = transformation * glm::vec2{area.size.width.as_int(), area.size.height.as_int()};
+    return {std::lround(std::abs(size.x)), std::lround(std::abs(size.y))};
+}
+
+geom::Stride stride_of(geom::Size const& size)
+{
+    return geom::Stride{size.width.as_int() * 4};
+}
+}
+
+mgm::DumbDisplayBuffer::DumbDisplayBuffer(
+    std::shared_ptr<DisplayReport> const& listener,
+    std::vector<std::shared_ptr<KMSOutput>> const& outputs,
+    geom::Rectangle const& area,
+    glm::mat2 const& transformation) :
+    outputs(outputs),
+    physical_size{physical_size_of(area, transformation)}
+{
+    auto const drm_fd = outputs.front()->drm_fd();
+    for (auto& buffer : scanout)
+        buffer = std::make_unique<ScanoutBuffer>(drm_fd, physical_size);
+
+    listener->report_successful_setup_of_native_resources();
+
+    set_transformation(transformation, area);
+    set_crtc(scanout[1]->framebuffer());
+
+    listener->report_successful_drm_mode_set_crtc_on_construction();
+    listener->report_successful_display_construction();
+}
+
+mgm::DumbDisplayBuffer::~DumbDisplayBuffer()
+{
+    wait_for_page_flip();
+}
+
+geom::Rectangle mgm::DumbDisplayBuffer::view_area() const
+{
+    return area;
+}
+
+bool mgm::DumbDisplayBuffer::overlay(RenderableList const&)
+{
+    return false;
+}
+
+glm::mat2 mgm::DumbDisplayBuffer::transformation() const
+{
+    // Frames are drawn upright, and rotated as they are copied out
+    return glm::mat2();
+}
+
+mg::NativeDisplayBuffer* mgm::DumbDisplayBuffer::native_display_buffer()
+{
+    return this;
+}
+
+void mgm::DumbDisplayBuffer::for_each_display_buffer(
+    std::function<void(graphics::DisplayBuffer&)> const& f)
+{
+    f(*this);
+}
+
+void mgm::DumbDisplayBuffer::set_transformation(glm::mat2 const& t, geom::Rectangle const& a)
+{
+    transform = t;
+    area = a;
+
+    shadow.assign(stride_of(area.size).as_int() * area.size.height.as_int(), 0);
+    shadow_drawn = false;
+    for (auto& rects : stale)
+        rects = geom::Rectangles{area};
+}
+
+auto mgm::DumbDisplayBuffer::back_buffer() -> Pixels
+{
+    return {shadow.data(), area.size, stride_of(area.size), mir_pixel_format_xrgb_8888, shadow_drawn ? 1u : 0u};
+}
+
+void mgm::DumbDisplayBuffer::swap_buffers(geom::Rectangles const& damage)
+{
+    shadow_drawn = true;
+
+    for (auto const& rect : damage)
+    {
+        auto const visible = rect.intersection_with(area);
+        if (visible.size == geom::Size{})
+            continue;
+
+        for (auto& rects : stale)
+            rects.add(visible);
+    }
+
+    // In clone mode the back buffer may still be on screen until the last flip
+    wait_for_page_flip();
+
+    for (auto const& rect : stale[back])
+        copy_out(rect, *scanout[back]);
+    stale[back].clear();
+
+    frame_ready = true;
+}
+
+void mgm::DumbDisplayBuffer::copy_out(geom::Rectangle const& rect, ScanoutBuffer& to) const
+{
+    auto const shadow_stride = stride_of(area.size).as_int();
+    auto const left = (rect.left() - area.left()).as_int();
+    auto const top = (rect.top() - area.top()).as_int();
+    auto const width = rect.size.width.as_int();
+    auto const height = rect.size.height.as_int();
+
+    if (transform == glm::mat2())
+    {
+        for (auto y = top; y != top + height; ++y)
+            memcpy(to.pixels + y * to.stride.as_int() + left * 4, shadow.data() + y * shadow_stride + left * 4, width * 4);
+        return;
+    }
+
+    // transformation() is in GL coordinates, whose y axis points up, so
+    // conjugate it to map the centres of pixels (doubled, to keep them
+    // whole) about the middle of the screen
+    int const xx = std::lround(transform[0][0]), yx = -std::lround(transform[1][0]);
+    int const xy = -std::lround(transform[0][1]), yy = std::lround(transform[1][1]);
+    auto const w = area.size.width.as_int(), h = area.size.height.as_int();
+    auto const physical_w = physical_size.width.as_int(), physical_h = physical_size.height.as_int();
+
+    for (auto y = top; y != top + height; ++y)
+    {
+        auto const cx = 2 * left + 1 - w, cy = 2 * y + 1 - h;
+        auto px = (xx * cx + yx * cy + physical_w - 1) / 2;
+        auto py = (xy * cx + yy * cy + physical_h - 1) / 2;
+
+        auto const* from = reinterpret_cast<uint32_t const*>(shadow.data() + y * shadow_stride) + left;
+        for (auto x = 0; x != width; ++x)
+        {
+            memcpy(to.pixels + py * to.stride.as_int() + px * 4, from + x, 4);
+            px += xx;
+            py += xy;
+        }
+    }
+}
+
+void mgm::DumbDisplayBuffer::post()
+{
+    if (!frame_ready)
+    {
+        // Nothing new to show, but the CRTC may need restoring (after a VT switch)
+        if (needs_set_crtc)
+        {
+            wait_for_page_flip();
+            set_crtc(scanout[back ^ 1]->framebuffer());
+            needs_set_crtc = false;
+        }
+        return;
+    }
+
+    frame_ready = false;
+    auto const& fb = scanout[back]->framebuffer();
+
+    wait_for_page_flip();
+    if (!needs_set_crtc)
+    {
+        for (auto& output : outputs)
+        {
+            if (output->schedule_page_flip(fb))
+                page_flips_pending = true;
+        }
+
+        if (!page_flips_pending)
+            needs_set_crtc = true;
+    }
+
+    if (needs_set_crtc)
+    {
+        set_crtc(fb);
+        needs_set_crtc = false;
+    }
+
+    back ^= 1;
+}
+
+std::chrono::milliseconds mgm::DumbDisplayBuffer::recommended_sleep() const
+{
+    return std::chrono::milliseconds::zero();
+}
+
+void mgm::DumbDisplayBuffer::wait_for_page_flip()
+{
+    if (page_flips_pending)
+    {
+        for (auto& output : outputs)
+            output->wait_for_page_flip();
+
+        page_flips_pending = false;
+    }
+}
+
+void mgm::DumbDisplayBuffer::schedule_set_crtc()
+{
+    needs_set_crtc = true;
+}
+
+void mgm::DumbDisplayBuffer::set_crtc(FBHandle const& fb)
+{
+    for (auto& output : outputs)
+    {
+        if (!output->set_crtc(fb))
+            mir::log_error("Failed to set DRM CRTC. "
+                "Screen contents may be incomplete. "
+                "Try plugging the monitor in again.");
+    }
+
+    // Some virtual GPUs only update the screen when told what has changed
+    drmModeDirtyFB(outputs.front()->drm_fd(), fb.get_drm_fb_id(), nullptr, 0);
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_GRAPHICS_MESA_DUMB_DISPLAY_BUFFER_H_
+#define MIR_GRAPHICS_MESA_DUMB_DISPLAY_BUFFER_H_
+
+#include "kms_display_buffer.h"
+#include "mir/renderer/sw/pixel_target.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+namespace mir
+{
+namespace graphics
+{
+
+class DisplayReport;
+
+namespace mesa
+{
+
+class FBHandle;
+class KMSOutput;
+
+/**
+ * A display buffer for the software renderer, scanned out of KMS "dumb"
+ * buffers.
+ *
+ * Frames are drawn into a shadow buffer in ordinary memory (as scanout
+ * memory may be uncached, and slow to blend in), and only the damaged parts
+ * of each frame are copied, rotated as the outputs' orientation requires,
+ * into whichever of the two dumb buffers is next to be shown.
+ */
+class DumbDisplayBuffer : public KMSDisplayBuffer,
+                          public renderer::software::PixelTarget
+{
+public:
+    DumbDisplayBuffer(std::shared_ptr<DisplayReport> const& listener,
+                      std::vector<std::shared_ptr<KMSOutput>> const& outputs,
+                      geometry::Rectangle const& area,
+                      glm::mat2 const& transformation);
+    ~DumbDisplayBuffer();
+
+    geometry::Rectangle view_area() const override;
+    bool overlay(RenderableList const& renderlist) override;
+    glm::mat2 transformation() const override;
+    NativeDisplayBuffer* native_display_buffer() override;
+
+    void for_each_display_buffer(
+        std::function<void(graphics::DisplayBuffer&)> const& f) override;
+    void post() override;
+    std::chrono::milliseconds recommended_sleep() const override;
+
+    void set_transformation(glm::mat2 const& t, geometry::Rectangle const& a) override;
+    void schedule_set_crtc() override;
+    void wait_for_page_flip() override;
+
+    Pixels back_buffer() override;
+    void swap_buffers(geometry::Rectangles const& damage) override;
+
+private:
+    class ScanoutBuffer;
+
+    void set_crtc(FBHandle const& fb);
+    void copy_out(geometry::Rectangle const& rect, ScanoutBuffer& to) const;
+
+    std::vector<std::shared_ptr<KMSOutput>> const outputs;
+    geometry::Size const physical_size;
+    std::array<std::unique_ptr<ScanoutBuffer>, 2> scanout;
+    /// The parts of each scanout buffer that are behind the shadow buffer
+    std::array<geometry::Rectangles, 2> stale;
+    size_t back{0};
+
+    geometry::Rectangle area;
+    glm::mat2 transform;
+    std::vector<unsigned char> shadow;
+    bool shadow_drawn{false};
+    bool frame_ready{false};
+    std::atomic<bool> needs_set_crtc{false};
+    bool page_flips_pending{false};
+};
+
+}
+}
+}
+
+#endif /* MIR_GRAPHICS_MESA_DUMB_DISPLAY_BUFFER_H_ */
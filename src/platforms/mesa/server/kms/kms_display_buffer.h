@@ -0,0 +1,50 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_GRAPHICS_MESA_KMS_DISPLAY_BUFFER_H_
+#define MIR_GRAPHICS_MESA_KMS_DISPLAY_BUFFER_H_
+
+#include "mir/graphics/display_buffer.h"
+#include "mir/graphics/display.h"
+
+namespace mir
+{
+namespace graphics
+{
+namespace mesa
+{
+
+/// The display buffer of a group of outputs, as the Display drives it
+class KMSDisplayBuffer : public graphics::DisplayBuffer,
+                         public graphics::DisplaySyncGroup,
+                         public graphics::NativeDisplayBuffer
+{
+public:
+    virtual ~KMSDisplayBuffer() = default;
+
+    virtual void set_transformation(glm::mat2 const& t, geometry::Rectangle const& a) = 0;
+    virtual void schedule_set_crtc() = 0;
+    virtual void wait_for_page_flip() = 0;
+
+protected:
+    KMSDisplayBuffer() = default;
+};
+
+}
+}
+}
+
+#endif /* MIR_GRAPHICS_MESA_KMS_DISPLAY_BUFFER_H_ */
@@ -69,6 +69,13 @@ public:
     virtual bool schedule_page_flip(FBHandle const& fb) = 0;
     virtual void wait_for_page_flip() = 0;
 
+    /**
+     * Let the refresh of a variable refresh rate capable output follow the
+     * page flips scheduled on it rather than the fixed rate of its mode.
+     * Outputs that can't vary their refresh rate ignore this.
+     */
+    virtual void set_variable_refresh(bool enabled) = 0;
+
     virtual bool set_cursor(gbm_bo* buffer) = 0;
     virtual void move_cursor(geometry::Point destination) = 0;
     virtual bool clear_cursor() = 0;
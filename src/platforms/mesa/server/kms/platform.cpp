@@ -41,12 +41,25 @@ mgm::Platform::Platform(std::shared_ptr<DisplayReport> const& listener,
                         std::shared_ptr<VirtualTerminal> const& vt,
                         EmergencyCleanupRegistry& emergency_cleanup_registry,
                         BypassOption bypass_option)
+    : Platform(listener, vt, emergency_cleanup_registry, bypass_option,
+               VariableRefreshOption::prohibited, RendererOption::gl)
+{
+}
+
+mgm::Platform::Platform(std::shared_ptr<DisplayReport> const& listener,
+                        std::shared_ptr<VirtualTerminal> const& vt,
+                        EmergencyCleanupRegistry& emergency_cleanup_registry,
+                        BypassOption bypass_option,
+                        VariableRefreshOption variable_refresh_option,
+                        RendererOption renderer_option)
     : udev{std::make_shared<mir::udev::Context>()},
       drm{helpers::DRMHelper::open_all_devices(udev)},
       gbm{std::make_shared<mgmh::GBMHelper>()},
       listener{listener},
       vt{vt},
-      bypass_option_{bypass_option}
+      bypass_option_{bypass_option},
+      variable_refresh_option{variable_refresh_option},
+      renderer_option{renderer_option}
 {
     // We assume the first DRM device is the boot GPU, and arbitrarily pick it as our
     // shell renderer.
@@ -99,6 +112,8 @@ mir::UniqueModulePtr<mg::Display> mgm::Platform::create_display(
         gbm,
         vt,
         bypass_option_,
+        variable_refresh_option,
+        renderer_option,
         initial_conf_policy,
         gl_config,
         listener);
@@ -44,6 +44,12 @@ public:
                       std::shared_ptr<VirtualTerminal> const& vt,
                       EmergencyCleanupRegistry& emergency_cleanup_registry,
                       BypassOption bypass_option);
+    Platform(std::shared_ptr<DisplayReport> const& reporter,
+             std::shared_ptr<VirtualTerminal> const& vt,
+             EmergencyCleanupRegistry& emergency_cleanup_registry,
+             BypassOption bypass_option,
+             VariableRefreshOption variable_refresh_option,
+             RendererOption renderer_option);
 
     /* From Platform */
     UniqueModulePtr<graphics::GraphicBufferAllocator> create_buffer_allocator() override;
@@ -68,6 +74,8 @@ public:
     BypassOption bypass_option() const;
 private:
     BypassOption const bypass_option_;
+    VariableRefreshOption const variable_refresh_option;
+    RendererOption const renderer_option;
     std::unique_ptr<DRMNativePlatform> native_platform;
 };
 
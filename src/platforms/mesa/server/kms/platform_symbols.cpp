@@ -37,8 +37,11 @@ namespace mo = mir::options;
 namespace
 {
 char const* bypass_option_name{"bypass"};
+char const* variable_refresh_option_name{"variable-refresh"};
 char const* vt_option_name{"vt"};
 char const* host_socket{"host-socket"};
+// The server's option, as the software renderer needs dumb buffers to draw in
+char const* renderer_option_name{"renderer"};
 
 struct RealVTFileOperations : public mgm::VTFileOperations
 {
@@ -122,8 +125,19 @@ mir::UniqueModulePtr<mg::Platform> create_host_platform(
     if (!options->get<bool>(bypass_option_name))
         bypass_option = mgm::BypassOption::prohibited;
 
+    auto variable_refresh_option = mgm::VariableRefreshOption::prohibited;
+    if (options->get<bool>(variable_refresh_option_name))
+        variable_refresh_option = mgm::VariableRefreshOption::allowed;
+
+    auto renderer_option = mgm::RendererOption::gl;
+    if (options->is_set(renderer_option_name) &&
+        options->get<std::string>(renderer_option_name) == "software")
+    {
+        renderer_option = mgm::RendererOption::software;
+    }
+
     return mir::make_module_ptr<mgm::Platform>(
-        report, vt, *emergency_cleanup_registry, bypass_option);
+        report, vt, *emergency_cleanup_registry, bypass_option, variable_refresh_option, renderer_option);
 }
 
 void add_graphics_platform_options(boost::program_options::options_description& config)
@@ -135,7 +149,11 @@ void add_graphics_platform_options(boost::program_options::options_description&
          "[platform-specific] VT to run on or 0 to use current.")
         (bypass_option_name,
          boost::program_options::value<bool>()->default_value(true),
-         "[platform-specific] utilize the bypass optimization for fullscreen surfaces.");
+         "[platform-specific] utilize the bypass optimization for fullscreen surfaces.")
+        (variable_refresh_option_name,
+         boost::program_options::value<bool>()->default_value(false),
+         "[platform-specific] let outputs capable of a variable refresh rate (Adaptive Sync) "
+         "follow the frame rate of bypassed fullscreen surfaces.");
 }
 
 mg::PlatformPriority probe_graphics_platform(mo::ProgramOption const& options)
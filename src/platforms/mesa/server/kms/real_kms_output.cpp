@@ -17,6 +17,7 @@
  */
 
 #include "real_kms_output.h"
+#include "fb_handle.h"
 #include "mir/graphics/display_configuration.h"
 #include "page_flipper.h"
 #include "kms-utils/kms_connector.h"
@@ -32,33 +33,6 @@ namespace mgm = mg::mesa;
 namespace mgk = mg::kms;
 namespace geom = mir::geometry;
 
-class mgm::FBHandle
-{
-public:
-    FBHandle(gbm_bo* bo, uint32_t drm_fb_id)
-        : bo{bo}, drm_fb_id{drm_fb_id}
-    {
-    }
-
-    ~FBHandle()
-    {
-        if (drm_fb_id)
-        {
-            int drm_fd = gbm_device_get_fd(gbm_bo_get_device(bo));
-            drmModeRmFB(drm_fd, drm_fb_id);
-        }
-    }
-
-    uint32_t get_drm_fb_id() const
-    {
-        return drm_fb_id;
-    }
-
-private:
-    gbm_bo *bo;
-    uint32_t drm_fb_id;
-};
-
 namespace
 {
 void bo_user_data_destroy(gbm_bo* /*bo*/, void *data)
@@ -67,6 +41,24 @@ void bo_user_data_destroy(gbm_bo* /*bo*/, void *data)
     delete bufobj;
 }
 
+bool supports_variable_refresh(int drm_fd, mgk::DRMModeConnectorUPtr const& connector)
+{
+    // Only the monitor on the other end of the connector can say whether it copes
+    if (connector->connection != DRM_MODE_CONNECTED)
+        return false;
+
+    try
+    {
+        mgk::ObjectProperties connector_props{
+            drm_fd, connector->connector_id, DRM_MODE_OBJECT_CONNECTOR};
+        return connector_props.has_property("vrr_capable") && connector_props["vrr_capable"];
+    }
+    catch (std::system_error const&)
+    {
+        // It's an optimisation; the output works just as well without it
+        return false;
+    }
+}
 }
 
 mgm::RealKMSOutput::RealKMSOutput(
@@ -99,6 +91,7 @@ mgm::RealKMSOutput::RealKMSOutput(
 
 mgm::RealKMSOutput::~RealKMSOutput()
 {
+    restore_fixed_refresh();
     restore_saved_crtc();
 }
 
@@ -109,6 +102,9 @@ uint32_t mgm::RealKMSOutput::id() const
 
 void mgm::RealKMSOutput::reset()
 {
+    // The CRTC we might have enabled it on is about to be forgotten
+    restore_fixed_refresh();
+
     kms::DRMModeResources resources{drm_fd_};
 
     /* Update the connector to ensure we have the latest information */
@@ -136,6 +132,8 @@ void mgm::RealKMSOutput::reset()
         }
     }
 
+    variable_refresh_capable = supports_variable_refresh(drm_fd_, connector);
+
     /* Discard previously current crtc */
     current_crtc = nullptr;
 }
@@ -154,6 +152,8 @@ int mgm::RealKMSOutput::max_refresh_rate() const
 
 void mgm::RealKMSOutput::configure(geom::Displacement offset, size_t kms_mode_index)
 {
+    restore_fixed_refresh();
+
     fb_offset = offset;
     mode_index = kms_mode_index;
 }
@@ -177,6 +177,8 @@ bool mgm::RealKMSOutput::set_crtc(FBHandle const& fb)
         return false;
     }
 
+    // Setting the CRTC shows the new framebuffer at once, with no flip to wait on
+    last_frame_.increment_now();
     using_saved_crtc = false;
     return true;
 }
@@ -198,6 +200,8 @@ void mgm::RealKMSOutput::clear_crtc()
         return;
     }
 
+    restore_fixed_refresh();
+
     auto result = drmModeSetCrtc(drm_fd_, current_crtc->crtc_id,
                                  0, 0, 0, nullptr, 0, nullptr);
     if (result)
@@ -240,6 +244,66 @@ void mgm::RealKMSOutput::wait_for_page_flip()
     last_frame_.store(page_flipper->wait_for_flip(current_crtc->crtc_id));
 }
 
+void mgm::RealKMSOutput::set_variable_refresh(bool enabled)
+{
+    // Once the kernel has refused, wait for reset() or configure() to try again
+    if (variable_refresh_refused)
+        return;
+
+    enabled = enabled && variable_refresh_capable;
+    if (enabled == (variable_refresh_crtc_id != 0))
+        return;
+
+    // Disabling has to reach the CRTC it was enabled on, even if we've since let go of it
+    auto const crtc_id = enabled ?
+        (current_crtc ? current_crtc->crtc_id : 0) :
+        variable_refresh_crtc_id;
+    if (!crtc_id)
+        return;
+
+    // A driver reporting capable connectors should let their CRTCs enable it, but check
+    int result = -ENOTSUP;
+    try
+    {
+        mgk::ObjectProperties crtc_props{drm_fd_, crtc_id, DRM_MODE_OBJECT_CRTC};
+
+        if (crtc_props.has_property("VRR_ENABLED"))
+        {
+            result = drmModeObjectSetProperty(
+                drm_fd_,
+                crtc_id,
+                DRM_MODE_OBJECT_CRTC,
+                crtc_props.id_for("VRR_ENABLED"),
+                enabled);
+        }
+    }
+    catch (std::system_error const& error)
+    {
+        result = -error.code().value();
+    }
+
+    if (result)
+    {
+        mir::log_warning("Failed to %s variable refresh on output %s (%s)",
+                         enabled ? "enable" : "disable",
+                         mgk::connector_name(connector).c_str(),
+                         strerror(-result));
+
+        // Don't try again every frame. The CRTC is left as it was, so a failed
+        // disable is still recorded against it and retried.
+        variable_refresh_refused = true;
+        return;
+    }
+
+    variable_refresh_crtc_id = enabled ? crtc_id : 0;
+}
+
+void mgm::RealKMSOutput::restore_fixed_refresh()
+{
+    variable_refresh_refused = false;
+    set_variable_refresh(false);
+}
+
 mg::Frame mgm::RealKMSOutput::last_frame() const
 {
     return last_frame_.load();
@@ -378,8 +442,11 @@ void mgm::RealKMSOutput::set_gamma(mg::GammaCurves const& gamma)
 
 void mgm::RealKMSOutput::refresh_hardware_state()
 {
+    restore_fixed_refresh();
+
     connector = kms::get_connector(drm_fd_, connector->connector_id);
     current_crtc = nullptr;
+    variable_refresh_capable = supports_variable_refresh(drm_fd_, connector);
 
     if (connector->encoder_id)
     {
@@ -586,6 +653,7 @@ void mgm::RealKMSOutput::update_from_hardware_state(
     output.subpixel_arrangement = kms_subpixel_to_mir_subpixel(connector->subpixel);
     output.gamma = gamma;
     output.edid = edid;
+    output.variable_refresh_capable = variable_refresh_capable;
 }
 
 mgm::FBHandle* mgm::RealKMSOutput::fb_for(gbm_bo* bo) const
@@ -626,7 +694,7 @@ mgm::FBHandle* mgm::RealKMSOutput::fb_for(gbm_bo* bo) const
         return nullptr;
 
     /* Create a FBHandle and associate it with the gbm_bo */
-    bufobj = new FBHandle{bo, fb_id};
+    bufobj = new FBHandle{drm_fd_, fb_id};
     gbm_bo_set_user_data(bo, bufobj, bo_user_data_destroy);
 
     return bufobj;
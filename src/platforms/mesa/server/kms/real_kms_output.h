@@ -55,6 +55,7 @@ public:
     void clear_crtc() override;
     bool schedule_page_flip(FBHandle const& fb) override;
     void wait_for_page_flip() override;
+    void set_variable_refresh(bool enabled) override;
 
     bool set_cursor(gbm_bo* buffer) override;
     void move_cursor(geometry::Point destination) override;
@@ -76,6 +77,7 @@ public:
 private:
     bool ensure_crtc();
     void restore_saved_crtc();
+    void restore_fixed_refresh();
 
     int const drm_fd_;
     std::shared_ptr<PageFlipper> const page_flipper;
@@ -91,6 +93,10 @@ private:
     MirPowerMode power_mode;
     int dpms_enum_id;
 
+    bool variable_refresh_capable{false};
+    uint32_t variable_refresh_crtc_id{0};   // Where VRR_ENABLED is set, if anywhere
+    bool variable_refresh_refused{false};
+
     std::mutex power_mutex;
 
     AtomicFrame last_frame_;
@@ -0,0 +1,158 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "native_fence_ops.h"
+
+#include MIR_SERVER_GL_H
+
+#include <linux/sync_file.h>
+#include <sys/ioctl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+namespace mg = mir::graphics;
+namespace mgm = mir::graphics::mesa;
+
+namespace
+{
+// Waiting on the CPU holds up the compositor thread, so we only give a
+// client's rendering this long before leaving its buffer for a later frame
+int const client_fence_timeout_ms{8};
+
+/// Returns false if fence has not signalled within timeout_ms (or, if it is
+/// negative, never returns until it has)
+bool wait_on_cpu(mir::Fd const& fence, int timeout_ms)
+{
+    pollfd pfd{fence, POLLIN, 0};
+    int result;
+    while ((result = poll(&pfd, 1, timeout_ms)) < 0 && (errno == EINTR || errno == EAGAIN))
+        ;
+    return result != 0;
+}
+
+bool has_extension(EGLDisplay display, char const* name)
+{
+    auto const extensions = eglQueryString(display, EGL_EXTENSIONS);
+    if (!extensions)
+        return false;
+
+    auto const length = strlen(name);
+    for (auto match = strstr(extensions, name); match; match = strstr(match + length, name))
+    {
+        if ((match == extensions || match[-1] == ' ') &&
+            (match[length] == ' ' || match[length] == '\0'))
+            return true;
+    }
+    return false;
+}
+}
+
+mgm::EGLNativeFenceOps::EGLNativeFenceOps() :
+    eglCreateSyncKHR{
+        reinterpret_cast<PFNEGLCREATESYNCKHRPROC>(eglGetProcAddress("eglCreateSyncKHR"))},
+    eglDestroySyncKHR{
+        reinterpret_cast<PFNEGLDESTROYSYNCKHRPROC>(eglGetProcAddress("eglDestroySyncKHR"))},
+    eglWaitSyncKHR{
+        reinterpret_cast<PFNEGLWAITSYNCKHRPROC>(eglGetProcAddress("eglWaitSyncKHR"))},
+    eglDupNativeFenceFDANDROID{
+        reinterpret_cast<PFNEGLDUPNATIVEFENCEFDANDROIDPROC>(eglGetProcAddress("eglDupNativeFenceFDANDROID"))}
+{
+}
+
+bool mgm::EGLNativeFenceOps::native_fences_supported(EGLDisplay display)
+{
+    std::call_once(probed, [&]
+        {
+            supported =
+                eglCreateSyncKHR && eglDestroySyncKHR && eglWaitSyncKHR && eglDupNativeFenceFDANDROID &&
+                has_extension(display, "EGL_ANDROID_native_fence_sync") &&
+                has_extension(display, "EGL_KHR_wait_sync");
+        });
+
+    return supported;
+}
+
+bool mgm::EGLNativeFenceOps::wait_in_command_stream(Fd const& fence)
+{
+    if (fence == Fd::invalid)
+        return true;
+
+    auto const display = eglGetCurrentDisplay();
+    if (display == EGL_NO_DISPLAY || !native_fences_supported(display))
+        return wait_on_cpu(fence, client_fence_timeout_ms);
+
+    // On success the EGLSync takes ownership of the fd it is given
+    int const fd = dup(fence);
+    EGLint const attribs[] = { EGL_SYNC_NATIVE_FENCE_FD_ANDROID, fd, EGL_NONE };
+    auto const sync = eglCreateSyncKHR(display, EGL_SYNC_NATIVE_FENCE_ANDROID, attribs);
+
+    if (sync == EGL_NO_SYNC_KHR)
+    {
+        close(fd);
+        return wait_on_cpu(fence, client_fence_timeout_ms);
+    }
+
+    auto const waiting = eglWaitSyncKHR(display, sync, 0) == EGL_TRUE ||
+                         wait_on_cpu(fence, client_fence_timeout_ms);
+
+    eglDestroySyncKHR(display, sync);
+    return waiting;
+}
+
+mir::Fd mgm::EGLNativeFenceOps::fence_for_issued_commands()
+{
+    auto const display = eglGetCurrentDisplay();
+    if (display == EGL_NO_DISPLAY || !native_fences_supported(display))
+        return Fd{};
+
+    EGLint const attribs[] = { EGL_SYNC_NATIVE_FENCE_FD_ANDROID, EGL_NO_NATIVE_FENCE_FD_ANDROID, EGL_NONE };
+    auto const sync = eglCreateSyncKHR(display, EGL_SYNC_NATIVE_FENCE_ANDROID, attribs);
+    if (sync == EGL_NO_SYNC_KHR)
+        return Fd{};
+
+    // The fence only gets an fd once it has been flushed to the kernel
+    glFlush();
+    auto const fd = eglDupNativeFenceFDANDROID(display, sync);
+    eglDestroySyncKHR(display, sync);
+
+    return fd == EGL_NO_NATIVE_FENCE_FD_ANDROID ? Fd{} : Fd{fd};
+}
+
+mir::Fd mgm::EGLNativeFenceOps::merge(Fd const& first, Fd const& second)
+{
+    if (first == Fd::invalid)
+        return second;
+    if (second == Fd::invalid)
+        return first;
+
+    sync_merge_data data;
+    memset(&data, 0, sizeof data);
+    strncpy(data.name, "mir", sizeof data.name - 1);
+    data.fd2 = second;
+
+    if (ioctl(first, SYNC_IOC_MERGE, &data) < 0)
+    {
+        // Not a sync_file we can merge: settle for one fence covering both.
+        // Both are for our own rendering, which cannot be held up for long.
+        wait_on_cpu(first, -1);
+        return second;
+    }
+
+    return Fd{data.fence};
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_GRAPHICS_MESA_NATIVE_FENCE_OPS_H_
+#define MIR_GRAPHICS_MESA_NATIVE_FENCE_OPS_H_
+
+#include "mir/fd.h"
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include <mutex>
+
+namespace mir
+{
+namespace graphics
+{
+namespace mesa
+{
+
+/// Operations on native (sync_file) fences shared between clients and the
+/// compositor's GL context.
+class NativeFenceOps
+{
+public:
+    virtual ~NativeFenceOps() = default;
+
+    /// Makes commands subsequently issued to the current GL context wait for
+    /// fence to signal. Returns false if that could only be done by waiting on
+    /// the CPU and fence did not signal in time, in which case the commands
+    /// must not rely on it.
+    virtual bool wait_in_command_stream(Fd const& fence) = 0;
+
+    /// Returns a fence that signals when the commands issued so far to the
+    /// current GL context have completed, or an invalid Fd if native fences
+    /// are not supported (and implicit synchronization must be relied on).
+    virtual Fd fence_for_issued_commands() = 0;
+
+    /// Returns a fence that signals when both first and second have.
+    virtual Fd merge(Fd const& first, Fd const& second) = 0;
+
+protected:
+    NativeFenceOps() = default;
+    NativeFenceOps(NativeFenceOps const&) = delete;
+    NativeFenceOps& operator=(NativeFenceOps const&) = delete;
+};
+
+/// Implements NativeFenceOps with EGL_ANDROID_native_fence_sync and
+/// EGL_KHR_wait_sync, falling back to waiting on the CPU where the EGL
+/// implementation lacks them.
+class EGLNativeFenceOps : public NativeFenceOps
+{
+public:
+    EGLNativeFenceOps();
+
+    bool wait_in_command_stream(Fd const& fence) override;
+    Fd fence_for_issued_commands() override;
+    Fd merge(Fd const& first, Fd const& second) override;
+
+private:
+    bool native_fences_supported(EGLDisplay display);
+
+    PFNEGLCREATESYNCKHRPROC const eglCreateSyncKHR;
+    PFNEGLDESTROYSYNCKHRPROC const eglDestroySyncKHR;
+    PFNEGLWAITSYNCKHRPROC const eglWaitSyncKHR;
+    PFNEGLDUPNATIVEFENCEFDANDROIDPROC const eglDupNativeFenceFDANDROID;
+
+    std::once_flag probed;
+    bool supported{false};
+};
+
+}
+}
+}
+
+#endif /* MIR_GRAPHICS_MESA_NATIVE_FENCE_OPS_H_ */
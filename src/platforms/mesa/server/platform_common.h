@@ -32,6 +32,20 @@ enum class BypassOption
     prohibited
 };
 
+/// Whether outputs may vary their refresh rate to follow a bypassed surface
+enum class VariableRefreshOption
+{
+    allowed,
+    prohibited
+};
+
+/// How the server composites the outputs it drives
+enum class RendererOption
+{
+    gl,         ///< into GBM surfaces, with GL
+    software    ///< into dumb buffers, with the CPU
+};
+
 }
 }
 }
@@ -48,7 +48,8 @@ mgx::DisplayConfiguration::DisplayConfiguration(MirPixelFormat pf, geom::Size co
             mir_subpixel_arrangement_unknown,
             {},
             mir_output_gamma_unsupported,
-            {}},
+            {},
+            false},
     card{mg::DisplayConfigurationCardId{0}, 1}
 {
 }
@@ -17,6 +17,7 @@
  */
 
 #include "program_family.h"
+#include "mir/gl/program_binary_cache.h"
 #include MIR_SERVER_GL_H
 #include MIR_SERVER_GLEXT_H
 #include <mutex>
@@ -53,6 +54,11 @@ void ProgramFamily::Shader::init(GLenum type, const GLchar* src)
     }
 }
 
+ProgramFamily::ProgramFamily(std::shared_ptr<mir::gl::ProgramBinaryCache> const& binary_cache)
+    : binary_cache{binary_cache}
+{
+}
+
 ProgramFamily::~ProgramFamily() noexcept
 {
     // shader and program lifetimes are managed manually, so that we don't
@@ -89,18 +95,31 @@ GLuint ProgramFamily::add_program(const GLchar* const vshader_src,
     static std::mutex lp1416482_mutex;
     std::lock_guard<decltype(lp1416482_mutex)> lock{lp1416482_mutex};
 
-    auto& v = vshader[vshader_src];
-    if (!v.id) v.init(GL_VERTEX_SHADER, vshader_src);
-
-    auto& f = fshader[fshader_src];
-    if (!f.id) f.init(GL_FRAGMENT_SHADER, fshader_src);
-
-    auto& p = program[{v.id, f.id}];
+    auto& p = program[{vshader_src, fshader_src}];
     if (!p.id)
     {
         p.id = glCreateProgram();
-        glAttachShader(p.id, v.id);
-        glAttachShader(p.id, f.id);
+        if (binary_cache && binary_cache->load(p.id, vshader_src, fshader_src))
+            return p.id;
+
+        try
+        {
+            auto& v = vshader[vshader_src];
+            if (!v.id) v.init(GL_VERTEX_SHADER, vshader_src);
+
+            auto& f = fshader[fshader_src];
+            if (!f.id) f.init(GL_FRAGMENT_SHADER, fshader_src);
+
+            glAttachShader(p.id, v.id);
+            glAttachShader(p.id, f.id);
+        }
+        catch (...)
+        {
+            glDeleteProgram(p.id);
+            p.id = 0;
+            throw;
+        }
+
         glLinkProgram(p.id);
         GLint ok;
         glGetProgramiv(p.id, GL_LINK_STATUS, &ok);
@@ -109,10 +128,13 @@ GLuint ProgramFamily::add_program(const GLchar* const vshader_src,
             GLchar log[1024];
             glGetProgramInfoLog(p.id, sizeof log - 1, NULL, log);
             log[sizeof log - 1] = '\0';
-            glDeleteShader(p.id);
+            glDeleteProgram(p.id);
             p.id = 0;
             throw std::runtime_error(std::string("Link failed: ")+log);
         }
+
+        if (binary_cache)
+            binary_cache->store(p.id, vshader_src, fshader_src);
     }
 
     return p.id;
@@ -22,10 +22,12 @@
 #include MIR_SERVER_GL_H
 #include <utility>
 #include <map>
+#include <memory>
 #include <unordered_map>
 
 namespace mir
 {
+namespace gl { class ProgramBinaryCache; }
 namespace renderer
 {
 namespace gl
@@ -43,6 +45,7 @@ class ProgramFamily
 {
 public:
     ProgramFamily() = default;
+    explicit ProgramFamily(std::shared_ptr<mir::gl::ProgramBinaryCache> const& binary_cache);
     ProgramFamily(ProgramFamily const&) = delete;
     ProgramFamily& operator=(ProgramFamily const&) = delete;
     ~ProgramFamily() noexcept;
@@ -59,12 +62,14 @@ private:
     typedef std::unordered_map<const GLchar*, Shader> ShaderMap;
     ShaderMap vshader, fshader;
 
-    typedef std::pair<GLuint, GLuint> ShaderPair;
+    typedef std::pair<const GLchar*, const GLchar*> SourcePair;
     struct Program
     {
         GLuint id = 0;
     };
-    std::map<ShaderPair, Program> program;
+    std::map<SourcePair, Program> program;
+
+    std::shared_ptr<mir::gl::ProgramBinaryCache> const binary_cache;
 };
 
 }
@@ -35,7 +35,7 @@
 
 namespace mir
 {
-namespace gl { class TextureCache; }
+namespace gl { class TextureCache; class SharedTextures; class ProgramBinaryCache; }
 namespace graphics { class DisplayBuffer; }
 namespace renderer
 {
@@ -60,6 +60,12 @@ class Renderer : public renderer::Renderer
 {
 public:
     Renderer(graphics::DisplayBuffer& display_buffer);
+    /// Shares the textures of buffers with the other renderers using
+    /// shared_textures (whose GL contexts must be in a share group), and
+    /// loads its programs from program_cache where possible
+    Renderer(graphics::DisplayBuffer& display_buffer,
+             std::shared_ptr<mir::gl::SharedTextures> const& shared_textures,
+             std::shared_ptr<mir::gl::ProgramBinaryCache> const& program_cache);
     virtual ~Renderer();
 
     // These are called with a valid GL context:
@@ -19,12 +19,25 @@
 #include "renderer_factory.h"
 #include "renderer.h"
 #include "mir/graphics/display_buffer.h"
+#include "mir/gl/shared_textures.h"
+#include "mir/gl/program_binary_cache.h"
 
 namespace mrg = mir::renderer::gl;
 
+mrg::RendererFactory::RendererFactory() :
+    RendererFactory(std::string{})
+{
+}
+
+mrg::RendererFactory::RendererFactory(std::string const& program_cache_dir) :
+    shared_textures{std::make_shared<mir::gl::SharedTextures>()},
+    program_cache{std::make_shared<mir::gl::ProgramBinaryCache>(program_cache_dir)}
+{
+}
+
 std::unique_ptr<mir::renderer::Renderer>
 mrg::RendererFactory::create_renderer_for(
     graphics::DisplayBuffer& display_buffer)
 {
-    return std::make_unique<Renderer>(display_buffer);
+    return std::make_unique<Renderer>(display_buffer, shared_textures, program_cache);
 }
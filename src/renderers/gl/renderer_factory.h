@@ -21,8 +21,12 @@
 
 #include "mir/renderer/renderer_factory.h"
 
+#include <memory>
+#include <string>
+
 namespace mir
 {
+namespace gl { class SharedTextures; class ProgramBinaryCache; }
 namespace renderer
 {
 namespace gl
@@ -31,8 +35,18 @@ namespace gl
 class RendererFactory : public renderer::RendererFactory
 {
 public:
+    RendererFactory();
+    /// Keeps linked GL programs in program_cache_dir so that later runs can
+    /// skip building them (an empty path keeps them in memory only)
+    explicit RendererFactory(std::string const& program_cache_dir);
+
     std::unique_ptr<renderer::Renderer> create_renderer_for(
         graphics::DisplayBuffer& display_buffer) override;
+
+private:
+    // The display buffers' GL contexts are all in the platform's share group
+    std::shared_ptr<mir::gl::SharedTextures> const shared_textures;
+    std::shared_ptr<mir::gl::ProgramBinaryCache> const program_cache;
 };
 
 }
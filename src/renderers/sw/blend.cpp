@@ -0,0 +1,289 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "blend.h"
+
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define MIR_BLEND_X86
+#include <immintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define MIR_BLEND_NEON
+#include <arm_neon.h>
+#endif
+
+namespace mrs = mir::renderer::software;
+
+namespace
+{
+typedef void (*BlendKernel)(uint8_t const* src, uint8_t* dst, size_t count, unsigned alpha);
+
+struct Kernels
+{
+    BlendKernel premultiplied;
+    BlendKernel constant;
+    char const* name;
+};
+
+// x * y / 255, rounded to nearest
+inline unsigned mul255(unsigned x, unsigned y)
+{
+    auto const t = x * y + 128;
+    return (t + (t >> 8)) >> 8;
+}
+
+void premultiplied_scalar(uint8_t const* src, uint8_t* dst, size_t count, unsigned alpha)
+{
+    for (size_t i = 0; i != 4 * count; i += 4)
+    {
+        auto const inverse = 255 - mul255(src[i + 3], alpha);
+        // Saturating, in case a client's colours exceed its alpha
+        for (size_t c = 0; c != 4; ++c)
+            dst[i + c] = std::min(255u, mul255(src[i + c], alpha) + mul255(dst[i + c], inverse));
+    }
+}
+
+void constant_scalar(uint8_t const* src, uint8_t* dst, size_t count, unsigned alpha)
+{
+    for (size_t i = 0; i != 4 * count; ++i)
+        dst[i] = mul255(src[i], alpha) + mul255(dst[i], 255 - alpha);
+}
+
+#ifdef MIR_BLEND_X86
+// The SSE2 and AVX2 kernels widen each channel to 16 bits, where x * y + 128
+// cannot overflow for 8 bit x and y
+
+__attribute__((target("sse2")))
+inline __m128i mul255_sse2(__m128i x, __m128i y)
+{
+    auto const t = _mm_add_epi16(_mm_mullo_epi16(x, y), _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+}
+
+__attribute__((target("sse2")))
+inline __m128i alphas_sse2(__m128i pixels)
+{
+    return _mm_shufflehi_epi16(_mm_shufflelo_epi16(pixels, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+}
+
+__attribute__((target("sse2")))
+void premultiplied_sse2(uint8_t const* src, uint8_t* dst, size_t count, unsigned alpha)
+{
+    auto const zero = _mm_setzero_si128();
+    auto const opacity = _mm_set1_epi16(alpha);
+    auto const max = _mm_set1_epi16(255);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        auto const s = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + 4 * i));
+        auto const d = _mm_loadu_si128(reinterpret_cast<__m128i const*>(dst + 4 * i));
+
+        auto const s_lo = mul255_sse2(_mm_unpacklo_epi8(s, zero), opacity);
+        auto const s_hi = mul255_sse2(_mm_unpackhi_epi8(s, zero), opacity);
+        auto const d_lo = mul255_sse2(_mm_unpacklo_epi8(d, zero), _mm_sub_epi16(max, alphas_sse2(s_lo)));
+        auto const d_hi = mul255_sse2(_mm_unpackhi_epi8(d, zero), _mm_sub_epi16(max, alphas_sse2(s_hi)));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4 * i),
+                         _mm_packus_epi16(_mm_add_epi16(s_lo, d_lo), _mm_add_epi16(s_hi, d_hi)));
+    }
+
+    premultiplied_scalar(src + 4 * i, dst + 4 * i, count - i, alpha);
+}
+
+__attribute__((target("sse2")))
+void constant_sse2(uint8_t const* src, uint8_t* dst, size_t count, unsigned alpha)
+{
+    auto const zero = _mm_setzero_si128();
+    auto const opacity = _mm_set1_epi16(alpha);
+    auto const transparency = _mm_set1_epi16(255 - alpha);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        auto const s = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + 4 * i));
+        auto const d = _mm_loadu_si128(reinterpret_cast<__m128i const*>(dst + 4 * i));
+
+        auto const lo = _mm_add_epi16(
+            mul255_sse2(_mm_unpacklo_epi8(s, zero), opacity),
+            mul255_sse2(_mm_unpacklo_epi8(d, zero), transparency));
+        auto const hi = _mm_add_epi16(
+            mul255_sse2(_mm_unpackhi_epi8(s, zero), opacity),
+            mul255_sse2(_mm_unpackhi_epi8(d, zero), transparency));
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4 * i), _mm_packus_epi16(lo, hi));
+    }
+
+    constant_scalar(src + 4 * i, dst + 4 * i, count - i, alpha);
+}
+
+__attribute__((target("avx2")))
+inline __m256i mul255_avx2(__m256i x, __m256i y)
+{
+    auto const t = _mm256_add_epi16(_mm256_mullo_epi16(x, y), _mm256_set1_epi16(128));
+    return _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+}
+
+__attribute__((target("avx2")))
+inline __m256i alphas_avx2(__m256i pixels)
+{
+    return _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(pixels, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+}
+
+// Unpacking and packing both work within 128 bit lanes, so the pixels come
+// back out in the order they went in
+__attribute__((target("avx2")))
+void premultiplied_avx2(uint8_t const* src, uint8_t* dst, size_t count, unsigned alpha)
+{
+    auto const zero = _mm256_setzero_si256();
+    auto const opacity = _mm256_set1_epi16(alpha);
+    auto const max = _mm256_set1_epi16(255);
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        auto const s = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(src + 4 * i));
+        auto const d = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(dst + 4 * i));
+
+        auto const s_lo = mul255_avx2(_mm256_unpacklo_epi8(s, zero), opacity);
+        auto const s_hi = mul255_avx2(_mm256_unpackhi_epi8(s, zero), opacity);
+        auto const d_lo = mul255_avx2(_mm256_unpacklo_epi8(d, zero), _mm256_sub_epi16(max, alphas_avx2(s_lo)));
+        auto const d_hi = mul255_avx2(_mm256_unpackhi_epi8(d, zero), _mm256_sub_epi16(max, alphas_avx2(s_hi)));
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 4 * i),
+                            _mm256_packus_epi16(_mm256_add_epi16(s_lo, d_lo), _mm256_add_epi16(s_hi, d_hi)));
+    }
+
+    premultiplied_sse2(src + 4 * i, dst + 4 * i, count - i, alpha);
+}
+
+__attribute__((target("avx2")))
+void constant_avx2(uint8_t const* src, uint8_t* dst, size_t count, unsigned alpha)
+{
+    auto const zero = _mm256_setzero_si256();
+    auto const opacity = _mm256_set1_epi16(alpha);
+    auto const transparency = _mm256_set1_epi16(255 - alpha);
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        auto const s = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(src + 4 * i));
+        auto const d = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(dst + 4 * i));
+
+        auto const lo = _mm256_add_epi16(
+            mul255_avx2(_mm256_unpacklo_epi8(s, zero), opacity),
+            mul255_avx2(_mm256_unpacklo_epi8(d, zero), transparency));
+        auto const hi = _mm256_add_epi16(
+            mul255_avx2(_mm256_unpackhi_epi8(s, zero), opacity),
+            mul255_avx2(_mm256_unpackhi_epi8(d, zero), transparency));
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 4 * i), _mm256_packus_epi16(lo, hi));
+    }
+
+    constant_sse2(src + 4 * i, dst + 4 * i, count - i, alpha);
+}
+#endif
+
+#ifdef MIR_BLEND_NEON
+// (t + ((t + 128) >> 8) + 128) >> 8 is the same rounding as mul255()
+inline uint8x8_t mul255_neon(uint8x8_t x, uint8x8_t y)
+{
+    auto const t = vmull_u8(x, y);
+    return vraddhn_u16(t, vrshrq_n_u16(t, 8));
+}
+
+void premultiplied_neon(uint8_t const* src, uint8_t* dst, size_t count, unsigned alpha)
+{
+    auto const opacity = vdup_n_u8(alpha);
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        auto s = vld4_u8(src + 4 * i);
+        auto d = vld4_u8(dst + 4 * i);
+
+        for (int c = 0; c != 4; ++c)
+            s.val[c] = mul255_neon(s.val[c], opacity);
+
+        auto const inverse = vmvn_u8(s.val[3]);
+        for (int c = 0; c != 4; ++c)
+            d.val[c] = vqadd_u8(s.val[c], mul255_neon(d.val[c], inverse));
+
+        vst4_u8(dst + 4 * i, d);
+    }
+
+    premultiplied_scalar(src + 4 * i, dst + 4 * i, count - i, alpha);
+}
+
+void constant_neon(uint8_t const* src, uint8_t* dst, size_t count, unsigned alpha)
+{
+    auto const opacity = vdup_n_u8(alpha);
+    auto const transparency = vdup_n_u8(255 - alpha);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        auto const s = vld1q_u8(src + 4 * i);
+        auto const d = vld1q_u8(dst + 4 * i);
+
+        auto const lo = vadd_u8(
+            mul255_neon(vget_low_u8(s), opacity), mul255_neon(vget_low_u8(d), transparency));
+        auto const hi = vadd_u8(
+            mul255_neon(vget_high_u8(s), opacity), mul255_neon(vget_high_u8(d), transparency));
+
+        vst1q_u8(dst + 4 * i, vcombine_u8(lo, hi));
+    }
+
+    constant_scalar(src + 4 * i, dst + 4 * i, count - i, alpha);
+}
+#endif
+
+Kernels select_kernels()
+{
+#if defined(MIR_BLEND_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return {premultiplied_avx2, constant_avx2, "avx2"};
+    if (__builtin_cpu_supports("sse2"))
+        return {premultiplied_sse2, constant_sse2, "sse2"};
+#elif defined(MIR_BLEND_NEON)
+    return {premultiplied_neon, constant_neon, "neon"};
+#endif
+    return {premultiplied_scalar, constant_scalar, "scalar"};
+}
+
+Kernels const& kernels()
+{
+    static Kernels const selected = select_kernels();
+    return selected;
+}
+}
+
+void mrs::blend_premultiplied(uint8_t const* src, uint8_t* dst, size_t count, unsigned alpha)
+{
+    kernels().premultiplied(src, dst, count, alpha);
+}
+
+void mrs::blend_constant(uint8_t const* src, uint8_t* dst, size_t count, unsigned alpha)
+{
+    kernels().constant(src, dst, count, alpha);
+}
+
+char const* mrs::blend_kernels()
+{
+    return kernels().name;
+}
@@ -0,0 +1,55 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_RENDERER_SW_BLEND_H_
+#define MIR_RENDERER_SW_BLEND_H_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mir
+{
+namespace renderer
+{
+namespace software
+{
+/*!
+ * \name Row blending kernels
+ *
+ * Each draws count 4-byte pixels from src over those in dst, both with
+ * their channels in the same order and alpha last, applying the window
+ * opacity alpha (0-255). Products are rounded as GL would round them. The
+ * fastest implementation the running CPU supports (AVX2, SSE2, NEON or
+ * plain C++) is picked on first use.
+ * \{
+ */
+
+/// For sources with premultiplied alpha: the GL renderer's blend for shaped surfaces
+void blend_premultiplied(std::uint8_t const* src, std::uint8_t* dst, std::size_t count, unsigned alpha);
+
+/// For sources whose alpha channel is to be ignored: a constant-alpha cross-fade
+void blend_constant(std::uint8_t const* src, std::uint8_t* dst, std::size_t count, unsigned alpha);
+
+/// The name of the kernels in use ("avx2", "sse2", "neon" or "scalar")
+char const* blend_kernels();
+/*!
+ * \}
+ */
+}
+}
+}
+
+#endif /* MIR_RENDERER_SW_BLEND_H_ */
@@ -0,0 +1,405 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "renderer.h"
+#include "blend.h"
+
+#include "mir/renderer/sw/pixel_source.h"
+#include "mir/geometry/displacement.h"
+#include "mir/graphics/buffer.h"
+#include "mir/graphics/pixel_conversion.h"
+#include "mir/thread/basic_thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <future>
+#include <unordered_map>
+
+namespace mrs = mir::renderer::software;
+namespace mg = mir::graphics;
+namespace geom = mir::geometry;
+
+namespace
+{
+// How many frames of damage to remember for buffer age
+size_t const max_buffer_age{4};
+// Too few tiles to be worth handing to another thread
+size_t const tiles_per_task{4};
+
+bool supported(MirPixelFormat format)
+{
+    switch (format)
+    {
+    case mir_pixel_format_argb_8888:
+    case mir_pixel_format_xrgb_8888:
+    case mir_pixel_format_abgr_8888:
+    case mir_pixel_format_xbgr_8888:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Whether the bytes in memory are red, green, blue (rather than blue, green, red)
+bool red_first(MirPixelFormat format)
+{
+    return format == mir_pixel_format_abgr_8888 || format == mir_pixel_format_xbgr_8888;
+}
+}
+
+struct mrs::Renderer::Layer
+{
+    enum class Mode { copy, premultiplied, constant };
+
+    PixelSource* source;
+    unsigned char const* pixels;
+    geom::Stride stride;
+    geom::Size size;
+    geom::Rectangle position;
+    Mode mode;
+    unsigned alpha;
+    bool swap_red_and_blue;
+};
+
+mrs::Renderer::Renderer(
+    PixelTarget& target,
+    std::shared_ptr<thread::BasicThreadPool> const& workers,
+    unsigned worker_count) :
+    target(target),
+    workers{workers},
+    worker_count{std::max(worker_count, 1u)}
+{
+}
+
+mrs::Renderer::~Renderer() = default;
+
+void mrs::Renderer::set_viewport(geom::Rectangle const& rect)
+{
+    if (rect != viewport)
+    {
+        viewport = rect;
+        redraw_everything = true;
+    }
+}
+
+void mrs::Renderer::set_output_transform(glm::mat2 const&)
+{
+    // PixelTargets report an identity transformation and rotate as they show frames
+}
+
+void mrs::Renderer::suspend()
+{
+    // Whatever is shown instead may have used our buffers
+    redraw_everything = true;
+}
+
+void mrs::Renderer::render(mg::RenderableList const& renderables) const
+{
+    std::vector<Drawn> frame;
+    frame.reserve(renderables.size());
+    for (auto const& renderable : renderables)
+    {
+        frame.push_back({renderable->id(), renderable->buffer()->id(), renderable->screen_position(),
+                         renderable->alpha(), renderable->shaped()});
+    }
+
+    auto damage = damage_since_last_frame(frame);
+    if (redraw_everything)
+        damage = geom::Rectangles{viewport};
+
+    last_frame = std::move(frame);
+
+    // Nothing has changed, so the frame on screen can stay there
+    if (damage.size() == 0)
+        return;
+
+    auto const pixels = target.back_buffer();
+    auto const tiles = tiles_to_redraw(damage, pixels.age);
+    if (tiles.empty())
+        return;
+
+    redraw_everything = false;
+    damage_history.push_front(damage);
+    if (damage_history.size() > max_buffer_age)
+        damage_history.pop_back();
+
+    std::vector<Layer> layers;
+    layers.reserve(renderables.size());
+    for (auto const& renderable : renderables)
+    {
+        auto const buffer = renderable->buffer();
+        auto const source = dynamic_cast<PixelSource*>(buffer->native_buffer_base());
+        auto const position = renderable->screen_position();
+
+        if (!source || !supported(buffer->pixel_format()) ||
+            position.intersection_with(viewport).size == geom::Size{})
+        {
+            continue;
+        }
+
+        auto mode = Layer::Mode::copy;
+        if (renderable->shaped())
+            mode = Layer::Mode::premultiplied;
+        else if (renderable->alpha() < 1.0f)
+            mode = Layer::Mode::constant;
+
+        layers.push_back({
+            source, nullptr, source->stride(), buffer->size(), position, mode,
+            static_cast<unsigned>(std::lround(std::min(std::max(renderable->alpha(), 0.0f), 1.0f) * 255)),
+            red_first(buffer->pixel_format()) != red_first(pixels.format)});
+    }
+
+    // Pixels are only ours to read within PixelSource::read(), so draw
+    // within the nested reads of every layer
+    std::function<void(size_t)> const read_from = [&](size_t i)
+        {
+            if (i == layers.size())
+            {
+                draw(pixels, layers, tiles);
+                return;
+            }
+
+            layers[i].source->read([&](unsigned char const* source_pixels)
+                {
+                    layers[i].pixels = source_pixels;
+                    read_from(i + 1);
+                });
+        };
+    read_from(0);
+
+    target.swap_buffers(damage);
+}
+
+geom::Rectangles mrs::Renderer::damage_since_last_frame(std::vector<Drawn> const& frame) const
+{
+    geom::Rectangles damage;
+
+    std::unordered_map<mg::Renderable::ID, Drawn const*> before, after;
+    for (auto const& drawn : last_frame)
+        before[drawn.id] = &drawn;
+    for (auto const& drawn : frame)
+        after[drawn.id] = &drawn;
+
+    // Whatever appeared, disappeared, moved or changed its content
+    std::vector<mg::Renderable::ID> kept_before, kept_after;
+    for (auto const& drawn : frame)
+    {
+        auto const i = before.find(drawn.id);
+        if (i == before.end())
+        {
+            damage.add(drawn.position);
+            continue;
+        }
+
+        auto const& previous = *i->second;
+        if (previous.buffer != drawn.buffer || previous.position != drawn.position ||
+            previous.alpha != drawn.alpha || previous.shaped != drawn.shaped)
+        {
+            damage.add(previous.position);
+            damage.add(drawn.position);
+        }
+        kept_after.push_back(drawn.id);
+    }
+
+    for (auto const& drawn : last_frame)
+    {
+        if (after.count(drawn.id))
+            kept_before.push_back(drawn.id);
+        else
+            damage.add(drawn.position);
+    }
+
+    // ...and whatever was restacked
+    for (size_t i = 0; i != kept_before.size(); ++i)
+    {
+        if (kept_before[i] != kept_after[i])
+        {
+            damage.add(before[kept_before[i]]->position);
+            damage.add(after[kept_after[i]]->position);
+        }
+    }
+
+    return damage;
+}
+
+auto mrs::Renderer::tiles_to_redraw(geom::Rectangles const& damage, unsigned buffer_age) const
+-> std::vector<geom::Rectangle>
+{
+    geom::Rectangles redraw{damage};
+    if (buffer_age == 0 || buffer_age - 1 > damage_history.size())
+    {
+        redraw = geom::Rectangles{viewport};
+    }
+    else
+    {
+        for (unsigned frame = 0; frame + 1 < buffer_age; ++frame)
+        {
+            for (auto const& rect : damage_history[frame])
+                redraw.add(rect);
+        }
+    }
+
+    auto const columns = (viewport.size.width.as_int() + tile_size - 1) / tile_size;
+    auto const rows = (viewport.size.height.as_int() + tile_size - 1) / tile_size;
+    std::vector<bool> marked(columns * rows, false);
+
+    for (auto const& rect : redraw)
+    {
+        auto const area = rect.intersection_with(viewport);
+        if (area.size == geom::Size{})
+            continue;
+
+        auto const left = (area.top_left.x - viewport.top_left.x).as_int() / tile_size;
+        auto const top = (area.top_left.y - viewport.top_left.y).as_int() / tile_size;
+        auto const right = ((area.right() - viewport.top_left.x).as_int() + tile_size - 1) / tile_size;
+        auto const bottom = ((area.bottom() - viewport.top_left.y).as_int() + tile_size - 1) / tile_size;
+
+        for (auto row = top; row != bottom; ++row)
+            std::fill(marked.begin() + row * columns + left, marked.begin() + row * columns + right, true);
+    }
+
+    std::vector<geom::Rectangle> tiles;
+    for (int row = 0; row != rows; ++row)
+    {
+        for (int column = 0; column != columns; ++column)
+        {
+            if (!marked[row * columns + column])
+                continue;
+
+            geom::Rectangle const tile{
+                viewport.top_left + geom::Displacement{column * tile_size, row * tile_size},
+                geom::Size{tile_size, tile_size}};
+            tiles.push_back(tile.intersection_with(viewport));
+        }
+    }
+
+    return tiles;
+}
+
+void mrs::Renderer::draw(
+    PixelTarget::Pixels const& pixels,
+    std::vector<Layer> const& layers,
+    std::vector<geom::Rectangle> const& tiles) const
+{
+    geom::Rectangle const output{viewport.top_left, pixels.size};
+
+    auto const draw_tile = [&](geom::Rectangle const& view_tile)
+        {
+            auto const tile = view_tile.intersection_with(output);
+            if (tile.size == geom::Size{})
+                return;
+
+            auto const destination = [&](geom::Point point)
+                {
+                    return pixels.data + (point.y - output.top_left.y).as_int() * pixels.stride.as_int() +
+                           (point.x - output.top_left.x).as_int() * 4;
+                };
+            auto const width = tile.size.width.as_int();
+
+            // Nothing beneath the topmost layer that covers the tile opaquely can show
+            auto bottom = layers.size();
+            while (bottom-- > 0)
+            {
+                if (layers[bottom].mode == Layer::Mode::copy && layers[bottom].position.contains(tile))
+                    break;
+            }
+
+            if (bottom > layers.size())
+            {
+                bottom = 0;
+                for (auto y = tile.top(); y != tile.bottom(); y += geom::DeltaY{1})
+                    memset(destination({tile.left(), y}), 0, width * 4);
+            }
+
+            unsigned char scratch[tile_size * 4];
+            for (auto i = bottom; i != layers.size(); ++i)
+            {
+                auto const& layer = layers[i];
+                auto const area = layer.position.intersection_with(tile);
+                if (area.size == geom::Size{})
+                    continue;
+
+                auto const count = area.size.width.as_int();
+                bool const scaled = layer.size != layer.position.size;
+
+                for (auto y = area.top(); y != area.bottom(); y += geom::DeltaY{1})
+                {
+                    auto const dy = (y - layer.position.top()).as_int();
+                    auto const dx = (area.left() - layer.position.left()).as_int();
+
+                    unsigned char const* source;
+                    if (scaled)
+                    {
+                        // Nearest neighbour, for buffers of a different size to their surface
+                        auto const row = layer.pixels + layer.stride.as_int() *
+                            (dy * layer.size.height.as_int() / layer.position.size.height.as_int());
+                        for (int x = 0; x != count; ++x)
+                        {
+                            auto const column = (dx + x) * layer.size.width.as_int() / layer.position.size.width.as_int();
+                            memcpy(scratch + 4 * x, row + 4 * column, 4);
+                        }
+                        source = scratch;
+                    }
+                    else
+                    {
+                        source = layer.pixels + dy * layer.stride.as_int() + dx * 4;
+                    }
+
+                    auto const target_row = destination({area.left(), y});
+
+                    if (layer.mode == Layer::Mode::copy)
+                    {
+                        if (layer.swap_red_and_blue)
+                            mg::copy_swapping_red_and_blue(source, target_row, count);
+                        else
+                            memcpy(target_row, source, count * 4);
+                        continue;
+                    }
+
+                    if (layer.swap_red_and_blue)
+                    {
+                        mg::copy_swapping_red_and_blue(source, scratch, count);
+                        source = scratch;
+                    }
+
+                    if (layer.mode == Layer::Mode::premultiplied)
+                        blend_premultiplied(source, target_row, count, layer.alpha);
+                    else
+                        blend_constant(source, target_row, count, layer.alpha);
+                }
+            }
+        };
+
+    std::atomic<size_t> next_tile{0};
+    auto const draw_tiles = [&]
+        {
+            for (auto i = next_tile++; i < tiles.size(); i = next_tile++)
+                draw_tile(tiles[i]);
+        };
+
+    auto const tasks = std::min<size_t>(worker_count, (tiles.size() + tiles_per_task - 1) / tiles_per_task);
+
+    std::vector<std::future<void>> helpers;
+    for (size_t i = 1; i < tasks; ++i)
+        helpers.push_back(workers->run(draw_tiles));
+
+    draw_tiles();
+
+    for (auto& helper : helpers)
+        helper.get();
+}
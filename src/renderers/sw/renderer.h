@@ -0,0 +1,96 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_RENDERER_SW_RENDERER_H_
+#define MIR_RENDERER_SW_RENDERER_H_
+
+#include "mir/renderer/renderer.h"
+#include "mir/renderer/sw/pixel_target.h"
+#include "mir/geometry/rectangles.h"
+#include "mir/graphics/buffer_id.h"
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+namespace mir
+{
+namespace thread { class BasicThreadPool; }
+namespace renderer
+{
+namespace software
+{
+/**
+ * Composites, with the CPU, the renderables whose buffers offer a
+ * PixelSource in one of the 8888 formats; others are not drawn.
+ *
+ * Only the parts of the view that have changed since the back buffer was
+ * last drawn are redrawn: the view is divided into tiles, and each tile
+ * that needs redrawing is drawn, in parallel, from the topmost renderable
+ * that covers it opaquely upwards. Frames are drawn in the view's own
+ * orientation; a PixelTarget on a rotated output rotates them as it
+ * shows them.
+ */
+class Renderer : public renderer::Renderer
+{
+public:
+    static int const tile_size = 64;
+
+    Renderer(
+        PixelTarget& target,
+        std::shared_ptr<thread::BasicThreadPool> const& workers,
+        unsigned worker_count);
+    ~Renderer();
+
+    void set_viewport(geometry::Rectangle const& rect) override;
+    void set_output_transform(glm::mat2 const&) override;
+    void render(graphics::RenderableList const&) const override;
+    void suspend() override;
+
+private:
+    struct Drawn
+    {
+        graphics::Renderable::ID id;
+        graphics::BufferID buffer;
+        geometry::Rectangle position;
+        float alpha;
+        bool shaped;
+    };
+    struct Layer;
+
+    geometry::Rectangles damage_since_last_frame(std::vector<Drawn> const& frame) const;
+    std::vector<geometry::Rectangle> tiles_to_redraw(geometry::Rectangles const& damage, unsigned buffer_age) const;
+    void draw(
+        PixelTarget::Pixels const& pixels,
+        std::vector<Layer> const& layers,
+        std::vector<geometry::Rectangle> const& tiles) const;
+
+    PixelTarget& target;
+    std::shared_ptr<thread::BasicThreadPool> const workers;
+    unsigned const worker_count;
+
+    geometry::Rectangle viewport;
+    mutable bool redraw_everything{true};
+    mutable std::vector<Drawn> last_frame;
+    /// The damage of the frames most recently shown, latest first
+    mutable std::deque<geometry::Rectangles> damage_history;
+};
+
+}
+}
+}
+
+#endif /* MIR_RENDERER_SW_RENDERER_H_ */
@@ -0,0 +1,42 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "renderer_factory.h"
+#include "renderer.h"
+#include "mir/graphics/display_buffer.h"
+#include "mir/thread/basic_thread_pool.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace mrs = mir::renderer::software;
+
+mrs::RendererFactory::RendererFactory(std::shared_ptr<renderer::RendererFactory> const& fallback) :
+    fallback{fallback},
+    worker_count{std::max(std::thread::hardware_concurrency(), 1u)},
+    workers{std::make_shared<thread::BasicThreadPool>(worker_count - 1)}
+{
+}
+
+std::unique_ptr<mir::renderer::Renderer>
+mrs::RendererFactory::create_renderer_for(
+    graphics::DisplayBuffer& display_buffer)
+{
+    if (auto const target = dynamic_cast<PixelTarget*>(display_buffer.native_display_buffer()))
+        return std::make_unique<Renderer>(*target, workers, worker_count);
+
+    return fallback->create_renderer_for(display_buffer);
+}
@@ -0,0 +1,55 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_RENDERER_SW_RENDERER_FACTORY_H_
+#define MIR_RENDERER_SW_RENDERER_FACTORY_H_
+
+#include "mir/renderer/renderer_factory.h"
+
+#include <memory>
+
+namespace mir
+{
+namespace thread { class BasicThreadPool; }
+namespace renderer
+{
+namespace software
+{
+
+/**
+ * Creates software renderers for the display buffers that are PixelTargets,
+ * and leaves the others to the fallback factory.
+ */
+class RendererFactory : public renderer::RendererFactory
+{
+public:
+    explicit RendererFactory(std::shared_ptr<renderer::RendererFactory> const& fallback);
+
+    std::unique_ptr<renderer::Renderer> create_renderer_for(
+        graphics::DisplayBuffer& display_buffer) override;
+
+private:
+    std::shared_ptr<renderer::RendererFactory> const fallback;
+    unsigned const worker_count;
+    // Shared by the renderers of all outputs, whose compositors take turns
+    std::shared_ptr<thread::BasicThreadPool> const workers;
+};
+
+}
+}
+}
+
+#endif /* MIR_RENDERER_SW_RENDERER_FACTORY_H_ */
@@ -0,0 +1,87 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "buffer_count_advisor.h"
+
+namespace mc = mir::compositor;
+
+int const mc::BufferCountAdvisor::reduced_buffer_count;
+int const mc::BufferCountAdvisor::client_buffer_count;
+
+mc::BufferCountAdvisor::BufferCountAdvisor(
+    unsigned int idle_compositions,
+    unsigned int dropped_frames,
+    unsigned int replaced_frames) :
+    idle_compositions{idle_compositions},
+    dropped_frames{dropped_frames},
+    replaced_frames{replaced_frames}
+{
+}
+
+mir::optional_value<int> mc::BufferCountAdvisor::frame_submitted()
+{
+    submitted_since_composition = true;
+    compositions_since_submission = 0;
+    return {};
+}
+
+mir::optional_value<int> mc::BufferCountAdvisor::frame_composited(CompositorID id)
+{
+    drops_since_composition = 0;
+    replacements_since_composition = 0;
+
+    // A compositor coming round again starts the next cycle
+    auto const first_of_cycle = !compositors_this_cycle.insert(id).second || compositors_this_cycle.size() == 1;
+    if (first_of_cycle)
+        compositors_this_cycle = {id};
+
+    if (submitted_since_composition)
+    {
+        submitted_since_composition = false;
+        if (reduced)
+        {
+            reduced = false;
+            return client_buffer_count;
+        }
+        return {};
+    }
+
+    if (first_of_cycle && ++compositions_since_submission == idle_compositions)
+        return reduce();
+    return {};
+}
+
+mir::optional_value<int> mc::BufferCountAdvisor::frame_dropped()
+{
+    if (++drops_since_composition == dropped_frames)
+        return reduce();
+    return {};
+}
+
+mir::optional_value<int> mc::BufferCountAdvisor::frame_replaced()
+{
+    if (++replacements_since_composition == replaced_frames)
+        return reduce();
+    return {};
+}
+
+mir::optional_value<int> mc::BufferCountAdvisor::reduce()
+{
+    if (reduced)
+        return {};
+    reduced = true;
+    return reduced_buffer_count;
+}
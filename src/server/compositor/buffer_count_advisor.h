@@ -0,0 +1,76 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_COMPOSITOR_BUFFER_COUNT_ADVISOR_H_
+#define MIR_COMPOSITOR_BUFFER_COUNT_ADVISOR_H_
+
+#include "mir/compositor/compositor_id.h"
+#include "mir/optional_value.h"
+
+#include <set>
+
+namespace mir
+{
+namespace compositor
+{
+/**
+ * Watches how a stream's frames are produced and consumed, and decides when
+ * the client could get by with fewer buffers (because nothing it renders
+ * reaches the screen) and when it should go back to its own choice.
+ *
+ * Each notification returns the new hint when it changes: a buffer count,
+ * or 0 meaning "whatever the client would normally use". Not threadsafe;
+ * the owning stream serializes the calls.
+ */
+class BufferCountAdvisor
+{
+public:
+    static int const reduced_buffer_count = 2;
+    static int const client_buffer_count = 0;
+
+    BufferCountAdvisor(
+        unsigned int idle_compositions,
+        unsigned int dropped_frames,
+        unsigned int replaced_frames);
+
+    mir::optional_value<int> frame_submitted();
+    // A compositor picked up the stream's content. When several compositors
+    // (one per output) show the stream, only one composition per cycle of
+    // them counts towards the idle threshold
+    mir::optional_value<int> frame_composited(CompositorID id);
+    // A blocked client was handed a buffer back because nothing consumed its frames
+    mir::optional_value<int> frame_dropped();
+    // A frame was replaced by a newer one before any compositor saw it
+    mir::optional_value<int> frame_replaced();
+
+private:
+    mir::optional_value<int> reduce();
+
+    unsigned int const idle_compositions;
+    unsigned int const dropped_frames;
+    unsigned int const replaced_frames;
+
+    bool reduced{false};
+    bool submitted_since_composition{false};
+    unsigned int compositions_since_submission{0};
+    unsigned int drops_since_composition{0};
+    unsigned int replacements_since_composition{0};
+    std::set<CompositorID> compositors_this_cycle;
+};
+}
+}
+
+#endif /* MIR_COMPOSITOR_BUFFER_COUNT_ADVISOR_H_ */
@@ -83,6 +83,18 @@ void mc::BufferMap::send_buffer(mg::BufferID id)
     }
 }
 
+void mc::BufferMap::send_buffer_count_hint(mf::BufferStreamId id, int buffer_count)
+{
+    if (auto s = sink.lock())
+        s->send_buffer_count_hint(id, buffer_count);
+}
+
+void mc::BufferMap::send_present_feedback(mf::BufferStreamId id, mf::PresentFeedback const& feedback)
+{
+    if (auto s = sink.lock())
+        s->send_present_feedback(id, feedback);
+}
+
 void mc::BufferMap::receive_buffer(graphics::BufferID id)
 {
     std::unique_lock<decltype(mutex)> lk(mutex);
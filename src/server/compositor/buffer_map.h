@@ -38,6 +38,8 @@ public:
 
     void receive_buffer(graphics::BufferID id) override;
     void send_buffer(graphics::BufferID id) override;
+    void send_buffer_count_hint(frontend::BufferStreamId id, int buffer_count) override;
+    void send_present_feedback(frontend::BufferStreamId id, frontend::PresentFeedback const& feedback) override;
 
     std::shared_ptr<graphics::Buffer> get(graphics::BufferID) const override;
     
@@ -37,8 +37,10 @@ namespace ms = mir::scene;
 namespace mf = mir::frontend;
 
 mc::BufferStreamFactory::BufferStreamFactory(
-    std::shared_ptr<mc::FrameDroppingPolicyFactory> const& policy_factory) :
-    policy_factory{policy_factory}
+    std::shared_ptr<mc::FrameDroppingPolicyFactory> const& policy_factory,
+    bool skip_unchanged_frames) :
+    policy_factory{policy_factory},
+    skip_unchanged_frames{skip_unchanged_frames}
 {
     assert(policy_factory);
 }
@@ -51,13 +53,16 @@ std::shared_ptr<mc::BufferStream> mc::BufferStreamFactory::create_buffer_stream(
 }
 
 std::shared_ptr<mc::BufferStream> mc::BufferStreamFactory::create_buffer_stream(
-    mf::BufferStreamId, std::shared_ptr<mf::ClientBuffers> const& buffers,
+    mf::BufferStreamId id, std::shared_ptr<mf::ClientBuffers> const& buffers,
     int, mg::BufferProperties const& buffer_properties)
 {
-    return std::make_shared<mc::Stream>(
+    auto const stream = std::make_shared<mc::Stream>(
         *policy_factory,
+        id,
         buffers,
         buffer_properties.size, buffer_properties.format);
+    stream->set_skip_unchanged_frames(skip_unchanged_frames);
+    return stream;
 }
 
 std::shared_ptr<mf::ClientBuffers> mc::BufferStreamFactory::create_buffer_map(
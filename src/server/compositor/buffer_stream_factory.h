@@ -38,7 +38,9 @@ namespace compositor
 class BufferStreamFactory : public scene::BufferStreamFactory
 {
 public:
-    BufferStreamFactory(std::shared_ptr<FrameDroppingPolicyFactory> const& policy_factory);
+    BufferStreamFactory(
+        std::shared_ptr<FrameDroppingPolicyFactory> const& policy_factory,
+        bool skip_unchanged_frames = false);
 
     virtual ~BufferStreamFactory() {}
 
@@ -53,6 +55,7 @@ public:
 
 private:
     std::shared_ptr<FrameDroppingPolicyFactory> const policy_factory;
+    bool const skip_unchanged_frames;
 };
 
 }
@@ -23,9 +23,11 @@
 #include "default_display_buffer_compositor_factory.h"
 #include "multi_threaded_compositor.h"
 #include "gl/renderer_factory.h"
+#include "sw/renderer_factory.h"
 #include "compositing_screencast.h"
 #include "timeout_frame_dropping_policy_factory.h"
 #include "mir/main_loop.h"
+#include "mir/abnormal_exit.h"
 
 #include "mir/frontend/screencast.h"
 #include "mir/options/configuration.h"
@@ -43,7 +45,8 @@ mir::DefaultServerConfiguration::the_buffer_stream_factory()
         [this]()
         {
             return std::make_shared<mc::BufferStreamFactory>(
-                the_frame_dropping_policy_factory());
+                the_frame_dropping_policy_factory(),
+                the_options()->get<bool>(options::skip_unchanged_frames_opt));
         });
 }
 
@@ -92,16 +95,31 @@ mir::DefaultServerConfiguration::the_compositor()
                 the_shell(),
                 the_compositor_report(),
                 composite_delay,
-                !the_options()->is_set(options::host_socket_opt));
+                !the_options()->is_set(options::host_socket_opt),
+                the_options()->get<bool>(options::parallel_outputs_opt));
         });
 }
 
 std::shared_ptr<mir::renderer::RendererFactory> mir::DefaultServerConfiguration::the_renderer_factory()
 {
     return renderer_factory(
-        []()
+        [this]() -> std::shared_ptr<mir::renderer::RendererFactory>
         {
-            return std::make_shared<mir::renderer::gl::RendererFactory>();
+            std::shared_ptr<mir::renderer::RendererFactory> gl_factory;
+            if (the_options()->is_set(options::gl_program_cache_opt))
+                gl_factory = std::make_shared<mir::renderer::gl::RendererFactory>(
+                    the_options()->get<std::string>(options::gl_program_cache_opt));
+            else
+                gl_factory = std::make_shared<mir::renderer::gl::RendererFactory>();
+
+            auto const renderer = the_options()->get<std::string>(options::renderer_opt);
+            if (renderer == "software")
+                return std::make_shared<mir::renderer::software::RendererFactory>(gl_factory);
+            else if (renderer != "gl")
+                throw AbnormalExit(std::string("Invalid ") + options::renderer_opt + " option: " + renderer +
+                                   " (valid options are: \"gl\" and \"software\")");
+
+            return gl_factory;
         });
 }
 
@@ -23,10 +23,13 @@
 #include "mir/compositor/scene_element.h"
 #include "mir/graphics/renderable.h"
 #include "mir/graphics/display_buffer.h"
+#include "mir/graphics/partial_overlay.h"
 #include "mir/graphics/buffer.h"
 #include "mir/compositor/buffer_stream.h"
 #include "mir/renderer/renderer.h"
 #include "occlusion.h"
+#include "presentation_tracker.h"
+#include "temporary_buffers.h"
 #include <mutex>
 #include <cstdlib>
 #include <algorithm>
@@ -74,6 +77,7 @@ void mc::DefaultDisplayBufferCompositor::composite(mc::SceneElementSequence&& sc
 
     if (display_buffer.overlay(renderable_list))
     {
+        drawn(renderable_list, {});
         report->renderables_in_frame(this, renderable_list);
         renderer->suspend();
     }
@@ -81,7 +85,22 @@ void mc::DefaultDisplayBufferCompositor::composite(mc::SceneElementSequence&& sc
     {
         renderer->set_output_transform(display_buffer.transformation());
         renderer->set_viewport(view_area);
-        renderer->render(renderable_list);
+
+        // A display that can't overlay the whole scene may still overlay the
+        // top of it, leaving us to composite what lies beneath
+        auto const partial_overlay =
+            dynamic_cast<mg::PartialOverlay*>(display_buffer.native_display_buffer());
+        if (partial_overlay)
+        {
+            auto const composited = partial_overlay->overlay_top(renderable_list);
+            renderer->render(composited);
+            drawn(renderable_list, composited);
+        }
+        else
+        {
+            renderer->render(renderable_list);
+            drawn(renderable_list, renderable_list);
+        }
 
         report->renderables_in_frame(this, renderable_list);
         report->rendered_frame(this);
@@ -102,3 +121,37 @@ void mc::DefaultDisplayBufferCompositor::composite(mc::SceneElementSequence&& sc
 
     report->finished_frame(this);
 }
+
+void mc::DefaultDisplayBufferCompositor::drawn(
+    mg::RenderableList const& renderables, mg::RenderableList const& composited)
+{
+    for (auto const& renderable : renderables)
+    {
+        auto const buffer = std::dynamic_pointer_cast<TemporaryCompositorBuffer>(renderable->buffer());
+        if (!buffer || !buffer->presentation_tracker())
+            continue;
+
+        auto const how = std::find(composited.begin(), composited.end(), renderable) != composited.end() ?
+            mir_present_result_composited : mir_present_result_bypassed;
+
+        auto const& tracker = buffer->presentation_tracker();
+        auto const feedback = tracker->drawn(buffer->id(), how);
+        if (feedback.is_set())
+            pending_feedback.push_back({tracker, feedback.value()});
+    }
+}
+
+void mc::DefaultDisplayBufferCompositor::frame_posted(
+    std::function<mg::Frame()> const& flip, std::chrono::nanoseconds refresh)
+{
+    if (pending_feedback.empty())
+        return;
+
+    auto const shown = flip();
+    for (auto const& pending : pending_feedback)
+    {
+        if (auto const tracker = pending.tracker.lock())
+            tracker->shown(pending.feedback, shown, refresh);
+    }
+    pending_feedback.clear();
+}
@@ -21,7 +21,9 @@
 
 #include "mir/compositor/display_buffer_compositor.h"
 #include "mir/compositor/compositor_report.h"
+#include "mir/frontend/present_feedback.h"
 #include <memory>
+#include <vector>
 
 namespace mir
 {
@@ -37,6 +39,7 @@ namespace compositor
 {
 
 class Scene;
+class PresentationTracker;
 
 class DefaultDisplayBufferCompositor : public DisplayBufferCompositor
 {
@@ -47,11 +50,22 @@ public:
         std::shared_ptr<CompositorReport> const& report);
 
     void composite(SceneElementSequence&& scene_sequence) override;
+    void frame_posted(std::function<graphics::Frame()> const& flip, std::chrono::nanoseconds refresh) override;
 
 private:
+    void drawn(graphics::RenderableList const& renderables, graphics::RenderableList const& composited);
+
     graphics::DisplayBuffer& display_buffer;
     std::shared_ptr<renderer::Renderer> const renderer;
     std::shared_ptr<CompositorReport> const report;
+
+    // Frames drawn whose clients want to hear when they reach the screen
+    struct Pending
+    {
+        std::weak_ptr<PresentationTracker> tracker;
+        frontend::PresentFeedback feedback;
+    };
+    std::vector<Pending> pending_feedback;
 };
 
 }
@@ -72,3 +72,7 @@ std::shared_ptr<mg::Buffer> mc::DroppingSchedule::next_buffer()
     the_only_buffer = nullptr;
     return buffer;
 }
+
+void mc::DroppingSchedule::frame_missed()
+{
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "fifo_relaxed_schedule.h"
+#include "mir/frontend/client_buffers.h"
+#include "mir/graphics/buffer.h"
+
+#include <boost/throw_exception.hpp>
+#include <algorithm>
+
+namespace mf = mir::frontend;
+namespace mg = mir::graphics;
+namespace mc = mir::compositor;
+
+mc::FifoRelaxedSchedule::FifoRelaxedSchedule(std::shared_ptr<mf::ClientBuffers> const& client_buffers) :
+    sender(client_buffers)
+{
+}
+
+void mc::FifoRelaxedSchedule::schedule(std::shared_ptr<mg::Buffer> const& buffer)
+{
+    auto drop = schedule_nonblocking(buffer);
+    if (drop.valid())
+        drop.wait();
+}
+
+std::future<void> mc::FifoRelaxedSchedule::schedule_nonblocking(
+    std::shared_ptr<mg::Buffer> const& buffer)
+{
+    std::future<void> drop;
+    std::lock_guard<decltype(mutex)> lk(mutex);
+
+    auto it = std::find(queue.begin(), queue.end(), buffer);
+    if (it != queue.end())
+        queue.erase(it);
+
+    if (late && !queue.empty())
+    {
+        drop = std::async(std::launch::deferred,
+            [sender=sender, dropped=std::move(queue)]()
+            {
+                for (auto const& buffer : dropped)
+                    sender->send_buffer(buffer->id());
+            });
+        queue.clear();
+    }
+
+    queue.emplace_back(buffer);
+    return drop;
+}
+
+unsigned int mc::FifoRelaxedSchedule::num_scheduled()
+{
+    std::lock_guard<decltype(mutex)> lk(mutex);
+    return queue.size();
+}
+
+std::shared_ptr<mg::Buffer> mc::FifoRelaxedSchedule::next_buffer()
+{
+    std::lock_guard<decltype(mutex)> lk(mutex);
+    if (queue.empty())
+        BOOST_THROW_EXCEPTION(std::logic_error("no buffer scheduled"));
+    auto buffer = queue.front();
+    queue.pop_front();
+    late = false;
+    return buffer;
+}
+
+void mc::FifoRelaxedSchedule::frame_missed()
+{
+    std::lock_guard<decltype(mutex)> lk(mutex);
+    late = true;
+}
@@ -0,0 +1,55 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_COMPOSITOR_FIFO_RELAXED_SCHEDULE_H_
+#define MIR_COMPOSITOR_FIFO_RELAXED_SCHEDULE_H_
+#include "schedule.h"
+#include <deque>
+#include <memory>
+#include <mutex>
+
+namespace mir
+{
+namespace graphics { class Buffer; }
+namespace frontend { class ClientBuffers; }
+namespace compositor
+{
+/**
+ * Shows every buffer in order, as QueueingSchedule does, until the client
+ * falls behind: once a compositor has had to show a frame again, the client
+ * is late, and a buffer it submits replaces any still waiting so that it is
+ * the one shown next.
+ */
+class FifoRelaxedSchedule : public Schedule
+{
+public:
+    FifoRelaxedSchedule(std::shared_ptr<frontend::ClientBuffers> const&);
+    void schedule(std::shared_ptr<graphics::Buffer> const& buffer) override;
+    std::future<void> schedule_nonblocking(
+        std::shared_ptr<graphics::Buffer> const& buffer) override;
+    unsigned int num_scheduled() override;
+    std::shared_ptr<graphics::Buffer> next_buffer() override;
+    void frame_missed() override;
+
+private:
+    std::mutex mutable mutex;
+    std::shared_ptr<frontend::ClientBuffers> const sender;
+    std::deque<std::shared_ptr<graphics::Buffer>> queue;
+    bool late{false};
+};
+}
+}
+#endif /* MIR_COMPOSITOR_FIFO_RELAXED_SCHEDULE_H_ */
@@ -61,6 +61,8 @@ std::shared_ptr<mg::Buffer> mc::MultiMonitorArbiter::compositor_acquire(composit
     {
         if (schedule->num_scheduled())
             onscreen_buffers.emplace_front(schedule->next_buffer(), 0);
+        else
+            schedule->frame_missed();
         current_buffer_users.clear();
     }
     current_buffer_users.insert(id);
@@ -19,10 +19,14 @@
 #include "multi_threaded_compositor.h"
 #include "mir/graphics/display.h"
 #include "mir/graphics/display_buffer.h"
+#include "mir/graphics/display_configuration.h"
+#include "mir/optional_value.h"
 #include "mir/compositor/display_buffer_compositor.h"
 #include "mir/compositor/display_buffer_compositor_factory.h"
 #include "mir/compositor/display_listener.h"
 #include "mir/compositor/scene.h"
+#include "mir/compositor/scene_element.h"
+#include "mir/compositor/decoration.h"
 #include "mir/compositor/compositor_report.h"
 #include "mir/scene/legacy_scene_change_notification.h"
 #include "mir/scene/surface_observer.h"
@@ -32,6 +36,7 @@
 #include "mir/unwind_helpers.h"
 #include "mir/thread_name.h"
 
+#include <algorithm>
 #include <thread>
 #include <chrono>
 #include <condition_variable>
@@ -43,6 +48,46 @@ namespace mc = mir::compositor;
 namespace mg = mir::graphics;
 namespace ms = mir::scene;
 
+namespace
+{
+// What an output made of an element of the scene it shares with the other outputs of its group
+enum class Seen { neither, occluded, rendered };
+
+class ElementSeenByOutput : public mc::SceneElement
+{
+public:
+    ElementSeenByOutput(std::shared_ptr<mc::SceneElement> const& element, Seen& seen) :
+        element{element},
+        seen(seen)
+    {
+    }
+
+    std::shared_ptr<mg::Renderable> renderable() const override
+    {
+        return element->renderable();
+    }
+
+    void rendered() override
+    {
+        seen = Seen::rendered;
+    }
+
+    void occluded() override
+    {
+        seen = Seen::occluded;
+    }
+
+    std::unique_ptr<mc::Decoration> decoration() const override
+    {
+        return element->decoration();
+    }
+
+private:
+    std::shared_ptr<mc::SceneElement> const element;
+    Seen& seen;
+};
+}
+
 namespace mir
 {
 namespace compositor
@@ -53,17 +98,21 @@ class CompositingFunctor
 public:
     CompositingFunctor(
         std::shared_ptr<mc::DisplayBufferCompositorFactory> const& db_compositor_factory,
+        mg::Display const& display,
         mg::DisplaySyncGroup& group,
         std::shared_ptr<mc::Scene> const& scene,
         std::shared_ptr<DisplayListener> const& display_listener,
         std::chrono::milliseconds fixed_composite_delay,
+        bool parallel_outputs,
         std::shared_ptr<CompositorReport> const& report) :
         compositor_factory{db_compositor_factory},
+        display(display),
         group(group),
         scene(scene),
         running{true},
         frames_scheduled{0},
         force_sleep{fixed_composite_delay},
+        parallel_outputs{parallel_outputs},
         display_listener{display_listener},
         report{report},
         started_future{started.get_future()}
@@ -75,12 +124,32 @@ public:
     {
         mir::set_thread_name("Mir/Comp");
 
-        std::vector<std::tuple<mg::DisplayBuffer*, std::unique_ptr<mc::DisplayBufferCompositor>>> compositors;
+        // A group with a single output has nothing to composite alongside it
+        size_t group_size{0};
+        group.for_each_display_buffer([&group_size](mg::DisplayBuffer&) { ++group_size; });
+
+        // A GL context can be current on only one thread at a time, so each
+        // output compositing in parallel lives and dies on a thread of its own
+        std::unique_ptr<mir::thread::BasicThreadPool> const outputs{
+            parallel_outputs && group_size > 1 ? std::make_unique<mir::thread::BasicThreadPool>(0) : nullptr};
+
+        Compositors compositors;
+        auto const compositors_release = mir::raii::paired_calls([]{},
+            [&outputs, &compositors]
+            {
+                if (!outputs)
+                    return;
+                for (auto& compositor : compositors)
+                    outputs->run([&]{ std::get<1>(compositor).reset(); }, std::get<0>(compositor)).wait();
+            });
+
+        std::vector<ShownOn> shown_on;
+        auto const display_config = display.configuration();
         group.for_each_display_buffer(
-        [this, &compositors](mg::DisplayBuffer& buffer)
+        [this, &outputs, &compositors, &shown_on, &display_config](mg::DisplayBuffer& buffer)
         {
-            compositors.emplace_back(
-                std::make_tuple(&buffer, compositor_factory->create_compositor_for(buffer)));
+            compositors.emplace_back(std::make_tuple(&buffer, create_compositor_for(buffer, outputs.get())));
+            shown_on.push_back(output_showing(*display_config, buffer.view_area()));
 
             auto const& r = buffer.view_area();
             auto const comp_id = std::get<1>(compositors.back()).get();
@@ -97,15 +166,23 @@ public:
             [this, &disp_listener]{group.for_each_display_buffer([&disp_listener](mg::DisplayBuffer& buffer)
                 { disp_listener->remove_display(buffer.view_area()); });});
 
+        // To the scene, outputs compositing in parallel are one compositor
+        std::vector<mc::CompositorID> scene_ids;
+        if (outputs)
+            scene_ids.push_back(&group);
+        else
+            for (auto& compositor : compositors)
+                scene_ids.push_back(std::get<1>(compositor).get());
+
         auto compositor_registration = mir::raii::paired_calls(
-            [this,&compositors]
+            [this,&scene_ids]
             {
-                for (auto& compositor : compositors)
-                    scene->register_compositor(std::get<1>(compositor).get());
+                for (auto id : scene_ids)
+                    scene->register_compositor(id);
             },
-            [this,&compositors]{
-                for (auto& compositor : compositors)
-                    scene->unregister_compositor(std::get<1>(compositor).get());
+            [this,&scene_ids]{
+                for (auto id : scene_ids)
+                    scene->unregister_compositor(id);
             });
 
         started.set_value();
@@ -135,13 +212,27 @@ public:
                     not_posted_yet = false;
                     lock.unlock();
 
-                    for (auto& tuple : compositors)
+                    if (outputs)
+                    {
+                        composite_in_parallel(*outputs, compositors);
+                    }
+                    else
                     {
-                        auto& compositor = std::get<1>(tuple);
-                        compositor->composite(scene->scene_elements_for(compositor.get()));
+                        for (auto& tuple : compositors)
+                        {
+                            auto& compositor = std::get<1>(tuple);
+                            compositor->composite(scene->scene_elements_for(compositor.get()));
+                        }
                     }
                     group.post();
 
+                    for (size_t i = 0; i != compositors.size(); ++i)
+                    {
+                        auto const& output = shown_on[i];
+                        std::get<1>(compositors[i])->frame_posted(
+                            [this, &output] { return last_frame_on(output); }, output.refresh);
+                    }
+
                     /*
                      * "Predictive bypass" optimization: If the last frame was
                      * bypassed/overlayed or you simply have a fast GPU, it is
@@ -162,10 +253,9 @@ public:
                      * to the initial scene_elements_for()...
                      */
                     int pending = 0;
-                    for (auto& compositor : compositors)
+                    for (auto id : scene_ids)
                     {
-                        auto const comp_id = std::get<1>(compositor).get();
-                        int pend = scene->frames_pending(comp_id);
+                        int pend = scene->frames_pending(id);
                         if (pend > pending)
                             pending = pend;
                     }
@@ -231,12 +321,124 @@ public:
     }
 
 private:
+    using Compositors =
+        std::vector<std::tuple<mg::DisplayBuffer*, std::unique_ptr<mc::DisplayBufferCompositor>>>;
+
+    std::unique_ptr<mc::DisplayBufferCompositor> create_compositor_for(
+        mg::DisplayBuffer& buffer, mir::thread::BasicThreadPool* outputs)
+    {
+        if (!outputs)
+            return compositor_factory->create_compositor_for(buffer);
+
+        std::unique_ptr<mc::DisplayBufferCompositor> compositor;
+        outputs->run([&]{ compositor = compositor_factory->create_compositor_for(buffer); }, &buffer).get();
+        return compositor;
+    }
+
+    /*
+     * Composites a frame as a graph of jobs: the scene is snapshotted once
+     * for the whole group, acquiring each client buffer once; then each
+     * output culls and draws the snapshot on its own thread; then what the
+     * outputs made of each element is told to the scene. (Renderers made
+     * by gl::RendererFactory already load each buffer's texture just once,
+     * for all the outputs, through gl::SharedTextures.)
+     *
+     * Only a group with more than one display buffer gains anything, as on
+     * android. The mesa, X11 and eglstream platforms make a group of each
+     * display buffer (cloned outputs share one), so there every output
+     * keeps its own thread, snapshot and timing.
+     */
+    void composite_in_parallel(mir::thread::BasicThreadPool& outputs, Compositors const& compositors)
+    {
+        mc::SceneElementSequence elements;
+        std::shared_future<void> const snapshot =
+            outputs.run([this, &elements]{ elements = scene->scene_elements_for(&group); }).share();
+
+        std::vector<std::vector<Seen>> seen(compositors.size());
+        std::vector<std::shared_future<void>> drawn;
+        for (size_t i = 0; i != compositors.size(); ++i)
+        {
+            auto const compositor = std::get<1>(compositors[i]).get();
+            auto& seen_by_output = seen[i];
+
+            drawn.push_back(outputs.run_after({snapshot},
+                [&elements, &seen_by_output, compositor]
+                {
+                    seen_by_output.assign(elements.size(), Seen::neither);
+
+                    mc::SceneElementSequence view;
+                    view.reserve(elements.size());
+                    for (size_t e = 0; e != elements.size(); ++e)
+                        view.push_back(std::make_shared<ElementSeenByOutput>(elements[e], seen_by_output[e]));
+
+                    compositor->composite(std::move(view));
+                },
+                std::get<0>(compositors[i])).share());
+        }
+
+        outputs.run_after(drawn, [&elements, &seen]
+            {
+                for (size_t e = 0; e != elements.size(); ++e)
+                {
+                    auto const seen_as = [e](Seen how)
+                        {
+                            return [e, how](std::vector<Seen> const& by_output) { return by_output[e] == how; };
+                        };
+
+                    if (std::any_of(seen.begin(), seen.end(), seen_as(Seen::rendered)))
+                        elements[e]->rendered();
+                    else if (std::any_of(seen.begin(), seen.end(), seen_as(Seen::occluded)))
+                        elements[e]->occluded();
+                }
+            }).get();
+    }
+
+    // The output a display buffer shows (the first, if it's cloned)
+    struct ShownOn
+    {
+        mir::optional_value<unsigned> output_id;
+        std::chrono::nanoseconds refresh;
+    };
+
+    static ShownOn output_showing(mg::DisplayConfiguration const& config, geometry::Rectangle const& view_area)
+    {
+        ShownOn shown_on{{}, std::chrono::nanoseconds::zero()};
+        config.for_each_output([&](mg::DisplayConfigurationOutput const& output)
+            {
+                if (shown_on.output_id.is_set() || !output.used || !output.connected ||
+                    output.extents() != view_area || output.current_mode_index >= output.modes.size())
+                {
+                    return;
+                }
+
+                shown_on.output_id = output.id.as_value();
+                auto const hz = output.modes[output.current_mode_index].vrefresh_hz;
+                if (hz > 0)
+                    shown_on.refresh = std::chrono::nanoseconds{static_cast<int64_t>(1e9 / hz)};
+            });
+        return shown_on;
+    }
+
+    // When the frame just posted reached the screen (waiting for its flip if need be);
+    // displays that can't say are taken to be immediate
+    mg::Frame last_frame_on(ShownOn const& shown_on) const
+    {
+        mg::Frame frame;
+        if (shown_on.output_id.is_set())
+            frame = display.last_frame_on(shown_on.output_id.value());
+        if (frame.ust.nanoseconds == std::chrono::nanoseconds::zero())
+            frame.ust = mir::time::PosixTimestamp::now(CLOCK_MONOTONIC);
+        return frame;
+    }
+
     std::shared_ptr<mc::DisplayBufferCompositorFactory> const compositor_factory;
+    mg::Display const& display;
     mg::DisplaySyncGroup& group;
     std::shared_ptr<mc::Scene> const scene;
     bool running;
     int frames_scheduled;
     std::chrono::milliseconds force_sleep{-1};
+    bool const parallel_outputs;
     std::mutex run_mutex;
     std::condition_variable run_cv;
     std::shared_ptr<DisplayListener> const display_listener;
@@ -256,7 +458,8 @@ mc::MultiThreadedCompositor::MultiThreadedCompositor(
     std::shared_ptr<DisplayListener> const& display_listener,
     std::shared_ptr<CompositorReport> const& compositor_report,
     std::chrono::milliseconds fixed_composite_delay,
-    bool compose_on_start)
+    bool compose_on_start,
+    bool parallel_outputs)
     : display{display},
       scene{scene},
       display_buffer_compositor_factory{db_compositor_factory},
@@ -265,6 +468,7 @@ mc::MultiThreadedCompositor::MultiThreadedCompositor(
       state{CompositorState::stopped},
       fixed_composite_delay{fixed_composite_delay},
       compose_on_start{compose_on_start},
+      parallel_outputs{parallel_outputs},
       thread_pool{1}
 {
     observer = std::make_shared<ms::LegacySceneChangeNotification>(
@@ -367,8 +571,8 @@ void mc::MultiThreadedCompositor::create_compositing_threads()
     display->for_each_display_sync_group([this](mg::DisplaySyncGroup& group)
     {
         auto thread_functor = std::make_unique<mc::CompositingFunctor>(
-            display_buffer_compositor_factory, group, scene, display_listener,
-            fixed_composite_delay, report);
+            display_buffer_compositor_factory, *display, group, scene, display_listener,
+            fixed_composite_delay, parallel_outputs, report);
 
         futures.push_back(thread_pool.run(std::ref(*thread_functor), &group));
         thread_functors.push_back(std::move(thread_functor));
@@ -0,0 +1,122 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "presentation_tracker.h"
+#include "mir/frontend/client_buffers.h"
+
+#include <algorithm>
+
+namespace mc = mir::compositor;
+namespace mf = mir::frontend;
+namespace mg = mir::graphics;
+
+size_t const mc::PresentationTracker::max_outstanding;
+
+mc::PresentationTracker::PresentationTracker(
+    mf::BufferStreamId id,
+    std::shared_ptr<mf::ClientBuffers> const& client) :
+    id{id},
+    client{client}
+{
+}
+
+void mc::PresentationTracker::set_enabled(bool enable)
+{
+    std::lock_guard<decltype(mutex)> lock{mutex};
+    enabled = enable;
+    if (!enable)
+        outstanding.clear();
+}
+
+void mc::PresentationTracker::submitted(mg::BufferID buffer)
+{
+    std::vector<mf::PresentFeedback> feedback;
+    {
+        std::lock_guard<decltype(mutex)> lock{mutex};
+        auto const frame = ++frames;
+        if (!enabled)
+            return;
+
+        // A buffer back with the client before any compositor drew it was dropped
+        auto const undrawn = std::find_if(outstanding.begin(), outstanding.end(),
+            [&](Outstanding const& o) { return o.buffer == buffer && !o.drawn; });
+        if (undrawn != outstanding.end())
+        {
+            feedback.push_back(dropped(*undrawn));
+            outstanding.erase(undrawn);
+        }
+
+        // ...as is a frame that has waited so long nothing will show it
+        if (outstanding.size() == max_outstanding)
+        {
+            feedback.push_back(dropped(outstanding.front()));
+            outstanding.pop_front();
+        }
+
+        outstanding.push_back({buffer, frame, false});
+    }
+    send(feedback);
+}
+
+auto mc::PresentationTracker::drawn(mg::BufferID buffer, MirPresentResult how)
+    -> mir::optional_value<mf::PresentFeedback>
+{
+    if (!enabled)
+        return {};
+
+    std::lock_guard<decltype(mutex)> lock{mutex};
+    auto const latest = std::find_if(outstanding.rbegin(), outstanding.rend(),
+        [&](Outstanding const& o) { return o.buffer == buffer; });
+    if (latest == outstanding.rend())
+        return {};
+
+    latest->drawn = true;
+    return mf::PresentFeedback{buffer, latest->frame, how, {}, {}};
+}
+
+void mc::PresentationTracker::shown(
+    mf::PresentFeedback feedback, mg::Frame const& flip, std::chrono::nanoseconds refresh)
+{
+    std::vector<mf::PresentFeedback> sent;
+    {
+        std::lock_guard<decltype(mutex)> lock{mutex};
+        auto const frame = std::find_if(outstanding.begin(), outstanding.end(),
+            [&](Outstanding const& o) { return o.frame == feedback.frame; });
+        if (frame == outstanding.end())
+            return;
+
+        // Anything older was never going to be seen
+        for (auto i = outstanding.begin(); i != frame; ++i)
+            sent.push_back(dropped(*i));
+        outstanding.erase(outstanding.begin(), frame + 1);
+    }
+
+    feedback.flip = flip;
+    feedback.refresh = refresh;
+    sent.push_back(feedback);
+    send(sent);
+}
+
+mf::PresentFeedback mc::PresentationTracker::dropped(Outstanding const& frame)
+{
+    return {frame.buffer, frame.frame, mir_present_result_dropped, {}, {}};
+}
+
+void mc::PresentationTracker::send(std::vector<mf::PresentFeedback> const& feedback)
+{
+    for (auto const& f : feedback)
+        client->send_present_feedback(id, f);
+}
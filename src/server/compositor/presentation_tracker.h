@@ -0,0 +1,93 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_COMPOSITOR_PRESENTATION_TRACKER_H_
+#define MIR_COMPOSITOR_PRESENTATION_TRACKER_H_
+
+#include "mir/frontend/buffer_stream_id.h"
+#include "mir/frontend/present_feedback.h"
+#include "mir/optional_value.h"
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace mir
+{
+namespace frontend { class ClientBuffers; }
+namespace compositor
+{
+/**
+ * Follows a stream's frames from submission to the screen and, once the
+ * client asks for it, tells the client what became of each one: the flip
+ * that first showed it and whether it was composited or scanned out
+ * directly, or that it was dropped because a later frame was shown first.
+ *
+ * Compositors draw a frame before they know the flip that shows it, and
+ * the frame's buffer may be back with the client (and even submitted
+ * again) by the time they do; so drawing and showing are reported
+ * separately. Only frames that reach an output are shown: a frame drawn
+ * by, say, a screencast is dropped if a later frame is shown first.
+ */
+class PresentationTracker
+{
+public:
+    PresentationTracker(
+        frontend::BufferStreamId id,
+        std::shared_ptr<frontend::ClientBuffers> const& client);
+
+    void set_enabled(bool enabled);
+
+    /// The client has submitted the buffer as the stream's next frame
+    void submitted(graphics::BufferID buffer);
+    /**
+     * A compositor has drawn the frame most recently submitted in the buffer.
+     * Returns the feedback to complete by shown() once the flip that shows
+     * the frame is known, or nothing if there is nothing to tell.
+     */
+    mir::optional_value<frontend::PresentFeedback> drawn(graphics::BufferID buffer, MirPresentResult how);
+    /// Tells the client of a drawn frame now on screen, unless another output showed it first
+    void shown(frontend::PresentFeedback feedback, graphics::Frame const& flip, std::chrono::nanoseconds refresh);
+
+    /// How many frames may await an output before the oldest is given up as dropped
+    static size_t const max_outstanding = 32;
+
+private:
+    struct Outstanding
+    {
+        graphics::BufferID buffer;
+        uint64_t frame;
+        bool drawn;
+    };
+
+    static frontend::PresentFeedback dropped(Outstanding const& frame);
+    void send(std::vector<frontend::PresentFeedback> const& feedback);
+
+    frontend::BufferStreamId const id;
+    std::shared_ptr<frontend::ClientBuffers> const client;
+    std::atomic<bool> enabled{false};
+
+    std::mutex mutex;
+    uint64_t frames{0};
+    /// Frames submitted but not yet shown, oldest first
+    std::deque<Outstanding> outstanding;
+};
+}
+}
+
+#endif /* MIR_COMPOSITOR_PRESENTATION_TRACKER_H_ */
@@ -54,3 +54,7 @@ std::shared_ptr<mg::Buffer> mc::QueueingSchedule::next_buffer()
     queue.pop_front();
     return buffer;
 }
+
+void mc::QueueingSchedule::frame_missed()
+{
+}
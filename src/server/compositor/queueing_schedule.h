@@ -36,6 +36,7 @@ public:
         std::shared_ptr<graphics::Buffer> const& buffer) override;
     unsigned int num_scheduled() override;
     std::shared_ptr<graphics::Buffer> next_buffer() override;
+    void frame_missed() override;
 
 private:
     std::mutex mutable mutex;
@@ -35,6 +35,8 @@ public:
         std::shared_ptr<graphics::Buffer> const& buffer) = 0;
     virtual unsigned int num_scheduled() = 0;
     virtual std::shared_ptr<graphics::Buffer> next_buffer() = 0;
+    /// A compositor showed the last frame again, as nothing new was scheduled in time
+    virtual void frame_missed() = 0;
 
     virtual ~Schedule() = default;
     Schedule() = default;
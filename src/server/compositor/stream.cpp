@@ -20,9 +20,12 @@
 #include "stream.h"
 #include "queueing_schedule.h"
 #include "dropping_schedule.h"
+#include "fifo_relaxed_schedule.h"
 #include "temporary_buffers.h"
 #include "mir/frontend/client_buffers.h"
 #include "mir/graphics/buffer.h"
+#include "mir/graphics/content_hash.h"
+#include "mir/renderer/sw/pixel_source.h"
 #include "mir/compositor/frame_dropping_policy_factory.h"
 #include "mir/compositor/frame_dropping_policy.h"
 #include <boost/throw_exception.hpp>
@@ -31,12 +34,16 @@ namespace mc = mir::compositor;
 namespace geom = mir::geometry;
 namespace mg = mir::graphics;
 namespace ms = mir::scene;
-namespace geom = mir::geometry;
+namespace mf = mir::frontend;
+namespace mrs = mir::renderer::software;
 
-enum class mc::Stream::ScheduleMode {
-    Queueing,
-    Dropping
-};
+namespace
+{
+// About two seconds of a 60Hz compositor redrawing the same frame
+unsigned int const idle_compositions{120};
+unsigned int const dropped_frames{3};
+unsigned int const replaced_frames{120};
+}
 
 mc::Stream::DroppingCallback::DroppingCallback(Stream* stream) :
     stream(stream)
@@ -62,8 +69,27 @@ void mc::Stream::DroppingCallback::unlock()
 mc::Stream::Stream(
     mc::FrameDroppingPolicyFactory const& policy_factory,
     std::shared_ptr<frontend::ClientBuffers> map, geom::Size size, MirPixelFormat pf) :
+    Stream(policy_factory, mir::optional_value<mf::BufferStreamId>{}, map, size, pf)
+{
+}
+
+mc::Stream::Stream(
+    mc::FrameDroppingPolicyFactory const& policy_factory,
+    mf::BufferStreamId id,
+    std::shared_ptr<frontend::ClientBuffers> map, geom::Size size, MirPixelFormat pf) :
+    Stream(policy_factory, mir::optional_value<mf::BufferStreamId>{id}, map, size, pf)
+{
+}
+
+mc::Stream::Stream(
+    mc::FrameDroppingPolicyFactory const& policy_factory,
+    mir::optional_value<mf::BufferStreamId> const& id,
+    std::shared_ptr<frontend::ClientBuffers> map, geom::Size size, MirPixelFormat pf) :
+    id(id),
+    buffer_count_advisor(idle_compositions, dropped_frames, replaced_frames),
+    presentation(id.is_set() ? std::make_shared<mc::PresentationTracker>(id.value(), map) : nullptr),
     drop_policy(policy_factory.create_policy(std::make_unique<DroppingCallback>(this))),
-    schedule_mode(ScheduleMode::Queueing),
+    present_mode(mir_present_mode_fifo),
     schedule(std::make_shared<mc::QueueingSchedule>()),
     buffers(map),
     arbiter(std::make_shared<mc::MultiMonitorArbiter>(
@@ -91,19 +117,48 @@ unsigned int mc::Stream::client_owned_buffer_count(std::lock_guard<decltype(mute
 void mc::Stream::submit_buffer(std::shared_ptr<mg::Buffer> const& buffer)
 {
     std::future<void> deferred_io;
+    mir::optional_value<int> hint;
 
     if (!buffer)
         BOOST_THROW_EXCEPTION(std::invalid_argument("cannot submit null buffer"));
 
+    // Before any compositor can see it
+    if (presentation)
+        presentation->submitted(buffer->id());
+
+    // Hashing takes long enough to keep it outside the lock
+    mir::optional_value<Content> content;
+    if (skip_unchanged)
+        content = content_of(*buffer);
+
+    bool unchanged{false};
     {
         std::lock_guard<decltype(mutex)> lk(mutex); 
         first_frame_posted = true;
         buffers->receive_buffer(buffer->id());
-        deferred_io = schedule->schedule_nonblocking(buffers->get(buffer->id()));
-        if (!associated_buffers.empty() && (client_owned_buffer_count(lk) == 0))
-            drop_policy->swap_now_blocking();
+
+        unchanged = content.is_set() && content == last_content;
+        last_content = content;
+        if (!unchanged)
+        {
+            deferred_io = schedule->schedule_nonblocking(buffers->get(buffer->id()));
+            hint = deferred_io.valid() ?
+                buffer_count_advisor.frame_replaced() :
+                buffer_count_advisor.frame_submitted();
+            if (!associated_buffers.empty() && (client_owned_buffer_count(lk) == 0))
+                drop_policy->swap_now_blocking();
+        }
+    }
+
+    // The same pixels are already queued or on screen: nothing to redraw
+    if (unchanged)
+    {
+        buffers->send_buffer(buffer->id());
+        return;
     }
+
     observers.frame_posted(1, buffer->size());
+    send_buffer_count_hint(hint);
 
     // Ensure that mutex is not locked while we do this (synchronous!) socket
     // IO. Holding it locked blocks the compositor thread(s) from rendering.
@@ -139,11 +194,14 @@ void mc::Stream::remove_observer(std::weak_ptr<ms::SurfaceObserver> const& obser
 
 std::shared_ptr<mg::Buffer> mc::Stream::lock_compositor_buffer(void const* id)
 {
+    mir::optional_value<int> hint;
     {
         std::lock_guard<decltype(mutex)> lk(mutex);
         drop_policy->swap_unblocked();
+        hint = buffer_count_advisor.frame_composited(id);
     }
-    return std::make_shared<mc::TemporaryCompositorBuffer>(arbiter, id);
+    send_buffer_count_hint(hint);
+    return std::make_shared<mc::TemporaryCompositorBuffer>(arbiter, id, presentation);
 }
 
 geom::Size mc::Stream::stream_size()
@@ -160,23 +218,46 @@ void mc::Stream::resize(geom::Size const& new_size)
 }
 
 void mc::Stream::allow_framedropping(bool dropping)
+{
+    set_present_mode(dropping ? mir_present_mode_mailbox : mir_present_mode_fifo);
+}
+
+void mc::Stream::set_present_mode(MirPresentMode mode)
 {
     std::lock_guard<decltype(mutex)> lk(mutex); 
-    if (dropping && schedule_mode == ScheduleMode::Queueing)
-    {
-        transition_schedule(std::make_shared<mc::DroppingSchedule>(buffers), lk);
-        schedule_mode = ScheduleMode::Dropping;
-    }
-    else if (!dropping && schedule_mode == ScheduleMode::Dropping)
+    if (mode == present_mode)
+        return;
+
+    switch (mode)
     {
+    case mir_present_mode_fifo:
         transition_schedule(std::make_shared<mc::QueueingSchedule>(), lk);
-        schedule_mode = ScheduleMode::Queueing;
+        break;
+    case mir_present_mode_fifo_relaxed:
+        transition_schedule(std::make_shared<mc::FifoRelaxedSchedule>(buffers), lk);
+        break;
+    // We never tear, so the closest we can show a frame to "immediately" is
+    // the next composition, as mailbox does
+    case mir_present_mode_mailbox:
+    case mir_present_mode_immediate:
+        if (!framedropping())
+            transition_schedule(std::make_shared<mc::DroppingSchedule>(buffers), lk);
+        break;
+    default:
+        BOOST_THROW_EXCEPTION(std::invalid_argument("invalid present mode"));
     }
+    present_mode = mode;
+}
+
+void mc::Stream::set_present_feedback(bool enabled)
+{
+    if (presentation)
+        presentation->set_enabled(enabled);
 }
 
 bool mc::Stream::framedropping() const
 {
-    return schedule_mode == ScheduleMode::Dropping;
+    return present_mode == mir_present_mode_mailbox || present_mode == mir_present_mode_immediate;
 }
 
 void mc::Stream::transition_schedule(
@@ -245,7 +326,38 @@ void mc::Stream::set_scale(float)
 void mc::Stream::drop_frame()
 {
     if (schedule->num_scheduled() > 1)
+    {
         buffers->send_buffer(schedule->next_buffer()->id());
+        send_buffer_count_hint(buffer_count_advisor.frame_dropped());
+    }
+}
+
+void mc::Stream::send_buffer_count_hint(mir::optional_value<int> const& hint)
+{
+    if (hint.is_set() && id.is_set())
+        buffers->send_buffer_count_hint(id.value(), hint.value());
+}
+
+void mc::Stream::set_skip_unchanged_frames(bool skip)
+{
+    skip_unchanged = skip;
+}
+
+auto mc::Stream::content_of(mg::Buffer& buffer) -> mir::optional_value<Content>
+{
+    auto const source = dynamic_cast<mrs::PixelSource*>(buffer.native_buffer_base());
+    if (!source)
+        return {};
+
+    auto const size = buffer.size();
+    auto const stride = source->stride();
+    uint64_t hash{0};
+    source->read([&](unsigned char const* pixels)
+        {
+            hash = mg::content_hash(pixels, stride.as_int() * size.height.as_int());
+        });
+
+    return Content{hash, size, stride, buffer.pixel_format()};
 }
 
 bool mc::Stream::suitable_for_cursor() const
@@ -26,6 +26,10 @@
 #include "mir/lockable_callback.h"
 #include "mir/geometry/size.h"
 #include "multi_monitor_arbiter.h"
+#include "buffer_count_advisor.h"
+#include "presentation_tracker.h"
+#include "mir/optional_value.h"
+#include <atomic>
 #include <mutex>
 #include <memory>
 #include <set>
@@ -44,6 +48,12 @@ public:
     Stream(
         FrameDroppingPolicyFactory const& policy_factory,
         std::shared_ptr<frontend::ClientBuffers>, geometry::Size sz, MirPixelFormat format);
+    // A stream that knows its id will hint to the client how many buffers it needs,
+    // and can tell it what became of its frames
+    Stream(
+        FrameDroppingPolicyFactory const& policy_factory,
+        frontend::BufferStreamId id,
+        std::shared_ptr<frontend::ClientBuffers>, geometry::Size sz, MirPixelFormat format);
     ~Stream();
 
     void submit_buffer(std::shared_ptr<graphics::Buffer> const& buffer) override;
@@ -56,6 +66,8 @@ public:
     geometry::Size stream_size() override;
     void resize(geometry::Size const& size) override;
     void allow_framedropping(bool) override;
+    void set_present_mode(MirPresentMode mode) override;
+    void set_present_feedback(bool enabled) override;
     bool framedropping() const override;
     int buffers_ready_for_compositor(void const* user_id) const override;
     void drop_old_buffers() override;
@@ -65,8 +77,23 @@ public:
     void set_scale(float scale) override;
     bool suitable_for_cursor() const override;
 
+    /**
+     * Hands a frame whose pixels are the same as the one before it straight
+     * back to the client, rather than queue it up to be composited again.
+     * Only buffers the server can read cheaply (shm buffers) are compared;
+     * skipped frames are reported to the client as dropped.
+     *
+     * A client that draws as fast as its buffers come back loses its pacing
+     * while its content stays still, so this is off unless asked for.
+     */
+    void set_skip_unchanged_frames(bool skip);
+
 private:
-    enum class ScheduleMode;
+    Stream(
+        FrameDroppingPolicyFactory const& policy_factory,
+        mir::optional_value<frontend::BufferStreamId> const& id,
+        std::shared_ptr<frontend::ClientBuffers>, geometry::Size sz, MirPixelFormat format);
+
     struct DroppingCallback : mir::LockableCallback
     {
         DroppingCallback(Stream* stream);
@@ -78,16 +105,37 @@ private:
     };
     void transition_schedule(std::shared_ptr<Schedule>&& new_schedule, std::lock_guard<std::mutex> const&);
     void drop_frame();
+    void send_buffer_count_hint(mir::optional_value<int> const& hint);
+
+    struct Content
+    {
+        uint64_t hash;
+        geometry::Size size;
+        geometry::Stride stride;
+        MirPixelFormat format;
+
+        bool operator==(Content const& other) const
+        {
+            return hash == other.hash && size == other.size && stride == other.stride && format == other.format;
+        }
+    };
+    static mir::optional_value<Content> content_of(graphics::Buffer& buffer);
 
     std::mutex mutable mutex;
+    mir::optional_value<frontend::BufferStreamId> const id;
+    BufferCountAdvisor buffer_count_advisor;
+    std::shared_ptr<PresentationTracker> const presentation;
     std::unique_ptr<compositor::FrameDroppingPolicy> drop_policy;
-    ScheduleMode schedule_mode;
+    MirPresentMode present_mode;
     std::shared_ptr<Schedule> schedule;
     std::shared_ptr<frontend::ClientBuffers> const buffers;
     std::shared_ptr<MultiMonitorArbiter> const arbiter;
     geometry::Size size; 
     MirPixelFormat const pf;
     bool first_frame_posted;
+    std::atomic<bool> skip_unchanged{false};
+    /// The pixels of the latest frame submitted, if we could read them
+    mir::optional_value<Content> last_content;
 
     scene::SurfaceObservers observers;
 
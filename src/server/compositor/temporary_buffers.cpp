@@ -33,8 +33,16 @@ mc::TemporaryBuffer::TemporaryBuffer(std::shared_ptr<mg::Buffer> const& real_buf
 
 mc::TemporaryCompositorBuffer::TemporaryCompositorBuffer(
     std::shared_ptr<BufferAcquisition> const& acquisition, void const* user_id)
+    : TemporaryCompositorBuffer(acquisition, user_id, nullptr)
+{
+}
+
+mc::TemporaryCompositorBuffer::TemporaryCompositorBuffer(
+    std::shared_ptr<BufferAcquisition> const& acquisition, void const* user_id,
+    std::shared_ptr<PresentationTracker> const& presentation)
     : TemporaryBuffer(acquisition->compositor_acquire(user_id)),
-      acquisition(acquisition)
+      acquisition(acquisition),
+      presentation(presentation)
 {
 }
 
@@ -43,6 +51,11 @@ mc::TemporaryCompositorBuffer::~TemporaryCompositorBuffer()
     acquisition->compositor_release(buffer);
 }
 
+auto mc::TemporaryCompositorBuffer::presentation_tracker() const -> std::shared_ptr<PresentationTracker> const&
+{
+    return presentation;
+}
+
 mc::TemporarySnapshotBuffer::TemporarySnapshotBuffer(
     std::shared_ptr<BufferAcquisition> const& acquisition)
     : TemporaryBuffer(acquisition->snapshot_acquire()),
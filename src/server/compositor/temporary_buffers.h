@@ -22,6 +22,8 @@
 #include "mir/graphics/buffer.h"
 #include "mir/graphics/buffer_id.h"
 
+#include <memory>
+
 namespace mg = mir::graphics;
 
 namespace mir
@@ -31,6 +33,7 @@ namespace compositor
 
 class BufferAcquisition;
 class BackBufferStrategy;
+class PresentationTracker;
 
 class TemporaryBuffer : public mg::Buffer
 {
@@ -51,10 +54,17 @@ class TemporaryCompositorBuffer : public TemporaryBuffer
 public:
     explicit TemporaryCompositorBuffer(
         std::shared_ptr<BufferAcquisition> const& acquisition, void const* user_id);
+    TemporaryCompositorBuffer(
+        std::shared_ptr<BufferAcquisition> const& acquisition, void const* user_id,
+        std::shared_ptr<PresentationTracker> const& presentation);
     ~TemporaryCompositorBuffer();
 
+    /// Where to report drawing the buffer, if anyone wants to know
+    std::shared_ptr<PresentationTracker> const& presentation_tracker() const;
+
 private:
     std::shared_ptr<BufferAcquisition> const acquisition;
+    std::shared_ptr<PresentationTracker> const presentation;
 };
 
 class TemporarySnapshotBuffer : public TemporaryBuffer
@@ -26,6 +26,7 @@
 #include "mir/default_configuration.h"
 #include "mir/cookie/authority.h"
 
+#include "mir/logging/async_console_logger.h"
 #include "mir/logging/dumb_console_logger.h"
 #include "mir/options/program_option.h"
 #include "mir/frontend/session_credentials.h"
@@ -225,8 +226,16 @@ auto mir::DefaultServerConfiguration::the_logger()
     -> std::shared_ptr<ml::Logger>
 {
     return logger(
-        []() -> std::shared_ptr<ml::Logger>
+        [this]() -> std::shared_ptr<ml::Logger>
         {
+            auto const options = the_options();
+            if (options->is_set(mo::async_log_opt))
+            {
+                auto const buffer_kib = options->get<int>(mo::async_log_opt);
+                if (buffer_kib > 0)
+                    return std::make_shared<ml::AsyncConsoleLogger>(buffer_kib * 1024);
+            }
+
             return std::make_shared<ml::DumbConsoleLogger>();
         });
 }
@@ -31,6 +31,7 @@ class DisplayServer : public mir::protobuf::DisplayServer
 {
 public:
     virtual void client_pid(int pid) = 0;
+    virtual void client_activity() = 0;
 };
 }
 }
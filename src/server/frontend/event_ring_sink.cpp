@@ -0,0 +1,155 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "event_ring_sink.h"
+#include "event_sender.h"
+#include "mir/input/event_ring.h"
+#include "mir/events/event_private.h"
+#include "mir/frontend/surface_id.h"
+
+#include <boost/throw_exception.hpp>
+
+#include <system_error>
+
+#include <sys/eventfd.h>
+
+namespace mf = mir::frontend;
+namespace mfd = mir::frontend::detail;
+namespace mi = mir::input;
+
+mf::EventRingSink::EventRingSink(
+    std::shared_ptr<EventSink> const& next,
+    std::shared_ptr<detail::EventSender> const& resume_sender,
+    std::unique_ptr<mi::EventRing> ring) :
+    next{next},
+    resume_sender{resume_sender},
+    ring{std::move(ring)},
+    wake_fd{eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)}
+{
+    if (wake_fd < 0)
+        BOOST_THROW_EXCEPTION((std::system_error{errno, std::system_category(), "Failed to create input ring eventfd"}));
+}
+
+mf::EventRingSink::~EventRingSink() = default;
+
+std::vector<mir::Fd> mf::EventRingSink::client_fds() const
+{
+    return {ring->fd(), wake_fd};
+}
+
+void mf::EventRingSink::handle_event(MirEvent const& e)
+{
+    if (e.type() != mir_event_type_input)
+    {
+        next->handle_event(e);
+        return;
+    }
+
+    std::lock_guard<decltype(mutex)> lock{mutex};
+
+    if (diverted)
+    {
+        // Until the client has read up to the barrier, events must follow
+        // it over the socket to keep them in order
+        if (!ring->empty())
+        {
+            next->handle_event(e);
+            return;
+        }
+
+        diverted = false;
+        resume_sender->send_input_ring_resumed(SurfaceId{e.to_input()->window_id()});
+    }
+
+    serialized = MirEvent::serialize(&e);
+    if (!ring->write(serialized))
+    {
+        ring->write_barrier();
+        diverted = true;
+        wake_client();
+        next->handle_event(e);
+        return;
+    }
+
+    if (ring->take_wakeup())
+        wake_client();
+}
+
+void mf::EventRingSink::wake_client()
+{
+    // Only fails if the counter would overflow, so the client has been woken anyway
+    eventfd_write(wake_fd, 1);
+}
+
+void mf::EventRingSink::handle_lifecycle_event(MirLifecycleState state)
+{
+    next->handle_lifecycle_event(state);
+}
+
+void mf::EventRingSink::handle_display_config_change(graphics::DisplayConfiguration const& config)
+{
+    next->handle_display_config_change(config);
+}
+
+void mf::EventRingSink::send_ping(int32_t serial)
+{
+    next->send_ping(serial);
+}
+
+void mf::EventRingSink::handle_input_config_change(MirInputConfig const& config)
+{
+    next->handle_input_config_change(config);
+}
+
+void mf::EventRingSink::handle_error(ClientVisibleError const& error)
+{
+    next->handle_error(error);
+}
+
+void mf::EventRingSink::send_buffer(BufferStreamId id, graphics::Buffer& buffer, graphics::BufferIpcMsgType type)
+{
+    next->send_buffer(id, buffer, type);
+}
+
+void mf::EventRingSink::add_buffer(graphics::Buffer& buffer)
+{
+    next->add_buffer(buffer);
+}
+
+void mf::EventRingSink::error_buffer(geometry::Size req_size, MirPixelFormat req_format, std::string const& error_msg)
+{
+    next->error_buffer(req_size, req_format, error_msg);
+}
+
+void mf::EventRingSink::remove_buffer(graphics::Buffer& buffer)
+{
+    next->remove_buffer(buffer);
+}
+
+void mf::EventRingSink::update_buffer(graphics::Buffer& buffer)
+{
+    next->update_buffer(buffer);
+}
+
+void mf::EventRingSink::send_buffer_count_hint(BufferStreamId id, int buffer_count)
+{
+    next->send_buffer_count_hint(id, buffer_count);
+}
+
+void mf::EventRingSink::send_present_feedback(BufferStreamId id, PresentFeedback const& feedback)
+{
+    next->send_present_feedback(id, feedback);
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_FRONTEND_EVENT_RING_SINK_H_
+#define MIR_FRONTEND_EVENT_RING_SINK_H_
+
+#include "mir/frontend/event_sink.h"
+#include "mir/fd.h"
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace mir
+{
+namespace input { class EventRing; }
+namespace frontend
+{
+namespace detail { class EventSender; }
+
+/**
+ * An EventSink that passes a surface's input events to its client through
+ * an input::EventRing, and everything else on to the next sink.
+ *
+ * If the ring fills (or an event is too big for it) a barrier is written
+ * and input events go on to the next sink until the client has emptied the
+ * ring; then the client is told that the ring has resumed. The client
+ * switches between the two at the barrier and at the resume message, so
+ * it sees the events in the order they were sent.
+ */
+class EventRingSink : public EventSink
+{
+public:
+    EventRingSink(
+        std::shared_ptr<EventSink> const& next,
+        std::shared_ptr<detail::EventSender> const& resume_sender,
+        std::unique_ptr<input::EventRing> ring);
+    ~EventRingSink();
+
+    /// The ring's memfd and the eventfd signalled when the client should read it
+    std::vector<Fd> client_fds() const;
+
+    void handle_event(MirEvent const& e) override;
+    void handle_lifecycle_event(MirLifecycleState state) override;
+    void handle_display_config_change(graphics::DisplayConfiguration const& config) override;
+    void send_ping(int32_t serial) override;
+    void handle_input_config_change(MirInputConfig const& config) override;
+    void handle_error(ClientVisibleError const& error) override;
+    void send_buffer(BufferStreamId id, graphics::Buffer& buffer, graphics::BufferIpcMsgType type) override;
+    void add_buffer(graphics::Buffer& buffer) override;
+    void error_buffer(geometry::Size req_size, MirPixelFormat req_format, std::string const& error_msg) override;
+    void remove_buffer(graphics::Buffer& buffer) override;
+    void update_buffer(graphics::Buffer& buffer) override;
+    void send_buffer_count_hint(BufferStreamId id, int buffer_count) override;
+    void send_present_feedback(BufferStreamId id, PresentFeedback const& feedback) override;
+
+private:
+    void wake_client();
+
+    std::shared_ptr<EventSink> const next;
+    std::shared_ptr<detail::EventSender> const resume_sender;
+    std::unique_ptr<input::EventRing> const ring;
+    Fd const wake_fd;
+
+    std::mutex mutex;
+    bool diverted{false};
+    std::string serialized;
+};
+}
+}
+
+#endif /* MIR_FRONTEND_EVENT_RING_SINK_H_ */
@@ -159,6 +159,37 @@ void mfd::EventSender::update_buffer(graphics::Buffer& buffer)
     send_buffer(seq, buffer, mg::BufferIpcMsgType::update_msg);
 }
 
+void mfd::EventSender::send_buffer_count_hint(frontend::BufferStreamId id, int buffer_count)
+{
+    mp::EventSequence seq;
+    auto hint = seq.mutable_buffer_stream_hint();
+    hint->mutable_id()->set_value(id.as_value());
+    hint->set_buffer_count(buffer_count);
+    send_event_sequence(seq, {});
+}
+
+void mfd::EventSender::send_present_feedback(frontend::BufferStreamId id, frontend::PresentFeedback const& feedback)
+{
+    mp::EventSequence seq;
+    auto message = seq.mutable_present_feedback();
+    message->mutable_id()->set_value(id.as_value());
+    message->set_buffer_id(feedback.buffer.as_value());
+    message->set_frame(feedback.frame);
+    message->set_result(feedback.result);
+    message->set_sequence(feedback.flip.msc);
+    message->set_clock_id(feedback.flip.ust.clock_id);
+    message->set_timestamp(feedback.flip.ust.nanoseconds.count());
+    message->set_refresh(feedback.refresh.count());
+    send_event_sequence(seq, {});
+}
+
+void mfd::EventSender::send_input_ring_resumed(SurfaceId id)
+{
+    mp::EventSequence seq;
+    seq.mutable_input_ring_resumed()->set_value(id.as_value());
+    send_event_sequence(seq, {});
+}
+
 void mfd::EventSender::send_buffer(frontend::BufferStreamId id, graphics::Buffer& buffer, mg::BufferIpcMsgType type)
 {
     mp::EventSequence seq;
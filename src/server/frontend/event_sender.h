@@ -21,6 +21,7 @@
 
 #include "mir/frontend/event_sink.h"
 #include "mir/frontend/fd_sets.h"
+#include "mir/frontend/surface_id.h"
 #include <memory>
 
 namespace mir
@@ -54,6 +55,11 @@ public:
     void error_buffer(geometry::Size, MirPixelFormat, std::string const&) override;
     void remove_buffer(graphics::Buffer&) override;
     void update_buffer(graphics::Buffer&) override;
+    void send_buffer_count_hint(frontend::BufferStreamId id, int buffer_count) override;
+    void send_present_feedback(frontend::BufferStreamId id, frontend::PresentFeedback const& feedback) override;
+
+    /// Tells the client that the surface's input events are back in its event ring
+    void send_input_ring_resumed(SurfaceId id);
 
 private:
     void send_event_sequence(protobuf::EventSequence&, FdSets const&);
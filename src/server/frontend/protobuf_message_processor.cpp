@@ -199,6 +199,7 @@ bool mfd::ProtobufMessageProcessor::dispatch(
     std::vector<mir::Fd> const& side_channel_fds)
 {
     report->received_invocation(display_server.get(), invocation.id(), invocation.method_name());
+    display_server->client_activity();
 
     bool result = true;
 
@@ -217,9 +218,11 @@ bool mfd::ProtobufMessageProcessor::dispatch(
         else if ("submit_buffer" == invocation.method_name())
         {
             auto request = parse_parameter<mir::protobuf::BufferRequest>(invocation);
+            // The request's fds are owned by whoever unpacks it, so they
+            // must not be the ones side_channel_fds will close.
             request.mutable_buffer()->clear_fd();
             for (auto& fd : side_channel_fds)
-                request.mutable_buffer()->add_fd(fd);
+                request.mutable_buffer()->add_fd(dup(fd));
             invoke(shared_from_this(), display_server.get(), &DisplayServer::submit_buffer, invocation.id(), &request);
         }
         else if ("allocate_buffers" == invocation.method_name())
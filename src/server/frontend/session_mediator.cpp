@@ -18,6 +18,8 @@
 
 #include "session_mediator.h"
 #include "reordering_message_sender.h"
+#include "event_ring_sink.h"
+#include "event_sender.h"
 #include "event_sink_factory.h"
 
 #include "mir/frontend/session_mediator_observer.h"
@@ -55,6 +57,7 @@
 #include "mir/input/mir_pointer_config.h"
 #include "mir/input/mir_keyboard_config.h"
 #include "mir/input/device.h"
+#include "mir/input/event_ring.h"
 #include "mir/scene/prompt_session_creation_parameters.h"
 #include "mir/fd.h"
 #include "mir/cookie/authority.h"
@@ -71,6 +74,7 @@
 #include <boost/exception/errinfo_errno.hpp>
 #include <boost/throw_exception.hpp>
 
+#include <algorithm>
 #include <mutex>
 #include <thread>
 #include <functional>
@@ -92,6 +96,35 @@ mg::GammaCurve convert_string_to_gamma_curve(std::string const& str_bytes)
     std::copy(std::begin(str_bytes), std::end(str_bytes), reinterpret_cast<char*>(out.data()));
     return out;
 }
+
+mg::BufferID create_buffer_for(
+    mf::Session& session,
+    mir::protobuf::BufferStreamParameters const& req,
+    geom::Size const& size)
+{
+    if (req.has_flags() && req.has_native_format())
+    {
+        return session.create_buffer(size, req.native_format(), req.flags());
+    }
+    else if (req.has_buffer_usage() && req.has_pixel_format())
+    {
+        auto const usage = static_cast<mg::BufferUsage>(req.buffer_usage());
+        auto const pf = static_cast<MirPixelFormat>(req.pixel_format());
+        if (usage == mg::BufferUsage::software)
+        {
+            return session.create_buffer(size, pf); 
+        }
+        else
+        {
+            //legacy route, server-selected pf and usage
+            return session.create_buffer(mg::BufferProperties{size, pf, mg::BufferUsage::hardware});
+        }
+    }
+    else
+    {
+        BOOST_THROW_EXCEPTION(std::logic_error("Invalid buffer request"));
+    }
+}
 }
 
 mf::SessionMediator::SessionMediator(
@@ -147,6 +180,23 @@ void mf::SessionMediator::client_pid(int pid)
     client_pid_ = pid;
 }
 
+void mf::SessionMediator::client_activity()
+{
+    if (!record_activity)
+    {
+        auto const session = weak_session.lock();
+        if (!session)
+            return;
+
+        // Looked up once, rather than for every message
+        record_activity = anr_detector->activity_recorder(session.get());
+        if (!record_activity)
+            return;
+    }
+
+    record_activity();
+}
+
 void mf::SessionMediator::connect(
     const ::mir::protobuf::ConnectParameters* request,
     ::mir::protobuf::Connection* response,
@@ -187,6 +237,9 @@ void mf::SessionMediator::connect(
     for (auto pf : surface_pixel_formats)
         response->add_surface_pixel_format(static_cast<::google::protobuf::uint32>(pf));
 
+    for (auto mode = 0; mode != mir_present_mode_num_modes; ++mode)
+        response->add_present_mode(mode);
+
     resource_cache->save_resource(response, ipc_package);
 
     for ( auto const& ext : extensions )
@@ -341,6 +394,23 @@ void mf::SessionMediator::create_surface(
     auto buffering_sender = std::make_shared<mf::ReorderingMessageSender>(message_sender);
     std::shared_ptr<mf::EventSink> sink = sink_factory->create_sink(buffering_sender);
 
+    std::shared_ptr<mf::EventRingSink> ring_sink;
+    if (request->input_ring())
+    {
+        try
+        {
+            ring_sink = std::make_shared<mf::EventRingSink>(
+                sink,
+                std::make_shared<mfd::EventSender>(buffering_sender, ipc_operations),
+                mi::EventRing::create());
+            sink = ring_sink;
+        }
+        catch (std::exception const&)
+        {
+            // Input events will go over the socket as usual
+        }
+    }
+
     auto const surf_id = shell->create_surface(session, params, sink);
 
     auto surface = session->get_surface(surf_id);
@@ -362,16 +432,53 @@ void mf::SessionMediator::create_surface(
         setting->set_ivalue(shell->get_surface_attribute(session, surf_id, static_cast<MirWindowAttrib>(i)));
     }
 
+    // The client chose the native flags of its initial buffers for the size it
+    // asked for, which may suit a buffer of another size badly. If the shell has
+    // changed the size, leave the client to allocate once it has seen the reply.
+    auto const requested_at = [&client_size](mir::protobuf::BufferStreamParameters const& req)
+        { return geom::Size{req.width(), req.height()} == client_size; };
+    auto const& initial_buffers = request->initial_buffers().buffer_requests();
+    auto const preallocate = legacy_stream && request->has_initial_buffers() &&
+        std::all_of(initial_buffers.begin(), initial_buffers.end(), requested_at);
     if (legacy_stream)
     {
         response->mutable_buffer_stream()->mutable_id()->set_value(buffer_stream_id.as_value());
         response->mutable_buffer_stream()->set_pixel_format(legacy_stream->pixel_format());
         response->mutable_buffer_stream()->set_buffer_usage(request->buffer_usage());
+        if (preallocate)
+        {
+            response->mutable_buffer_stream()->set_preallocated_buffers(
+                request->initial_buffers().buffer_requests_size());
+        }
         legacy_default_stream_map[surf_id] = buffer_stream_id;
     }
+
+    if (ring_sink)
+    {
+        for (auto const& fd : ring_sink->client_fds())
+            response->add_fd(fd);
+    }
+
     done->Run();
     // ...then uncork the message sender, sending all buffered surface events.
     buffering_sender->uncork();
+
+    // The client has been told how many buffers to expect; the buffer events
+    // follow the response, so it knows what to do with them on arrival.
+    if (preallocate)
+    {
+        observer->session_allocate_buffers_called(session->name());
+        try
+        {
+            for (auto const& req : initial_buffers)
+                legacy_stream->associate_buffer(create_buffer_for(*session, req, client_size));
+        }
+        catch (std::exception const&)
+        {
+            // The session has already sent the client a buffer error event,
+            // and the response has gone, so there is no-one else to tell.
+        }
+    }
 }
 
 void mf::SessionMediator::submit_buffer(
@@ -379,6 +486,9 @@ void mf::SessionMediator::submit_buffer(
     mir::protobuf::Void*,
     google::protobuf::Closure* done)
 {
+    // Takes ownership of any fds (i.e. an acquire fence) sent with the buffer
+    mfd::ProtobufBufferPacker request_msg{const_cast<mir::protobuf::Buffer*>(&request->buffer())};
+
     auto const session = weak_session.lock();
     if (!session) BOOST_THROW_EXCEPTION(std::logic_error("Invalid application session"));
     observer->session_submit_buffer_called(session->name());
@@ -387,7 +497,6 @@ void mf::SessionMediator::submit_buffer(
     mg::BufferID const buffer_id{static_cast<uint32_t>(request->buffer().buffer_id())};
     auto stream = session->get_buffer_stream(stream_id);
 
-    mfd::ProtobufBufferPacker request_msg{const_cast<mir::protobuf::Buffer*>(&request->buffer())};
     auto b = session->get_buffer(buffer_id);
     ipc_operations->unpack_buffer(request_msg, *b);
 
@@ -409,31 +518,7 @@ void mf::SessionMediator::allocate_buffers(
     for (auto i = 0; i < request->buffer_requests().size(); i++)
     {
         auto const& req = request->buffer_requests(i);
-
-        mg::BufferID id;
-        if (req.has_flags() && req.has_native_format())
-        {
-            id = session->create_buffer({req.width(), req.height()}, req.native_format(), req.flags());
-        }
-        else if (req.has_buffer_usage() && req.has_pixel_format())
-        {
-            auto const usage = static_cast<mg::BufferUsage>(req.buffer_usage());
-            geom::Size const size{req.width(), req.height()};
-            auto const pf = static_cast<MirPixelFormat>(req.pixel_format());
-            if (usage == mg::BufferUsage::software)
-            {
-                id = session->create_buffer(size, pf); 
-            }
-            else
-            {
-                //legacy route, server-selected pf and usage
-                id = session->create_buffer(mg::BufferProperties{size, pf, mg::BufferUsage::hardware});
-            }
-        }
-        else
-        {
-            BOOST_THROW_EXCEPTION(std::logic_error("Invalid buffer request"));
-        }
+        auto const id = create_buffer_for(*session, req, {req.width(), req.height()});
 
         if (request->has_id())
         {
@@ -1158,10 +1243,22 @@ void mf::SessionMediator::configure_buffer_stream(
         BOOST_THROW_EXCEPTION(std::logic_error("Invalid application session"));
 
     auto stream = session->get_buffer_stream(mf::BufferStreamId(request->id().value()));
-    if (request->has_swapinterval())
+    // Clients that know of present modes still send a swapinterval for older servers
+    if (request->has_present_mode())
+    {
+        auto const mode = request->present_mode();
+        if (mode < 0 || mode >= mir_present_mode_num_modes)
+            BOOST_THROW_EXCEPTION(std::invalid_argument("Invalid present mode"));
+        stream->set_present_mode(static_cast<MirPresentMode>(mode));
+    }
+    else if (request->has_swapinterval())
+    {
         stream->allow_framedropping(request->swapinterval() == 0);
+    }
     if (request->has_scale())
         stream->set_scale(request->scale());
+    if (request->has_present_feedback())
+        stream->set_present_feedback(request->present_feedback());
 
     done->Run();
 }
@@ -130,6 +130,7 @@ public:
     ~SessionMediator() noexcept;
 
     void client_pid(int pid) override;
+    void client_activity() override;
 
     void connect(
         mir::protobuf::ConnectParameters const* request,
@@ -303,6 +304,7 @@ private:
     ScreencastBufferTracker screencast_buffer_tracker;
 
     std::weak_ptr<Session> weak_session;
+    std::function<void()> record_activity;
     detail::PromptSessionStore prompt_sessions;
 
     std::map<frontend::SurfaceId, frontend::BufferStreamId> legacy_default_stream_map;
@@ -102,13 +102,25 @@ std::shared_ptr<mg::Platform> mir::DefaultServerConfiguration::the_graphics_plat
                 else
                 {
                     auto const& path = the_options()->get<std::string>(options::platform_path);
-                    auto platforms = mir::libraries_for_path(path, *the_shared_library_prober_report());
-                    if (platforms.empty())
+                    auto const& program_options = dynamic_cast<mir::options::ProgramOption&>(*the_options());
+                    if (the_options()->is_set(options::platform_probe_cache_opt))
                     {
-                        auto msg = "Failed to find any platform plugins in: " + path;
-                        throw std::runtime_error(msg.c_str());
+                        platform_library = mir::graphics::module_for_device(
+                            path,
+                            the_options()->get<std::string>(options::platform_probe_cache_opt),
+                            program_options,
+                            *the_shared_library_prober_report());
+                    }
+                    else
+                    {
+                        auto platforms = mir::libraries_for_path(path, *the_shared_library_prober_report());
+                        if (platforms.empty())
+                        {
+                            auto msg = "Failed to find any platform plugins in: " + path;
+                            throw std::runtime_error(msg.c_str());
+                        }
+                        platform_library = mir::graphics::module_for_device(platforms, program_options);
                     }
-                    platform_library = mir::graphics::module_for_device(platforms, dynamic_cast<mir::options::ProgramOption&>(*the_options()));
                 }
                 auto create_host_platform = platform_library->load_function<mg::CreateHostPlatform>(
                     "create_host_platform",
@@ -159,7 +171,8 @@ mir::DefaultServerConfiguration::the_display()
                     return std::make_shared<mg::offscreen::Display>(
                         egl_access->egl_native_display(),
                         the_display_configuration_policy(),
-                        the_display_report());
+                        the_display_report(),
+                        the_options()->get<std::string>(options::renderer_opt) == "software");
                 }
                 else
                 {
@@ -98,7 +98,12 @@ public:
         bind();
     }
 
-    void secure_for_render() override
+    bool secure_for_render() override
+    {
+        return true;
+    }
+
+    void rendering_finished() override
     {
     }
 
@@ -177,7 +182,12 @@ public:
         bind();
     }
 
-    void secure_for_render() override
+    bool secure_for_render() override
+    {
+        return true;
+    }
+
+    void rendering_finished() override
     {
     }
 
@@ -27,6 +27,7 @@
 #include "mir/graphics/egl_error.h"
 #include "buffer.h"
 
+#include <algorithm>
 #include <sstream>
 #include <boost/throw_exception.hpp>
 #include <stdexcept>
@@ -68,13 +69,12 @@ mgn::detail::DisplayBuffer::DisplayBuffer(
     host_stream{create_host_stream(*host_connection, best_output)},
     host_surface{create_host_surface(*host_connection, host_stream, best_output)},
     host_connection{host_connection},
-    host_chain{nullptr},
     egl_config{egl_display.choose_windowed_config(best_output.current_format)},
     egl_context{egl_display, eglCreateContext(egl_display, egl_config, egl_display.egl_context(), nested_egl_context_attribs)},
     area{best_output.extents()},
     egl_surface{egl_display, host_stream->egl_native_window(), egl_config},
     passthrough_option(option),
-    content{BackingContent::stream}
+    layout{{nullptr, area}}
 {
     host_surface->set_event_handler(event_thunk, this);
 }
@@ -98,74 +98,168 @@ void mgn::detail::DisplayBuffer::release_current()
 void mgn::detail::DisplayBuffer::swap_buffers()
 {
     eglSwapBuffers(egl_display, egl_surface);
-    if (content != BackingContent::stream)
+
+    RenderableList overlays;
+    std::swap(overlays, stream_overlays);
+    pass_through(overlays, true);
+}
+
+void mgn::detail::DisplayBuffer::bind()
+{
+}
+
+bool mgn::detail::DisplayBuffer::Layer::operator==(Layer const& other) const
+{
+    return chain == other.chain && position == other.position;
+}
+
+bool mgn::detail::DisplayBuffer::can_pass_through(Renderable const& renderable) const
+{
+    auto const position = renderable.screen_position();
+    if ((renderable.alpha() != 1.0f) ||
+        (renderable.transformation() != identity) ||
+        (position.size == geom::Size{}) ||
+        !area.contains(position))
     {
-        auto spec = host_connection->create_surface_spec();
-        spec->add_stream(*host_stream, geom::Displacement{0,0}, area.size);
-        content = BackingContent::stream;
-        host_surface->apply_spec(*spec);
-        //if the host_chain is not released, a buffer of the passthrough surface might get caught
-        //up in the host server, resulting a drop in nbuffers available to the client
-        host_chain = nullptr;
+        return false;
     }
+
+    return dynamic_cast<mgn::NativeBuffer*>(renderable.buffer()->native_buffer_handle().get());
 }
 
-void mgn::detail::DisplayBuffer::bind()
+mg::RenderableList::const_iterator mgn::detail::DisplayBuffer::passthrough_begin(
+    RenderableList const& list) const
 {
+    if (passthrough_option == mgn::PassthroughOption::disabled)
+        return list.end();
+
+    // Walk down from the top until a renderable can't be passed through or
+    // hides everything beneath it
+    auto begin = list.end();
+    while (begin != list.begin() && can_pass_through(**std::prev(begin)))
+    {
+        --begin;
+        if ((*begin)->screen_position() == area && !(*begin)->shaped())
+            break;
+    }
+    return begin;
 }
 
 bool mgn::detail::DisplayBuffer::overlay(RenderableList const& list)
 {
-    if ((passthrough_option == mgn::PassthroughOption::disabled) ||
-        list.empty() ||
-        (list.back()->screen_position() != area) ||
-        (list.back()->alpha() != 1.0f) ||
-        (list.back()->shaped()) ||
-        (list.back()->transformation() != identity))
+    auto const begin = passthrough_begin(list);
+    if ((begin == list.end()) ||
+        ((*begin)->screen_position() != area) ||
+        (*begin)->shaped())
     {
-        //could not represent scene with subsurfaces
+        //could not represent scene with subsurfaces alone
         return false;
     }
 
-    auto passthrough_buffer = list.back()->buffer();
-    auto native = dynamic_cast<mgn::NativeBuffer*>(passthrough_buffer->native_buffer_handle().get());
-    if (!native)
-        return false;
+    stream_overlays.clear();
+    pass_through({begin, list.end()}, false);
+    return true;
+}
+
+mg::RenderableList mgn::detail::DisplayBuffer::overlay_top(RenderableList const& list)
+{
+    auto const begin = passthrough_begin(list);
+    stream_overlays.assign(begin, list.end());
+    return {list.begin(), begin};
+}
 
-    if (!host_chain)
-        host_chain = host_connection->create_chain();
+void mgn::detail::DisplayBuffer::pass_through(RenderableList const& renderables, bool above_stream)
+{
+    // Surfaces that are no longer passed through give up their chains to
+    // those that now are. Chains left spare are released once the host has
+    // stopped showing them: if they weren't, a buffer of the surface they
+    // passed through might get caught up in the host server, resulting a
+    // drop in nbuffers available to the client.
+    std::vector<Passthrough> spare;
+    for (auto p = passthroughs.begin(); p != passthroughs.end();)
+    {
+        auto const shown = std::any_of(renderables.begin(), renderables.end(),
+            [&](std::shared_ptr<Renderable> const& r) { return r->id() == p->first; });
+        if (shown)
+        {
+            ++p;
+        }
+        else
+        {
+            spare.push_back(std::move(p->second));
+            p = passthroughs.erase(p);
+        }
+    }
+
+    std::vector<Layer> new_layout;
+    if (above_stream)
+        new_layout.push_back({nullptr, area});
+
+    for (auto const& renderable : renderables)
+    {
+        auto& passthrough = passthroughs[renderable->id()];
+        if (!passthrough.chain)
+        {
+            if (!spare.empty())
+            {
+                passthrough = std::move(spare.back());
+                spare.pop_back();
+            }
+            else
+            {
+                passthrough.chain = host_connection->create_chain();
+            }
+        }
+
+        submit(*renderable, passthrough);
+        new_layout.push_back({passthrough.chain.get(), renderable->screen_position()});
+    }
+
+    if (new_layout != layout)
+    {
+        // The host stacks the content of a surface in the order it's added
+        auto spec = host_connection->create_surface_spec();
+        for (auto const& layer : new_layout)
+        {
+            if (layer.chain)
+                spec->add_chain(*layer.chain, layer.position.top_left - area.top_left, layer.position.size);
+            else
+                spec->add_stream(*host_stream, geom::Displacement{0,0}, area.size);
+        }
+        host_surface->apply_spec(*spec);
+        layout = std::move(new_layout);
+    }
+}
+
+void mgn::detail::DisplayBuffer::submit(Renderable const& renderable, Passthrough& passthrough)
+{
+    auto passthrough_buffer = renderable.buffer();
+    auto native = dynamic_cast<mgn::NativeBuffer*>(passthrough_buffer->native_buffer_handle().get());
+    auto const chain = passthrough.chain->handle();
 
     {
         std::unique_lock<std::mutex> lk(mutex);
-        SubmissionInfo submission_info{native->client_handle(), host_chain->handle()};
+        SubmissionInfo submission_info{native->client_handle(), chain};
         auto submitted = submitted_buffers.find(submission_info);
-        if ((submission_info != last_submitted) && (submitted != submitted_buffers.end()))
+        auto const resubmission = (native->client_handle() == passthrough.last_submitted);
+        if (!resubmission && (submitted != submitted_buffers.end()))
             BOOST_THROW_EXCEPTION(std::logic_error("cannot resubmit buffer that has not been returned by host server"));
-        if ((submission_info == last_submitted) && (submitted != submitted_buffers.end()))
-            return true;
+        if (resubmission && (submitted != submitted_buffers.end()))
+            return;
 
-        if (list.back()->swap_interval() == 0)
-            host_chain->set_submission_mode(mgn::SubmissionMode::dropping);
+        if (renderable.swap_interval() == 0)
+            passthrough.chain->set_submission_mode(mgn::SubmissionMode::dropping);
         else
-            host_chain->set_submission_mode(mgn::SubmissionMode::queueing);
+            passthrough.chain->set_submission_mode(mgn::SubmissionMode::queueing);
 
         submitted_buffers[submission_info] = passthrough_buffer;
-        last_submitted = submission_info;
+        passthrough.last_submitted = native->client_handle();
     }
 
     native->on_ownership_notification(
         std::bind(&mgn::detail::DisplayBuffer::release_buffer, this,
-        native->client_handle(), host_chain->handle()));
-    host_chain->submit_buffer(*native);
-
-    if (content != BackingContent::chain)
-    {
-        auto spec = host_connection->create_surface_spec();
-        spec->add_chain(*host_chain, geom::Displacement{0,0}, passthrough_buffer->size());
-        content = BackingContent::chain;
-        host_surface->apply_spec(*spec);
-    }
-    return true;
+        native->client_handle(), chain));
+    passthrough.chain->submit_buffer(*native);
 }
 
 void mgn::detail::DisplayBuffer::release_buffer(MirBuffer* b, MirPresentationChain *c)
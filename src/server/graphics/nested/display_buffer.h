@@ -20,6 +20,7 @@
 #define MIR_GRAPHICS_NESTED_DETAIL_NESTED_OUTPUT_H_
 
 #include "mir/graphics/display_buffer.h"
+#include "mir/graphics/partial_overlay.h"
 #include "mir/renderer/gl/render_target.h"
 #include "display.h"
 #include "host_surface.h"
@@ -27,6 +28,7 @@
 #include "host_chain.h"
 
 #include <map>
+#include <vector>
 #include <glm/glm.hpp>
 #include <EGL/egl.h>
 
@@ -44,6 +46,7 @@ namespace detail
 
 class DisplayBuffer : public graphics::DisplayBuffer,
                       public graphics::NativeDisplayBuffer,
+                      public graphics::PartialOverlay,
                       public renderer::gl::RenderTarget
 {
 public:
@@ -63,6 +66,7 @@ public:
     glm::mat2 transformation() const override;
 
     bool overlay(RenderableList const& renderlist) override;
+    RenderableList overlay_top(RenderableList const& renderlist) override;
 
     NativeDisplayBuffer* native_display_buffer() override;
 
@@ -73,7 +77,6 @@ private:
     std::shared_ptr<HostStream> const host_stream;
     std::shared_ptr<HostSurface> const host_surface;
     std::shared_ptr<HostConnection> const host_connection;
-    std::unique_ptr<HostChain> host_chain;
     EGLConfig const egl_config;
     EGLContextStore const egl_context;
     geometry::Rectangle const area;
@@ -83,17 +86,37 @@ private:
     static void event_thunk(MirWindow* surface, MirEvent const* event, void* context);
     void mir_event(MirEvent const& event);
 
-    enum class BackingContent
-    {
-        stream,
-        chain
-    } content;
     glm::mat4 const identity;
 
+    // A renderable passed through to the host on a chain of its own
+    struct Passthrough
+    {
+        std::unique_ptr<HostChain> chain;
+        MirBuffer* last_submitted{nullptr};
+    };
+    std::map<Renderable::ID, Passthrough> passthroughs;
+
+    // The content of the host surface, bottom first. A layer without a
+    // chain is our GL composited stream.
+    struct Layer
+    {
+        HostChain* chain;
+        geometry::Rectangle position;
+        bool operator==(Layer const& other) const;
+    };
+    std::vector<Layer> layout;
+
+    // Renderables to pass through above the stream once it's swapped
+    RenderableList stream_overlays;
+
+    bool can_pass_through(Renderable const& renderable) const;
+    RenderableList::const_iterator passthrough_begin(RenderableList const& list) const;
+    void pass_through(RenderableList const& renderables, bool above_stream);
+    void submit(Renderable const& renderable, Passthrough& passthrough);
+
     std::mutex mutex;
     typedef std::tuple<MirBuffer*, MirPresentationChain*> SubmissionInfo;
     std::map<SubmissionInfo, std::shared_ptr<graphics::Buffer>> submitted_buffers;
-    SubmissionInfo last_submitted { nullptr, nullptr };
 
     void release_buffer(MirBuffer* b, MirPresentationChain* c);
 };
@@ -133,7 +133,8 @@ mg::DisplayConfigurationOutput mgn::NestedDisplayConfiguration::create_display_o
         local_config.subpixel_arrangement,
         local_config.gamma,
         local_config.gamma_supported,
-        std::move(edid)
+        std::move(edid),
+        false // The host does not tell us whether it varies its refresh rate
     };
 }
 
@@ -18,6 +18,7 @@
 
 #include "display.h"
 #include "display_buffer.h"
+#include "pixel_display_buffer.h"
 #include "mir/graphics/display_configuration_policy.h"
 #include "mir/graphics/egl_error.h"
 #include "mir/graphics/virtual_output.h"
@@ -97,8 +98,18 @@ mgo::detail::DisplaySyncGroup::recommended_sleep() const
 mgo::Display::Display(
     EGLNativeDisplayType egl_native_display,
     std::shared_ptr<DisplayConfigurationPolicy> const& initial_conf_policy,
-    std::shared_ptr<DisplayReport> const&)
-    : egl_display{create_and_initialize_display(egl_native_display)},
+    std::shared_ptr<DisplayReport> const& listener)
+    : Display(egl_native_display, initial_conf_policy, listener, false)
+{
+}
+
+mgo::Display::Display(
+    EGLNativeDisplayType egl_native_display,
+    std::shared_ptr<DisplayConfigurationPolicy> const& initial_conf_policy,
+    std::shared_ptr<DisplayReport> const&,
+    bool pixel_buffers)
+    : pixel_buffers{pixel_buffers},
+      egl_display{create_and_initialize_display(egl_native_display)},
       egl_context_shared{egl_display, EGL_NO_CONTEXT},
       current_display_configuration{geom::Size{1024,768}}
 {
@@ -150,6 +161,14 @@ void mgo::Display::configure(mg::DisplayConfiguration const& conf)
         {
             if (output.connected && output.preferred_mode_index < output.modes.size())
             {
+                if (pixel_buffers)
+                {
+                    display_sync_groups.emplace_back(
+                        new mgo::detail::DisplaySyncGroup(
+                            std::make_unique<mgo::PixelDisplayBuffer>(output.extents())));
+                    return;
+                }
+
                 eglBindAPI(MIR_SERVER_EGL_OPENGL_API);
                 auto raw_db = new mgo::DisplayBuffer{
                     SurfacelessEGLContext{egl_display, egl_context_shared},
@@ -80,6 +80,11 @@ public:
     Display(EGLNativeDisplayType egl_native_display,
             std::shared_ptr<DisplayConfigurationPolicy> const& initial_conf_policy,
             std::shared_ptr<DisplayReport> const& listener);
+    /// With pixel_buffers, outputs are drawn in main memory by the software renderer
+    Display(EGLNativeDisplayType egl_native_display,
+            std::shared_ptr<DisplayConfigurationPolicy> const& initial_conf_policy,
+            std::shared_ptr<DisplayReport> const& listener,
+            bool pixel_buffers);
     ~Display() noexcept;
 
     void for_each_display_sync_group(std::function<void(DisplaySyncGroup&)> const& f) override;
@@ -108,6 +113,7 @@ public:
     std::unique_ptr<renderer::gl::Context> create_gl_context() override;
     bool apply_if_configuration_preserves_display_buffers(graphics::DisplayConfiguration const& conf) override;
 private:
+    bool const pixel_buffers;
     detail::EGLDisplayHandle const egl_display;
     SurfacelessEGLContext const egl_context_shared;
     mutable std::mutex configuration_mutex;
@@ -40,7 +40,8 @@ mgo::DisplayConfiguration::DisplayConfiguration(geom::Size const& display_size)
                  mir_subpixel_arrangement_unknown,
                  {},
                  mir_output_gamma_unsupported,
-                 {}},
+                 {},
+                 false},
           card{mg::DisplayConfigurationCardId{0}, 1}
 {
 }
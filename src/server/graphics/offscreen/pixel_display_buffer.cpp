@@ -0,0 +1,58 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "pixel_display_buffer.h"
+
+namespace mg = mir::graphics;
+namespace mgo = mg::offscreen;
+namespace geom = mir::geometry;
+
+mgo::PixelDisplayBuffer::PixelDisplayBuffer(geom::Rectangle const& area) :
+    area{area},
+    stride{area.size.width.as_int() * 4},
+    pixels(stride.as_int() * area.size.height.as_int())
+{
+}
+
+geom::Rectangle mgo::PixelDisplayBuffer::view_area() const
+{
+    return area;
+}
+
+bool mgo::PixelDisplayBuffer::overlay(RenderableList const&)
+{
+    return false;
+}
+
+glm::mat2 mgo::PixelDisplayBuffer::transformation() const
+{
+    return glm::mat2();
+}
+
+mg::NativeDisplayBuffer* mgo::PixelDisplayBuffer::native_display_buffer()
+{
+    return this;
+}
+
+auto mgo::PixelDisplayBuffer::back_buffer() -> Pixels
+{
+    return {pixels.data(), area.size, stride, mir_pixel_format_argb_8888, drawn ? 1u : 0u};
+}
+
+void mgo::PixelDisplayBuffer::swap_buffers(geom::Rectangles const&)
+{
+    drawn = true;
+}
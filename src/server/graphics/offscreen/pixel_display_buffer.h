@@ -0,0 +1,61 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_GRAPHICS_OFFSCREEN_PIXEL_DISPLAY_BUFFER_H_
+#define MIR_GRAPHICS_OFFSCREEN_PIXEL_DISPLAY_BUFFER_H_
+
+#include "mir/graphics/display_buffer.h"
+#include "mir/geometry/rectangle.h"
+#include "mir/renderer/sw/pixel_target.h"
+
+#include <vector>
+
+namespace mir
+{
+namespace graphics
+{
+namespace offscreen
+{
+
+/// An offscreen display buffer in main memory, for the software renderer
+class PixelDisplayBuffer : public graphics::DisplayBuffer,
+                           public graphics::NativeDisplayBuffer,
+                           public renderer::software::PixelTarget
+{
+public:
+    PixelDisplayBuffer(geometry::Rectangle const& area);
+
+    geometry::Rectangle view_area() const override;
+    bool overlay(RenderableList const& renderlist) override;
+    glm::mat2 transformation() const override;
+    NativeDisplayBuffer* native_display_buffer() override;
+
+    Pixels back_buffer() override;
+    void swap_buffers(geometry::Rectangles const& damage) override;
+
+private:
+    geometry::Rectangle const area;
+    geometry::Stride const stride;
+    // Nothing scans the frame out, so it can be drawn over in place
+    std::vector<unsigned char> pixels;
+    bool drawn{false};
+};
+
+}
+}
+}
+
+#endif /* MIR_GRAPHICS_OFFSCREEN_PIXEL_DISPLAY_BUFFER_H_ */
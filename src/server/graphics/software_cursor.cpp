@@ -22,6 +22,7 @@
 #include "mir/graphics/pixel_format_utils.h"
 #include "mir/graphics/renderable.h"
 #include "mir/graphics/buffer_properties.h"
+#include "mir/graphics/content_hash.h"
 #include "mir/input/scene.h"
 #include "mir/renderer/sw/pixel_source.h"
 
@@ -36,6 +37,12 @@ namespace mrs = mir::renderer::software;
 
 namespace
 {
+size_t image_bytes(mg::CursorImage const& image)
+{
+    return image.size().width.as_uint32_t() *
+           image.size().height.as_uint32_t() *
+           MIR_BYTES_PER_PIXEL(mir_pixel_format_argb_8888);
+}
 
 MirPixelFormat get_8888_format(std::vector<MirPixelFormat> const& formats)
 {
@@ -143,6 +150,22 @@ void mg::SoftwareCursor::show()
 
 void mg::SoftwareCursor::show(CursorImage const& cursor_image)
 {
+    // Pointers often set the image they already have: keep the buffer we made for it
+    auto const new_image_hash = content_hash(cursor_image.as_argb_8888(), image_bytes(cursor_image));
+    bool unchanged = false;
+    {
+        std::lock_guard<std::mutex> lg{guard};
+        unchanged = renderable &&
+            new_image_hash == image_hash &&
+            cursor_image.size() == renderable->buffer()->size() &&
+            cursor_image.hotspot() == hotspot;
+    }
+    if (unchanged)
+    {
+        show();
+        return;
+    }
+
     std::shared_ptr<detail::CursorRenderable> new_renderable;
     std::shared_ptr<detail::CursorRenderable> old_renderable;
     bool old_visibility = false;
@@ -168,6 +191,7 @@ void mg::SoftwareCursor::show(CursorImage const& cursor_image)
         old_renderable = renderable;
         renderable = new_renderable;
         hotspot = cursor_image.hotspot();
+        image_hash = new_image_hash;
     }
 
     if (old_renderable && old_visibility)
@@ -22,6 +22,7 @@
 #include "mir/graphics/cursor.h"
 #include "mir_toolkit/client_types.h"
 #include "mir/geometry/displacement.h"
+#include <cstdint>
 #include <mutex>
 
 namespace mir
@@ -61,6 +62,8 @@ private:
     std::shared_ptr<detail::CursorRenderable> renderable;
     bool visible;
     geometry::Displacement hotspot;
+    /// The content_hash() of the image the renderable shows
+    uint64_t image_hash{0};
 };
 
 }
@@ -31,6 +31,7 @@
 #include "default_input_manager.h"
 #include "surface_input_dispatcher.h"
 #include "basic_seat.h"
+#include "threaded_seat.h"
 #include "seat_observer_multiplexer.h"
 #include "../graphics/nested/input_platform.h"
 
@@ -52,6 +53,8 @@
 
 #include "mir_toolkit/cursors.h"
 
+#include <boost/throw_exception.hpp>
+
 namespace mi = mir::input;
 namespace mr = mir::report;
 namespace ms = mir::scene;
@@ -230,6 +233,19 @@ mir::DefaultServerConfiguration::the_input_manager()
         {
             auto const options = the_options();
             bool input_opt = options->get<bool>(options::enable_input_opt);
+            auto const reader_priority = options->is_set(options::input_reader_priority_opt) ?
+                options->get<int>(options::input_reader_priority_opt) : 0;
+
+            // Without the queue, filters, the shell and dispatch to clients all run on the reading thread
+            if (input_opt && reader_priority != 0 &&
+                !(options->is_set(options::input_dispatch_queue_opt) &&
+                  options->get<int>(options::input_dispatch_queue_opt) > 0))
+            {
+                BOOST_THROW_EXCEPTION(mir::AbnormalExit(
+                    std::string("Exiting Mir! Reason: --") + options::input_reader_priority_opt +
+                    " needs --" + options::input_dispatch_queue_opt +
+                    ", or all of input dispatch would run real-time"));
+            }
 
             if (!input_opt)
             {
@@ -243,7 +259,8 @@ mir::DefaultServerConfiguration::the_input_manager()
                 // TODO: move this into a nested graphics platform
                 auto platform = std::make_shared<mgn::InputPlatform>(the_host_connection(), device_registry, input_report);
 
-                return std::make_shared<mi::DefaultInputManager>(the_input_reading_multiplexer(), std::move(platform));
+                return std::make_shared<mi::DefaultInputManager>(
+                    the_input_reading_multiplexer(), std::move(platform), reader_priority);
             }
             else
             {
@@ -263,7 +280,8 @@ mir::DefaultServerConfiguration::the_input_manager()
                                                      input_report, *the_shared_library_prober_report());
                 }
 
-                return std::make_shared<mi::DefaultInputManager>(the_input_reading_multiplexer(), std::move(platform));
+                return std::make_shared<mi::DefaultInputManager>(
+                    the_input_reading_multiplexer(), std::move(platform), reader_priority);
             }
         }
     );
@@ -318,8 +336,19 @@ std::shared_ptr<mi::DefaultInputDeviceHub> mir::DefaultServerConfiguration::the_
        {
            auto input_dispatcher = the_input_dispatcher();
            auto key_repeater = std::dynamic_pointer_cast<mi::KeyRepeatDispatcher>(input_dispatcher);
+
+           // Events from devices can be dispatched from a thread other than the one reading them
+           std::shared_ptr<mi::Seat> seat = the_seat();
+           auto const options = the_options();
+           if (options->is_set(options::input_dispatch_queue_opt))
+           {
+               auto const capacity = options->get<int>(options::input_dispatch_queue_opt);
+               if (capacity > 0)
+                   seat = std::make_shared<mi::ThreadedSeat>(seat, capacity);
+           }
+
            auto hub = std::make_shared<mi::DefaultInputDeviceHub>(
-               the_seat(),
+               seat,
                the_input_reading_multiplexer(),
                the_cookie_authority(),
                the_key_mapper(),
@@ -16,6 +16,8 @@
  * Authored by: Andreas Pokorny <andreas.pokorny@canonical.com>
  */
 
+#define MIR_LOG_COMPONENT "Input"
+
 #include "default_input_manager.h"
 
 #include "mir/input/platform.h"
@@ -23,6 +25,7 @@
 #include "mir/dispatch/multiplexing_dispatchable.h"
 #include "mir/dispatch/threaded_dispatcher.h"
 
+#include "mir/log.h"
 #include "mir/main_loop.h"
 #include "mir/thread_name.h"
 #include "mir/unwind_helpers.h"
@@ -30,14 +33,35 @@
 
 #include <future>
 
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+
 namespace mi = mir::input;
 
+namespace
+{
+void use_realtime_scheduling(int priority)
+{
+    sched_param param{};
+    param.sched_priority = priority;
+
+    if (auto const error = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param))
+    {
+        mir::log_warning("Failed to give the input reading thread SCHED_FIFO priority %d: %s",
+                         priority, strerror(error));
+    }
+}
+}
+
 mi::DefaultInputManager::DefaultInputManager(
     std::shared_ptr<dispatch::MultiplexingDispatchable> const& multiplexer,
-    std::shared_ptr<Platform> const& platform) :
+    std::shared_ptr<Platform> const& platform,
+    int reader_priority) :
     platform{platform},
     multiplexer{multiplexer},
     queue{std::make_shared<mir::dispatch::ActionQueue>()},
+    reader_priority{reader_priority},
     state{State::stopped}
 {
 }
@@ -82,6 +106,8 @@ void mi::DefaultInputManager::start()
      */
     queue->enqueue([this,promise = std::move(started_promise)]()
                    {
+                        if (reader_priority > 0)
+                            use_realtime_scheduling(reader_priority);
                         start_platforms();
                         promise->set_value();
                    });
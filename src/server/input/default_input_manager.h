@@ -41,9 +41,11 @@ class InputDeviceRegistry;
 class DefaultInputManager : public InputManager
 {
 public:
+    /// A positive reader_priority runs the thread reading devices with that SCHED_FIFO priority
     DefaultInputManager(
         std::shared_ptr<dispatch::MultiplexingDispatchable> const& multiplexer,
-        std::shared_ptr<Platform> const& platform);
+        std::shared_ptr<Platform> const& platform,
+        int reader_priority = 0);
     ~DefaultInputManager();
 
     void start() override;
@@ -56,6 +58,7 @@ private:
     std::shared_ptr<Platform> const platform;
     std::shared_ptr<dispatch::MultiplexingDispatchable> const multiplexer;
     std::shared_ptr<dispatch::ActionQueue> const queue;
+    int const reader_priority;
     std::unique_ptr<dispatch::ThreadedDispatcher> input_thread;
 
     enum class State
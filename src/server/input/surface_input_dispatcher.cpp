@@ -260,15 +260,20 @@ void mi::SurfaceInputDispatcher::send_enter_exit_event(std::shared_ptr<mi::Surfa
     surface->consume(event.get());
 }
 
+// Only a device's first event adds its state, so later events need no allocation
 mi::SurfaceInputDispatcher::PointerInputState& mi::SurfaceInputDispatcher::ensure_pointer_state(MirInputDeviceId id)
 {
-    pointer_state_by_id.insert(std::make_pair(id, PointerInputState()));
+    auto const existing = pointer_state_by_id.find(id);
+    if (existing != pointer_state_by_id.end())
+        return existing->second;
     return pointer_state_by_id[id];
 }
 
 mi::SurfaceInputDispatcher::TouchInputState& mi::SurfaceInputDispatcher::ensure_touch_state(MirInputDeviceId id)
 {
-    touch_state_by_id.insert(std::make_pair(id, TouchInputState()));
+    auto const existing = touch_state_by_id.find(id);
+    if (existing != touch_state_by_id.end())
+        return existing->second;
     return touch_state_by_id[id];
 }
 
@@ -0,0 +1,343 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define MIR_LOG_COMPONENT "Input"
+
+#include "threaded_seat.h"
+
+#include "mir/events/event_builders.h"
+#include "mir/input/device.h"
+#include "mir/input/input_sink.h"
+#include "mir/log.h"
+#include "mir/terminate_with_current_exception.h"
+#include "mir/thread_name.h"
+
+#include <algorithm>
+
+namespace mi = mir::input;
+namespace mev = mir::events;
+
+using namespace std::chrono;
+
+namespace
+{
+// How often to log how dispatching is doing, while there is input
+auto const log_interval = seconds{10};
+
+size_t round_up_to_power_of_two(size_t capacity)
+{
+    size_t size{2};
+    while (size < capacity)
+        size *= 2;
+    return size;
+}
+
+double milliseconds_of(nanoseconds time)
+{
+    return duration<double, std::milli>(time).count();
+}
+}
+
+void mi::ThreadedSeat::StageCounters::add(nanoseconds time)
+{
+    auto const ns = std::max<int64_t>(time.count(), 0);
+    total.fetch_add(ns, std::memory_order_relaxed);
+
+    auto current = max.load(std::memory_order_relaxed);
+    while (ns > current && !max.compare_exchange_weak(current, ns, std::memory_order_relaxed))
+        ;
+}
+
+auto mi::ThreadedSeat::StageCounters::read() const -> Stage
+{
+    return {nanoseconds{total.load(std::memory_order_relaxed)}, nanoseconds{max.load(std::memory_order_relaxed)}};
+}
+
+mi::ThreadedSeat::ThreadedSeat(std::shared_ptr<Seat> const& seat, size_t capacity) :
+    seat{seat},
+    mask{round_up_to_power_of_two(capacity) - 1},
+    slots{new Slot[mask + 1]},
+    next_log{steady_clock::now() + log_interval}
+{
+    for (size_t i = 0; i != mask + 1; ++i)
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+
+    dispatcher = std::thread{[this] { run(); }};
+}
+
+mi::ThreadedSeat::~ThreadedSeat()
+{
+    {
+        std::lock_guard<decltype(mutex)> lock{mutex};
+        stopping = true;
+    }
+    work.notify_all();
+    progress.notify_all();
+    dispatcher.join();
+}
+
+// A bounded multi-producer queue, after Dmitry Vyukov's: each slot's sequence
+// says whether it is ready to be written (== the position being pushed) or
+// read (== the position being popped + 1)
+bool mi::ThreadedSeat::try_push(Entry& entry)
+{
+    auto position = push_position.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        auto& slot = slots[position & mask];
+        auto const sequence = slot.sequence.load(std::memory_order_acquire);
+        auto const difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+
+        if (difference == 0)
+        {
+            if (push_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                slot.entry = std::move(entry);
+                slot.sequence.store(position + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (difference < 0)
+        {
+            return false;
+        }
+        else
+        {
+            position = push_position.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+bool mi::ThreadedSeat::try_pop(Entry& entry)
+{
+    auto position = pop_position.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        auto& slot = slots[position & mask];
+        auto const sequence = slot.sequence.load(std::memory_order_acquire);
+        auto const difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+
+        if (difference == 0)
+        {
+            if (pop_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                entry = std::move(slot.entry);
+                slot.sequence.store(position + mask + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (difference < 0)
+        {
+            return false;
+        }
+        else
+        {
+            position = pop_position.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void mi::ThreadedSeat::dispatch_event(MirEvent& event)
+{
+    Entry entry{mev::clone_event(event), steady_clock::now()};
+
+    // Input event times are CLOCK_MONOTONIC, as is steady_clock
+    if (mir_event_get_type(&event) == mir_event_type_input)
+    {
+        auto const event_time = mir_input_event_get_event_time(mir_event_get_input_event(&event));
+        acquisition.add(entry.queued.time_since_epoch() - nanoseconds{event_time});
+    }
+
+    auto const depth = queued.fetch_add(1) + 1 - dispatched.load();
+    auto deepest = max_depth.load(std::memory_order_relaxed);
+    while (depth > deepest && !max_depth.compare_exchange_weak(deepest, depth, std::memory_order_relaxed))
+        ;
+
+    if (!try_push(entry))
+    {
+        full.fetch_add(1, std::memory_order_relaxed);
+
+        std::unique_lock<decltype(mutex)> lock{mutex};
+        ++waiters;
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        progress.wait(lock, [&] { return stopping || try_push(entry); });
+        --waiters;
+    }
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (dispatcher_sleeping.load())
+    {
+        std::lock_guard<decltype(mutex)> lock{mutex};
+        work.notify_one();
+    }
+}
+
+void mi::ThreadedSeat::drain()
+{
+    if (std::this_thread::get_id() == dispatcher.get_id())
+        return;
+
+    auto const target = queued.load();
+
+    std::unique_lock<decltype(mutex)> lock{mutex};
+    ++waiters;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    progress.wait(lock, [&] { return stopping || dispatched.load() >= target; });
+    --waiters;
+}
+
+void mi::ThreadedSeat::wake_waiters()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiters.load())
+    {
+        std::lock_guard<decltype(mutex)> lock{mutex};
+        progress.notify_all();
+    }
+}
+
+void mi::ThreadedSeat::run()
+try
+{
+    mir::set_thread_name("Mir/Input Dispatch");
+
+    Entry entry;
+    for (;;)
+    {
+        if (!try_pop(entry))
+        {
+            std::unique_lock<decltype(mutex)> lock{mutex};
+            dispatcher_sleeping = true;
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            work.wait(lock, [&] { return stopping || try_pop(entry); });
+            dispatcher_sleeping = false;
+
+            if (!entry.event)
+                return;
+        }
+
+        auto const start = steady_clock::now();
+        waiting.add(start - entry.queued);
+
+        seat->dispatch_event(*entry.event);
+        entry.event.reset();
+
+        auto const end = steady_clock::now();
+        dispatching.add(end - start);
+        dispatched.fetch_add(1);
+        wake_waiters();
+
+        if (end >= next_log)
+        {
+            log_statistics();
+            next_log = end + log_interval;
+        }
+    }
+}
+catch (...)
+{
+    mir::terminate_with_current_exception();
+}
+
+void mi::ThreadedSeat::log_statistics()
+{
+    auto const now = statistics();
+    auto const events = now.events - last_logged.events;
+    if (!events)
+        return;
+
+    auto const mean = [events](nanoseconds now, nanoseconds then)
+        {
+            return milliseconds_of((now - then) / events);
+        };
+
+    log_debug("Dispatched %llu events, queued at most %zu deep (%llu times full). "
+              "Mean (max) ms: acquisition %.3f (%.3f), queued %.3f (%.3f), dispatch %.3f (%.3f)",
+              static_cast<unsigned long long>(events), now.max_depth,
+              static_cast<unsigned long long>(now.full - last_logged.full),
+              mean(now.acquisition.total, last_logged.acquisition.total), milliseconds_of(now.acquisition.max),
+              mean(now.queued.total, last_logged.queued.total), milliseconds_of(now.queued.max),
+              mean(now.dispatch.total, last_logged.dispatch.total), milliseconds_of(now.dispatch.max));
+
+    last_logged = now;
+}
+
+auto mi::ThreadedSeat::statistics() const -> Statistics
+{
+    return {
+        dispatched.load(),
+        max_depth.load(std::memory_order_relaxed),
+        full.load(std::memory_order_relaxed),
+        acquisition.read(),
+        waiting.read(),
+        dispatching.read()};
+}
+
+void mi::ThreadedSeat::add_device(Device const& device)
+{
+    drain();
+    seat->add_device(device);
+}
+
+void mi::ThreadedSeat::remove_device(Device const& device)
+{
+    drain();
+    seat->remove_device(device);
+}
+
+mir::EventUPtr mi::ThreadedSeat::create_device_state()
+{
+    drain();
+    return seat->create_device_state();
+}
+
+void mi::ThreadedSeat::set_key_state(Device const& dev, std::vector<uint32_t> const& scan_codes)
+{
+    drain();
+    seat->set_key_state(dev, scan_codes);
+}
+
+void mi::ThreadedSeat::set_pointer_state(Device const& dev, MirPointerButtons buttons)
+{
+    drain();
+    seat->set_pointer_state(dev, buttons);
+}
+
+void mi::ThreadedSeat::set_cursor_position(float cursor_x, float cursor_y)
+{
+    drain();
+    seat->set_cursor_position(cursor_x, cursor_y);
+}
+
+void mi::ThreadedSeat::set_confinement_regions(geometry::Rectangles const& regions)
+{
+    seat->set_confinement_regions(regions);
+}
+
+void mi::ThreadedSeat::reset_confinement_regions()
+{
+    seat->reset_confinement_regions();
+}
+
+mir::geometry::Rectangle mi::ThreadedSeat::bounding_rectangle() const
+{
+    return seat->bounding_rectangle();
+}
+
+mi::OutputInfo mi::ThreadedSeat::output_info(uint32_t output_id) const
+{
+    return seat->output_info(output_id);
+}
@@ -0,0 +1,147 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_INPUT_THREADED_SEAT_H_
+#define MIR_INPUT_THREADED_SEAT_H_
+
+#include "mir/input/seat.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace mir
+{
+namespace input
+{
+/**
+ * Dispatches events through another seat from a thread of its own, so that
+ * the thread reading input devices isn't held up by the event filters,
+ * dispatchers and sends to clients that dispatching involves.
+ *
+ * Events are handed over, in order, through a bounded lock-free queue; when
+ * that is full the reading thread waits. Calls that change the seat's state
+ * first wait for the events already queued to be dispatched, so that they
+ * happen in the order they were made.
+ */
+class ThreadedSeat : public Seat
+{
+public:
+    ThreadedSeat(std::shared_ptr<Seat> const& seat, size_t capacity);
+    ~ThreadedSeat();
+
+    void add_device(Device const& device) override;
+    void remove_device(Device const& device) override;
+    void dispatch_event(MirEvent& event) override;
+    EventUPtr create_device_state() override;
+
+    void set_key_state(Device const& dev, std::vector<uint32_t> const& scan_codes) override;
+    void set_pointer_state(Device const& dev, MirPointerButtons buttons) override;
+    void set_cursor_position(float cursor_x, float cursor_y) override;
+    void set_confinement_regions(geometry::Rectangles const& regions) override;
+    void reset_confinement_regions() override;
+
+    geometry::Rectangle bounding_rectangle() const override;
+    input::OutputInfo output_info(uint32_t output_id) const override;
+
+    struct Stage
+    {
+        std::chrono::nanoseconds total;
+        std::chrono::nanoseconds max;
+    };
+
+    struct Statistics
+    {
+        uint64_t events;
+        /// The most events that have been queued at once
+        size_t max_depth;
+        /// How often the reading thread has found the queue full
+        uint64_t full;
+        /// From the time of the input event until it was queued
+        Stage acquisition;
+        /// From being queued until being dispatched
+        Stage queued;
+        /// Dispatching
+        Stage dispatch;
+    };
+
+    Statistics statistics() const;
+
+    /// Waits until the events queued so far have been dispatched
+    void drain();
+
+private:
+    struct Entry
+    {
+        EventUPtr event{nullptr, nullptr};
+        std::chrono::steady_clock::time_point queued;
+    };
+
+    struct Slot
+    {
+        std::atomic<size_t> sequence;
+        Entry entry;
+    };
+
+    struct StageCounters
+    {
+        std::atomic<int64_t> total{0};
+        std::atomic<int64_t> max{0};
+
+        void add(std::chrono::nanoseconds time);
+        Stage read() const;
+    };
+
+    bool try_push(Entry& entry);
+    bool try_pop(Entry& entry);
+    void wake_waiters();
+    void run();
+    void log_statistics();
+
+    std::shared_ptr<Seat> const seat;
+
+    size_t const mask;
+    std::unique_ptr<Slot[]> const slots;
+    alignas(64) std::atomic<size_t> push_position{0};
+    alignas(64) std::atomic<size_t> pop_position{0};
+
+    alignas(64) std::atomic<uint64_t> queued{0};
+    std::atomic<uint64_t> dispatched{0};
+    std::atomic<size_t> max_depth{0};
+    std::atomic<uint64_t> full{0};
+    StageCounters acquisition;
+    StageCounters waiting;
+    StageCounters dispatching;
+
+    std::mutex mutex;
+    std::condition_variable work;
+    std::condition_variable progress;
+    std::atomic<bool> dispatcher_sleeping{false};
+    std::atomic<int> waiters{0};
+    bool stopping{false};
+
+    Statistics last_logged{};
+    std::chrono::steady_clock::time_point next_log;
+
+    std::thread dispatcher;
+};
+}
+}
+
+#endif /* MIR_INPUT_THREADED_SEAT_H_ */
@@ -18,24 +18,44 @@
 
 #include "mir/input/validator.h"
 #include "mir/events/event_builders.h"
+#include "mir/events/touch_event.h"
 #include "mir_toolkit/event.h"
 
-#include <set>
 #include <algorithm>
+#include <bitset>
 
 namespace mi = mir::input;
 namespace mev = mir::events;
 
-namespace
+size_t const mi::Validator::max_contacts;
+static_assert(mi::Validator::max_contacts == mir::capnp::TouchScreenEvent::MAX_COUNT,
+              "Contacts must hold every contact a touch event can carry");
+
+bool mi::Validator::Contacts::contains(MirTouchId id) const
 {
-std::vector<mev::ContactState> get_contact_state(MirTouchEvent const* event)
+    return std::any_of(begin(), end(), [id](auto const& contact) { return contact.touch_id == id; });
+}
+
+void mi::Validator::Contacts::push_back(mev::ContactState const& contact)
 {
-    std::vector<mev::ContactState> ret;
-    ret.reserve(mir_touch_event_point_count(event));
+    if (count != max_contacts)
+        contacts[count++] = contact;
+}
 
+void mi::Validator::Contacts::erase(mev::ContactState* contact)
+{
+    std::copy(contact + 1, end(), contact);
+    --count;
+}
+
+namespace
+{
+template<typename Contacts>
+void get_contact_state(MirTouchEvent const* event, Contacts& contacts)
+{
     for (size_t i = 0, count = mir_touch_event_point_count(event); i != count; ++i)
     {
-        ret.push_back(mev::ContactState{
+        contacts.push_back(mev::ContactState{
                       mir_touch_event_id(event, i),
                       mir_touch_event_action(event, i),
                       mir_touch_event_tooltype(event, i),
@@ -47,8 +67,6 @@ std::vector<mev::ContactState> get_contact_state(MirTouchEvent const* event)
                       0.0f
                       });
     }
-
-    return ret;
 }
 }
 
@@ -83,68 +101,93 @@ void mi::Validator::validate_and_dispatch(MirEvent const& event)
 //     2. A touch point can not appear without coming down.
 // Our algorithm to ensure a candidate event can be dispatched is as follows:
 //
-//     First we look at the last event to build a set of expected touch ID's. That is to say
+//     First we look at the last event to find the expected touch ID's. That is to say
 // each touch point in the last event which did not have touch_action_up (signifying its dissapearance)
-// is expected to be in the candidate event. Likewise we go through the candidate event can produce a set of events
-// we have found.
+// is expected to be in the candidate event.
 //
-//     We now check for expected events which were not found, e.g. touch points which are missing a release.
+//     We now check for expected touch points which were not found, e.g. touch points which are missing a release.
 // For each of these touch points we can take the coordinates for these points from the last event
 // and dispatch an event which releases the missing point.
 //
 //     Now we check for found touch points which were not expected. If these show up with mir_touch_action_down
 // things are fine. On the other hand if they show up with mir_touch_action_change then a touch point
 // has appeared before its gone down and thus we must inject an event signifying this touch going down.
+//
+//     Touch events are frequent and carry few contacts, so this is done with the contacts held inline
+// and bitsets over them rather than with containers that would allocate for every event.
 void mi::Validator::ensure_stream_validity_locked(
     std::lock_guard<std::mutex> const&,
-    std::vector<mev::ContactState> const& new_event,
-    std::vector<mev::ContactState>& last_state,
-    std::function<void(std::vector<mev::ContactState> const&)> const& dispatch)
+    MirInputEvent const* event,
+    Contacts const& new_event,
+    Contacts& last_state)
 {
-    using TouchSet = std::set<MirTouchId>;
-    TouchSet expected;
-    for (auto const& contact : last_state)
-        expected.insert(contact.touch_id);
-
-    TouchSet in_next_event;
-    TouchSet changed_in_next_event;
-    for (auto const& contact : new_event)
+    std::bitset<max_contacts> missing_up;
+    for (size_t i = 0; i != last_state.size(); ++i)
+        missing_up[i] = !new_event.contains(last_state.begin()[i].touch_id);
+
+    std::bitset<max_contacts> missing_down;
+    for (size_t i = 0; i != new_event.size(); ++i)
     {
-        in_next_event.insert(contact.touch_id);
-        if (contact.action != mir_touch_action_down)
-            changed_in_next_event.insert(contact.touch_id);
+        auto const& contact = new_event.begin()[i];
+        missing_down[i] = contact.action != mir_touch_action_down && !last_state.contains(contact.touch_id);
     }
 
-    std::vector<MirTouchId> missing_up;
-    set_difference(begin(expected), end(expected),
-                   begin(in_next_event), end(in_next_event),
-                   std::back_inserter(missing_up));
-
-    std::vector<MirTouchId> missing_down;
-    set_difference(begin(changed_in_next_event), end(changed_in_next_event),
-                   begin(expected), end(expected),
-                   std::back_inserter(missing_down));
-
-    for (auto touch_id : missing_up)
+    // Repairs are dispatched in order of touch ID
+    auto const next = [](Contacts const& contacts, std::bitset<max_contacts>& marked)
+        {
+            size_t lowest = max_contacts;
+            for (size_t i = 0; i != contacts.size(); ++i)
+            {
+                if (marked[i] && (lowest == max_contacts ||
+                    contacts.begin()[i].touch_id < contacts.begin()[lowest].touch_id))
+                {
+                    lowest = i;
+                }
+            }
+            if (lowest != max_contacts)
+                marked[lowest] = false;
+            return lowest;
+        };
+
+    while (missing_up.any())
     {
         // TODO on purpose we only send out one state change per event..
-        auto pos = find_if(begin(last_state), end(last_state), [touch_id](auto& item){return item.touch_id == touch_id;});
+        auto const i = next(last_state, missing_up);
+        auto const pos = last_state.begin() + i;
         pos->action = mir_touch_action_up;
-        dispatch(last_state);
+        dispatch_synthesized(event, last_state);
         last_state.erase(pos);
+
+        // Those after it have moved down one
+        auto const above = missing_up >> (i + 1) << (i + 1);
+        missing_up = (missing_up ^ above) | (above >> 1);
     }
 
-    for (auto touch_id : missing_down)
+    while (missing_down.any())
     {
         // TODO on purpose we only send out one state change per event..
-        auto pos = find_if(begin(new_event), end(new_event), [touch_id](auto& item){return item.touch_id == touch_id;});
-        last_state.push_back(*pos);
-        last_state.back().action = mir_touch_action_down;
-        dispatch(last_state);
-        last_state.back().action = mir_touch_action_change;
+        auto const i = next(new_event, missing_down);
+        last_state.push_back(new_event.begin()[i]);
+        auto& added = *(last_state.end() - 1);
+        added.action = mir_touch_action_down;
+        dispatch_synthesized(event, last_state);
+        added.action = mir_touch_action_change;
     }
 }
 
+void mi::Validator::dispatch_synthesized(MirInputEvent const* event, Contacts const& contacts)
+{
+    // Only a stream needing repair gets here, so this is not the steady state
+    auto const touch_event = mir_input_event_get_touch_event(event);
+    dispatch_valid_event(*mev::make_event(
+            mir_input_event_get_device_id(event),
+            std::chrono::nanoseconds{mir_input_event_get_event_time(event)},
+            std::vector<uint8_t>{},
+            mir_touch_event_modifiers(touch_event),
+            std::vector<mev::ContactState>(contacts.begin(), contacts.end())
+            ));
+}
+
 void mi::Validator::handle_touch_event(MirEvent const& event)
 {
     std::lock_guard<std::mutex> lg(state_guard);
@@ -152,37 +195,20 @@ void mi::Validator::handle_touch_event(MirEvent const& event)
     auto const input_event = mir_event_get_input_event(&event);
     auto const id = mir_input_event_get_device_id(input_event);
     auto const touch_event = mir_input_event_get_touch_event(input_event);
-    auto new_state = get_contact_state(touch_event);
+    Contacts new_state;
+    get_contact_state(touch_event, new_state);
 
-    ensure_stream_validity_locked(
-        lg,
-        new_state,
-        last_event_by_device[id],
-        [this, touch_event, id](std::vector<events::ContactState> const& contacts)
-        {
-            dispatch_valid_event(*mev::make_event(
-                    id,
-                    std::chrono::nanoseconds{mir_touch_event_modifiers(touch_event)},
-                    std::vector<uint8_t>{},
-                    mir_touch_event_modifiers(touch_event),
-                    contacts
-                    ));
-        });
+    auto& last_state = last_event_by_device[id];
+    ensure_stream_validity_locked(lg, input_event, new_state, last_state);
 
     dispatch_valid_event(event);
 
-    new_state.erase(
-        remove_if(
-            begin(new_state),
-            end(new_state),
-            [](auto& item)
-            {
-                if (item.action == mir_touch_action_down)
-                   item.action = mir_touch_action_change;
-                return item.action == mir_touch_action_up;
-            }),
-        end(new_state)
-        );
-
-    last_event_by_device[id] = new_state;
+    last_state = Contacts{};
+    for (auto contact : new_state)
+    {
+        if (contact.action == mir_touch_action_up)
+            continue;
+        contact.action = mir_touch_action_change;
+        last_state.push_back(contact);
+    }
 }
@@ -45,10 +45,9 @@ mrl::CompositorReport::TimePoint mrl::CompositorReport::now() const
 
 void mrl::CompositorReport::added_display(int width, int height, int x, int y, SubCompositorId id)
 {
-    char msg[128];
-    snprintf(msg, sizeof msg, "Added display %p: %dx%d %+d%+d",
-             id, width, height, x, y);
-    logger->log(ml::Severity::informational, msg, component);
+    logger->log(component, ml::Severity::informational,
+                "Added display %p: %dx%d %+d%+d",
+                id, width, height, x, y);
 }
 
 void mrl::CompositorReport::began_frame(SubCompositorId id)
@@ -103,8 +102,8 @@ void mrl::CompositorReport::Instance::log(ml::Logger& logger, SubCompositorId id
         long avg_latency_usec = dn ? dl / dn : 0;
         long dt_msec = dt / 1000L;
 
-        char msg[128];
-        snprintf(msg, sizeof msg, "Display %p averaged %ld.%03ld FPS, "
+        logger.log(component, ml::Severity::informational,
+                 "Display %p averaged %ld.%03ld FPS, "
                  "%ld.%03ld ms/frame, "
                  "latency %ld.%03ld ms, "
                  "%ld frames over %ld.%03ld sec, "
@@ -121,8 +120,6 @@ void mrl::CompositorReport::Instance::log(ml::Logger& logger, SubCompositorId id
                  dt_msec % 1000,
                  bypass_percent
                  );
-
-        logger.log(ml::Severity::informational, msg, component);
     }
 
     last_reported_total_time_sum = total_time_sum;
@@ -158,10 +155,9 @@ void mrl::CompositorReport::finished_frame(SubCompositorId id)
 
     if (inst.bypassed != inst.prev_bypassed || inst.nframes == 1)
     {
-        char msg[128];
-        snprintf(msg, sizeof msg, "Display %p bypass %s",
-                 id, inst.bypassed ? "ON" : "OFF");
-        logger->log(ml::Severity::informational, msg, component);
+        logger->log(component, ml::Severity::informational,
+                    "Display %p bypass %s",
+                    id, inst.bypassed ? "ON" : "OFF");
     }
     inst.prev_bypassed = inst.bypassed;
 }
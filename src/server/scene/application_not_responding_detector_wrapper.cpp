@@ -43,6 +43,11 @@ void ms::ApplicationNotRespondingDetectorWrapper::pong_received(frontend::Sessio
     wrapped->pong_received(received_for);
 }
 
+std::function<void()> ms::ApplicationNotRespondingDetectorWrapper::activity_recorder(frontend::Session const* session)
+{
+    return wrapped->activity_recorder(session);
+}
+
 void ms::ApplicationNotRespondingDetectorWrapper::register_observer(std::shared_ptr<Observer> const& observer)
 {
     wrapped->register_observer(observer);
@@ -76,6 +76,7 @@ public:
     std::shared_ptr<Surface> surface_after(std::shared_ptr<Surface> const&) const override;
 
     void take_snapshot(SnapshotCallback const& snapshot_taken) override;
+    void take_snapshot(geometry::Size const& max_size, SnapshotCallback const& snapshot_taken) override;
     std::shared_ptr<Surface> default_surface() const override;
 
     std::string name() const override;
@@ -123,6 +124,7 @@ private:
     std::shared_ptr<graphics::GraphicBufferAllocator> const gralloc;
 
     frontend::SurfaceId next_id();
+    std::shared_ptr<compositor::BufferStream> default_content_stream();
 
     std::atomic<int> next_surface_id;
 
@@ -18,9 +18,13 @@
 
 #include "gl_pixel_buffer.h"
 #include "mir/graphics/buffer.h"
+#include "mir/graphics/pixel_conversion.h"
+#include "mir/gl/program.h"
 #include "mir/renderer/gl/context.h"
 #include "mir/renderer/gl/texture_source.h"
 
+#include <algorithm>
+#include <cstdint>
 #include <stdexcept>
 #include <boost/throw_exception.hpp>
 #include MIR_SERVER_GL_H
@@ -39,19 +43,67 @@ bool is_big_endian()
     return (*reinterpret_cast<char*>(&n) != 1);
 }
 
-inline uint32_t abgr_to_argb(uint32_t p)
+geom::Size scaled_to_fit(geom::Size const& size, geom::Size const& max_size)
 {
-    return ((p << 16) & 0x00ff0000) | /* Move R to new position */
-           ((p) & 0x0000ff00) |       /* G remains at same position */
-           ((p >> 16) & 0x000000ff) | /* Move B to new position */
-           ((p) & 0xff000000);        /* A remains at same position */
+    int64_t const width = size.width.as_int();
+    int64_t const height = size.height.as_int();
+    int64_t const max_width = max_size.width.as_int() > 0 ? max_size.width.as_int() : width;
+    int64_t const max_height = max_size.height.as_int() > 0 ? max_size.height.as_int() : height;
+
+    if (width <= max_width && height <= max_height)
+        return size;
+
+    /* Whichever dimension is most over its limit determines the scale */
+    if (max_width * height <= max_height * width)
+        return {max_width, std::max<int64_t>(1, height * max_width / width)};
+    else
+        return {std::max<int64_t>(1, width * max_height / height), max_height};
 }
 
+/*
+ * Reading a buffer's texture directly returns its rows bottom to top. The
+ * scaling pass samples upside down so that glReadPixels() returns its
+ * output top to bottom, leaving nothing to flip on the CPU.
+ */
+GLchar const* const scaling_vertex_shader_src =
+{
+    "attribute vec2 position;\n"
+    "varying vec2 v_texcoord;\n"
+    "void main() {\n"
+    "   gl_Position = vec4(position, 0.0, 1.0);\n"
+    "   v_texcoord = vec2(position.x * 0.5 + 0.5, 0.5 - position.y * 0.5);\n"
+    "}\n"
+};
+
+/*
+ * Four bilinear taps a quarter of a destination pixel from its centre
+ * average a 4x4 block of the source: a box filter for 2x reductions, and
+ * much less prone to aliasing than a single tap for larger ones.
+ */
+GLchar const* const scaling_fragment_shader_src =
+{
+    "#ifdef GL_ES\n"
+    "precision mediump float;\n"
+    "#endif\n"
+    "uniform sampler2D tex;\n"
+    "uniform vec2 tap_offset;\n"
+    "varying vec2 v_texcoord;\n"
+    "void main() {\n"
+    "   gl_FragColor = 0.25 * (\n"
+    "       texture2D(tex, v_texcoord + vec2(-tap_offset.x, -tap_offset.y)) +\n"
+    "       texture2D(tex, v_texcoord + vec2( tap_offset.x, -tap_offset.y)) +\n"
+    "       texture2D(tex, v_texcoord + vec2(-tap_offset.x,  tap_offset.y)) +\n"
+    "       texture2D(tex, v_texcoord + vec2( tap_offset.x,  tap_offset.y)));\n"
+    "}\n"
+};
+
+GLfloat const viewport_quad[] = {-1.0f, -1.0f, 1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f};
 }
 
 ms::GLPixelBuffer::GLPixelBuffer(std::unique_ptr<renderer::gl::Context> gl_context)
     : gl_context{std::move(gl_context)},
-      tex{0}, fbo{0}, gl_pixel_format{0}, pixels_need_y_flip{false}
+      tex{0}, fbo{0}, scaled_tex{0},
+      gl_pixel_format{0}, pixels_need_conversion{false}, pixels_need_y_flip{false}
 {
     /*
      * TODO: Handle systems that are big-endian, and therefore GL_BGRA doesn't
@@ -73,8 +125,12 @@ ms::GLPixelBuffer::~GLPixelBuffer() noexcept
     if (tex != 0 || fbo != 0)
         gl_context->make_current();
 
+    scaling_program.reset();
+
     if (tex != 0)
         glDeleteTextures(1, &tex);
+    if (scaled_tex != 0)
+        glDeleteTextures(1, &scaled_tex);
     if (fbo != 0)
         glDeleteFramebuffers(1, &fbo);
 }
@@ -97,10 +153,13 @@ void ms::GLPixelBuffer::prepare()
 
 void ms::GLPixelBuffer::fill_from(graphics::Buffer& buffer)
 {
-    auto width = buffer.size().width.as_uint32_t();
-    auto height = buffer.size().height.as_uint32_t();
+    fill_from(buffer, buffer.size());
+}
 
-    pixels.resize(width * height * 4);
+void ms::GLPixelBuffer::fill_from(graphics::Buffer& buffer, geometry::Size const& max_size)
+{
+    auto const buffer_size = buffer.size();
+    auto const target_size = scaled_to_fit(buffer_size, max_size);
 
     prepare();
 
@@ -111,7 +170,75 @@ void ms::GLPixelBuffer::fill_from(graphics::Buffer& buffer)
         BOOST_THROW_EXCEPTION(std::logic_error("Buffer does not support GL rendering"));
     texture_source->gl_bind_to_texture();
 
-    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, tex, 0);
+    if (target_size == buffer_size)
+    {
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, tex, 0);
+        /* GL rows run bottom to top */
+        pixels_need_y_flip = true;
+    }
+    else
+    {
+        /* The scaling pass leaves the rows top to bottom */
+        downscale_into_fbo(target_size);
+        pixels_need_y_flip = false;
+    }
+
+    read_pixels(target_size);
+    texture_source->rendering_finished();
+
+    size_ = target_size;
+    pixels_need_conversion = true;
+}
+
+void ms::GLPixelBuffer::downscale_into_fbo(geom::Size const& target_size)
+{
+    auto const width = target_size.width.as_int();
+    auto const height = target_size.height.as_int();
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    if (scaled_tex == 0)
+        glGenTextures(1, &scaled_tex);
+
+    glBindTexture(GL_TEXTURE_2D, scaled_tex);
+    if (scaled_tex_size != target_size)
+    {
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        scaled_tex_size = target_size;
+    }
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, scaled_tex, 0);
+    glBindTexture(GL_TEXTURE_2D, tex);
+
+    if (!scaling_program)
+    {
+        scaling_program.reset(
+            new mir::gl::SimpleProgram{scaling_vertex_shader_src, scaling_fragment_shader_src});
+    }
+
+    GLuint const program = *scaling_program;
+    glUseProgram(program);
+    glUniform1i(glGetUniformLocation(program, "tex"), 0);
+    glUniform2f(glGetUniformLocation(program, "tap_offset"), 0.25f / width, 0.25f / height);
+
+    auto const position = glGetAttribLocation(program, "position");
+    glViewport(0, 0, width, height);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glVertexAttribPointer(position, 2, GL_FLOAT, GL_FALSE, 0, viewport_quad);
+    glEnableVertexAttribArray(position);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    glDisableVertexAttribArray(position);
+    glUseProgram(0);
+}
+
+void ms::GLPixelBuffer::read_pixels(geom::Size const& read_size)
+{
+    auto const width = read_size.width.as_uint32_t();
+    auto const height = read_size.height.as_uint32_t();
+
+    pixels.resize(width * height * 4);
 
     /* First try to get pixels as BGRA */
     glGetError();
@@ -124,42 +251,24 @@ void ms::GLPixelBuffer::fill_from(graphics::Buffer& buffer)
         gl_pixel_format = GL_RGBA;
         glReadPixels(0, 0, width, height, gl_pixel_format, GL_UNSIGNED_BYTE, pixels.data());
     }
-
-    size_ = buffer.size();
-    pixels_need_y_flip = true;
 }
 
 void const* ms::GLPixelBuffer::as_argb_8888()
 {
-    if (pixels_need_y_flip)
+    if (pixels_need_conversion)
     {
-        auto const stride_val = stride().as_uint32_t();
-        auto const height = size_.height.as_uint32_t();
-
-        std::vector<char> tmp(stride_val);
+        auto const swap_red_and_blue = gl_pixel_format == GL_RGBA;
 
-        for (unsigned int i = 0; i < height / 2; i++)
+        if (pixels_need_y_flip)
         {
-            /* Store line i */
-            tmp.assign(&pixels[i * stride_val], &pixels[(i + 1) * stride_val]);
-
-            /* Copy line height - i - 1 to line i */
-            copy_and_convert_pixel_line(&pixels[(height - i - 1) * stride_val],
-                                        &pixels[i * stride_val]);
-
-            /* Copy stored line (i) to height - i - 1 */
-            copy_and_convert_pixel_line(tmp.data(),
-                                        &pixels[(height - i - 1) * stride_val]);
+            mg::flip_rows_8888(pixels.data(), size_, stride(), swap_red_and_blue);
         }
-
-        /* Process middle line if there is one */
-        if (height % 2 == 1)
+        else if (swap_red_and_blue)
         {
-            copy_and_convert_pixel_line(&pixels[(height / 2) * stride_val],
-                                        &pixels[(height / 2) * stride_val]);
+            mg::copy_swapping_red_and_blue(pixels.data(), pixels.data(), pixels.size() / 4);
         }
 
-        pixels_need_y_flip = false;
+        pixels_need_conversion = false;
     }
 
     return pixels.data();
@@ -174,21 +283,3 @@ geom::Stride ms::GLPixelBuffer::stride() const
 {
     return geom::Stride{size_.width.as_uint32_t() * sizeof(uint32_t)};
 }
-
-void ms::GLPixelBuffer::copy_and_convert_pixel_line(char* src, char* dst)
-{
-    if (gl_pixel_format == GL_RGBA)
-    {
-        /* Convert from abgr_8888 to argb_8888 while copying */
-        auto pixels_src = reinterpret_cast<uint32_t*>(src);
-        auto pixels_dst = reinterpret_cast<uint32_t*>(dst);
-        auto const width = size_.width.as_uint32_t();
-
-        for (uint32_t n = 0; n < width; n++)
-            pixels_dst[n] = abgr_to_argb(pixels_src[n]);
-    }
-    else if (src != dst)
-    {
-        std::copy(src, src + stride().as_uint32_t(), dst);
-    }
-}
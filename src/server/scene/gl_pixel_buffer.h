@@ -32,6 +32,10 @@ namespace graphics
 {
 class Buffer;
 }
+namespace gl
+{
+class Program;
+}
 namespace renderer
 {
 namespace gl
@@ -42,7 +46,11 @@ class Context;
 
 namespace scene
 {
-/** Extracts the pixels from a graphics::Buffer using GL facilities. */
+/**
+ * Extracts the pixels from a graphics::Buffer using GL facilities.
+ *
+ * Downscaling is done on the GPU, so only the pixels asked for are read back.
+ */
 class GLPixelBuffer : public PixelBuffer
 {
 public:
@@ -50,19 +58,25 @@ public:
     ~GLPixelBuffer() noexcept;
 
     void fill_from(graphics::Buffer& buffer);
+    void fill_from(graphics::Buffer& buffer, geometry::Size const& max_size);
     void const* as_argb_8888();
     geometry::Size size() const;
     geometry::Stride stride() const;
 
 private:
     void prepare();
-    void copy_and_convert_pixel_line(char* src, char* dst);
+    void downscale_into_fbo(geometry::Size const& target_size);
+    void read_pixels(geometry::Size const& read_size);
 
     std::unique_ptr<renderer::gl::Context> const gl_context;
     GLuint tex;
     GLuint fbo;
+    GLuint scaled_tex;
+    geometry::Size scaled_tex_size;
+    std::unique_ptr<gl::Program> scaling_program;
     std::vector<char> pixels;
     GLuint gl_pixel_format;
+    bool pixels_need_conversion;
     bool pixels_need_y_flip;
     geometry::Size size_;
     geometry::Stride stride_;
@@ -75,6 +75,14 @@ void ms::GlobalEventSender::update_buffer(graphics::Buffer&)
 {
 }
 
+void ms::GlobalEventSender::send_buffer_count_hint(mir::frontend::BufferStreamId, int)
+{
+}
+
+void ms::GlobalEventSender::send_present_feedback(mir::frontend::BufferStreamId, mir::frontend::PresentFeedback const&)
+{
+}
+
 void ms::GlobalEventSender::error_buffer(geometry::Size, MirPixelFormat, std::string const&)
 {
 }
@@ -45,6 +45,18 @@ public:
      */
     virtual void fill_from(graphics::Buffer& buffer) = 0;
 
+    /**
+     * Fills the PixelBuffer with the contents of a graphics::Buffer, scaled
+     * down (preserving the aspect ratio) to fit within max_size.
+     *
+     * A zero max_size dimension leaves that dimension unconstrained. Buffers
+     * that already fit are not scaled up.
+     *
+     * \param [in] buffer   the buffer to get the pixels of
+     * \param [in] max_size the largest size the pixels should occupy
+     */
+    virtual void fill_from(graphics::Buffer& buffer, geometry::Size const& max_size) = 0;
+
     /**
      * The pixels in 0xAARRGGBB format.
      *
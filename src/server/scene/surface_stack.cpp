@@ -122,32 +122,49 @@ private:
 ms::SurfaceStack::SurfaceStack(
     std::shared_ptr<SceneReport> const& report) :
     report{report},
+    state{std::make_shared<State>()},
     scene_changed{false}
 {
 }
 
-mc::SceneElementSequence ms::SurfaceStack::scene_elements_for(mc::CompositorID id)
+auto ms::SurfaceStack::current_state() const -> std::shared_ptr<State const>
 {
-    RecursiveReadLock lg(guard);
+    return std::atomic_load(&state);
+}
+
+auto ms::SurfaceStack::copy_of_state() const -> std::shared_ptr<State>
+{
+    return std::make_shared<State>(*state);
+}
 
+void ms::SurfaceStack::publish(std::shared_ptr<State const> const& next)
+{
+    std::atomic_store(&state, next);
+}
+
+mc::SceneElementSequence ms::SurfaceStack::scene_elements_for(mc::CompositorID id)
+{
     scene_changed = false;
+    auto const scene = current_state();
+
     mc::SceneElementSequence elements;
-    for (auto const& surface : surfaces)
+    for (auto const& surface : scene->surfaces)
     {
         if (surface->visible())
         {
+            auto const tracker = scene->rendering_trackers.find(surface.get());
             for (auto& renderable : surface->generate_renderables(id))
             {
                 elements.emplace_back(
                     std::make_shared<SurfaceSceneElement>(
                         surface->name(),
                         renderable,
-                        rendering_trackers[surface.get()],
+                        tracker != scene->rendering_trackers.end() ? tracker->second : nullptr,
                         id));
             }
         }
     }
-    for (auto const& renderable : overlays)
+    for (auto const& renderable : scene->overlays)
     {
         elements.emplace_back(std::make_shared<OverlaySceneElement>(renderable));
     }
@@ -156,15 +173,15 @@ mc::SceneElementSequence ms::SurfaceStack::scene_elements_for(mc::CompositorID i
 
 int ms::SurfaceStack::frames_pending(mc::CompositorID id) const
 {
-    RecursiveReadLock lg(guard);
-
     int result = scene_changed ? 1 : 0;
-    for (auto const& surface : surfaces)
+    auto const scene = current_state();
+
+    for (auto const& surface : scene->surfaces)
     {
         if (surface->visible())
         {
-            auto const tracker = rendering_trackers.find(surface.get());
-            if (tracker != rendering_trackers.end() && tracker->second->is_exposed_in(id))
+            auto const tracker = scene->rendering_trackers.find(surface.get());
+            if (tracker != scene->rendering_trackers.end() && tracker->second->is_exposed_in(id))
             {
                 // Note that we ask the surface and not a Renderable.
                 // This is because we don't want to waste time and resources
@@ -180,18 +197,22 @@ int ms::SurfaceStack::frames_pending(mc::CompositorID id) const
 
 void ms::SurfaceStack::register_compositor(mc::CompositorID cid)
 {
-    RecursiveWriteLock lg(guard);
-
-    registered_compositors.insert(cid);
+    std::lock_guard<decltype(tracker_guard)> tg(tracker_guard);
+    {
+        std::lock_guard<decltype(guard)> lg(guard);
+        registered_compositors.insert(cid);
+    }
 
     update_rendering_tracker_compositors();
 }
 
 void ms::SurfaceStack::unregister_compositor(mc::CompositorID cid)
 {
-    RecursiveWriteLock lg(guard);
-
-    registered_compositors.erase(cid);
+    std::lock_guard<decltype(tracker_guard)> tg(tracker_guard);
+    {
+        std::lock_guard<decltype(guard)> lg(guard);
+        registered_compositors.erase(cid);
+    }
 
     update_rendering_tracker_compositors();
 }
@@ -200,8 +221,10 @@ void ms::SurfaceStack::add_input_visualization(
     std::shared_ptr<mg::Renderable> const& overlay)
 {
     {
-        RecursiveWriteLock lg(guard);
-        overlays.push_back(overlay);
+        std::lock_guard<decltype(guard)> lg(guard);
+        auto const next = copy_of_state();
+        next->overlays.push_back(overlay);
+        publish(next);
     }
     emit_scene_changed();
 }
@@ -211,13 +234,15 @@ void ms::SurfaceStack::remove_input_visualization(
 {
     auto overlay = weak_overlay.lock();
     {
-        RecursiveWriteLock lg(guard);
-        auto const p = std::find(overlays.begin(), overlays.end(), overlay);
-        if (p == overlays.end())
+        std::lock_guard<decltype(guard)> lg(guard);
+        auto const next = copy_of_state();
+        auto const p = std::find(next->overlays.begin(), next->overlays.end(), overlay);
+        if (p == next->overlays.end())
         {
             BOOST_THROW_EXCEPTION(std::runtime_error("Attempt to remove an overlay which was never added or which has been previously removed"));
         }
-        overlays.erase(p);
+        next->overlays.erase(p);
+        publish(next);
     }
     
     emit_scene_changed();
@@ -225,10 +250,7 @@ void ms::SurfaceStack::remove_input_visualization(
 
 void ms::SurfaceStack::emit_scene_changed()
 {
-    {
-        RecursiveWriteLock lg(guard);
-        scene_changed = true;
-    }
+    scene_changed = true;
     observers.scene_changed();
 }
 
@@ -237,9 +259,22 @@ void ms::SurfaceStack::add_surface(
     mi::InputReceptionMode input_mode)
 {
     {
-        RecursiveWriteLock lg(guard);
-        surfaces.push_back(surface);
-        create_rendering_tracker_for(surface);
+        std::lock_guard<decltype(tracker_guard)> tg(tracker_guard);
+        std::set<mc::CompositorID> compositors;
+        {
+            std::lock_guard<decltype(guard)> lg(guard);
+            compositors = registered_compositors;
+        }
+
+        // Set up before publishing, as compositors may report on it from then on
+        auto const tracker = std::make_shared<RenderingTracker>(surface);
+        tracker->active_compositors(compositors);
+
+        std::lock_guard<decltype(guard)> lg(guard);
+        auto const next = copy_of_state();
+        next->surfaces.push_back(surface);
+        next->rendering_trackers[surface.get()] = tracker;
+        publish(next);
     }
     surface->set_reception_mode(input_mode);
     observers.surface_added(surface.get());
@@ -253,14 +288,16 @@ void ms::SurfaceStack::remove_surface(std::weak_ptr<Surface> const& surface)
 
     bool found_surface = false;
     {
-        RecursiveWriteLock lg(guard);
+        std::lock_guard<decltype(guard)> lg(guard);
 
-        auto const surface = std::find(surfaces.begin(), surfaces.end(), keep_alive);
+        auto const next = copy_of_state();
+        auto const surface = std::find(next->surfaces.begin(), next->surfaces.end(), keep_alive);
 
-        if (surface != surfaces.end())
+        if (surface != next->surfaces.end())
         {
-            surfaces.erase(surface);
-            rendering_trackers.erase(keep_alive.get());
+            next->surfaces.erase(surface);
+            next->rendering_trackers.erase(keep_alive.get());
+            publish(next);
             found_surface = true;
         }
     }
@@ -290,8 +327,8 @@ InReverse<Container> in_reverse(Container& container) { return InReverse<Contain
 auto ms::SurfaceStack::surface_at(geometry::Point cursor) const
 -> std::shared_ptr<Surface>
 {
-    RecursiveReadLock lg(guard);
-    for (auto const& surface : in_reverse(surfaces))
+    auto const scene = current_state();
+    for (auto const& surface : in_reverse(scene->surfaces))
     {
         // TODO There's a lack of clarity about how the input area will
         // TODO be maintained and whether this test will detect clicks on
@@ -306,8 +343,8 @@ auto ms::SurfaceStack::surface_at(geometry::Point cursor) const
 
 void ms::SurfaceStack::for_each(std::function<void(std::shared_ptr<mi::Surface> const&)> const& callback)
 {
-    RecursiveReadLock lg(guard);
-    for (auto &surface : surfaces)
+    auto const scene = current_state();
+    for (auto &surface : scene->surfaces)
     {
         callback(surface);
     }
@@ -320,13 +357,15 @@ void ms::SurfaceStack::raise(std::weak_ptr<Surface> const& s)
     {
         auto const surface = s.lock();
 
-        RecursiveWriteLock ul(guard);
-        auto const p = std::find(surfaces.begin(), surfaces.end(), surface);
+        std::lock_guard<decltype(guard)> ul(guard);
+        auto const next = copy_of_state();
+        auto const p = std::find(next->surfaces.begin(), next->surfaces.end(), surface);
 
-        if (p != surfaces.end())
+        if (p != next->surfaces.end())
         {
-            surfaces.erase(p);
-            surfaces.push_back(surface);
+            next->surfaces.erase(p);
+            next->surfaces.push_back(surface);
+            publish(next);
             surfaces_reordered = true;
         }
     }
@@ -342,36 +381,38 @@ void ms::SurfaceStack::raise(SurfaceSet const& ss)
 {
     bool surfaces_reordered{false};
     {
-        RecursiveWriteLock ul(guard);
+        std::lock_guard<decltype(guard)> ul(guard);
 
-        auto const old_surfaces = surfaces;
+        auto const next = copy_of_state();
         std::stable_partition(
-            begin(surfaces), end(surfaces),
+            begin(next->surfaces), end(next->surfaces),
             [&](std::weak_ptr<Surface> const& s) { return !ss.count(s); });
 
-        if (old_surfaces != surfaces)
+        if (next->surfaces != state->surfaces)
+        {
+            publish(next);
             surfaces_reordered = true;
+        }
     }
 
     if (surfaces_reordered)
         observers.surfaces_reordered();
 }
 
-void ms::SurfaceStack::create_rendering_tracker_for(std::shared_ptr<Surface> const& surface)
-{
-    auto const tracker = std::make_shared<RenderingTracker>(surface);
-
-    RecursiveWriteLock ul(guard);
-    tracker->active_compositors(registered_compositors);
-    rendering_trackers[surface.get()] = tracker;
-}
-
 void ms::SurfaceStack::update_rendering_tracker_compositors()
 {
-    RecursiveReadLock ul(guard);
+    std::set<mc::CompositorID> compositors;
+    std::vector<std::shared_ptr<RenderingTracker>> trackers;
+    {
+        std::lock_guard<decltype(guard)> lg(guard);
+        compositors = registered_compositors;
+        for (auto const& pair : state->rendering_trackers)
+            trackers.push_back(pair.second);
+    }
 
-    for (auto const& pair : rendering_trackers)
-        pair.second->active_compositors(registered_compositors);
+    // The trackers are shared between states, so there is nothing to publish
+    for (auto const& tracker : trackers)
+        tracker->active_compositors(compositors);
 }
 
 void ms::SurfaceStack::add_observer(std::shared_ptr<ms::Observer> const& observer)
@@ -379,8 +420,8 @@ void ms::SurfaceStack::add_observer(std::shared_ptr<ms::Observer> const& observe
     observers.add(observer);
 
     // Notify observer of existing surfaces
-    RecursiveReadLock lk(guard);
-    for (auto &surface : surfaces)
+    auto const scene = current_state();
+    for (auto &surface : scene->surfaces)
     {
         observer->surface_exists(surface.get());
     }
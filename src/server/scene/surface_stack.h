@@ -24,7 +24,6 @@
 #include "mir/compositor/scene.h"
 #include "mir/scene/observer.h"
 #include "mir/input/scene.h"
-#include "mir/recursive_read_write_mutex.h"
 
 #include "mir/basic_observers.h"
 
@@ -104,18 +103,40 @@ public:
 private:
     SurfaceStack(const SurfaceStack&) = delete;
     SurfaceStack& operator=(const SurfaceStack&) = delete;
-    void create_rendering_tracker_for(std::shared_ptr<Surface> const&);
+
+    // The stacking order, as published to readers. A State is never modified
+    // once published: writers copy it, change the copy and publish that, and
+    // each old State is freed when its last reader drops it. Readers don't
+    // wait for writers, but this is not lock-free: std::atomic_load() of a
+    // shared_ptr takes one of libstdc++'s internal mutexes for the copy, and
+    // each read increments the State's reference count.
+    struct State
+    {
+        std::vector<std::shared_ptr<Surface>> surfaces;
+        std::map<Surface*,std::shared_ptr<RenderingTracker>> rendering_trackers;
+        std::vector<std::shared_ptr<graphics::Renderable>> overlays;
+    };
+
+    std::shared_ptr<State const> current_state() const;
+    // Requires guard to be held
+    std::shared_ptr<State> copy_of_state() const;
+    void publish(std::shared_ptr<State const> const& next);
+
+    // Requires tracker_guard to be held
     void update_rendering_tracker_compositors();
 
-    RecursiveReadWriteMutex mutable guard;
+    // Serializes writers only; readers never take it. Observers are never
+    // called with it held, as they may call back into the stack
+    std::mutex mutable guard;
+    // Keeps the compositors given to the rendering trackers in step with
+    // registered_compositors. Telling a tracker can change the visibility of
+    // its surface, and so call observers that add surfaces; hence recursive
+    std::recursive_mutex tracker_guard;
 
     std::shared_ptr<SceneReport> const report;
 
-    std::vector<std::shared_ptr<Surface>> surfaces;
-    std::map<Surface*,std::shared_ptr<RenderingTracker>> rendering_trackers;
+    std::shared_ptr<State const> state;
     std::set<compositor::CompositorID> registered_compositors;
-    
-    std::vector<std::shared_ptr<graphics::Renderable>> overlays;
 
     Observers observers;
     std::atomic<bool> scene_changed;
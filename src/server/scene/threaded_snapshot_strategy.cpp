@@ -20,6 +20,7 @@
 #include "pixel_buffer.h"
 #include "mir/compositor/buffer_stream.h"
 #include "mir/thread_name.h"
+#include "mir/optional_value.h"
 
 #include <deque>
 #include <mutex>
@@ -36,6 +37,7 @@ namespace scene
 struct WorkItem
 {
     std::shared_ptr<compositor::BufferStream> const stream;
+    mir::optional_value<geom::Size> const max_size;
     ms::SnapshotCallback const snapshot_taken;
 };
 
@@ -73,8 +75,11 @@ public:
 
     void take_snapshot(WorkItem const& wi)
     {
-        wi.stream->with_most_recent_buffer_do([this](mir::graphics::Buffer& buffer) {
-            pixels->fill_from(buffer);
+        wi.stream->with_most_recent_buffer_do([this, &wi](mir::graphics::Buffer& buffer) {
+            if (wi.max_size.is_set())
+                pixels->fill_from(buffer, wi.max_size.value());
+            else
+                pixels->fill_from(buffer);
         });
 
         wi.snapshot_taken(
@@ -126,5 +131,13 @@ void ms::ThreadedSnapshotStrategy::take_snapshot_of(
     std::shared_ptr<compositor::BufferStream> const& surface_buffer_access,
     SnapshotCallback const& snapshot_taken)
 {
-    functor->schedule_snapshot(WorkItem{surface_buffer_access, snapshot_taken});
+    functor->schedule_snapshot(WorkItem{surface_buffer_access, {}, snapshot_taken});
+}
+
+void ms::ThreadedSnapshotStrategy::take_snapshot_of(
+    std::shared_ptr<compositor::BufferStream> const& surface_buffer_access,
+    geometry::Size const& max_size,
+    SnapshotCallback const& snapshot_taken)
+{
+    functor->schedule_snapshot(WorkItem{surface_buffer_access, max_size, snapshot_taken});
 }
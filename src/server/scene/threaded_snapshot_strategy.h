@@ -41,6 +41,10 @@ public:
     void take_snapshot_of(
         std::shared_ptr<compositor::BufferStream> const& surface_buffer_access,
         SnapshotCallback const& snapshot_taken);
+    void take_snapshot_of(
+        std::shared_ptr<compositor::BufferStream> const& surface_buffer_access,
+        geometry::Size const& max_size,
+        SnapshotCallback const& snapshot_taken);
 
 private:
     std::shared_ptr<PixelBuffer> const pixels;
@@ -22,21 +22,37 @@
 
 #include "mir/time/alarm_factory.h"
 
+#include <algorithm>
+#include <atomic>
+
 namespace ms = mir::scene;
 namespace mt = mir::time;
 
 struct ms::TimeoutApplicationNotRespondingDetector::ANRContext
 {
-    ANRContext(std::function<void()> const& pinger)
-        : pinger{pinger},
-          replied_since_last_ping{true},
-          flagged_as_unresponsive{false}
+    ANRContext(Session const* session, std::function<void()> const& pinger)
+        : session{session},
+          pinger{pinger},
+          pinged{false},
+          heard_from{false},
+          flagged_as_unresponsive{false},
+          filed{false}
     {
     }
 
+    Session const* const session;
     std::function<void()> const pinger;
-    bool replied_since_last_ping;
-    bool flagged_as_unresponsive;
+    bool pinged;
+
+    // Set without session_mutex by activity recorders, and so read and
+    // written with sequentially consistent atomics (see handle_ping_cycle())
+    std::atomic<bool> heard_from;
+    std::atomic<bool> flagged_as_unresponsive;
+
+    // Where on the wheel the session is, if it's on the wheel
+    bool filed;
+    std::uint64_t due;
+    Slot::iterator position;
 };
 
 void ms::TimeoutApplicationNotRespondingDetector::ANRObservers::session_unresponsive(
@@ -66,11 +82,23 @@ ms::TimeoutApplicationNotRespondingDetector::~TimeoutApplicationNotRespondingDet
 void ms::TimeoutApplicationNotRespondingDetector::register_session(
     frontend::Session const* session, std::function<void()> const& pinger)
 {
-    bool alarm_needs_schedule;
+    bool alarm_needs_schedule{false};
     {
         std::lock_guard<std::mutex> lock{session_mutex};
-        sessions[dynamic_cast<Session const*>(session)] = std::make_unique<ANRContext>(pinger);
-        alarm_needs_schedule = alarm->state() != mt::Alarm::State::pending;
+        auto const scene_session = dynamic_cast<Session const*>(session);
+        auto& session_ctx = sessions[scene_session];
+        if (session_ctx)
+        {
+            unfile_locked(*session_ctx);
+        }
+        session_ctx = std::make_shared<ANRContext>(scene_session, pinger);
+
+        if (!wheel_turning)
+        {
+            wheel_turning = true;
+            alarm_needs_schedule = true;
+        }
+        file_locked(*session_ctx, current_turn + 1);
     }
     if (alarm_needs_schedule)
     {
@@ -82,37 +110,115 @@ void ms::TimeoutApplicationNotRespondingDetector::unregister_session(
     frontend::Session const* session)
 {
     std::lock_guard<std::mutex> lock{session_mutex};
-    sessions.erase(dynamic_cast<Session const*>(session));
+    auto const i = sessions.find(dynamic_cast<Session const*>(session));
+    if (i != sessions.end())
+    {
+        unfile_locked(*i->second);
+        sessions.erase(i);
+    }
 }
 
 void ms::TimeoutApplicationNotRespondingDetector::pong_received(
    frontend::Session const* received_for)
+{
+    heard_from(received_for);
+}
+
+std::function<void()> ms::TimeoutApplicationNotRespondingDetector::activity_recorder(
+   frontend::Session const* session)
+{
+    std::lock_guard<std::mutex> lock{session_mutex};
+    auto const i = sessions.find(dynamic_cast<Session const*>(session));
+    if (i == sessions.end())
+        return {};
+
+    // This is called for every message a client sends, so rather than take
+    // session_mutex it just leaves a note for the next turn of the wheel.
+    // (If the session is unregistered meanwhile the note goes unread.)
+    auto const session_ctx = i->second;
+    return [this, session_ctx]
+        {
+            session_ctx->heard_from = true;
+
+            // ...unless the session is off the wheel and observers need telling now
+            if (session_ctx->flagged_as_unresponsive)
+                heard_from(session_ctx->session);
+        };
+}
+
+void ms::TimeoutApplicationNotRespondingDetector::heard_from(frontend::Session const* session)
 {
     bool needs_now_responsive_notification{false};
-    bool alarm_needs_rescheduling;
+    bool alarm_needs_schedule{false};
     {
         std::lock_guard<std::mutex> lock{session_mutex};
 
-        auto& session_ctx = sessions.at(dynamic_cast<Session const*>(received_for));
-        if (session_ctx->flagged_as_unresponsive)
+        auto const i = sessions.find(dynamic_cast<Session const*>(session));
+        if (i == sessions.end())
+            return;
+
+        auto& session_ctx = *i->second;
+        if (session_ctx.flagged_as_unresponsive)
         {
-            session_ctx->flagged_as_unresponsive = false;
+            session_ctx.flagged_as_unresponsive = false;
             needs_now_responsive_notification = true;
         }
-        session_ctx->replied_since_last_ping = true;
 
-        alarm_needs_rescheduling = alarm->state() != mt::Alarm::State::pending;
+        // A reply restarts the ping cycle. Anything else means we needn't ping
+        // until the session has been quiet for the whole of the coming period.
+        // (Activity doesn't get here unless it is a reply.)
+        bool const replied = session_ctx.pinged || needs_now_responsive_notification;
+        session_ctx.pinged = false;
+
+        if (!wheel_turning)
+        {
+            // The period starts now, rather than part way through a turn
+            wheel_turning = true;
+            alarm_needs_schedule = true;
+            file_locked(session_ctx, current_turn + 1);
+        }
+        else
+        {
+            file_locked(session_ctx, current_turn + (replied ? 1 : 2));
+        }
     }
     if (needs_now_responsive_notification)
     {
-        observers.session_now_responsive(dynamic_cast<Session const*>(received_for));
+        observers.session_now_responsive(dynamic_cast<Session const*>(session));
     }
-    if (alarm_needs_rescheduling)
+    if (alarm_needs_schedule)
     {
         alarm->reschedule_in(period);
     }
 }
 
+void ms::TimeoutApplicationNotRespondingDetector::file_locked(ANRContext& session_ctx, std::uint64_t turn)
+{
+    if (session_ctx.filed && session_ctx.due == turn)
+        return;
+
+    auto& slot = wheel[turn % wheel_slots];
+    if (session_ctx.filed)
+    {
+        slot.splice(slot.end(), wheel[session_ctx.due % wheel_slots], session_ctx.position);
+    }
+    else
+    {
+        session_ctx.position = slot.insert(slot.end(), &session_ctx);
+        session_ctx.filed = true;
+    }
+    session_ctx.due = turn;
+}
+
+void ms::TimeoutApplicationNotRespondingDetector::unfile_locked(ANRContext& session_ctx)
+{
+    if (session_ctx.filed)
+    {
+        wheel[session_ctx.due % wheel_slots].erase(session_ctx.position);
+        session_ctx.filed = false;
+    }
+}
+
 void ms::TimeoutApplicationNotRespondingDetector::register_observer(
     std::shared_ptr<Observer> const& observer)
 {
@@ -147,29 +253,65 @@ void ms::TimeoutApplicationNotRespondingDetector::handle_ping_cycle()
     bool needs_rearm{false};
     {
         std::lock_guard<std::mutex> lock{session_mutex};
-        for (auto const& session_pair : sessions)
-        {
-            bool const newly_unresponsive =
-                !session_pair.second->replied_since_last_ping &&
-                !session_pair.second->flagged_as_unresponsive;
-            bool const needs_ping =
-                session_pair.second->replied_since_last_ping;
+        auto& slot = wheel[++current_turn % wheel_slots];
+        auto& next_slot = wheel[(current_turn + 1) % wheel_slots];
 
-            if (newly_unresponsive)
+        auto const keep_watching = [&](ANRContext& session_ctx)
             {
-                session_pair.second->flagged_as_unresponsive = true;
-                unresponsive_sessions_temporary.push_back(session_pair.first);
+                // Look again once the session has been quiet for a whole period
+                session_ctx.pinged = false;
+                next_slot.splice(next_slot.end(), slot, slot.begin());
+                session_ctx.due = current_turn + 1;
+            };
+
+        // No pongs have been received from these sessions since they were filed
+        // here, but there may have been other activity
+        while (!slot.empty())
+        {
+            auto& session_ctx = *slot.front();
+            if (session_ctx.heard_from.exchange(false))
+            {
+                keep_watching(session_ctx);
             }
-            else if (needs_ping)
+            else if (session_ctx.pinged)
             {
-                session_pair.second->pinger();
-                session_pair.second->replied_since_last_ping = false;
-                needs_rearm = true;
+                // Activity recorders note activity before checking this flag,
+                // and we set the flag before checking for activity again, so one
+                // or the other of us sees that the session is responsive.
+                session_ctx.flagged_as_unresponsive = true;
+                if (session_ctx.heard_from.exchange(false))
+                {
+                    session_ctx.flagged_as_unresponsive = false;
+                    keep_watching(session_ctx);
+                    continue;
+                }
+
+                // Unresponsive sessions stay off the wheel until we hear from them
+                unresponsive_sessions_temporary.push_back(session_ctx.session);
+                slot.pop_front();
+                session_ctx.filed = false;
+            }
+            else
+            {
+                pings_temporary.push_back(session_ctx.pinger);
+                session_ctx.pinged = true;
+                next_slot.splice(next_slot.end(), slot, slot.begin());
+                session_ctx.due = current_turn + 1;
             }
         }
+
+        wheel_turning = std::any_of(wheel.begin(), wheel.end(), [](Slot const& s) { return !s.empty(); });
+        needs_rearm = wheel_turning;
+    }
+
+    // Ping and dispatch notifications outside the lock.
+    for (auto const& pinger : pings_temporary)
+    {
+        pinger();
     }
 
-    // Dispatch notifications outside the lock.
+    pings_temporary.clear();
+
     for (auto const& unresponsive_session : unresponsive_sessions_temporary)
     {
         observers.session_unresponsive(unresponsive_session);
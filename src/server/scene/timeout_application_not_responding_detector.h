@@ -22,9 +22,15 @@
 #include "mir/scene/application_not_responding_detector.h"
 #include "mir/basic_observers.h"
 
+#include <array>
 #include <chrono>
-#include <unordered_map>
+#include <cstdint>
 #include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
 namespace mir
 {
@@ -36,6 +42,16 @@ class AlarmFactory;
 
 namespace scene
 {
+/**
+ * Pings sessions that have been quiet for a whole period, and flags those
+ * that then stay quiet for another period as unresponsive.
+ *
+ * Sessions are kept on a timer wheel, turned once a period, in the slot for
+ * the turn at which they next need attention; only the sessions in that
+ * slot are looked at on each turn. Other traffic from a session just sets a
+ * flag that the turn reads, so sessions that are busy talking to the server
+ * are never pinged, and their messages never wait for the wheel's lock.
+ */
 class TimeoutApplicationNotRespondingDetector : public ApplicationNotRespondingDetector
 {
 public:
@@ -60,6 +76,7 @@ public:
     void unregister_session(frontend::Session const* session) override;
 
     void pong_received(frontend::Session const* received_for) override;
+    std::function<void()> activity_recorder(frontend::Session const* session) override;
 
     void register_observer(std::shared_ptr<Observer> const& observer) override;
     void unregister_observer(std::shared_ptr<Observer> const& observer) override;
@@ -67,6 +84,13 @@ private:
     void handle_ping_cycle();
 
     struct ANRContext;
+    using Slot = std::list<ANRContext*>;
+
+    using Sessions = std::unordered_map<Session const*, std::shared_ptr<ANRContext>>;
+
+    void heard_from(frontend::Session const* session);
+    void file_locked(ANRContext& session_ctx, std::uint64_t turn);
+    void unfile_locked(ANRContext& session_ctx);
 
     class ANRObservers : public Observer, private BasicObservers<Observer>
     {
@@ -79,8 +103,15 @@ private:
     } observers;
 
     std::mutex session_mutex;
-    std::unordered_map<Session const*, std::unique_ptr<ANRContext>> sessions;
+    Sessions sessions;
     std::vector<Session const*> unresponsive_sessions_temporary;
+    std::vector<std::function<void()>> pings_temporary;
+
+    // Sessions are never filed more than two turns ahead
+    static std::size_t const wheel_slots{3};
+    std::array<Slot, wheel_slots> wheel;
+    std::uint64_t current_turn{0};
+    bool wheel_turning{false};
 
     std::chrono::milliseconds const period;
     std::unique_ptr<time::Alarm> const alarm;
@@ -22,6 +22,8 @@
 #include "mir/scene/surface.h"
 #include "mir/scene/surface_creation_parameters.h"
 
+#include <vector>
+
 namespace msh = mir::shell;
 
 msh::BasicWindowManager::BasicWindowManager(
@@ -291,18 +293,20 @@ auto msh::BasicWindowManager::active_display()
 
 void msh::BasicWindowManager::raise_tree(std::shared_ptr<scene::Surface> const& root)
 {
-    SurfaceSet surfaces;
-    std::function<void(std::weak_ptr<scene::Surface> const& surface)> const add_children =
-        [&,this](std::weak_ptr<scene::Surface> const& surface)
-            {
-            auto const& info = info_for(surface);
-            surfaces.insert(begin(info.children), end(info.children));
-            for (auto const& child : info.children)
-                add_children(child);
-            };
-
-    surfaces.insert(root);
-    add_children(root);
+    SurfaceSet surfaces{root};
+    std::vector<std::weak_ptr<scene::Surface>> pending{root};
+
+    while (!pending.empty())
+    {
+        auto const& info = info_for(pending.back());
+        pending.pop_back();
+
+        for (auto const& child : info.children)
+        {
+            if (surfaces.insert(child).second)
+                pending.push_back(child);
+        }
+    }
 
     focus_controller->raise(surfaces);
 }
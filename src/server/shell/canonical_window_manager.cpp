@@ -28,7 +28,9 @@
 #include <linux/input.h>
 #include <csignal>
 
+#include <algorithm>
 #include <climits>
+#include <map>
 
 namespace msh = mir::shell;
 namespace ms = mir::scene;
@@ -38,6 +40,51 @@ namespace
 {
 int const title_bar_height = 10;
 
+using SurfaceList = std::vector<std::weak_ptr<ms::Surface>>;
+using SurfacePositions = std::map<std::weak_ptr<ms::Surface>, SurfaceList::size_type,
+    std::owner_less<std::weak_ptr<ms::Surface>>>;
+
+// Compares ownership rather than locking, so works even when the surface
+// has already been destroyed
+bool same_surface(std::weak_ptr<ms::Surface> const& a, std::weak_ptr<ms::Surface> const& b)
+{
+    return !a.owner_before(b) && !b.owner_before(a);
+}
+
+void append_surface(SurfaceList& surfaces, SurfacePositions& positions, std::weak_ptr<ms::Surface> const& surface)
+{
+    positions[surface] = surfaces.size();
+    surfaces.push_back(surface);
+}
+
+// Moves the last entry into the gap, so removal needn't search or shift the list
+void erase_surface(SurfaceList& surfaces, SurfacePositions& positions, std::weak_ptr<ms::Surface> const& surface)
+{
+    auto const position = positions.find(surface);
+    if (position == positions.end())
+        return;
+
+    auto i = position->second;
+    positions.erase(position);
+
+    // Should the list have been changed behind our back, fall back to searching it
+    if (i >= surfaces.size() || !same_surface(surfaces[i], surface))
+    {
+        i = std::find_if(begin(surfaces), end(surfaces),
+            [&](std::weak_ptr<ms::Surface> const& entry) { return same_surface(entry, surface); }) - begin(surfaces);
+
+        if (i == surfaces.size())
+            return;
+    }
+
+    if (i + 1 != surfaces.size())
+    {
+        surfaces[i] = std::move(surfaces.back());
+        positions[surfaces[i]] = i;
+    }
+    surfaces.pop_back();
+}
+
 // TODO this really should belong on CanonicalSurfaceInfo
 // but is currently used when placing the surface before construction.
 // Which implies we need some rework so that we can construct metadata
@@ -277,10 +324,10 @@ void msh::CanonicalWindowManagerPolicy::handle_new_surface(std::shared_ptr<ms::S
     auto& surface_info = tools->info_for(surface);
     if (auto const parent = surface_info.parent.lock())
     {
-        tools->info_for(parent).children.push_back(surface);
+        append_surface(tools->info_for(parent).children, position_among_siblings, surface);
     }
 
-    tools->info_for(session).surfaces.push_back(surface);
+    append_surface(tools->info_for(session).surfaces, position_in_session, surface);
 
     if (surface_info.can_be_active())
     {
@@ -358,6 +405,18 @@ void msh::CanonicalWindowManagerPolicy::handle_modify_surface(
 
     std::swap(surface_info, surface_info_old);
 
+    // surface_info now holds what was there before: move to the new parent's children
+    if (!same_surface(surface_info.parent, surface_info_old.parent))
+    {
+        if (auto const parent = surface_info.parent.lock())
+            erase_surface(tools->info_for(parent).children, position_among_siblings, surface);
+        else
+            position_among_siblings.erase(surface);
+
+        if (auto const parent = surface_info_old.parent.lock())
+            append_surface(tools->info_for(parent).children, position_among_siblings, surface);
+    }
+
     if (modifications.name.is_set())
         surface->rename(modifications.name.value());
 
@@ -424,31 +483,14 @@ void msh::CanonicalWindowManagerPolicy::handle_delete_surface(std::shared_ptr<ms
     auto& info = tools->info_for(surface);
 
     if (auto const parent = info.parent.lock())
-    {
-        auto& siblings = tools->info_for(parent).children;
-
-        for (auto i = begin(siblings); i != end(siblings); ++i)
-        {
-            if (surface.lock() == i->lock())
-            {
-                siblings.erase(i);
-                break;
-            }
-        }
-    }
+        erase_surface(tools->info_for(parent).children, position_among_siblings, surface);
+    else
+        position_among_siblings.erase(surface);
 
     session->destroy_surface(surface);
 
     auto& surfaces = tools->info_for(session).surfaces;
-
-    for (auto i = begin(surfaces); i != end(surfaces); ++i)
-    {
-        if (surface.lock() == i->lock())
-        {
-            surfaces.erase(i);
-            break;
-        }
-    }
+    erase_surface(surfaces, position_in_session, surface);
 
     if (is_active_surface)
     {
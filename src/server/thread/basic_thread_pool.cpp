@@ -21,7 +21,9 @@
 
 #include <deque>
 #include <algorithm>
+#include <chrono>
 #include <condition_variable>
+#include <iterator>
 
 namespace mt = mir::thread;
 
@@ -31,7 +33,10 @@ namespace
 class Task
 {
 public:
-    Task(std::function<void()> const& task) : task{task} {}
+    Task(std::function<void()> const& task, std::promise<void>&& promise)
+        : task{task}, promise{std::move(promise)}
+    {
+    }
 
     void execute()
     {
@@ -53,11 +58,6 @@ public:
             promise.set_value();
     }
 
-    std::future<void> get_future()
-    {
-        return promise.get_future();
-    }
-
 private:
     std::function<void()> const task;
     std::promise<void> promise;
@@ -67,7 +67,9 @@ private:
 class Worker
 {
 public:
-    Worker() : exiting{false}
+    Worker(std::function<void()> const& task_done)
+        : task_done{task_done},
+          exiting{false}
     {
     }
 
@@ -92,6 +94,12 @@ public:
                lock.lock();
                tasks.pop_front();
                task.notify_done();
+
+               // The pool may have tasks waiting on this one, and may
+               // queue them here, so it's told without our lock held
+               lock.unlock();
+               task_done();
+               lock.lock();
            }
        }
     }
@@ -121,6 +129,7 @@ public:
     }
 
 private:
+    std::function<void()> const task_done;
     std::deque<Task> tasks;
     bool exiting;
     std::mutex mutable state_mutex;
@@ -136,8 +145,9 @@ namespace thread
 class WorkerThread
 {
 public:
-    WorkerThread(mt::BasicThreadPool::TaskId an_id)
-        : thread{std::ref(worker)},
+    WorkerThread(mt::BasicThreadPool::TaskId an_id, std::function<void()> const& task_done)
+        : worker{task_done},
+          thread{std::ref(worker)},
           id_{an_id}
     {}
 
@@ -151,7 +161,13 @@ public:
     void queue_task(Task task, mt::BasicThreadPool::TaskId the_id)
     {
         worker.queue_task(std::move(task));
-        id_ = the_id;
+        if (the_id)
+            id_ = the_id;
+    }
+
+    void forget_id()
+    {
+        id_ = nullptr;
     }
 
     bool is_idle() const
@@ -177,7 +193,16 @@ mt::BasicThreadPool::BasicThreadPool(int min_threads)
 {
 }
 
-mt::BasicThreadPool::~BasicThreadPool() = default;
+mt::BasicThreadPool::~BasicThreadPool()
+{
+    {
+        std::lock_guard<decltype(mutex)> lock{mutex};
+        held_tasks.clear();
+    }
+
+    // Not under the lock: workers take it to look for held tasks as they finish
+    threads.clear();
+}
 
 std::future<void> mt::BasicThreadPool::run(std::function<void()> const& task)
 {
@@ -196,41 +221,132 @@ std::future<void> mt::BasicThreadPool::run(std::function<void()> const& task, Ta
 
 std::future<void> mt::BasicThreadPool::run(WorkerThread* worker_thread,
                                            std::function<void()> const& task, TaskId id)
+{
+    std::promise<void> done;
+    auto future = done.get_future();
+    queue(worker_thread, task, std::move(done), id);
+    return future;
+}
+
+void mt::BasicThreadPool::queue(
+    WorkerThread* worker_thread, std::function<void()> const& task, std::promise<void>&& done, TaskId id)
 {
     // No pre-selected thread to execute task, find an idle thread
     if (worker_thread == nullptr)
-        worker_thread = find_idle_thread();
+        worker_thread = find_idle_thread(id);
 
     if (worker_thread == nullptr)
     {
         // No idle threads available so create a new one
-        auto new_worker_thread = std::make_unique<WorkerThread>(id);
-        threads.push_back(std::move(new_worker_thread));
+        threads.push_back(std::make_unique<WorkerThread>(id, [this]{ task_done(); }));
         worker_thread = threads.back().get();
     }
 
-    Task a_task{task};
-    auto future = a_task.get_future();
-    worker_thread->queue_task(std::move(a_task), id);
-    return future;
+    worker_thread->queue_task(Task{task, std::move(done)}, id);
 }
 
+std::future<void> mt::BasicThreadPool::run_after(
+    std::vector<std::shared_future<void>> const& dependencies,
+    std::function<void()> const& task)
+{
+    TaskId const generic_id = nullptr;
+    return run_after(dependencies, task, generic_id);
+}
 
-void mt::BasicThreadPool::shrink()
+std::future<void> mt::BasicThreadPool::run_after(
+    std::vector<std::shared_future<void>> const& dependencies,
+    std::function<void()> const& task,
+    TaskId id)
+{
+    std::lock_guard<decltype(mutex)> lock{mutex};
+
+    held_tasks.push_back({dependencies, task, id, {}});
+    auto future = held_tasks.back().done.get_future();
+    release_held_tasks_locked();
+    return future;
+}
+
+void mt::BasicThreadPool::task_done()
 {
     std::lock_guard<decltype(mutex)> lock{mutex};
+    release_held_tasks_locked();
+}
+
+void mt::BasicThreadPool::release_held_tasks_locked()
+{
+    auto const ready = [](std::shared_future<void> const& dependency)
+        {
+            return dependency.wait_for(std::chrono::seconds::zero()) == std::future_status::ready;
+        };
 
-    int max_threads_to_remove = threads.size() - min_threads;
-    auto it = std::remove_if(threads.begin(), threads.end(),
-        [&max_threads_to_remove](std::unique_ptr<WorkerThread> const& worker_thread)
+    // Failing a task readies its future at once, which may release more
+    bool failed_any;
+    do
+    {
+        failed_any = false;
+        for (auto held = held_tasks.begin(); held != held_tasks.end();)
         {
-            bool remove = worker_thread->is_idle() && max_threads_to_remove > 0;
-            if (remove)
-                max_threads_to_remove--;
-            return remove;
+            if (!std::all_of(held->dependencies.begin(), held->dependencies.end(), ready))
+            {
+                ++held;
+                continue;
+            }
+
+            std::exception_ptr failure;
+            for (auto const& dependency : held->dependencies)
+            {
+                try
+                {
+                    dependency.get();
+                }
+                catch (...)
+                {
+                    failure = std::current_exception();
+                    break;
+                }
+            }
+
+            if (failure)
+            {
+                held->done.set_exception(failure);
+                failed_any = true;
+            }
+            else
+            {
+                queue(held->id ? find_thread_by(held->id) : nullptr, held->task, std::move(held->done), held->id);
+            }
+
+            held = held_tasks.erase(held);
         }
-    );
-    threads.erase(it, threads.end());
+    }
+    while (failed_any);
+}
+
+
+void mt::BasicThreadPool::shrink()
+{
+    std::vector<std::unique_ptr<WorkerThread>> removed;
+    {
+        std::lock_guard<decltype(mutex)> lock{mutex};
+
+        int max_threads_to_remove = threads.size() - min_threads;
+        auto it = std::stable_partition(threads.begin(), threads.end(),
+            [&max_threads_to_remove](std::unique_ptr<WorkerThread> const& worker_thread)
+            {
+                bool const idle = worker_thread->is_idle();
+                bool const remove = idle && max_threads_to_remove > 0;
+                if (remove)
+                    max_threads_to_remove--;
+                else if (idle)
+                    worker_thread->forget_id(); // Free for any id again
+                return !remove;
+            }
+        );
+        std::move(it, threads.end(), std::back_inserter(removed));
+        threads.erase(it, threads.end());
+    }
+
+    // Joined without the lock, which a finishing worker may be waiting for
 }
 
 mt::WorkerThread* mt::BasicThreadPool::find_thread_by(TaskId id)
@@ -245,12 +361,13 @@ mt::WorkerThread* mt::BasicThreadPool::find_thread_by(TaskId id)
     return it == threads.end() ? nullptr : it->get();
 }
 
-mt::WorkerThread *mt::BasicThreadPool::find_idle_thread()
+mt::WorkerThread *mt::BasicThreadPool::find_idle_thread(TaskId id)
 {
+    // A thread serving another id is kept for it
     auto it = std::find_if(threads.begin(), threads.end(),
-        [](std::unique_ptr<WorkerThread> const& worker_thread)
+        [id](std::unique_ptr<WorkerThread> const& worker_thread)
         {
-            return worker_thread->is_idle();
+            return worker_thread->is_idle() && (!id || !worker_thread->current_id());
         }
     );
 
@@ -100,6 +100,7 @@ public:
     MOCK_METHOD2(register_session, void(mir::frontend::Session const*, std::function<void ()> const&));
     MOCK_METHOD1(unregister_session, void(mir::frontend::Session const*));
     MOCK_METHOD1(pong_received, void(mir::frontend::Session const*));
+    MOCK_METHOD1(activity_recorder, std::function<void()>(mir::frontend::Session const*));
 
     MOCK_METHOD1(register_observer, void(std::shared_ptr<Observer> const&));
     MOCK_METHOD1(unregister_observer, void(std::shared_ptr<Observer> const&));
@@ -170,6 +171,8 @@ TEST_F(ApplicationNotRespondingDetection, can_wrap_anr_detector)
                     }));
             ON_CALL(*anr_detector, pong_received(_))
                 .WillByDefault(Invoke([wrapee](auto a) { wrapee->pong_received(a); }));
+            ON_CALL(*anr_detector, activity_recorder(_))
+                .WillByDefault(Invoke([wrapee](auto a) { return wrapee->activity_recorder(a); }));
 
             ON_CALL(*anr_detector, register_observer(_))
                 .WillByDefault(Invoke([wrapee](auto observer) { wrapee->register_observer(observer); }));
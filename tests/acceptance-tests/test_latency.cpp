@@ -255,7 +255,8 @@ struct TimeTrackingDisplay : mtd::NullDisplay
             mir_subpixel_arrangement_unknown,
             {},
             mir_output_gamma_unsupported,
-            {}
+            {},
+            false
         };
         outputs.push_back(output);
     }
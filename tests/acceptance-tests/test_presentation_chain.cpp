@@ -245,10 +245,9 @@ TEST_F(PresentationChain, supported_modes)
         connection, mir_present_mode_fifo));
     EXPECT_TRUE(mir_connection_present_mode_supported(
         connection, mir_present_mode_mailbox));
-    //TODOs: 
-    EXPECT_FALSE(mir_connection_present_mode_supported(
+    EXPECT_TRUE(mir_connection_present_mode_supported(
         connection, mir_present_mode_fifo_relaxed));
-    EXPECT_FALSE(mir_connection_present_mode_supported(
+    EXPECT_TRUE(mir_connection_present_mode_supported(
         connection, mir_present_mode_immediate));
 }
 
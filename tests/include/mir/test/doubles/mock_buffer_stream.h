@@ -69,6 +69,8 @@ struct MockBufferStream : public compositor::BufferStream
     MOCK_METHOD1(resize, void(geometry::Size const&));
     MOCK_METHOD0(force_client_completion, void());
     MOCK_METHOD1(allow_framedropping, void(bool));
+    MOCK_METHOD1(set_present_mode, void(MirPresentMode));
+    MOCK_METHOD1(set_present_feedback, void(bool));
     MOCK_CONST_METHOD0(framedropping, bool());
 
     MOCK_CONST_METHOD1(buffers_ready_for_compositor, int(void const*));
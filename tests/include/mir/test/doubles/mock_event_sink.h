@@ -44,6 +44,8 @@ struct MockEventSink : public frontend::EventSink
     MOCK_METHOD1(add_buffer, void(graphics::Buffer&));
     MOCK_METHOD1(remove_buffer, void(graphics::Buffer&));
     MOCK_METHOD1(update_buffer, void(graphics::Buffer&));
+    MOCK_METHOD2(send_buffer_count_hint, void(frontend::BufferStreamId, int));
+    MOCK_METHOD2(send_present_feedback, void(frontend::BufferStreamId, frontend::PresentFeedback const&));
     MOCK_METHOD3(error_buffer, void(geometry::Size, MirPixelFormat, std::string const&));
     MOCK_METHOD1(handle_input_config_change, void(MirInputConfig const&));
 };
@@ -33,10 +33,26 @@ struct MockGLBuffer : public MockBuffer,
                       public renderer::gl::TextureSource
 {
  public:
-    using MockBuffer::MockBuffer;
+    MockGLBuffer()
+    {
+        using namespace testing;
+        ON_CALL(*this, secure_for_render())
+                .WillByDefault(Return(true));
+    }
+
+    MockGLBuffer(geometry::Size size,
+                 geometry::Stride s,
+                 MirPixelFormat pf)
+        : MockBuffer{size, s, pf}
+    {
+        using namespace testing;
+        ON_CALL(*this, secure_for_render())
+                .WillByDefault(Return(true));
+    }
 
     MOCK_METHOD0(gl_bind_to_texture, void());
-    MOCK_METHOD0(secure_for_render, void());
+    MOCK_METHOD0(secure_for_render, bool());
+    MOCK_METHOD0(rendering_finished, void());
     MOCK_METHOD0(bind, void());
 };
 
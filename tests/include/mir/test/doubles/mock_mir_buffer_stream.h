@@ -54,6 +54,9 @@ struct MockMirBufferStream : public MirBufferStream
     MOCK_CONST_METHOD0(valid, bool(void));
     MOCK_METHOD1(buffer_available, void(mir::protobuf::Buffer const&));
     MOCK_METHOD0(buffer_unavailable, void());
+    MOCK_METHOD1(set_buffer_count_hint, void(int));
+    MOCK_METHOD2(set_present_feedback_callback, void(MirPresentFeedbackCallback, void*));
+    MOCK_METHOD1(present_feedback, void(mir::protobuf::PresentFeedback const&));
     MOCK_METHOD1(set_size, void(geometry::Size));
     MOCK_CONST_METHOD0(size, geometry::Size());
     MOCK_METHOD1(set_scale, MirWaitHandle*(float));
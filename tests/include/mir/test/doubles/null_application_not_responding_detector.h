@@ -39,6 +39,10 @@ public:
     void pong_received(frontend::Session const*) override
     {
     }
+    std::function<void()> activity_recorder(frontend::Session const*) override
+    {
+        return {};
+    }
     void register_observer(std::shared_ptr<Observer> const&) override
     {
     }
@@ -46,6 +46,8 @@ struct NullEventSink : public frontend::EventSink
     void add_buffer(graphics::Buffer&) override {}
     void remove_buffer(graphics::Buffer&) override {}
     void update_buffer(graphics::Buffer&) override {}
+    void send_buffer_count_hint(frontend::BufferStreamId, int) override {}
+    void send_present_feedback(frontend::BufferStreamId, frontend::PresentFeedback const&) override {}
     void error_buffer(geometry::Size, MirPixelFormat, std::string const&) override {}
 };
 
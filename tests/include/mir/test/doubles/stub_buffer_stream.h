@@ -59,6 +59,12 @@ public:
     void allow_framedropping(bool) override
     {
     }
+    void set_present_mode(MirPresentMode) override
+    {
+    }
+    void set_present_feedback(bool) override
+    {
+    }
     bool framedropping() const override
     {
         return false;
@@ -49,6 +49,12 @@ struct StubClientBuffers : frontend::ClientBuffers
     void receive_buffer(graphics::BufferID) override
     {
     }
+    void send_buffer_count_hint(frontend::BufferStreamId, int) override
+    {
+    }
+    void send_present_feedback(frontend::BufferStreamId, frontend::PresentFeedback const&) override
+    {
+    }
     std::shared_ptr<graphics::Buffer> buffer;
 };
 
@@ -30,6 +30,7 @@ namespace doubles
 struct StubDisplayServer : public mir::frontend::detail::DisplayServer
 {
     void client_pid(int /*pid*/) override {}
+    void client_activity() override {}
     void connect(
         mir::protobuf::ConnectParameters const* /*request*/,
         mir::protobuf::Connection* /*response*/,
@@ -39,7 +39,8 @@ public:
 
     void gl_bind_to_texture() {}
     void bind() {}
-    void secure_for_render() {}
+    bool secure_for_render() { return true; }
+    void rendering_finished() {}
     void bind_for_write() {}
 };
 
@@ -79,7 +79,8 @@ public:
     }
 
     void bind() override { gl_bind_to_texture(); }
-    void secure_for_render() override {}
+    bool secure_for_render() override { return true; }
+    void rendering_finished() override {}
 
 private:
     std::thread::id creation_thread_id;
@@ -214,6 +214,8 @@ struct StubEventSink : public mf::EventSink
         ipc->client_bound_transfer(request);
     }
     void error_buffer(geom::Size, MirPixelFormat, std::string const&) {}
+    void send_buffer_count_hint(mf::BufferStreamId, int) {}
+    void send_present_feedback(mf::BufferStreamId, mf::PresentFeedback const&) {}
     void handle_event(MirEvent const&) {}
     void handle_lifecycle_event(MirLifecycleState) {}
     void handle_display_config_change(mg::DisplayConfiguration const&) {}
@@ -155,6 +155,14 @@ struct StubStreamFactory : public msc::BufferStreamFactory
             {
             }
 
+            void send_buffer_count_hint(mf::BufferStreamId, int) override
+            {
+            }
+
+            void send_present_feedback(mf::BufferStreamId, mf::PresentFeedback const&) override
+            {
+            }
+
             std::shared_ptr<mg::Buffer> b;
             std::shared_ptr<mf::BufferSink> const sink;
             std::shared_ptr<mtd::StubBufferAllocator> alloc{std::make_shared<mtd::StubBufferAllocator>()};
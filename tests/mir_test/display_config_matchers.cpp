@@ -75,7 +75,8 @@ public:
                 mir_subpixel_arrangement_unknown,
                 {},
                 mir_output_gamma_unsupported,
-                {}
+                {},
+                false
             };
 
             /* Modes */
@@ -134,7 +135,8 @@ public:
                 mir_subpixel_arrangement_unknown,
                 {},
                 mir_output_gamma_unsupported,
-                {}
+                {},
+                false
             };
 
             /* Modes */
@@ -192,7 +194,8 @@ public:
                     mir_subpixel_arrangement_unknown,
                     {},
                     mir_output_gamma_unsupported,
-                    {}
+                    {},
+                    false
                 };
 
             /* Modes */
@@ -44,6 +44,8 @@ public:
     void add_buffer(mir::graphics::Buffer&) override;
     void remove_buffer(mir::graphics::Buffer&) override;
     void update_buffer(mir::graphics::Buffer&) override;
+    void send_buffer_count_hint(mf::BufferStreamId id, int buffer_count) override;
+    void send_present_feedback(mf::BufferStreamId id, mf::PresentFeedback const& feedback) override;
     void error_buffer(mir::geometry::Size, MirPixelFormat, std::string const&) override;
 
 private:
@@ -116,6 +118,16 @@ void GloballyUniqueMockEventSink::update_buffer(mir::graphics::Buffer& buffer)
     underlying_sink->update_buffer(buffer);
 }
 
+void GloballyUniqueMockEventSink::send_buffer_count_hint(mf::BufferStreamId id, int buffer_count)
+{
+    underlying_sink->send_buffer_count_hint(id, buffer_count);
+}
+
+void GloballyUniqueMockEventSink::send_present_feedback(mf::BufferStreamId id, mf::PresentFeedback const& feedback)
+{
+    underlying_sink->send_present_feedback(id, feedback);
+}
+
 void GloballyUniqueMockEventSink::handle_error(mir::ClientVisibleError const& error)
 {
     underlying_sink->handle_error(error);
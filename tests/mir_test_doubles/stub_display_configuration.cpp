@@ -93,7 +93,8 @@ mtd::StubDisplayConfigurationOutput::StubDisplayConfigurationOutput(
             subpixel_arrangement,
             {},
             mir_output_gamma_unsupported,
-            {}
+            {},
+            false
         }
 {
 }
@@ -122,7 +123,8 @@ mtd::StubDisplayConfigurationOutput::StubDisplayConfigurationOutput(
         mir_subpixel_arrangement_unknown,
         {},
         mir_output_gamma_unsupported,
-        {}
+        {},
+        false
     }
 {
     if (modes.empty())
@@ -225,7 +227,8 @@ mtd::StubDisplayConfig::StubDisplayConfig(unsigned int num_displays, std::vector
             mir_subpixel_arrangement_unknown,
             {},
             mir_output_gamma_unsupported,
-            {}
+            {},
+            false
         };
 
         outputs.push_back(output);
@@ -252,7 +255,8 @@ mtd::StubDisplayConfig::StubDisplayConfig(std::vector<geometry::Rectangle> const
                 mir_subpixel_arrangement_unknown,
                 {},
                 mir_output_gamma_unsupported,
-                {}
+                {},
+                false
             };
 
         outputs.push_back(output);
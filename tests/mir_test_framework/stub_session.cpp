@@ -47,6 +47,12 @@ void mtd::StubSession::take_snapshot(
 {
 }
 
+void mtd::StubSession::take_snapshot(
+    mir::geometry::Size const& /*max_size*/,
+    mir::scene::SnapshotCallback const& /*snapshot_taken*/)
+{
+}
+
 std::shared_ptr<mir::scene::Surface> mtd::StubSession::default_surface() const
 {
     return {};
@@ -21,6 +21,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <unistd.h>
+#include <poll.h>
 #include <string>
 #include <thread>
 
@@ -164,8 +165,18 @@ void SystemPerformanceTest::set_up_with(std::string const server_args)
 
 void SystemPerformanceTest::TearDown()
 {
-    kill_nicely(server_pid);
-    fclose(server_output);
+    stop_server();
+}
+
+void SystemPerformanceTest::stop_server()
+{
+    if (server_pid > 0)
+        kill_nicely(server_pid);
+    server_pid = 0;
+
+    if (server_output)
+        fclose(server_output);
+    server_output = nullptr;
 }
 
 void SystemPerformanceTest::spawn_clients(std::initializer_list<std::string> clients)
@@ -188,4 +199,41 @@ void SystemPerformanceTest::run_server_for(std::chrono::seconds timeout)
     killer.detach();
 }
 
+bool SystemPerformanceTest::wait_for_output(std::string const& text, std::chrono::seconds timeout)
+{
+    using namespace std::chrono;
+
+    // Read the descriptor directly: poll() can't see what stdio has buffered
+    auto const fd = fileno(server_output);
+    auto const deadline = steady_clock::now() + timeout;
+    std::string output;
+    char buffer[256];
+
+    while (true)
+    {
+        auto const remaining = duration_cast<milliseconds>(deadline - steady_clock::now());
+        if (remaining <= 0ms)
+            return false;
+
+        pollfd readable{fd, POLLIN, 0};
+        auto const ready = poll(&readable, 1, remaining.count());
+        if (ready < 0 && errno == EINTR)
+            continue;
+        if (ready <= 0)
+            return false;
+
+        auto const got = read(fd, buffer, sizeof buffer);
+        if (got <= 0)
+            return false;
+
+        output.append(buffer, got);
+        if (output.find(text) != std::string::npos)
+            return true;
+
+        // Only the tail could be the start of a match
+        if (output.size() > text.size())
+            output.erase(0, output.size() - text.size());
+    }
+}
+
 } } // namespace mir::test
@@ -32,10 +32,13 @@ protected:
     SystemPerformanceTest();
     void set_up_with(std::string const server_args);
     void TearDown() override;
+    void stop_server();
     void spawn_clients(std::initializer_list<std::string> clients);
     void run_server_for(std::chrono::seconds timeout);
+    // Reads server_output until text appears; false if it doesn't in time
+    bool wait_for_output(std::string const& text, std::chrono::seconds timeout);
 
-    FILE* server_output;
+    FILE* server_output = nullptr;
 private:
     std::string const bin_dir;
     pid_t server_pid = 0;
@@ -23,6 +23,7 @@
 #include <gtest/gtest.h>
 
 #include <chrono>
+#include <iostream>
 
 namespace mtf = mir_test_framework;
 
@@ -119,3 +120,54 @@ TEST_F(ClientStartupPerformance, create_surface_and_swap)
     mir_connection_release(conn);
 }
 
+
+TEST_F(ClientStartupPerformance, connect)
+{
+    int const connections = 20;
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (int i = 0; i != connections; ++i)
+    {
+        // Connecting selects and loads the client platform module, so this
+        // measures the cost of module probing.
+        mir_connection_release(create_connection());
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    auto mean = std::chrono::duration_cast<std::chrono::microseconds>(end-start) / connections;
+
+    // Connection time depends too much on the machine for a fixed limit;
+    // this is reported for comparison between runs
+    std::cout << "Mean time to connect: " << mean.count() << "us" << std::endl;
+}
+
+TEST_F(ClientStartupPerformance, time_to_first_frame)
+{
+    using namespace std::chrono;
+
+    auto const start = steady_clock::now();
+    auto conn = create_connection();
+    auto const connected = steady_clock::now();
+    auto window = make_surface(conn);
+    auto const window_created = steady_clock::now();
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+    auto stream  = mir_window_get_buffer_stream(window);
+#pragma GCC diagnostic pop
+    // The first swap waits for the initial buffers, so this reflects how
+    // much of their allocation overlapped window creation.
+    mir_buffer_stream_swap_buffers_sync(stream);
+    auto const first_frame = steady_clock::now();
+
+    // This depends too much on the machine for a fixed limit; it is
+    // recorded (in the XML output) for comparison between runs
+    auto const in_us = [](steady_clock::duration d) { return static_cast<int>(duration_cast<microseconds>(d).count()); };
+    RecordProperty("time_to_first_frame_us", in_us(first_frame - start));
+    RecordProperty("connect_us", in_us(connected - start));
+    RecordProperty("create_window_us", in_us(window_created - connected));
+    RecordProperty("first_swap_us", in_us(first_frame - window_created));
+
+    mir_window_release_sync(window);
+    mir_connection_release(conn);
+}
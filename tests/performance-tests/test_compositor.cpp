@@ -18,6 +18,13 @@
 
 #include "system_performance_test.h"
 
+#include <boost/filesystem.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <system_error>
+
 using namespace std::literals::chrono_literals;
 using namespace mir::test;
 
@@ -51,6 +58,45 @@ struct CompositorPerformance : SystemPerformanceTest
 
     float compositor_fps, compositor_render_time;
 };
+
+struct CompositorStartup : SystemPerformanceTest
+{
+    CompositorStartup()
+    {
+        char tmp_name[] = "/tmp/mir_gl_program_cache_XXXXXX";
+        if (mkdtemp(tmp_name) == NULL)
+        {
+            throw std::system_error{errno, std::system_category(), "Failed to create temporary directory"};
+        }
+        program_cache = tmp_name;
+    }
+
+    ~CompositorStartup()
+    {
+        boost::system::error_code ignored;
+        boost::filesystem::remove_all(program_cache, ignored);
+    }
+
+    // From spawning the server to its first composited frame, which the
+    // compositor report marks with the initial bypass state
+    std::chrono::milliseconds time_to_first_frame()
+    {
+        auto const start = std::chrono::steady_clock::now();
+        set_up_with("--compositor-report=log --gl-program-cache=" + program_cache);
+
+        std::chrono::milliseconds result{-1};
+        if (wait_for_output(" bypass ", 10s))
+        {
+            result = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - start);
+        }
+
+        stop_server();
+        return result;
+    }
+
+    std::string program_cache;
+};
 } // anonymous namespace
 
 TEST_F(CompositorPerformance, regression_test_1563287)
@@ -67,3 +113,15 @@ TEST_F(CompositorPerformance, regression_test_1563287)
     EXPECT_GE(compositor_fps, 58.0f);
     EXPECT_LT(compositor_render_time, 17.0f);
 }
+
+TEST_F(CompositorStartup, time_to_first_frame_with_cached_gl_programs)
+{
+    auto const cold = time_to_first_frame();
+    auto const warm = time_to_first_frame();
+
+    ASSERT_GE(cold.count(), 0) << "no frame composited with an empty program cache";
+    ASSERT_GE(warm.count(), 0) << "no frame composited with a populated program cache";
+
+    RecordProperty("cold_ms", cold.count());
+    RecordProperty("warm_ms", warm.count());
+}
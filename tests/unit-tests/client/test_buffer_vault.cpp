@@ -156,6 +156,29 @@ TEST_F(BufferVault, creates_all_buffers_on_start)
     make_vault();
 }
 
+TEST_F(BufferVault, only_requests_buffers_the_server_has_not_preallocated)
+{
+    unsigned int const preallocated_nbuffers{2};
+    EXPECT_CALL(mock_requests, allocate_buffer(size, format, usage))
+        .Times(initial_nbuffers - preallocated_nbuffers);
+
+    mcl::BufferVault vault{
+        mt::fake_shared(mock_platform_factory), mt::fake_shared(buffer_factory),
+        mt::fake_shared(mock_requests), surface_map,
+        size, format, usage, initial_nbuffers, preallocated_nbuffers};
+}
+
+TEST_F(BufferVault, makes_no_requests_on_start_if_all_buffers_are_preallocated)
+{
+    EXPECT_CALL(mock_requests, allocate_buffer(_,_,_))
+        .Times(0);
+
+    mcl::BufferVault vault{
+        mt::fake_shared(mock_platform_factory), mt::fake_shared(buffer_factory),
+        mt::fake_shared(mock_requests), surface_map,
+        size, format, usage, initial_nbuffers, initial_nbuffers};
+}
+
 TEST_F(BufferVault, frees_the_buffers_we_actually_got)
 {
     EXPECT_CALL(mock_requests, free_buffer(package.buffer_id()));
@@ -477,6 +500,63 @@ TEST_F(StartedBufferVault, can_decrease_allocation_count)
     Mock::VerifyAndClearExpectations(&mock_requests);
 }
 
+TEST_F(StartedBufferVault, frees_idle_buffers_when_hinted_to_use_fewer)
+{
+    EXPECT_CALL(mock_requests, free_buffer(_))
+        .Times(1);
+    vault.set_buffer_count_hint(2);
+    Mock::VerifyAndClearExpectations(&mock_requests);
+}
+
+TEST_F(StartedBufferVault, keeps_at_least_two_buffers_whatever_the_hint)
+{
+    EXPECT_CALL(mock_requests, free_buffer(_))
+        .Times(1);
+    vault.set_buffer_count_hint(1);
+    Mock::VerifyAndClearExpectations(&mock_requests);
+}
+
+TEST_F(StartedBufferVault, ignores_hints_to_use_more_buffers_than_initially_requested)
+{
+    EXPECT_CALL(mock_requests, allocate_buffer(_,_,_))
+        .Times(0);
+    vault.set_buffer_count_hint(5);
+
+    auto f1 = vault.withdraw();
+    auto f2 = vault.withdraw();
+    auto f3 = vault.withdraw();
+    auto f4 = vault.withdraw();
+    Mock::VerifyAndClearExpectations(&mock_requests);
+}
+
+TEST_F(StartedBufferVault, allocates_lazily_when_hint_is_withdrawn)
+{
+    vault.set_buffer_count_hint(2);
+
+    EXPECT_CALL(mock_requests, allocate_buffer(_,_,_))
+        .Times(0);
+    vault.set_buffer_count_hint(0);
+    auto f1 = vault.withdraw();
+    auto f2 = vault.withdraw();
+    Mock::VerifyAndClearExpectations(&mock_requests);
+
+    EXPECT_CALL(mock_requests, allocate_buffer(_,_,_))
+        .Times(1);
+    auto f3 = vault.withdraw();
+    Mock::VerifyAndClearExpectations(&mock_requests);
+}
+
+TEST_F(StartedBufferVault, hint_still_applies_when_interval_changes)
+{
+    vault.set_buffer_count_hint(2);
+    vault.set_interval(0);
+
+    EXPECT_CALL(mock_requests, free_buffer(_))
+        .Times(1);
+    vault.set_interval(1);
+    Mock::VerifyAndClearExpectations(&mock_requests);
+}
+
 TEST_F(StartedBufferVault, delayed_decrease_allocation_count)
 {
     mp::Buffer requested_buffer;
@@ -143,3 +143,23 @@ TEST_F(PresentationChain, double_interval_configure_is_ok)
         chain.set_queueing_mode();
     });
 }
+
+MATCHER_P(PresentModeIs, mode, "")
+{
+    return arg->has_present_mode() && arg->present_mode() == mode;
+}
+
+TEST_F(PresentationChain, sends_present_mode_once_per_change)
+{
+    mcl::PresentationChain chain(
+        connection, rpc_id, mock_server,
+        std::make_shared<mtd::StubClientBufferFactory>(),
+        std::make_shared<mcl::BufferFactory>());
+
+    EXPECT_CALL(mock_server, configure_buffer_stream(PresentModeIs(mir_present_mode_fifo_relaxed),_,_));
+    EXPECT_CALL(mock_server, configure_buffer_stream(PresentModeIs(mir_present_mode_immediate),_,_));
+
+    chain.set_present_mode(mir_present_mode_fifo_relaxed);
+    chain.set_present_mode(mir_present_mode_fifo_relaxed);
+    chain.set_present_mode(mir_present_mode_immediate);
+}
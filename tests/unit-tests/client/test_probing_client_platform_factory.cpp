@@ -21,9 +21,12 @@
 #include "src/server/report/null_report_factory.h"
 
 #include "mir/test/doubles/mock_client_context.h"
+#include "mir/test/doubles/mock_shared_library_prober_report.h"
 #include "mir_test_framework/executable_path.h"
 #include "mir_test_framework/stub_platform_helpers.h"
 
+#include <boost/filesystem.hpp>
+
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include <dlfcn.h>
@@ -265,6 +268,34 @@ TEST(ProbingClientPlatformFactory, DoesNotLeakUnusedDriverModulesOnStartup)
     ASSERT_EQ(0, nloaded);
 }
 
+#if defined(MIR_BUILD_PLATFORM_MESA_KMS)
+TEST(ProbingClientPlatformFactory, LoadsOnlyTheModuleNamedByTheServer)
+#else
+TEST(ProbingClientPlatformFactory, DISABLED_LoadsOnlyTheModuleNamedByTheServer)
+#endif
+{
+    using namespace testing;
+
+    auto const& fixture = all_available_fixtures().at("mesa-kms");
+    boost::filesystem::path const client_module{fixture.client_module_filename};
+
+    auto const report = std::make_shared<NiceMock<mtd::MockSharedLibraryProberReport>>();
+    EXPECT_CALL(*report, probing_path(_)).Times(0);
+    EXPECT_CALL(*report, loading_library(_)).Times(0);
+    EXPECT_CALL(*report, loading_library(client_module)).Times(1);
+
+    mir::client::ProbingClientPlatformFactory factory(
+        report,
+        {},
+        {client_module.parent_path().string()}, nullptr);
+
+    NiceMock<mtd::MockClientContext> context;
+    fixture.setup_context(context);
+
+    auto platform = factory.create_client_platform(&context);
+    EXPECT_EQ(mir_platform_type_gbm, platform->platform_type());
+}
+
 #if defined(MIR_BUILD_PLATFORM_MESA_KMS)
 TEST(ProbingClientPlatformFactory, CreatesMesaPlatformOnMesaKMS)
 #else
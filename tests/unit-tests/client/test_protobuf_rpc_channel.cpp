@@ -840,3 +840,68 @@ TEST_F(MirProtobufRpcChannelTest, sends_incoming_buffer_to_stream_if_stream_id_p
                   std::make_shared<mtd::NullClientEventSink>()};
     channel.on_data_available();
 }
+
+TEST_F(MirProtobufRpcChannelTest, passes_buffer_count_hint_to_stream)
+{
+    using namespace testing;
+    int stream_id = 331;
+    int buffer_count = 2;
+    auto stream_map = std::make_shared<MockSurfaceMap>();
+    auto mock_stream = std::make_shared<NiceMock<mtd::MockMirBufferStream>>();
+    EXPECT_CALL(*stream_map, stream(mir::frontend::BufferStreamId{stream_id}))
+        .WillOnce(Return(mock_stream));
+    EXPECT_CALL(*mock_stream, set_buffer_count_hint(buffer_count));
+
+    auto transport = std::make_unique<NiceMock<MockStreamTransport>>();
+    mir::protobuf::EventSequence seq;
+    auto hint = seq.mutable_buffer_stream_hint();
+    hint->mutable_id()->set_value(stream_id);
+    hint->set_buffer_count(buffer_count);
+    set_async_buffer_message(seq, *transport);
+
+    mclr::MirProtobufRpcChannel channel{
+                  std::move(transport),
+                  stream_map,
+                  std::make_shared<MockBufferFactory>(),
+                  std::make_shared<mcl::DisplayConfiguration>(),
+                  std::make_shared<mir::input::InputDevices>(stream_map),
+                  std::make_shared<mclr::NullRpcReport>(),
+                  lifecycle,
+                  std::make_shared<mir::client::PingHandler>(),
+                  std::make_shared<mir::client::ErrorHandler>(),
+                  std::make_shared<mtd::NullClientEventSink>()};
+    channel.on_data_available();
+}
+
+TEST_F(MirProtobufRpcChannelTest, passes_present_feedback_to_stream)
+{
+    using namespace testing;
+    int stream_id = 331;
+    uint64_t frame = 17;
+    auto stream_map = std::make_shared<MockSurfaceMap>();
+    auto mock_stream = std::make_shared<NiceMock<mtd::MockMirBufferStream>>();
+    EXPECT_CALL(*stream_map, stream(mir::frontend::BufferStreamId{stream_id}))
+        .WillOnce(Return(mock_stream));
+    EXPECT_CALL(*mock_stream, present_feedback(Property(&mir::protobuf::PresentFeedback::frame, frame)));
+
+    auto transport = std::make_unique<NiceMock<MockStreamTransport>>();
+    mir::protobuf::EventSequence seq;
+    auto feedback = seq.mutable_present_feedback();
+    feedback->mutable_id()->set_value(stream_id);
+    feedback->set_frame(frame);
+    feedback->set_result(mir_present_result_composited);
+    set_async_buffer_message(seq, *transport);
+
+    mclr::MirProtobufRpcChannel channel{
+                  std::move(transport),
+                  stream_map,
+                  std::make_shared<MockBufferFactory>(),
+                  std::make_shared<mcl::DisplayConfiguration>(),
+                  std::make_shared<mir::input::InputDevices>(stream_map),
+                  std::make_shared<mclr::NullRpcReport>(),
+                  lifecycle,
+                  std::make_shared<mir::client::PingHandler>(),
+                  std::make_shared<mir::client::ErrorHandler>(),
+                  std::make_shared<mtd::NullClientEventSink>()};
+    channel.on_data_available();
+}
@@ -0,0 +1,120 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/compositor/buffer_count_advisor.h"
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+using namespace testing;
+namespace mc = mir::compositor;
+
+namespace
+{
+struct BufferCountAdvisor : Test
+{
+    unsigned int const idle_compositions{4};
+    unsigned int const dropped_frames{2};
+    unsigned int const replaced_frames{3};
+    mc::BufferCountAdvisor advisor{idle_compositions, dropped_frames, replaced_frames};
+    mir::optional_value<int> const no_change{};
+    mir::optional_value<int> const reduced{mc::BufferCountAdvisor::reduced_buffer_count};
+    mir::optional_value<int> const client_choice{mc::BufferCountAdvisor::client_buffer_count};
+    int const first_output{0}, second_output{0};
+    mc::CompositorID const compositor{&first_output};
+};
+}
+
+TEST_F(BufferCountAdvisor, makes_no_suggestion_while_frames_are_being_composited)
+{
+    for (auto i = 0; i < 10; i++)
+    {
+        EXPECT_THAT(advisor.frame_submitted(), Eq(no_change));
+        EXPECT_THAT(advisor.frame_composited(compositor), Eq(no_change));
+    }
+}
+
+TEST_F(BufferCountAdvisor, reduces_count_once_stream_has_been_idle_for_a_while)
+{
+    advisor.frame_submitted();
+    advisor.frame_composited(compositor);
+
+    for (auto i = 1u; i < idle_compositions; i++)
+        EXPECT_THAT(advisor.frame_composited(compositor), Eq(no_change));
+    EXPECT_THAT(advisor.frame_composited(compositor), Eq(reduced));
+    EXPECT_THAT(advisor.frame_composited(compositor), Eq(no_change));
+}
+
+TEST_F(BufferCountAdvisor, counts_one_idle_composition_per_cycle_of_compositors)
+{
+    advisor.frame_submitted();
+    advisor.frame_composited(&first_output);
+    advisor.frame_composited(&second_output);
+
+    for (auto i = 1u; i < idle_compositions; i++)
+    {
+        EXPECT_THAT(advisor.frame_composited(&first_output), Eq(no_change));
+        EXPECT_THAT(advisor.frame_composited(&second_output), Eq(no_change));
+    }
+    EXPECT_THAT(advisor.frame_composited(&first_output), Eq(reduced));
+}
+
+TEST_F(BufferCountAdvisor, reduces_count_when_frames_keep_being_dropped_unseen)
+{
+    advisor.frame_submitted();
+    for (auto i = 1u; i < dropped_frames; i++)
+        EXPECT_THAT(advisor.frame_dropped(), Eq(no_change));
+    EXPECT_THAT(advisor.frame_dropped(), Eq(reduced));
+}
+
+TEST_F(BufferCountAdvisor, reduces_count_when_frames_keep_being_replaced_unseen)
+{
+    for (auto i = 1u; i < replaced_frames; i++)
+        EXPECT_THAT(advisor.frame_replaced(), Eq(no_change));
+    EXPECT_THAT(advisor.frame_replaced(), Eq(reduced));
+}
+
+TEST_F(BufferCountAdvisor, composition_resets_the_count_of_unseen_frames)
+{
+    for (auto i = 1u; i < replaced_frames; i++)
+        advisor.frame_replaced();
+    advisor.frame_composited(compositor);
+    EXPECT_THAT(advisor.frame_replaced(), Eq(no_change));
+
+    for (auto i = 1u; i < dropped_frames; i++)
+        advisor.frame_dropped();
+    advisor.frame_composited(compositor);
+    EXPECT_THAT(advisor.frame_dropped(), Eq(no_change));
+}
+
+TEST_F(BufferCountAdvisor, returns_choice_to_client_when_new_frames_are_composited_again)
+{
+    for (auto i = 0u; i < dropped_frames; i++)
+        advisor.frame_dropped();
+
+    EXPECT_THAT(advisor.frame_submitted(), Eq(no_change));
+    EXPECT_THAT(advisor.frame_composited(compositor), Eq(client_choice));
+    EXPECT_THAT(advisor.frame_submitted(), Eq(no_change));
+    EXPECT_THAT(advisor.frame_composited(compositor), Eq(no_change));
+}
+
+TEST_F(BufferCountAdvisor, does_not_repeat_a_reduction)
+{
+    for (auto i = 0u; i < dropped_frames; i++)
+        advisor.frame_dropped();
+
+    for (auto i = 0u; i < replaced_frames; i++)
+        EXPECT_THAT(advisor.frame_replaced(), Eq(no_change));
+}
@@ -17,6 +17,7 @@
  */
 
 #include "src/server/compositor/default_display_buffer_compositor.h"
+#include "mir/graphics/partial_overlay.h"
 #include "mir/compositor/display_buffer_compositor.h"
 #include "mir/compositor/decoration.h"
 #include "src/server/report/null_report_factory.h"
@@ -335,6 +336,34 @@ TEST_F(DefaultDisplayBufferCompositor, occluded_surfaces_are_not_rendered)
     }));
 }
 
+namespace
+{
+struct MockPartiallyOverlayingDisplayBuffer : mtd::MockDisplayBuffer, mg::PartialOverlay
+{
+    MOCK_METHOD1(overlay_top, mg::RenderableList(mg::RenderableList const&));
+};
+}
+
+TEST_F(DefaultDisplayBufferCompositor, renders_only_what_display_cannot_overlay)
+{
+    using namespace testing;
+    NiceMock<MockPartiallyOverlayingDisplayBuffer> partial_display_buffer;
+    ON_CALL(partial_display_buffer, view_area())
+        .WillByDefault(Return(screen));
+    ON_CALL(partial_display_buffer, overlay(_))
+        .WillByDefault(Return(false));
+
+    EXPECT_CALL(partial_display_buffer, overlay_top(ElementsAre(big, small)))
+        .WillOnce(Return(mg::RenderableList{big}));
+    EXPECT_CALL(mock_renderer, render(ElementsAre(big)));
+
+    mc::DefaultDisplayBufferCompositor compositor(
+        partial_display_buffer,
+        mt::fake_shared(mock_renderer),
+        mr::null_compositor_report());
+    compositor.composite(make_scene_elements({big, small}));
+}
+
 namespace
 {
 struct MockSceneElement : mc::SceneElement
@@ -395,3 +424,22 @@ TEST_F(DefaultDisplayBufferCompositor, marks_occluded_scene_elements)
     compositor.composite({element0_occluded, element1_rendered, element2_occluded});
 }
 
+
+TEST_F(DefaultDisplayBufferCompositor, does_not_wait_for_flip_when_nobody_wants_feedback)
+{
+    using namespace testing;
+
+    mc::DefaultDisplayBufferCompositor compositor(
+        display_buffer,
+        mt::fake_shared(mock_renderer),
+        mr::null_compositor_report());
+
+    compositor.composite(make_scene_elements({big, small}));
+
+    bool asked_for_flip{false};
+    compositor.frame_posted(
+        [&]{ asked_for_flip = true; return mir::graphics::Frame{}; },
+        std::chrono::milliseconds{16});
+
+    EXPECT_FALSE(asked_for_flip);
+}
@@ -38,6 +38,8 @@ struct MockBufferMap : mf::ClientBuffers
     MOCK_METHOD1(remove_buffer, void(mg::BufferID id));
     MOCK_METHOD1(send_buffer, void(mg::BufferID id));
     MOCK_METHOD1(receive_buffer, void(mg::BufferID id));
+    MOCK_METHOD2(send_buffer_count_hint, void(mf::BufferStreamId, int));
+    MOCK_METHOD2(send_present_feedback, void(mf::BufferStreamId, mf::PresentFeedback const&));
     MOCK_CONST_METHOD0(client_owned_buffer_count, size_t());
     MOCK_CONST_METHOD1(get, std::shared_ptr<mg::Buffer>(mg::BufferID));
 };
@@ -0,0 +1,152 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/frontend/client_buffers.h"
+#include "src/server/compositor/fifo_relaxed_schedule.h"
+#include "mir/test/doubles/stub_buffer.h"
+#include "mir/test/fake_shared.h"
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+using namespace testing;
+namespace mtd = mir::test::doubles;
+namespace mt = mir::test;
+namespace mg = mir::graphics;
+namespace mc = mir::compositor;
+namespace mf = mir::frontend;
+namespace
+{
+
+struct MockBufferMap : mf::ClientBuffers
+{
+    MOCK_METHOD1(add_buffer, mg::BufferID(std::shared_ptr<mg::Buffer> const&));
+    MOCK_METHOD1(remove_buffer, void(mg::BufferID id));
+    MOCK_METHOD1(send_buffer, void(mg::BufferID id));
+    MOCK_METHOD1(receive_buffer, void(mg::BufferID id));
+    MOCK_METHOD2(send_buffer_count_hint, void(mf::BufferStreamId, int));
+    MOCK_METHOD2(send_present_feedback, void(mf::BufferStreamId, mf::PresentFeedback const&));
+    MOCK_CONST_METHOD0(client_owned_buffer_count, size_t());
+    MOCK_CONST_METHOD1(get, std::shared_ptr<mg::Buffer>(mg::BufferID));
+};
+
+struct FifoRelaxedSchedule : Test
+{
+    FifoRelaxedSchedule()
+    {
+        for(auto i = 0u; i < num_buffers; i++)
+            buffers.emplace_back(std::make_shared<mtd::StubBuffer>());
+    }
+    unsigned int const num_buffers{5};
+    std::vector<std::shared_ptr<mg::Buffer>> buffers;
+
+    MockBufferMap mock_client_buffers;
+    mc::FifoRelaxedSchedule schedule{mt::fake_shared(mock_client_buffers)};
+    std::vector<std::shared_ptr<mg::Buffer>> drain_queue()
+    {
+        std::vector<std::shared_ptr<mg::Buffer>> scheduled_buffers;
+        while(schedule.num_scheduled())
+            scheduled_buffers.emplace_back(schedule.next_buffer());
+        return scheduled_buffers;
+    }
+};
+}
+
+TEST_F(FifoRelaxedSchedule, throws_if_no_buffers)
+{
+    EXPECT_FALSE(schedule.num_scheduled());
+    EXPECT_THROW({
+        schedule.next_buffer();
+    }, std::logic_error);
+}
+
+TEST_F(FifoRelaxedSchedule, queues_every_buffer_while_on_time)
+{
+    EXPECT_CALL(mock_client_buffers, send_buffer(_)).Times(0);
+
+    for(auto i = 0u; i < num_buffers; i++)
+        schedule.schedule(buffers[i]);
+
+    EXPECT_THAT(drain_queue(), ContainerEq(buffers));
+}
+
+TEST_F(FifoRelaxedSchedule, queueing_same_buffer_moves_it_to_the_back)
+{
+    schedule.schedule(buffers[0]);
+    schedule.schedule(buffers[1]);
+    schedule.schedule(buffers[0]);
+
+    auto queue = drain_queue();
+    ASSERT_THAT(queue, SizeIs(2));
+    EXPECT_THAT(queue[0], Eq(buffers[1]));
+    EXPECT_THAT(queue[1], Eq(buffers[0]));
+}
+
+TEST_F(FifoRelaxedSchedule, buffer_submitted_late_is_queued)
+{
+    EXPECT_CALL(mock_client_buffers, send_buffer(_)).Times(0);
+
+    schedule.frame_missed();
+    schedule.schedule(buffers[0]);
+
+    auto queue = drain_queue();
+    ASSERT_THAT(queue, SizeIs(1));
+    EXPECT_THAT(queue[0], Eq(buffers[0]));
+}
+
+TEST_F(FifoRelaxedSchedule, replaces_waiting_buffers_once_a_frame_is_missed)
+{
+    InSequence seq;
+    EXPECT_CALL(mock_client_buffers, send_buffer(buffers[0]->id()));
+    EXPECT_CALL(mock_client_buffers, send_buffer(buffers[1]->id()));
+    EXPECT_CALL(mock_client_buffers, send_buffer(buffers[2]->id()));
+
+    schedule.schedule(buffers[0]);
+    schedule.frame_missed();
+    schedule.schedule(buffers[1]);
+    schedule.schedule(buffers[2]);
+    schedule.schedule(buffers[3]);
+
+    auto queue = drain_queue();
+    ASSERT_THAT(queue, SizeIs(1));
+    EXPECT_THAT(queue[0], Eq(buffers[3]));
+}
+
+TEST_F(FifoRelaxedSchedule, queues_again_once_the_late_buffer_is_shown)
+{
+    schedule.frame_missed();
+    schedule.schedule(buffers[0]);
+    schedule.next_buffer();
+
+    EXPECT_CALL(mock_client_buffers, send_buffer(_)).Times(0);
+    schedule.schedule(buffers[1]);
+    schedule.schedule(buffers[2]);
+
+    EXPECT_THAT(drain_queue(), ElementsAre(buffers[1], buffers[2]));
+}
+
+TEST_F(FifoRelaxedSchedule, nonblocking_schedule_avoids_socket_io)
+{
+    schedule.schedule(buffers[0]);
+    schedule.frame_missed();
+
+    EXPECT_CALL(mock_client_buffers, send_buffer(_)).Times(0);
+    auto deferred_io = schedule.schedule_nonblocking(buffers[1]);
+    Mock::VerifyAndClearExpectations(&mock_client_buffers);
+
+    EXPECT_CALL(mock_client_buffers, send_buffer(buffers[0]->id()));
+    ASSERT_TRUE(deferred_io.valid());
+    deferred_io.wait();
+}
@@ -38,6 +38,8 @@ struct MockBufferMap : mf::ClientBuffers
     MOCK_METHOD1(add_buffer, mg::BufferID(std::shared_ptr<mg::Buffer> const&));
     MOCK_METHOD1(remove_buffer, void(mg::BufferID id));
     MOCK_METHOD1(receive_buffer, void(mg::BufferID id));
+    MOCK_METHOD2(send_buffer_count_hint, void(mf::BufferStreamId, int));
+    MOCK_METHOD2(send_present_feedback, void(mf::BufferStreamId, mf::PresentFeedback const&));
     MOCK_METHOD1(send_buffer, void(mg::BufferID id));
     MOCK_CONST_METHOD0(client_owned_buffer_count, size_t());
     MOCK_CONST_METHOD1(get, std::shared_ptr<mg::Buffer>(mg::BufferID));
@@ -65,11 +67,16 @@ struct FixedSchedule : mc::Schedule
             throw std::runtime_error("no buffer scheduled");
         return sched[current++];
     }
+    void frame_missed() override
+    {
+        ++missed;
+    }
     void set_schedule(std::vector<std::shared_ptr<mg::Buffer>> s)
     {
         current = 0;
         sched = s;
     }
+    unsigned int missed{0};
 private:
     unsigned int current{0};
     std::vector<std::shared_ptr<mg::Buffer>> sched;
@@ -121,6 +128,20 @@ TEST_F(MultiMonitorArbiter, compositor_access)
     EXPECT_THAT(cbuffer, Eq(buffers[0]));
 }
 
+TEST_F(MultiMonitorArbiter, tells_schedule_when_compositor_shows_frame_again)
+{
+    schedule.set_schedule({buffers[0]});
+    arbiter.compositor_release(arbiter.compositor_acquire(this));
+    EXPECT_THAT(schedule.missed, Eq(0u));
+
+    arbiter.compositor_release(arbiter.compositor_acquire(this));
+    EXPECT_THAT(schedule.missed, Eq(1u));
+
+    schedule.set_schedule({buffers[1]});
+    arbiter.compositor_release(arbiter.compositor_acquire(this));
+    EXPECT_THAT(schedule.missed, Eq(1u));
+}
+
 TEST_F(MultiMonitorArbiterWithAnyFrameGuarantee, compositor_release_sends_buffer_back_with_any_monitor_guarantee)
 {
     EXPECT_CALL(mock_map, send_buffer(buffers[0]->id()));
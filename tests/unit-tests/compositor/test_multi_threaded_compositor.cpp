@@ -27,17 +27,20 @@
 #include "mir/raii.h"
 
 #include "mir/test/current_thread_name.h"
+#include "mir/test/signal.h"
 #include "mir/test/doubles/null_display.h"
 #include "mir/test/doubles/null_display_buffer.h"
 #include "mir/test/doubles/mock_display_buffer.h"
 #include "mir/test/doubles/mock_compositor_report.h"
 #include "mir/test/doubles/mock_scene.h"
 #include "mir/test/doubles/stub_scene.h"
+#include "mir/test/doubles/stub_scene_element.h"
 #include "mir/test/doubles/stub_display.h"
 #include "mir/test/doubles/null_display_buffer_compositor_factory.h"
 
 #include <boost/throw_exception.hpp>
 
+#include <atomic>
 #include <unordered_map>
 #include <unordered_set>
 #include <thread>
@@ -93,6 +96,23 @@ private:
     std::vector<StubDisplaySyncGroup> buffers;
 };
 
+class StubDisplayWithOneSyncGroup : public mtd::NullDisplay
+{
+public:
+    StubDisplayWithOneSyncGroup(unsigned int nbuffers)
+        : group{std::vector<geom::Rectangle>(nbuffers, geom::Rectangle{{0,0},{1,1}})}
+    {
+    }
+
+    void for_each_display_sync_group(std::function<void(mg::DisplaySyncGroup&)> const& f) override
+    {
+        f(group);
+    }
+
+private:
+    mtd::StubDisplaySyncGroup group;
+};
+
 class StubScene : public mtd::StubScene
 {
 public:
@@ -944,3 +964,148 @@ TEST(MultiThreadedCompositor, can_schedule_from_display_observer_when_removing_d
         display, stub_scene, db_compositor_factory, mock_display_listener, mock_report, default_delay, true};
     compositor.start();
 }
+
+TEST(MultiThreadedCompositor, parallel_outputs_are_each_drawn_on_a_thread_of_their_own)
+{
+    using namespace testing;
+
+    unsigned int const nbuffers{3};
+
+    auto display = std::make_shared<StubDisplayWithOneSyncGroup>(nbuffers);
+    auto scene = std::make_shared<StubScene>();
+    auto db_compositor_factory = std::make_shared<RecordingDisplayBufferCompositorFactory>();
+    mc::MultiThreadedCompositor compositor{
+        display, scene, db_compositor_factory, null_display_listener, null_report, default_delay, true, true};
+
+    compositor.start();
+
+    while (!db_compositor_factory->enough_records_gathered(nbuffers))
+        scene->emit_change_event();
+
+    compositor.stop();
+
+    EXPECT_TRUE(db_compositor_factory->each_buffer_rendered_in_single_thread());
+    EXPECT_TRUE(db_compositor_factory->buffers_rendered_in_different_threads());
+}
+
+TEST(MultiThreadedCompositor, parallel_outputs_leave_single_output_groups_to_their_own_thread)
+{
+    using namespace testing;
+
+    struct RecordingFactory : mtd::NullDisplayBufferCompositorFactory
+    {
+        auto create_compositor_for(mg::DisplayBuffer& buffer)
+            -> std::unique_ptr<mc::DisplayBufferCompositor> override
+        {
+            auto compositor = NullDisplayBufferCompositorFactory::create_compositor_for(buffer);
+            std::lock_guard<std::mutex> lock{mutex};
+            created.insert(compositor.get());
+            return compositor;
+        }
+
+        std::mutex mutex;
+        std::unordered_set<mc::CompositorID> created;
+    };
+
+    unsigned int const nbuffers{3};
+
+    auto display = std::make_shared<StubDisplayWithMockBuffers>(nbuffers);
+    auto mock_scene = std::make_shared<NiceMock<mtd::MockScene>>();
+    auto db_compositor_factory = std::make_shared<RecordingFactory>();
+
+    // Outputs composited in parallel register with the scene as their group
+    std::mutex registered_mutex;
+    std::vector<mc::CompositorID> registered;
+    ON_CALL(*mock_scene, register_compositor(_))
+        .WillByDefault(Invoke([&](mc::CompositorID id)
+            {
+                std::lock_guard<std::mutex> lock{registered_mutex};
+                registered.push_back(id);
+            }));
+
+    mc::MultiThreadedCompositor compositor{
+        display, mock_scene, db_compositor_factory, null_display_listener, null_report, default_delay, true, true};
+
+    compositor.start();
+    compositor.stop();
+
+    EXPECT_THAT(registered.size(), Eq(nbuffers));
+    for (auto const id : registered)
+        EXPECT_THAT(db_compositor_factory->created.count(id), Eq(1u));
+}
+
+TEST(MultiThreadedCompositor, parallel_outputs_share_one_scene_snapshot)
+{
+    using namespace testing;
+
+    struct CountingSceneElement : mtd::StubSceneElement
+    {
+        void rendered() override { ++times_rendered; }
+        void occluded() override { ++times_occluded; }
+
+        std::atomic<int> times_rendered{0};
+        std::atomic<int> times_occluded{0};
+    };
+
+    // The first output draws everything, the others find it all covered up
+    struct CullingDisplayBufferCompositorFactory : mc::DisplayBufferCompositorFactory
+    {
+        struct Compositor : mc::DisplayBufferCompositor
+        {
+            Compositor(bool draws) : draws{draws} {}
+
+            void composite(mc::SceneElementSequence&& elements) override
+            {
+                for (auto const& element : elements)
+                {
+                    if (draws)
+                        element->rendered();
+                    else
+                        element->occluded();
+                }
+            }
+
+            bool const draws;
+        };
+
+        std::unique_ptr<mc::DisplayBufferCompositor> create_compositor_for(mg::DisplayBuffer&) override
+        {
+            return std::make_unique<Compositor>(created++ == 0);
+        }
+
+        int created{0};
+    };
+
+    unsigned int const nbuffers{3};
+    int const frames{10};
+
+    auto display = std::make_shared<StubDisplayWithOneSyncGroup>(nbuffers);
+    auto mock_scene = std::make_shared<NiceMock<mtd::MockScene>>();
+    auto element = std::make_shared<CountingSceneElement>();
+    mt::Signal enough_frames;
+    std::atomic<int> snapshots{0};
+
+    EXPECT_CALL(*mock_scene, register_compositor(_))
+        .Times(1);
+    EXPECT_CALL(*mock_scene, scene_elements_for(_))
+        .WillRepeatedly(InvokeWithoutArgs([&]
+            {
+                if (++snapshots == frames)
+                    enough_frames.raise();
+                return mc::SceneElementSequence{element};
+            }));
+    ON_CALL(*mock_scene, frames_pending(_))
+        .WillByDefault(Return(1));
+
+    mc::MultiThreadedCompositor compositor{
+        display, mock_scene, std::make_shared<CullingDisplayBufferCompositorFactory>(),
+        null_display_listener, null_report, default_delay, true, true};
+
+    compositor.start();
+    EXPECT_TRUE(enough_frames.wait_for(10s));
+    compositor.stop();
+
+    // Once a frame, however many outputs drew it
+    EXPECT_THAT(element->times_rendered.load(), Eq(snapshots.load()));
+    EXPECT_THAT(element->times_occluded.load(), Eq(0));
+}
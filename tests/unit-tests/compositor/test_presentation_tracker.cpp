@@ -0,0 +1,196 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/compositor/presentation_tracker.h"
+#include "mir/frontend/client_buffers.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+using namespace testing;
+using namespace std::literals::chrono_literals;
+namespace mc = mir::compositor;
+namespace mf = mir::frontend;
+namespace mg = mir::graphics;
+
+namespace
+{
+struct RecordingClientBuffers : mf::ClientBuffers
+{
+    mg::BufferID add_buffer(std::shared_ptr<mg::Buffer> const&) override { return {}; }
+    void remove_buffer(mg::BufferID) override {}
+    std::shared_ptr<mg::Buffer> get(mg::BufferID) const override { return nullptr; }
+    void send_buffer(mg::BufferID) override {}
+    void receive_buffer(mg::BufferID) override {}
+    void send_buffer_count_hint(mf::BufferStreamId, int) override {}
+    void send_present_feedback(mf::BufferStreamId, mf::PresentFeedback const& f) override
+    {
+        feedback.push_back(f);
+    }
+
+    std::vector<mf::PresentFeedback> feedback;
+};
+
+struct PresentationTracker : Test
+{
+    PresentationTracker()
+    {
+        tracker.set_enabled(true);
+    }
+
+    mf::PresentFeedback draw(mg::BufferID buffer, MirPresentResult how = mir_present_result_composited)
+    {
+        auto const feedback = tracker.drawn(buffer, how);
+        EXPECT_TRUE(feedback.is_set());
+        return feedback.value();
+    }
+
+    std::vector<std::pair<uint64_t, MirPresentResult>> results() const
+    {
+        std::vector<std::pair<uint64_t, MirPresentResult>> r;
+        for (auto const& f : client->feedback)
+            r.emplace_back(f.frame, f.result);
+        return r;
+    }
+
+    mg::BufferID const buffer_a{1};
+    mg::BufferID const buffer_b{2};
+    mg::Frame const flip{42, {CLOCK_MONOTONIC, 1000ns}};
+    std::chrono::nanoseconds const refresh{16666666ns};
+    std::shared_ptr<RecordingClientBuffers> const client{std::make_shared<RecordingClientBuffers>()};
+    mc::PresentationTracker tracker{mf::BufferStreamId{7}, client};
+};
+
+using Result = std::pair<uint64_t, MirPresentResult>;
+}
+
+TEST_F(PresentationTracker, tells_the_client_nothing_unless_asked)
+{
+    tracker.set_enabled(false);
+
+    tracker.submitted(buffer_a);
+    EXPECT_FALSE(tracker.drawn(buffer_a, mir_present_result_composited).is_set());
+    tracker.submitted(buffer_a);
+
+    EXPECT_THAT(client->feedback, IsEmpty());
+}
+
+TEST_F(PresentationTracker, reports_the_flip_that_showed_a_frame)
+{
+    tracker.submitted(buffer_a);
+    tracker.shown(draw(buffer_a), flip, refresh);
+
+    ASSERT_THAT(client->feedback.size(), Eq(1u));
+    auto const& feedback = client->feedback.front();
+    EXPECT_THAT(feedback.buffer, Eq(buffer_a));
+    EXPECT_THAT(feedback.frame, Eq(1u));
+    EXPECT_THAT(feedback.result, Eq(mir_present_result_composited));
+    EXPECT_THAT(feedback.flip.msc, Eq(flip.msc));
+    EXPECT_THAT(feedback.flip.ust, Eq(flip.ust));
+    EXPECT_THAT(feedback.refresh, Eq(refresh));
+}
+
+TEST_F(PresentationTracker, reports_how_a_frame_was_shown)
+{
+    tracker.submitted(buffer_a);
+    tracker.shown(draw(buffer_a, mir_present_result_bypassed), flip, refresh);
+
+    EXPECT_THAT(results(), ElementsAre(Result{1, mir_present_result_bypassed}));
+}
+
+TEST_F(PresentationTracker, counts_frames_submitted_before_the_client_asked)
+{
+    tracker.set_enabled(false);
+    tracker.submitted(buffer_a);
+    tracker.submitted(buffer_b);
+    tracker.set_enabled(true);
+
+    tracker.submitted(buffer_a);
+    tracker.shown(draw(buffer_a), flip, refresh);
+
+    EXPECT_THAT(results(), ElementsAre(Result{3, mir_present_result_composited}));
+}
+
+TEST_F(PresentationTracker, reports_a_frame_replaced_before_it_was_drawn_as_dropped)
+{
+    tracker.submitted(buffer_a);
+    tracker.submitted(buffer_a);
+
+    EXPECT_THAT(results(), ElementsAre(Result{1, mir_present_result_dropped}));
+}
+
+TEST_F(PresentationTracker, reports_frames_older_than_one_shown_as_dropped)
+{
+    tracker.submitted(buffer_a);
+    auto const first = draw(buffer_a);
+    tracker.submitted(buffer_b);
+    tracker.shown(draw(buffer_b), flip, refresh);
+    tracker.shown(first, flip, refresh);
+
+    EXPECT_THAT(results(), ElementsAre(
+        Result{1, mir_present_result_dropped},
+        Result{2, mir_present_result_composited}));
+}
+
+TEST_F(PresentationTracker, reports_a_frame_shown_on_several_outputs_once)
+{
+    tracker.submitted(buffer_a);
+    auto const on_one = draw(buffer_a);
+    auto const on_another = draw(buffer_a, mir_present_result_bypassed);
+
+    tracker.shown(on_one, flip, refresh);
+    tracker.shown(on_another, flip, refresh);
+
+    EXPECT_THAT(results(), ElementsAre(Result{1, mir_present_result_composited}));
+}
+
+TEST_F(PresentationTracker, keeps_track_of_a_buffer_resubmitted_after_it_was_drawn)
+{
+    tracker.submitted(buffer_a);
+    auto const first = draw(buffer_a);
+    tracker.submitted(buffer_a);
+    auto const second = draw(buffer_a);
+
+    tracker.shown(first, flip, refresh);
+    tracker.shown(second, flip, refresh);
+
+    EXPECT_THAT(results(), ElementsAre(
+        Result{1, mir_present_result_composited},
+        Result{2, mir_present_result_composited}));
+}
+
+TEST_F(PresentationTracker, gives_up_on_frames_nothing_shows)
+{
+    for (unsigned i = 0; i != mc::PresentationTracker::max_outstanding + 1; ++i)
+    {
+        mg::BufferID const buffer{i + 1};
+        tracker.submitted(buffer);
+        draw(buffer);
+    }
+
+    EXPECT_THAT(results(), ElementsAre(Result{1, mir_present_result_dropped}));
+}
+
+TEST_F(PresentationTracker, forgets_outstanding_frames_when_the_client_stops_asking)
+{
+    tracker.submitted(buffer_a);
+    auto const feedback = draw(buffer_a);
+    tracker.set_enabled(false);
+
+    tracker.shown(feedback, flip, refresh);
+
+    EXPECT_THAT(client->feedback, IsEmpty());
+}
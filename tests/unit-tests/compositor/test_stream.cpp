@@ -62,6 +62,14 @@ struct StubBufferMap : mf::ClientBuffers
     void receive_buffer(mg::BufferID)
     {
     }
+    void send_buffer_count_hint(mf::BufferStreamId id, int buffer_count)
+    {
+        sink.send_buffer_count_hint(id, buffer_count);
+    }
+    void send_present_feedback(mf::BufferStreamId id, mf::PresentFeedback const& feedback)
+    {
+        sink.send_present_feedback(id, feedback);
+    }
     void send_buffer(mg::BufferID id)
     {
         sink.send_buffer(mf::BufferStreamId{33}, *get(id), mg::BufferIpcMsgType::update_msg);
@@ -140,6 +148,66 @@ TEST_F(Stream, transitions_from_framedropping_to_queuing)
     EXPECT_THAT(cbuffers, SizeIs(buffers.size()));
 }
 
+TEST_F(Stream, immediate_mode_drops_frames_as_mailbox_mode_does)
+{
+    stream.set_present_mode(mir_present_mode_immediate);
+    EXPECT_TRUE(stream.framedropping());
+
+    EXPECT_CALL(mock_sink, send_buffer(_,_,_)).Times(buffers.size() - 1);
+    for(auto& buffer : buffers)
+        stream.submit_buffer(buffer);
+
+    std::vector<std::shared_ptr<mg::Buffer>> cbuffers;
+    while(stream.buffers_ready_for_compositor(this))
+        cbuffers.push_back(stream.lock_compositor_buffer(this));
+    ASSERT_THAT(cbuffers, SizeIs(1));
+    EXPECT_THAT(cbuffers[0]->id(), Eq(buffers.back()->id()));
+    Mock::VerifyAndClearExpectations(&mock_sink);
+}
+
+TEST_F(Stream, fifo_relaxed_mode_queues_frames_while_client_keeps_up)
+{
+    stream.set_present_mode(mir_present_mode_fifo_relaxed);
+    EXPECT_FALSE(stream.framedropping());
+
+    EXPECT_CALL(mock_sink, send_buffer(_,_,_)).Times(0);
+    for(auto& buffer : buffers)
+        stream.submit_buffer(buffer);
+
+    std::vector<std::shared_ptr<mg::Buffer>> cbuffers;
+    while(stream.buffers_ready_for_compositor(this))
+        cbuffers.push_back(stream.lock_compositor_buffer(this));
+    EXPECT_THAT(cbuffers, SizeIs(buffers.size()));
+    Mock::VerifyAndClearExpectations(&mock_sink);
+}
+
+TEST_F(Stream, fifo_relaxed_mode_shows_latest_frame_once_client_has_missed_a_frame)
+{
+    stream.set_present_mode(mir_present_mode_fifo_relaxed);
+
+    stream.submit_buffer(buffers[0]);
+    stream.lock_compositor_buffer(this);
+    // Nothing new in time for this composition
+    stream.lock_compositor_buffer(this);
+
+    EXPECT_CALL(mock_sink, send_buffer(_,Ref(*buffers[1]),_));
+    stream.submit_buffer(buffers[1]);
+    stream.submit_buffer(buffers[2]);
+    Mock::VerifyAndClearExpectations(&mock_sink);
+
+    ASSERT_THAT(stream.buffers_ready_for_compositor(this), Eq(1));
+    EXPECT_THAT(stream.lock_compositor_buffer(this)->id(), Eq(buffers[2]->id()));
+}
+
+TEST_F(Stream, allowing_framedropping_selects_mailbox_or_fifo_mode)
+{
+    stream.set_present_mode(mir_present_mode_fifo_relaxed);
+    stream.allow_framedropping(true);
+    EXPECT_TRUE(stream.framedropping());
+    stream.allow_framedropping(false);
+    EXPECT_FALSE(stream.framedropping());
+}
+
 TEST_F(Stream, indicates_buffers_ready_when_queueing)
 {
     for(auto& buffer : buffers)
@@ -388,3 +456,119 @@ TEST_F(Stream, returns_buffers_to_client_when_told_to_bring_queue_up_to_date)
     stream.drop_old_buffers();
     Mock::VerifyAndClearExpectations(&mock_sink);
 }
+
+TEST_F(Stream, hints_fewer_buffers_when_frames_are_dropped_without_being_composited)
+{
+    mf::BufferStreamId const id{33};
+    mc::Stream stream{
+        framedrop_factory, id,
+        std::make_unique<StubBufferMap>(mock_sink, buffers), initial_size, construction_format};
+    for (auto& buffer : buffers)
+        stream.submit_buffer(buffer);
+
+    EXPECT_CALL(mock_sink, send_buffer_count_hint(id, 2))
+        .Times(1);
+    for (auto& buffer : buffers)
+    {
+        framedrop_factory.trigger_policies();
+        stream.submit_buffer(buffer);
+    }
+    Mock::VerifyAndClearExpectations(&mock_sink);
+}
+
+TEST_F(Stream, hints_client_to_choose_its_buffer_count_once_frames_are_composited_again)
+{
+    mf::BufferStreamId const id{33};
+    mc::Stream stream{
+        framedrop_factory, id,
+        std::make_unique<StubBufferMap>(mock_sink, buffers), initial_size, construction_format};
+    for (auto& buffer : buffers)
+        stream.submit_buffer(buffer);
+    for (auto& buffer : buffers)
+    {
+        framedrop_factory.trigger_policies();
+        stream.submit_buffer(buffer);
+    }
+
+    Mock::VerifyAndClearExpectations(&mock_sink);
+    EXPECT_CALL(mock_sink, send_buffer_count_hint(id, 0))
+        .Times(1);
+    stream.lock_compositor_buffer(this);
+    stream.lock_compositor_buffer(this);
+    Mock::VerifyAndClearExpectations(&mock_sink);
+}
+
+TEST_F(Stream, does_not_hint_buffer_count_without_a_stream_id)
+{
+    EXPECT_CALL(mock_sink, send_buffer_count_hint(_,_))
+        .Times(0);
+    for (auto& buffer : buffers)
+        stream.submit_buffer(buffer);
+    for (auto& buffer : buffers)
+    {
+        framedrop_factory.trigger_policies();
+        stream.submit_buffer(buffer);
+    }
+    stream.lock_compositor_buffer(this);
+    Mock::VerifyAndClearExpectations(&mock_sink);
+}
+
+namespace
+{
+std::shared_ptr<mtd::StubBuffer> buffer_of(geom::Size size, unsigned char content)
+{
+    auto const buffer = std::make_shared<mtd::StubBuffer>(
+        mg::BufferProperties{size, mir_pixel_format_argb_8888, mg::BufferUsage::software});
+    std::vector<unsigned char> pixels(buffer->stride().as_int() * size.height.as_int(), content);
+    buffer->write(pixels.data(), pixels.size());
+    return buffer;
+}
+}
+
+TEST_F(Stream, hands_back_frames_whose_pixels_are_unchanged_when_asked_to)
+{
+    buffers = {buffer_of(initial_size, 0x11), buffer_of(initial_size, 0x11)};
+    stream.set_skip_unchanged_frames(true);
+
+    auto observer = std::make_shared<MockSurfaceObserver>();
+    EXPECT_CALL(*observer, frame_posted(_,_)).Times(1);
+    EXPECT_CALL(mock_sink, send_buffer(_,Ref(*buffers[1]),_));
+    stream.add_observer(observer);
+
+    stream.submit_buffer(buffers[0]);
+    stream.submit_buffer(buffers[1]);
+    Mock::VerifyAndClearExpectations(&mock_sink);
+
+    ASSERT_THAT(stream.buffers_ready_for_compositor(this), Eq(1));
+    EXPECT_THAT(stream.lock_compositor_buffer(this)->id(), Eq(buffers[0]->id()));
+    EXPECT_THAT(stream.buffers_ready_for_compositor(this), Eq(0));
+}
+
+TEST_F(Stream, schedules_frames_whose_pixels_have_changed)
+{
+    buffers = {buffer_of(initial_size, 0x11), buffer_of(initial_size, 0x22)};
+    stream.set_skip_unchanged_frames(true);
+
+    auto observer = std::make_shared<MockSurfaceObserver>();
+    EXPECT_CALL(*observer, frame_posted(_,_)).Times(2);
+    EXPECT_CALL(mock_sink, send_buffer(_,_,_)).Times(0);
+    stream.add_observer(observer);
+
+    stream.submit_buffer(buffers[0]);
+    stream.submit_buffer(buffers[1]);
+    Mock::VerifyAndClearExpectations(&mock_sink);
+}
+
+TEST_F(Stream, schedules_unchanged_frames_by_default)
+{
+    buffers = {buffer_of(initial_size, 0x11), buffer_of(initial_size, 0x11)};
+
+    auto observer = std::make_shared<MockSurfaceObserver>();
+    EXPECT_CALL(*observer, frame_posted(_,_)).Times(2);
+    EXPECT_CALL(mock_sink, send_buffer(_,_,_)).Times(0);
+    stream.add_observer(observer);
+
+    stream.submit_buffer(buffers[0]);
+    stream.submit_buffer(buffers[1]);
+    Mock::VerifyAndClearExpectations(&mock_sink);
+}
@@ -17,6 +17,7 @@
  */
 
 #include "mir/test/doubles/fd_matcher.h"
+#include "mir/test/doubles/stub_display_configuration.h"
 #include "src/server/frontend/protobuf_buffer_packer.h"
 #include "src/server/frontend/resource_cache.h"
 
@@ -111,3 +112,17 @@ TEST(ProtobufBufferPacker, message_takes_ownership_of_fds)
         EXPECT_THAT(response.fd().Get(i), Not(mtd::RawFdIsValid()));
     EXPECT_THAT(response.fd().Get(i), mtd::RawFdIsValid());
 }
+
+TEST(ProtobufBufferPacker, display_configuration_says_which_outputs_can_vary_their_refresh_rate)
+{
+    mtd::StubDisplayConfig display_config{2};
+    display_config.outputs[0].variable_refresh_capable = false;
+    display_config.outputs[1].variable_refresh_capable = true;
+
+    mp::DisplayConfiguration protobuf_config;
+    mfd::pack_protobuf_display_configuration(protobuf_config, display_config);
+
+    ASSERT_EQ(2, protobuf_config.display_output_size());
+    EXPECT_FALSE(protobuf_config.display_output(0).variable_refresh_capable());
+    EXPECT_TRUE(protobuf_config.display_output(1).variable_refresh_capable());
+}
@@ -87,8 +87,14 @@ struct StubDisplayServer : mtd::StubDisplayServer
         changed_during_create_bstream_closure = before != after;
     }
 
+    void client_activity() override
+    {
+        ++activity_count;
+    }
+
     bool changed_during_create_surface_closure;
     bool changed_during_create_bstream_closure;
+    int activity_count{0};
 };
 }
 
@@ -151,3 +157,33 @@ TEST(ProtobufMessageProcessor, doesnt_inject_buffers_when_creating_bstream)
     mp->dispatch(invocation, fds);
     EXPECT_FALSE(stub_display_server.changed_during_create_bstream_closure);
 }
+
+TEST(ProtobufMessageProcessor, reports_client_activity_for_each_message)
+{
+    using namespace testing;
+    StubProtobufMessageSender stub_msg_sender;
+    StubMessageProcessorReport stub_report;
+    StubDisplayServer stub_display_server;
+    mfd::ProtobufMessageProcessor pb_message_processor(
+        mt::fake_shared(stub_msg_sender),
+        mt::fake_shared(stub_display_server),
+        mt::fake_shared(stub_report));
+    std::shared_ptr<mfd::MessageProcessor> mp = mt::fake_shared(pb_message_processor);
+
+    mpw::Invocation raw_invocation;
+    mp::BufferStreamParameters request;
+    request.set_width(1);
+    request.set_height(1);
+    request.set_pixel_format(1);
+    request.set_buffer_usage(1);
+    std::string str_parameters;
+    request.SerializeToString(&str_parameters);
+    raw_invocation.set_parameters(str_parameters.c_str());
+    raw_invocation.set_method_name("create_buffer_stream");
+    mfd::Invocation invocation(raw_invocation);
+
+    std::vector<mir::Fd> fds;
+    mp->dispatch(invocation, fds);
+    mp->dispatch(invocation, fds);
+    EXPECT_THAT(stub_display_server.activity_count, Eq(2));
+}
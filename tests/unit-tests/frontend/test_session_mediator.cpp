@@ -751,6 +751,52 @@ TEST_F(SessionMediator, allocates_native_buffers_from_the_session)
     EXPECT_THAT(stubbed_session->native_buffer_count, Eq(1));
 }
 
+TEST_F(SessionMediator, allocates_initial_buffers_requested_with_the_surface)
+{
+    using namespace testing;
+    auto num_requests = 3;
+    mg::BufferProperties properties(geom::Size{34, 84}, mir_pixel_format_abgr_8888, mg::BufferUsage::hardware);
+    for(auto i = 0; i < num_requests; i++)
+    {
+        auto buffer_request = surface_parameters.mutable_initial_buffers()->add_buffer_requests();
+        buffer_request->set_width(properties.size.width.as_int());
+        buffer_request->set_height(properties.size.height.as_int());
+        buffer_request->set_pixel_format(properties.format);
+        buffer_request->set_buffer_usage((int)properties.usage);
+    }
+    ON_CALL(*stubbed_session->mock_surface_at(mf::SurfaceId{0}), client_size())
+        .WillByDefault(Return(properties.size));
+
+    mediator.connect(&connect_parameters, &connection, null_callback.get());
+    mediator.create_surface(&surface_parameters, &surface_response, null_callback.get());
+
+    EXPECT_THAT(surface_response.buffer_stream().preallocated_buffers(), Eq(num_requests));
+    EXPECT_THAT(stubbed_session->num_alloc_requests(), Eq(num_requests));
+}
+
+TEST_F(SessionMediator, leaves_initial_buffers_to_the_client_when_the_shell_changes_the_size)
+{
+    using namespace testing;
+    auto num_requests = 3;
+    mg::BufferProperties properties(geom::Size{34, 84}, mir_pixel_format_abgr_8888, mg::BufferUsage::hardware);
+    for(auto i = 0; i < num_requests; i++)
+    {
+        auto buffer_request = surface_parameters.mutable_initial_buffers()->add_buffer_requests();
+        buffer_request->set_width(properties.size.width.as_int());
+        buffer_request->set_height(properties.size.height.as_int());
+        buffer_request->set_pixel_format(properties.format);
+        buffer_request->set_buffer_usage((int)properties.usage);
+    }
+    ON_CALL(*stubbed_session->mock_surface_at(mf::SurfaceId{0}), client_size())
+        .WillByDefault(Return(geom::Size{34, 60}));
+
+    mediator.connect(&connect_parameters, &connection, null_callback.get());
+    mediator.create_surface(&surface_parameters, &surface_response, null_callback.get());
+
+    EXPECT_THAT(surface_response.buffer_stream().preallocated_buffers(), Eq(0));
+    EXPECT_THAT(stubbed_session->num_alloc_requests(), Eq(0));
+}
+
 TEST_F(SessionMediator, removes_buffer_from_the_session)
 {
     using namespace testing;
@@ -795,6 +841,55 @@ TEST_F(SessionMediator, configures_swap_intervals_on_streams)
     mediator.configure_buffer_stream(&request, &response, null_callback.get());
 }
 
+TEST_F(SessionMediator, configures_present_mode_on_streams_in_preference_to_swap_interval)
+{
+    using namespace testing;
+    mf::BufferStreamId stream_id{0};
+    mp::StreamConfiguration request;
+    mp::Void response;
+
+    auto stream = stubbed_session->mock_stream_at(stream_id);
+    EXPECT_CALL(*stream, set_present_mode(mir_present_mode_fifo_relaxed));
+    EXPECT_CALL(*stream, allow_framedropping(_)).Times(0);
+
+    mediator.connect(&connect_parameters, &connection, null_callback.get());
+    mediator.create_surface(&surface_parameters, &surface_response, null_callback.get());
+
+    request.mutable_id()->set_value(stream_id.as_value());
+    request.set_present_mode(mir_present_mode_fifo_relaxed);
+    request.set_swapinterval(1);
+    mediator.configure_buffer_stream(&request, &response, null_callback.get());
+}
+
+TEST_F(SessionMediator, rejects_unknown_present_modes)
+{
+    using namespace testing;
+    mf::BufferStreamId stream_id{0};
+    mp::StreamConfiguration request;
+    mp::Void response;
+
+    auto stream = stubbed_session->mock_stream_at(stream_id);
+    EXPECT_CALL(*stream, set_present_mode(_)).Times(0);
+
+    mediator.connect(&connect_parameters, &connection, null_callback.get());
+    mediator.create_surface(&surface_parameters, &surface_response, null_callback.get());
+
+    request.mutable_id()->set_value(stream_id.as_value());
+    request.set_present_mode(mir_present_mode_num_modes);
+    EXPECT_THROW({
+        mediator.configure_buffer_stream(&request, &response, null_callback.get());
+    }, std::invalid_argument);
+}
+
+TEST_F(SessionMediator, connect_advertises_present_modes)
+{
+    mediator.connect(&connect_parameters, &connection, null_callback.get());
+
+    ASSERT_THAT(connection.present_mode_size(), testing::Eq(mir_present_mode_num_modes));
+    for (auto i = 0; i != mir_present_mode_num_modes; ++i)
+        EXPECT_THAT(connection.present_mode(i), testing::Eq(static_cast<unsigned>(i)));
+}
+
 namespace
 {
 MATCHER(IsReplyWithEvents, "")
@@ -18,9 +18,11 @@
  */
 
 #include "src/gl/recently_used_cache.h"
+#include "mir/gl/shared_textures.h"
 #include "mir/test/doubles/mock_gl_buffer.h"
 #include "mir/test/doubles/mock_renderable.h"
 #include "mir/test/doubles/mock_gl.h"
+#include "mir/test/doubles/mock_egl.h"
 #include <gtest/gtest.h>
 
 namespace mtd=mir::test::doubles;
@@ -123,9 +125,90 @@ TEST_F(RecentlyUsedCache, holds_buffers_till_the_end)
     cache.load(*renderable);
     EXPECT_EQ(old_use_count+1, mock_buffer.use_count());
     cache.drop_unused();
+    cache.drop_unused();
+    EXPECT_EQ(old_use_count, mock_buffer.use_count());
+}
+
+TEST_F(RecentlyUsedCache, holds_shown_buffer_till_the_next_is_loaded)
+{
+    using namespace testing;
+    auto const next_buffer = std::make_shared<NiceMock<mtd::MockGLBuffer>>();
+    ON_CALL(*next_buffer, id())
+        .WillByDefault(Return(mg::BufferID(456)));
+
+    auto old_use_count = mock_buffer.use_count();
+    mgl::RecentlyUsedCache cache;
+    cache.load(*renderable);
+    cache.drop_unused();
+    EXPECT_EQ(old_use_count+1, mock_buffer.use_count());
+
+    ON_CALL(*renderable, buffer())
+        .WillByDefault(Return(next_buffer));
+    cache.load(*renderable);
+    EXPECT_EQ(old_use_count, mock_buffer.use_count());
+}
+
+TEST_F(RecentlyUsedCache, releases_buffers_when_invalidated)
+{
+    auto old_use_count = mock_buffer.use_count();
+    mgl::RecentlyUsedCache cache;
+    cache.load(*renderable);
+    cache.drop_unused();
+    cache.invalidate();
     EXPECT_EQ(old_use_count, mock_buffer.use_count());
 }
 
+TEST_F(RecentlyUsedCache, keeps_showing_previous_buffer_while_next_is_not_ready)
+{
+    using namespace testing;
+    auto const next_buffer = std::make_shared<NiceMock<mtd::MockGLBuffer>>();
+    ON_CALL(*next_buffer, id())
+        .WillByDefault(Return(mg::BufferID(456)));
+
+    mgl::RecentlyUsedCache cache;
+    auto const texture = cache.load(*renderable);
+    cache.drop_unused();
+
+    ON_CALL(*renderable, buffer())
+        .WillByDefault(Return(next_buffer));
+    EXPECT_CALL(*next_buffer, secure_for_render())
+        .WillOnce(Return(false));
+    EXPECT_CALL(*next_buffer, bind())
+        .Times(0);
+    EXPECT_CALL(*next_buffer, rendering_finished())
+        .Times(0);
+    EXPECT_CALL(*mock_buffer, rendering_finished());
+
+    EXPECT_THAT(cache.load(*renderable), Eq(texture));
+    cache.drop_unused();
+    Mock::VerifyAndClearExpectations(next_buffer.get());
+    Mock::VerifyAndClearExpectations(mock_buffer.get());
+
+    EXPECT_CALL(*next_buffer, bind());
+    EXPECT_CALL(*next_buffer, rendering_finished());
+    EXPECT_CALL(*mock_buffer, rendering_finished())
+        .Times(0);
+
+    cache.load(*renderable);
+    cache.drop_unused();
+}
+
+TEST_F(RecentlyUsedCache, does_not_load_buffer_that_is_not_ready_with_nothing_else_to_show)
+{
+    using namespace testing;
+
+    ON_CALL(*mock_buffer, secure_for_render())
+        .WillByDefault(Return(false));
+    EXPECT_CALL(*mock_buffer, bind())
+        .Times(0);
+    EXPECT_CALL(*mock_buffer, rendering_finished())
+        .Times(0);
+
+    mgl::RecentlyUsedCache cache;
+    EXPECT_THROW(cache.load(*renderable), std::runtime_error);
+    cache.drop_unused();
+}
+
 //LP: #1362444
 TEST_F(RecentlyUsedCache, invalidated_buffers_are_reloaded)
 {
@@ -140,3 +223,94 @@ TEST_F(RecentlyUsedCache, invalidated_buffers_are_reloaded)
     cache.invalidate();
     cache.load(*renderable);
 }
+
+TEST_F(RecentlyUsedCache, finishes_rendering_only_from_buffers_used_since_last_drop)
+{
+    using namespace testing;
+
+    mgl::RecentlyUsedCache cache;
+
+    EXPECT_CALL(*mock_buffer, rendering_finished())
+        .Times(1);
+    cache.load(*renderable);
+    cache.drop_unused();
+    Mock::VerifyAndClearExpectations(mock_buffer.get());
+
+    EXPECT_CALL(*mock_buffer, rendering_finished())
+        .Times(0);
+    cache.drop_unused();
+    Mock::VerifyAndClearExpectations(mock_buffer.get());
+
+    EXPECT_CALL(*mock_buffer, rendering_finished())
+        .Times(1);
+    cache.load(*renderable);
+    cache.drop_unused();
+}
+
+TEST_F(RecentlyUsedCache, shares_textures_between_caches_while_buffer_is_held)
+{
+    using namespace testing;
+    NiceMock<mtd::MockEGL> mock_egl;
+    auto const shared_textures = std::make_shared<mgl::SharedTextures>();
+    mgl::RecentlyUsedCache first_output{shared_textures};
+    mgl::RecentlyUsedCache second_output{shared_textures};
+
+    EXPECT_CALL(*mock_buffer, bind())
+        .Times(1);
+    EXPECT_CALL(*mock_buffer, secure_for_render())
+        .Times(2);
+
+    auto const first_texture = first_output.load(*renderable);
+    auto const second_texture = second_output.load(*renderable);
+
+    EXPECT_THAT(second_texture, Eq(first_texture));
+}
+
+TEST_F(RecentlyUsedCache, reloads_shared_texture_once_nothing_holds_buffer)
+{
+    using namespace testing;
+    NiceMock<mtd::MockEGL> mock_egl;
+    auto const shared_textures = std::make_shared<mgl::SharedTextures>();
+    mgl::RecentlyUsedCache first_output{shared_textures};
+    mgl::RecentlyUsedCache second_output{shared_textures};
+
+    // Like compositors, hand out a fresh handle on the buffer for each frame
+    ON_CALL(*renderable, buffer())
+        .WillByDefault(Invoke([this]
+            { return std::shared_ptr<mg::Buffer>{std::make_shared<int>(), mock_buffer.get()}; }));
+
+    EXPECT_CALL(*mock_buffer, bind())
+        .Times(2);
+
+    first_output.load(*renderable);
+    first_output.drop_unused();
+    // Not shown for a frame
+    first_output.drop_unused();
+
+    // The buffer may have been refilled since
+    second_output.load(*renderable);
+}
+
+TEST_F(RecentlyUsedCache, shared_texture_load_waits_for_loading_context)
+{
+    using namespace testing;
+    NiceMock<mtd::MockEGL> mock_egl;
+    auto const shared_textures = std::make_shared<mgl::SharedTextures>();
+    mgl::RecentlyUsedCache first_output{shared_textures};
+    mgl::RecentlyUsedCache second_output{shared_textures};
+
+    ON_CALL(mock_egl, eglQueryString(_, EGL_EXTENSIONS))
+        .WillByDefault(Return("EGL_KHR_fence_sync"));
+    EGLSyncKHR const fence{reinterpret_cast<EGLSyncKHR>(0x1234)};
+
+    InSequence seq;
+    EXPECT_CALL(*mock_buffer, bind());
+    EXPECT_CALL(mock_egl, eglCreateSyncKHR(_, EGL_SYNC_FENCE_KHR, _))
+        .WillOnce(Return(fence));
+    EXPECT_CALL(mock_gl, glFlush());
+    EXPECT_CALL(mock_egl, eglClientWaitSyncKHR(_, fence, _, _));
+    EXPECT_CALL(mock_egl, eglDestroySyncKHR(_, fence));
+
+    first_output.load(*renderable);
+    second_output.load(*renderable);
+}
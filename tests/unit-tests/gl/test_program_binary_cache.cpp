@@ -0,0 +1,223 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/gl/program_binary_cache.h"
+
+#include "mir/test/doubles/mock_gl.h"
+#include "mir/test/doubles/mock_egl.h"
+
+#include <boost/filesystem.hpp>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <system_error>
+
+namespace mgl = mir::gl;
+namespace mtd = mir::test::doubles;
+
+using namespace testing;
+
+namespace
+{
+GLenum const stub_format = 0x1234;
+std::string const stub_binary{"linked program"};
+char const* const vertex_shader = "vertex shader";
+char const* const fragment_shader = "fragment shader";
+
+std::string loaded_binary;
+GLenum loaded_format{0};
+
+void get_program_binary(GLuint, GLsizei size, GLsizei* length, GLenum* format, void* binary)
+{
+    auto const written = std::min<GLsizei>(size, stub_binary.size());
+    memcpy(binary, stub_binary.data(), written);
+    *length = written;
+    *format = stub_format;
+}
+
+void program_binary(GLuint, GLenum format, void const* binary, GLint length)
+{
+    loaded_format = format;
+    loaded_binary.assign(static_cast<char const*>(binary), length);
+}
+
+GLubyte const* gl_string(char const* value)
+{
+    return reinterpret_cast<GLubyte const*>(value);
+}
+
+struct ProgramBinaryCache : Test
+{
+    ProgramBinaryCache()
+    {
+        char tmp_name[] = "/tmp/mir_program_binary_cache_XXXXXX";
+        if (mkdtemp(tmp_name) == NULL)
+        {
+            throw std::system_error{errno, std::system_category(), "Failed to create temporary directory"};
+        }
+        directory = tmp_name;
+
+        loaded_binary.clear();
+        loaded_format = 0;
+
+        ON_CALL(mock_gl, glGetString(GL_EXTENSIONS))
+            .WillByDefault(Return(gl_string("GL_OES_get_program_binary")));
+        ON_CALL(mock_gl, glGetString(GL_RENDERER))
+            .WillByDefault(Return(gl_string("Stub GPU")));
+        ON_CALL(mock_gl, glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS_OES, _))
+            .WillByDefault(SetArgPointee<1>(1));
+        ON_CALL(mock_gl, glGetProgramiv(_, GL_PROGRAM_BINARY_LENGTH_OES, _))
+            .WillByDefault(SetArgPointee<2>(stub_binary.size()));
+        ON_CALL(mock_gl, glGetProgramiv(_, GL_LINK_STATUS, _))
+            .WillByDefault(SetArgPointee<2>(GL_TRUE));
+
+        ON_CALL(mock_egl, eglGetProcAddress(StrEq("glGetProgramBinaryOES")))
+            .WillByDefault(Return(reinterpret_cast<mtd::MockEGL::generic_function_pointer_t>(&get_program_binary)));
+        ON_CALL(mock_egl, eglGetProcAddress(StrEq("glProgramBinaryOES")))
+            .WillByDefault(Return(reinterpret_cast<mtd::MockEGL::generic_function_pointer_t>(&program_binary)));
+    }
+
+    ~ProgramBinaryCache()
+    {
+        boost::system::error_code ignored;
+        boost::filesystem::remove_all(directory, ignored);
+    }
+
+    int files_in_directory() const
+    {
+        return std::distance(
+            boost::filesystem::directory_iterator{directory},
+            boost::filesystem::directory_iterator{});
+    }
+
+    NiceMock<mtd::MockGL> mock_gl;
+    NiceMock<mtd::MockEGL> mock_egl;
+    std::string directory;
+
+    GLuint const program{7};
+};
+}
+
+TEST_F(ProgramBinaryCache, does_nothing_without_driver_support)
+{
+    ON_CALL(mock_gl, glGetString(GL_EXTENSIONS))
+        .WillByDefault(Return(gl_string("GL_OES_something_else")));
+
+    mgl::ProgramBinaryCache cache{directory};
+
+    EXPECT_CALL(mock_gl, glGetProgramiv(_, GL_PROGRAM_BINARY_LENGTH_OES, _)).Times(0);
+
+    cache.store(program, vertex_shader, fragment_shader);
+    EXPECT_FALSE(cache.load(program, vertex_shader, fragment_shader));
+    EXPECT_THAT(files_in_directory(), Eq(0));
+}
+
+TEST_F(ProgramBinaryCache, does_nothing_when_driver_has_no_binary_formats)
+{
+    ON_CALL(mock_gl, glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS_OES, _))
+        .WillByDefault(SetArgPointee<1>(0));
+
+    mgl::ProgramBinaryCache cache{directory};
+
+    cache.store(program, vertex_shader, fragment_shader);
+    EXPECT_FALSE(cache.load(program, vertex_shader, fragment_shader));
+}
+
+TEST_F(ProgramBinaryCache, misses_programs_never_stored)
+{
+    mgl::ProgramBinaryCache cache{directory};
+
+    EXPECT_FALSE(cache.load(program, vertex_shader, fragment_shader));
+    EXPECT_THAT(loaded_binary, IsEmpty());
+}
+
+TEST_F(ProgramBinaryCache, loads_stored_binary_without_a_directory)
+{
+    mgl::ProgramBinaryCache cache{""};
+
+    cache.store(program, vertex_shader, fragment_shader);
+
+    EXPECT_TRUE(cache.load(program + 1, vertex_shader, fragment_shader));
+    EXPECT_THAT(loaded_binary, Eq(stub_binary));
+    EXPECT_THAT(loaded_format, Eq(stub_format));
+}
+
+TEST_F(ProgramBinaryCache, binary_is_keyed_on_shader_sources)
+{
+    mgl::ProgramBinaryCache cache{directory};
+
+    cache.store(program, vertex_shader, fragment_shader);
+
+    EXPECT_FALSE(cache.load(program, vertex_shader, "another fragment shader"));
+    EXPECT_FALSE(cache.load(program, "another vertex shader", fragment_shader));
+}
+
+TEST_F(ProgramBinaryCache, binary_persists_in_directory)
+{
+    mgl::ProgramBinaryCache{directory}.store(program, vertex_shader, fragment_shader);
+
+    mgl::ProgramBinaryCache cache{directory};
+
+    EXPECT_TRUE(cache.load(program, vertex_shader, fragment_shader));
+    EXPECT_THAT(loaded_binary, Eq(stub_binary));
+    EXPECT_THAT(loaded_format, Eq(stub_format));
+}
+
+TEST_F(ProgramBinaryCache, persisted_binary_is_not_loaded_by_a_different_driver)
+{
+    mgl::ProgramBinaryCache{directory}.store(program, vertex_shader, fragment_shader);
+
+    ON_CALL(mock_gl, glGetString(GL_RENDERER))
+        .WillByDefault(Return(gl_string("Another GPU")));
+    mgl::ProgramBinaryCache cache{directory};
+
+    EXPECT_FALSE(cache.load(program, vertex_shader, fragment_shader));
+    EXPECT_THAT(loaded_binary, IsEmpty());
+}
+
+TEST_F(ProgramBinaryCache, binary_rejected_by_driver_is_discarded)
+{
+    mgl::ProgramBinaryCache cache{directory};
+    cache.store(program, vertex_shader, fragment_shader);
+    ASSERT_THAT(files_in_directory(), Eq(1));
+
+    EXPECT_CALL(mock_gl, glGetProgramiv(program, GL_LINK_STATUS, _))
+        .WillOnce(SetArgPointee<2>(GL_FALSE));
+
+    EXPECT_FALSE(cache.load(program, vertex_shader, fragment_shader));
+    EXPECT_THAT(files_in_directory(), Eq(0));
+
+    loaded_binary.clear();
+    EXPECT_FALSE(cache.load(program, vertex_shader, fragment_shader));
+    EXPECT_THAT(loaded_binary, IsEmpty());
+}
+
+TEST_F(ProgramBinaryCache, corrupt_file_is_a_miss)
+{
+    mgl::ProgramBinaryCache{directory}.store(program, vertex_shader, fragment_shader);
+
+    for (auto const& file : boost::filesystem::directory_iterator{directory})
+        boost::filesystem::resize_file(file.path(), 12);
+
+    mgl::ProgramBinaryCache cache{directory};
+
+    EXPECT_FALSE(cache.load(program, vertex_shader, fragment_shader));
+    EXPECT_THAT(loaded_binary, IsEmpty());
+}
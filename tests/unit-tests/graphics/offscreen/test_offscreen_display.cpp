@@ -3,6 +3,7 @@
 #include "src/server/graphics/offscreen/display.h"
 #include "mir/graphics/default_display_configuration_policy.h"
 #include "mir/renderer/gl/render_target.h"
+#include "mir/renderer/sw/pixel_target.h"
 #include "src/server/report/null_report_factory.h"
 
 #include "mir/test/doubles/mock_egl.h"
@@ -19,6 +20,7 @@ namespace mgo=mir::graphics::offscreen;
 namespace mtd=mir::test::doubles;
 namespace mr = mir::report;
 namespace mt = mir::test;
+namespace mrs = mir::renderer::software;
 
 namespace
 {
@@ -97,6 +99,34 @@ TEST_F(OffscreenDisplayTest, never_enables_predictive_bypass)
     EXPECT_TRUE(groups);
 }
 
+TEST_F(OffscreenDisplayTest, offers_pixel_target_when_asked_for_pixel_buffers)
+{
+    using namespace ::testing;
+    mgo::Display display{
+        native_display,
+        std::make_shared<mg::CloneDisplayConfigurationPolicy>(),
+        mr::null_display_report(),
+        true};
+
+    int count = 0;
+    display.for_each_display_sync_group([&](mg::DisplaySyncGroup& group) {
+        group.for_each_display_buffer([&](mg::DisplayBuffer& db) {
+            ++count;
+            auto const target = dynamic_cast<mrs::PixelTarget*>(db.native_display_buffer());
+            ASSERT_THAT(target, NotNull());
+
+            auto const pixels = target->back_buffer();
+            EXPECT_THAT(pixels.size, Eq(db.view_area().size));
+            EXPECT_THAT(pixels.age, Eq(0u));
+
+            target->swap_buffers({db.view_area()});
+            EXPECT_THAT(target->back_buffer().age, Eq(1u));
+        });
+    });
+
+    EXPECT_TRUE(count);
+}
+
 TEST_F(OffscreenDisplayTest, makes_fbo_current_rendering_target)
 {
     using namespace ::testing;
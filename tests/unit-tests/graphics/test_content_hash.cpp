@@ -0,0 +1,127 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/graphics/content_hash.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+namespace mg = mir::graphics;
+using namespace testing;
+
+namespace
+{
+std::vector<uint8_t> numbered_bytes(size_t count)
+{
+    std::vector<uint8_t> bytes(count);
+    for (size_t i = 0; i != count; ++i)
+        bytes[i] = static_cast<uint8_t>(i * 7 + 3);
+    return bytes;
+}
+}
+
+TEST(ContentHash, same_content_has_same_hash)
+{
+    auto const content = numbered_bytes(4096);
+    auto const copy = content;
+
+    EXPECT_THAT(mg::content_hash(copy.data(), copy.size()), Eq(mg::content_hash(content.data(), content.size())));
+}
+
+TEST(ContentHash, changing_any_byte_changes_the_hash)
+{
+    // Spans several blocks of stripes and ends part-way through a stripe
+    size_t const count{1100};
+    auto content = numbered_bytes(count);
+    auto const original = mg::content_hash(content.data(), count);
+
+    for (size_t i = 0; i != count; ++i)
+    {
+        content[i] ^= 0x01;
+        EXPECT_THAT(mg::content_hash(content.data(), count), Ne(original)) << "byte " << i;
+        content[i] ^= 0x01;
+    }
+}
+
+TEST(ContentHash, trailing_zeros_change_the_hash)
+{
+    std::vector<uint8_t> const zeros(64, 0);
+    std::set<uint64_t> hashes;
+
+    for (size_t count = 0; count != zeros.size(); ++count)
+        hashes.insert(mg::content_hash(zeros.data(), count));
+
+    EXPECT_THAT(hashes.size(), Eq(zeros.size()));
+}
+
+TEST(ContentHash, does_not_depend_on_alignment)
+{
+    auto const content = numbered_bytes(1024 + 1);
+
+    EXPECT_THAT(mg::content_hash(content.data() + 1, 1024),
+                Eq(mg::content_hash(std::vector<uint8_t>(content.begin() + 1, content.end()).data(), 1024)));
+}
+
+TEST(ContentHash, kernel_in_use_is_listed_first)
+{
+    auto const kernels = mg::content_hash_kernels();
+
+    ASSERT_THAT(kernels, Not(IsEmpty()));
+    EXPECT_THAT(kernels.front(), StrEq(mg::content_hash_kernel()));
+    EXPECT_THAT(kernels.back(), StrEq("scalar"));
+}
+
+TEST(ContentHash, every_kernel_gives_the_same_hash)
+{
+    auto const content = numbered_bytes(4 * 1024 + 3);
+
+    // Worked out with the plain C++ kernel
+    EXPECT_THAT(mg::content_hash(content.data(), 1100, "scalar"), Eq(0xaeb02aa80896ca5fu));
+
+    // Around block and stripe boundaries, and from unaligned addresses
+    for (auto const kernel : mg::content_hash_kernels())
+    {
+        for (size_t offset : {0, 1, 3})
+        {
+            for (size_t count : {0, 31, 32, 33, 511, 512, 513, 1100, 4096})
+            {
+                EXPECT_THAT(mg::content_hash(content.data() + offset, count, kernel),
+                            Eq(mg::content_hash(content.data() + offset, count, "scalar")))
+                    << "kernel: " << kernel << ", offset: " << offset << ", count: " << count;
+            }
+        }
+    }
+}
+
+TEST(ContentHash, hashes_with_kernel_in_use_by_default)
+{
+    auto const content = numbered_bytes(1100);
+
+    EXPECT_THAT(mg::content_hash(content.data(), content.size()),
+                Eq(mg::content_hash(content.data(), content.size(), mg::content_hash_kernel())));
+}
+
+TEST(ContentHash, throws_for_unsupported_kernel)
+{
+    auto const content = numbered_bytes(64);
+
+    EXPECT_THROW(mg::content_hash(content.data(), content.size(), "no such kernel"), std::invalid_argument);
+}
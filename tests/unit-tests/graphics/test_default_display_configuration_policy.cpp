@@ -65,7 +65,8 @@ DisplayConfigurationOutput default_output(DisplayConfigurationOutputId id)
         mir_subpixel_arrangement_unknown,
         {},
         mir_output_gamma_unsupported,
-        {}
+        {},
+        false
     };
 }
 
@@ -53,7 +53,8 @@ mg::DisplayConfigurationOutput const tmpl_output
     mir_subpixel_arrangement_unknown,
     {},
     mir_output_gamma_unsupported,
-    {}
+    {},
+    false
 };
 
 }
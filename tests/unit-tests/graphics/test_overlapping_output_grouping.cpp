@@ -100,7 +100,8 @@ public:
                 mir_subpixel_arrangement_unknown,
                 {},
                 mir_output_gamma_unsupported,
-                {}
+                {},
+                false
             };
 
             f(output);
@@ -0,0 +1,109 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/graphics/pixel_conversion.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace mg = mir::graphics;
+namespace geom = mir::geometry;
+using namespace testing;
+
+namespace
+{
+uint32_t swapped(uint32_t p)
+{
+    return (p & 0xff00ff00) | ((p & 0x00ff0000) >> 16) | ((p & 0x000000ff) << 16);
+}
+
+std::vector<uint32_t> numbered_pixels(size_t count)
+{
+    std::vector<uint32_t> pixels(count);
+    for (size_t i = 0; i != count; ++i)
+        pixels[i] = 0x01020304u * static_cast<uint32_t>(i + 1);
+    return pixels;
+}
+}
+
+TEST(PixelConversion, swaps_red_and_blue_of_every_pixel)
+{
+    // An odd count exercises both the vector loop and the scalar tail
+    size_t const count{37};
+    auto const src = numbered_pixels(count);
+    std::vector<uint32_t> dst(count);
+
+    mg::copy_swapping_red_and_blue(src.data(), dst.data(), count);
+
+    for (size_t i = 0; i != count; ++i)
+        EXPECT_THAT(dst[i], Eq(swapped(src[i]))) << "pixel " << i;
+}
+
+TEST(PixelConversion, swaps_red_and_blue_in_place)
+{
+    size_t const count{37};
+    auto const original = numbered_pixels(count);
+    auto pixels = original;
+
+    mg::copy_swapping_red_and_blue(pixels.data(), pixels.data(), count);
+
+    for (size_t i = 0; i != count; ++i)
+        EXPECT_THAT(pixels[i], Eq(swapped(original[i]))) << "pixel " << i;
+}
+
+TEST(PixelConversion, flips_rows_without_touching_stride_padding)
+{
+    geom::Size const size{19, 5};
+    auto const stride_pixels = 21;
+    geom::Stride const stride{stride_pixels * 4};
+    auto const original = numbered_pixels(stride_pixels * size.height.as_int());
+    auto pixels = original;
+
+    mg::flip_rows_8888(pixels.data(), size, stride, false);
+
+    for (int y = 0; y < size.height.as_int(); ++y)
+    {
+        auto const flipped_y = size.height.as_int() - y - 1;
+        for (int x = 0; x < stride_pixels; ++x)
+        {
+            auto const expected = x < size.width.as_int() ?
+                original[flipped_y * stride_pixels + x] :
+                original[y * stride_pixels + x];
+            EXPECT_THAT(pixels[y * stride_pixels + x], Eq(expected)) << "(" << x << ", " << y << ")";
+        }
+    }
+}
+
+TEST(PixelConversion, flips_and_swaps_every_row_including_the_middle_one)
+{
+    auto const width = 33;
+    for (auto height : {4, 5})
+    {
+        geom::Size const image_size{width, height};
+        auto const original = numbered_pixels(width * height);
+        auto pixels = original;
+
+        mg::flip_rows_8888(pixels.data(), image_size, geom::Stride{width * 4}, true);
+
+        for (int y = 0; y < height; ++y)
+            for (int x = 0; x < width; ++x)
+                EXPECT_THAT(pixels[y * width + x], Eq(swapped(original[(height - y - 1) * width + x])))
+                    << "(" << x << ", " << y << ") of height " << height;
+    }
+}
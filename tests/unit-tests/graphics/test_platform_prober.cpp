@@ -17,6 +17,7 @@
  */
 
 #include <gtest/gtest.h>
+#include <gmock/gmock.h>
 
 #include "mir/graphics/platform.h"
 #include "mir/graphics/platform_probe.h"
@@ -25,6 +26,7 @@
 #include "mir/raii.h"
 
 #include "mir/test/doubles/mock_egl.h"
+#include "mir/test/doubles/mock_shared_library_prober_report.h"
 #if defined(MIR_BUILD_PLATFORM_MESA_KMS) || defined(MIR_BUILD_PLATFORM_MESA_X11)
 #include "mir/test/doubles/mock_drm.h"
 #endif
@@ -38,6 +40,11 @@
 
 #include "mir_test_framework/udev_environment.h"
 #include "mir_test_framework/executable_path.h"
+#include "mir_test_framework/temporary_environment_value.h"
+
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <system_error>
 
 namespace mtd = mir::test::doubles;
 namespace mtf = mir_test_framework;
@@ -111,6 +118,39 @@ std::shared_ptr<void> ensure_android_probing_succeeds()
 #endif
 }
 
+class ServerPlatformProbeCache : public ::testing::Test
+{
+public:
+    ServerPlatformProbeCache()
+    {
+        char tmp_name[] = "/tmp/mir_platform_probe_cache_XXXXXX";
+        if (mkdtemp(tmp_name) == NULL)
+        {
+            throw std::system_error{errno, std::system_category(), "Failed to create temporary directory"};
+        }
+        platform_directory = tmp_name;
+        cache_file = platform_directory + "/probe-cache";
+
+        add_library("graphics-dummy.so", mtf::server_platform("graphics-dummy.so"));
+    }
+
+    ~ServerPlatformProbeCache()
+    {
+        boost::system::error_code ignored;
+        boost::filesystem::remove_all(platform_directory, ignored);
+    }
+
+    void add_library(std::string const& name, std::string const& target)
+    {
+        boost::filesystem::create_symlink(target, platform_directory + "/" + name);
+    }
+
+    mir::options::ProgramOption options;
+    std::string platform_directory;
+    std::string cache_file;
+    testing::NiceMock<mtd::MockSharedLibraryProberReport> report;
+};
+
 class ServerPlatformProbeMockDRM : public ::testing::Test
 {
 #if defined(MIR_BUILD_PLATFORM_MESA_KMS) || defined(MIR_BUILD_PLATFORM_MESA_X11)
@@ -267,3 +307,68 @@ TEST_F(ServerPlatformProbeMockDRM, IgnoresNonPlatformModules)
     auto module = mir::graphics::module_for_device(modules, options);
     EXPECT_NE(nullptr, module);
 }
+
+TEST_F(ServerPlatformProbeCache, writes_cache_on_first_probe)
+{
+    auto module = mir::graphics::module_for_device(platform_directory, cache_file, options, report);
+    ASSERT_NE(nullptr, module);
+
+    EXPECT_TRUE(boost::filesystem::exists(cache_file));
+}
+
+TEST_F(ServerPlatformProbeCache, loads_only_the_cached_module_when_nothing_has_changed)
+{
+    using namespace testing;
+    add_library("dummy.so", mtf::client_platform("dummy.so"));
+    mir::graphics::module_for_device(platform_directory, cache_file, options, report);
+
+    EXPECT_CALL(report, loading_library(_)).Times(1);
+
+    auto module = mir::graphics::module_for_device(platform_directory, cache_file, options, report);
+    ASSERT_NE(nullptr, module);
+
+    auto descriptor = module->load_function<mir::graphics::DescribeModule>(describe_module);
+    EXPECT_THAT(descriptor()->name, HasSubstr("mir:stub-graphics"));
+}
+
+TEST_F(ServerPlatformProbeCache, probes_all_modules_when_a_library_has_been_added)
+{
+    using namespace testing;
+    mir::graphics::module_for_device(platform_directory, cache_file, options, report);
+
+    add_library("dummy.so", mtf::client_platform("dummy.so"));
+
+    EXPECT_CALL(report, loading_library(_)).Times(2);
+
+    auto module = mir::graphics::module_for_device(platform_directory, cache_file, options, report);
+    EXPECT_NE(nullptr, module);
+}
+
+TEST_F(ServerPlatformProbeCache, probes_all_modules_when_the_display_environment_has_changed)
+{
+    using namespace testing;
+    add_library("dummy.so", mtf::client_platform("dummy.so"));
+    {
+        mtf::TemporaryEnvironmentValue no_display{"DISPLAY", nullptr};
+        mir::graphics::module_for_device(platform_directory, cache_file, options, report);
+    }
+
+    mtf::TemporaryEnvironmentValue display{"DISPLAY", ":42"};
+
+    EXPECT_CALL(report, loading_library(_)).Times(2);
+
+    auto module = mir::graphics::module_for_device(platform_directory, cache_file, options, report);
+    EXPECT_NE(nullptr, module);
+}
+
+TEST_F(ServerPlatformProbeCache, ignores_a_corrupt_cache)
+{
+    using namespace testing;
+    {
+        std::ofstream corrupt{cache_file};
+        corrupt << "this is not a probe cache";
+    }
+
+    auto module = mir::graphics::module_for_device(platform_directory, cache_file, options, report);
+    EXPECT_NE(nullptr, module);
+}
@@ -295,7 +295,7 @@ TEST_F(SoftwareCursor, places_new_cursor_renderable_at_correct_position)
 }
 
 //lp: #1413211
-TEST_F(SoftwareCursor, new_buffer_on_each_show)
+TEST_F(SoftwareCursor, new_buffer_for_each_new_image)
 {
     struct MockBufferAllocator : public mg::GraphicBufferAllocator
     {
@@ -307,13 +307,30 @@ TEST_F(SoftwareCursor, new_buffer_on_each_show)
 
     EXPECT_CALL(mock_allocator, alloc_buffer(testing::_))
         .Times(3)
-        .WillRepeatedly(testing::Return(std::make_shared<mtd::StubBuffer>()));;
+        .WillRepeatedly(testing::Invoke([](mg::BufferProperties const& properties)
+            { return std::make_shared<mtd::StubBuffer>(properties); }));
     mg::SoftwareCursor cursor{
         mt::fake_shared(mock_allocator),
         mt::fake_shared(mock_input_scene)};
     cursor.show(another_stub_cursor_image);
     cursor.show(another_stub_cursor_image);
     cursor.show(stub_cursor_image);
+    cursor.show(another_stub_cursor_image);
+}
+
+TEST_F(SoftwareCursor, showing_the_same_image_again_keeps_its_renderable)
+{
+    using namespace testing;
+
+    std::shared_ptr<mg::Renderable> cursor_renderable;
+    EXPECT_CALL(mock_input_scene, add_input_visualization(_))
+        .WillOnce(SaveArg<0>(&cursor_renderable));
+    EXPECT_CALL(mock_input_scene, remove_input_visualization(_)).Times(0);
+
+    cursor.show(stub_cursor_image);
+    cursor.show(StubCursorImage{stub_cursor_image.hotspot()});
+
+    Mock::VerifyAndClearExpectations(&mock_input_scene);
 }
 
 //lp: 1483779
@@ -0,0 +1,166 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/input/event_ring.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <unistd.h>
+
+namespace mi = mir::input;
+using namespace testing;
+
+namespace
+{
+using Entry = mi::EventRing::Entry;
+
+struct EventRing : Test
+{
+    std::size_t const slot_count{8};
+    std::unique_ptr<mi::EventRing> const writer{mi::EventRing::create(slot_count)};
+    std::unique_ptr<mi::EventRing> const reader{mi::EventRing::open(mir::Fd{dup(writer->fd())})};
+    std::string event;
+};
+}
+
+TEST_F(EventRing, reader_sees_events_in_the_order_written)
+{
+    EXPECT_TRUE(writer->write("one"));
+    EXPECT_TRUE(writer->write("two"));
+
+    EXPECT_THAT(reader->read(event), Eq(Entry::event));
+    EXPECT_THAT(event, Eq("one"));
+    EXPECT_THAT(reader->read(event), Eq(Entry::event));
+    EXPECT_THAT(event, Eq("two"));
+    EXPECT_THAT(reader->read(event), Eq(Entry::none));
+    EXPECT_TRUE(writer->empty());
+}
+
+TEST_F(EventRing, events_may_contain_nul_bytes)
+{
+    std::string const binary{"a\0b\0c", 5};
+
+    EXPECT_TRUE(writer->write(binary));
+    EXPECT_THAT(reader->read(event), Eq(Entry::event));
+    EXPECT_THAT(event, Eq(binary));
+}
+
+TEST_F(EventRing, rejects_events_larger_than_a_slot)
+{
+    EXPECT_FALSE(writer->write(std::string(mi::EventRing::slot_size, 'x')));
+    EXPECT_TRUE(writer->empty());
+}
+
+TEST_F(EventRing, keeps_the_last_slot_for_a_barrier)
+{
+    for (std::size_t i = 0; i != slot_count - 1; ++i)
+        EXPECT_TRUE(writer->write(std::to_string(i)));
+
+    EXPECT_FALSE(writer->write("overflow"));
+    writer->write_barrier();
+
+    for (std::size_t i = 0; i != slot_count - 1; ++i)
+    {
+        EXPECT_THAT(reader->read(event), Eq(Entry::event));
+        EXPECT_THAT(event, Eq(std::to_string(i)));
+    }
+    EXPECT_THAT(reader->read(event), Eq(Entry::barrier));
+    EXPECT_THAT(reader->read(event), Eq(Entry::none));
+}
+
+TEST_F(EventRing, wraps_around)
+{
+    for (int i = 0; i != 100; ++i)
+    {
+        EXPECT_TRUE(writer->write(std::to_string(i)));
+        EXPECT_THAT(reader->read(event), Eq(Entry::event));
+        EXPECT_THAT(event, Eq(std::to_string(i)));
+    }
+}
+
+TEST_F(EventRing, writer_wakes_a_reader_only_once_it_has_armed_its_wakeup)
+{
+    // A new reader hasn't mapped the ring yet, so needs waking
+    EXPECT_TRUE(writer->take_wakeup());
+    EXPECT_FALSE(writer->take_wakeup());
+
+    EXPECT_TRUE(reader->arm_wakeup());
+    EXPECT_TRUE(writer->take_wakeup());
+    EXPECT_FALSE(writer->take_wakeup());
+}
+
+TEST_F(EventRing, arming_the_wakeup_fails_while_there_are_events_to_read)
+{
+    writer->write("event");
+
+    EXPECT_FALSE(reader->arm_wakeup());
+    reader->read(event);
+    EXPECT_TRUE(reader->arm_wakeup());
+}
+
+TEST_F(EventRing, passes_events_between_threads)
+{
+    int const nevents{10000};
+
+    std::thread producer{[this]
+        {
+            for (int i = 0; i != nevents;)
+            {
+                if (writer->write(std::to_string(i)))
+                    ++i;
+                else
+                    std::this_thread::yield();
+            }
+        }};
+
+    for (int i = 0; i != nevents;)
+    {
+        auto const entry = reader->read(event);
+        if (entry == Entry::none)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        ASSERT_THAT(entry, Eq(Entry::event));
+        ASSERT_THAT(event, Eq(std::to_string(i++)));
+    }
+
+    producer.join();
+}
+
+TEST_F(EventRing, rejects_a_size_that_is_not_a_power_of_two)
+{
+    EXPECT_THROW(mi::EventRing::create(6), std::logic_error);
+}
+
+TEST_F(EventRing, open_rejects_a_file_that_is_not_a_ring)
+{
+    std::unique_ptr<FILE, decltype(&fclose)> const file{tmpfile(), &fclose};
+    ASSERT_THAT(ftruncate(fileno(file.get()), 4096), Eq(0));
+
+    EXPECT_THROW(mi::EventRing::open(mir::Fd{dup(fileno(file.get()))}), std::runtime_error);
+}
+
+TEST_F(EventRing, client_cannot_resize_the_ring)
+{
+    EXPECT_THAT(ftruncate(reader->fd(), 0), Ne(0));
+}
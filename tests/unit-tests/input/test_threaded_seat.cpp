@@ -0,0 +1,190 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/input/threaded_seat.h"
+
+#include "mir/events/event_builders.h"
+#include "mir/test/doubles/mock_input_seat.h"
+#include "mir/test/doubles/mock_device.h"
+#include "mir/test/fake_shared.h"
+#include "mir/test/signal.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mi = mir::input;
+namespace mev = mir::events;
+namespace mt = mir::test;
+namespace mtd = mir::test::doubles;
+using namespace testing;
+using namespace std::chrono_literals;
+
+namespace
+{
+mir::EventUPtr key_event(int scan_code)
+{
+    return mev::make_event(
+        MirInputDeviceId{1}, std::chrono::nanoseconds{0}, std::vector<uint8_t>{},
+        mir_keyboard_action_down, 0, scan_code, mir_input_event_modifier_none);
+}
+
+int scan_code_of(MirEvent const& event)
+{
+    return mir_keyboard_event_scan_code(mir_input_event_get_keyboard_event(mir_event_get_input_event(&event)));
+}
+
+struct ThreadedSeat : Test
+{
+    NiceMock<mtd::MockInputSeat> seat;
+    mtd::MockDevice device{1, mi::DeviceCapability::keyboard, "keyboard", "keyboard-uid"};
+
+    std::mutex mutex;
+    std::vector<int> dispatched;
+    std::vector<std::thread::id> dispatch_threads;
+
+    void record_dispatches()
+    {
+        ON_CALL(seat, dispatch_event(_)).WillByDefault(Invoke([this](MirEvent& event)
+            {
+                std::lock_guard<decltype(mutex)> lock{mutex};
+                dispatched.push_back(scan_code_of(event));
+                dispatch_threads.push_back(std::this_thread::get_id());
+            }));
+    }
+
+    // The first event dispatched waits for first_may_finish
+    void hold_first_dispatch()
+    {
+        ON_CALL(seat, dispatch_event(_)).WillByDefault(Invoke([this](MirEvent& event)
+            {
+                first_started.raise();
+                first_may_finish.wait_for(10s);
+
+                std::lock_guard<decltype(mutex)> lock{mutex};
+                dispatched.push_back(scan_code_of(event));
+            }));
+    }
+
+    mt::Signal first_started;
+    mt::Signal first_may_finish;
+};
+}
+
+TEST_F(ThreadedSeat, dispatches_events_in_order_from_another_thread)
+{
+    record_dispatches();
+    mi::ThreadedSeat threaded{mt::fake_shared(seat), 16};
+
+    for (int i = 0; i != 100; ++i)
+        threaded.dispatch_event(*key_event(i));
+    threaded.drain();
+
+    std::vector<int> expected;
+    for (int i = 0; i != 100; ++i)
+        expected.push_back(i);
+
+    std::lock_guard<decltype(mutex)> lock{mutex};
+    EXPECT_THAT(dispatched, ContainerEq(expected));
+    EXPECT_THAT(dispatch_threads, Each(Ne(std::this_thread::get_id())));
+}
+
+TEST_F(ThreadedSeat, dispatches_copies_of_events)
+{
+    mi::ThreadedSeat threaded{mt::fake_shared(seat), 16};
+
+    EXPECT_CALL(seat, dispatch_event(_)).WillOnce(Invoke([](MirEvent& event)
+        {
+            EXPECT_THAT(scan_code_of(event), Eq(42));
+        }));
+
+    {
+        auto const event = key_event(42);
+        threaded.dispatch_event(*event);
+    }
+    threaded.drain();
+}
+
+TEST_F(ThreadedSeat, changes_to_devices_wait_for_queued_events)
+{
+    mi::ThreadedSeat threaded{mt::fake_shared(seat), 16};
+
+    {
+        InSequence seq;
+        EXPECT_CALL(seat, dispatch_event(_)).Times(3).WillRepeatedly(InvokeWithoutArgs([]
+            {
+                std::this_thread::sleep_for(10ms);
+            }));
+        EXPECT_CALL(seat, set_key_state(_, _));
+        EXPECT_CALL(seat, remove_device(_));
+    }
+
+    for (int i = 0; i != 3; ++i)
+        threaded.dispatch_event(*key_event(i));
+    threaded.set_key_state(device, {});
+    threaded.remove_device(device);
+}
+
+TEST_F(ThreadedSeat, reader_waits_while_the_queue_is_full)
+{
+    hold_first_dispatch();
+    mi::ThreadedSeat threaded{mt::fake_shared(seat), 2};
+
+    threaded.dispatch_event(*key_event(0));
+    ASSERT_TRUE(first_started.wait_for(10s));
+
+    // Two more fill the queue; the fourth has to wait
+    mt::Signal all_queued;
+    std::thread reader{[&]
+        {
+            for (int i = 1; i != 4; ++i)
+                threaded.dispatch_event(*key_event(i));
+            all_queued.raise();
+        }};
+
+    EXPECT_FALSE(all_queued.wait_for(100ms));
+    EXPECT_THAT(threaded.statistics().full, Eq(1u));
+
+    first_may_finish.raise();
+    EXPECT_TRUE(all_queued.wait_for(10s));
+    reader.join();
+    threaded.drain();
+
+    std::lock_guard<decltype(mutex)> lock{mutex};
+    EXPECT_THAT(dispatched, ElementsAre(0, 1, 2, 3));
+}
+
+TEST_F(ThreadedSeat, counts_dispatched_events_and_how_deep_they_queued)
+{
+    hold_first_dispatch();
+    mi::ThreadedSeat threaded{mt::fake_shared(seat), 8};
+
+    for (int i = 0; i != 3; ++i)
+        threaded.dispatch_event(*key_event(i));
+    ASSERT_TRUE(first_started.wait_for(10s));
+    first_may_finish.raise();
+    threaded.drain();
+
+    auto const statistics = threaded.statistics();
+    EXPECT_THAT(statistics.events, Eq(3u));
+    EXPECT_THAT(statistics.max_depth, Eq(3u));
+    EXPECT_THAT(statistics.full, Eq(0u));
+    EXPECT_THAT(statistics.queued.max, Gt(std::chrono::nanoseconds{0}));
+    EXPECT_THAT(statistics.dispatch.max, Gt(std::chrono::nanoseconds{0}));
+}
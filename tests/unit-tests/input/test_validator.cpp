@@ -260,3 +260,50 @@ TEST_F(Validator, up_and_down_inserted_when_id_changes)
     rewriter.validate_and_dispatch(*touch_1);
     rewriter.validate_and_dispatch(*touch_2);
 }
+
+TEST_F(Validator, max_contacts_touches_pass_through_unchanged)
+{
+    auto touch_1 = make_touch(0, mir_touch_action_down);
+    auto touch_2 = make_touch(0, mir_touch_action_change);
+    for (MirTouchId id = 1; id != static_cast<MirTouchId>(mi::Validator::max_contacts); ++id)
+    {
+        add_another_touch(touch_1, id, mir_touch_action_down);
+        add_another_touch(touch_2, id, mir_touch_action_change);
+    }
+
+    InSequence seq;
+    EXPECT_CALL(input_sink, handle(mt::MirTouchEventMatches(touch_1.get())));
+    EXPECT_CALL(input_sink, handle(mt::MirTouchEventMatches(touch_2.get())));
+
+    rewriter.validate_and_dispatch(*touch_1);
+    rewriter.validate_and_dispatch(*touch_2);
+}
+
+TEST_F(Validator, touches_beyond_max_contacts_are_dropped_when_the_event_is_built)
+{
+    auto const make_touches = [](MirTouchAction action)
+        {
+            std::vector<mev::ContactState> contacts;
+            for (MirTouchId id = 0; id != static_cast<MirTouchId>(mi::Validator::max_contacts + 1); ++id)
+                contacts.push_back({id, action, mir_touch_tooltype_finger, 0, 0, 0, 0, 0, 0});
+
+            return mev::make_event(MirInputDeviceId(0), std::chrono::nanoseconds(0),
+                                   std::vector<uint8_t>{}, mir_input_event_modifier_none, contacts);
+        };
+
+    auto touch_1 = make_touches(mir_touch_action_down);
+    auto touch_2 = make_touches(mir_touch_action_change);
+    add_another_touch(touch_2, mi::Validator::max_contacts + 1, mir_touch_action_change);
+
+    auto const touch_event = [](mir::EventUPtr const& ev)
+        { return mir_input_event_get_touch_event(mir_event_get_input_event(ev.get())); };
+    ASSERT_THAT(mir_touch_event_point_count(touch_event(touch_1)), Eq(mi::Validator::max_contacts));
+    ASSERT_THAT(mir_touch_event_point_count(touch_event(touch_2)), Eq(mi::Validator::max_contacts));
+
+    InSequence seq;
+    EXPECT_CALL(input_sink, handle(mt::MirTouchEventMatches(touch_1.get())));
+    EXPECT_CALL(input_sink, handle(mt::MirTouchEventMatches(touch_2.get())));
+
+    rewriter.validate_and_dispatch(*touch_1);
+    rewriter.validate_and_dispatch(*touch_2);
+}
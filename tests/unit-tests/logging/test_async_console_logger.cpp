@@ -0,0 +1,283 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/logging/async_console_logger.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace ml = mir::logging;
+using namespace testing;
+
+namespace
+{
+struct TemporaryFile
+{
+    TemporaryFile() : file{tmpfile()}, fd{fileno(file)} {}
+    ~TemporaryFile() { fclose(file); }
+
+    std::string contents() const
+    {
+        std::string result;
+        char buffer[4096];
+        ssize_t n;
+        for (off_t offset = 0; (n = pread(fd, buffer, sizeof buffer, offset)) > 0; offset += n)
+            result.append(buffer, n);
+        return result;
+    }
+
+    std::vector<std::string> lines() const
+    {
+        std::vector<std::string> result;
+        std::istringstream in{contents()};
+        for (std::string line; std::getline(in, line);)
+            result.push_back(line);
+        return result;
+    }
+
+    FILE* const file;
+    int const fd;
+};
+
+// The text after the timestamp
+std::string without_timestamp(std::string const& line)
+{
+    auto const end = line.find("] ");
+    return end == std::string::npos ? line : line.substr(end + 2);
+}
+
+struct AsyncConsoleLogger : Test
+{
+    TemporaryFile out;
+    TemporaryFile err;
+    std::unique_ptr<ml::AsyncConsoleLogger> logger =
+        std::make_unique<ml::AsyncConsoleLogger>(ml::AsyncConsoleLogger::default_buffer_size, out.fd, err.fd);
+
+    std::string last_message()
+    {
+        logger->flush();
+        auto const lines = out.lines();
+        return lines.empty() ? "" : without_timestamp(lines.back());
+    }
+};
+}
+
+TEST_F(AsyncConsoleLogger, writes_lines_like_dumb_console_logger)
+{
+    logger->log(ml::Severity::informational, "Hello, world", "component");
+    logger->flush();
+
+    auto const lines = out.lines();
+    ASSERT_THAT(lines.size(), Eq(1u));
+    EXPECT_THAT(lines[0], MatchesRegex(
+        "\\[[0-9]{4}-[0-9]{2}-[0-9]{2} [0-9]{2}:[0-9]{2}:[0-9]{2}\\.[0-9]{6}\\] component: Hello, world"));
+}
+
+TEST_F(AsyncConsoleLogger, writes_warnings_and_errors_to_err_with_severity)
+{
+    logger->log(ml::Severity::critical, "a", "c");
+    logger->log(ml::Severity::error, "b", "c");
+    logger->log(ml::Severity::warning, "c", "c");
+    logger->log(ml::Severity::informational, "d", "c");
+    logger->log(ml::Severity::debug, "e", "c");
+    logger->flush();
+
+    std::vector<std::string> err_lines, out_lines;
+    for (auto const& line : err.lines())
+        err_lines.push_back(without_timestamp(line));
+    for (auto const& line : out.lines())
+        out_lines.push_back(without_timestamp(line));
+
+    EXPECT_THAT(err_lines, ElementsAre("<CRITICAL> c: a", "<ERROR> c: b", "<WARNING> c: c"));
+    EXPECT_THAT(out_lines, ElementsAre("c: d", "<DEBUG> c: e"));
+}
+
+#define EXPECT_LOGS_LIKE_SNPRINTF(...) \
+    { \
+        char expected[1024]; \
+        snprintf(expected, sizeof expected, __VA_ARGS__); \
+        logger->log("component", ml::Severity::informational, __VA_ARGS__); \
+        EXPECT_THAT(last_message(), Eq(std::string{"component: "} + expected)); \
+    }
+
+TEST_F(AsyncConsoleLogger, formats_deferred_messages_like_snprintf)
+{
+    int const i{-42};
+    unsigned const u{0xdeadbeef};
+    char const* const s{"string"};
+    void const* const p{&i};
+
+    EXPECT_LOGS_LIKE_SNPRINTF("no conversions");
+    EXPECT_LOGS_LIKE_SNPRINTF("%d %i %u %x %X %o %%", i, i, u, u, u, u);
+    EXPECT_LOGS_LIKE_SNPRINTF("%hhd %hhu %hx %hd", i, i, i, i);
+    EXPECT_LOGS_LIKE_SNPRINTF("%ld %lu %lld %llx %zu %zd %jd %td",
+        -1L, 2UL, -3LL, 4ULL, size_t{5}, ssize_t{-6}, intmax_t{7}, ptrdiff_t{-8});
+    EXPECT_LOGS_LIKE_SNPRINTF("[%-8d] [%+08d] [% d] [%#x] [%#o]", i, i, 7, u, u);
+    EXPECT_LOGS_LIKE_SNPRINTF("%f %.3f %10.2e %g %G %a %lf", 3.14159, 2.71828, 1e-7, 1e20, 1e-20, 0.5, 1.0);
+    EXPECT_LOGS_LIKE_SNPRINTF("[%s] [%10s] [%-10s] [%.3s] [%c]", s, s, s, s, 'x');
+    EXPECT_LOGS_LIKE_SNPRINTF("[%*d] [%-*d] [%.*f] [%*.*s]", 6, i, 6, i, 2, 3.14159, 8, 3, s);
+    EXPECT_LOGS_LIKE_SNPRINTF("%p %p", p, static_cast<void*>(nullptr));
+    EXPECT_LOGS_LIKE_SNPRINTF("%s", std::string(1000, 'x').c_str());
+}
+
+TEST_F(AsyncConsoleLogger, copies_string_arguments_when_logged)
+{
+    char s[] = "before";
+    logger->log("component", ml::Severity::informational, "%s", s);
+    strcpy(s, "after");
+
+    EXPECT_THAT(last_message(), Eq("component: before"));
+}
+
+TEST_F(AsyncConsoleLogger, copies_only_the_precision_of_a_string)
+{
+    char unterminated[3] = {'a', 'b', 'c'};
+    logger->log("component", ml::Severity::informational, "%.3s", unterminated);
+
+    EXPECT_THAT(last_message(), Eq("component: abc"));
+}
+
+TEST_F(AsyncConsoleLogger, formats_errno_when_logged)
+{
+    // Not a literal, as %m is a GNU extension
+    std::string const format{"%s: %m"};
+
+    errno = ENOENT;
+    logger->log("component", ml::Severity::informational, format.c_str(), "open");
+    errno = 0;
+
+    EXPECT_THAT(last_message(), Eq(std::string{"component: open: "} + strerror(ENOENT)));
+}
+
+TEST_F(AsyncConsoleLogger, formats_messages_it_cannot_defer_when_logged)
+{
+    // Not a literal, as positional arguments are a POSIX extension
+    std::string const positional{"%2$s %1$s"};
+
+    EXPECT_LOGS_LIKE_SNPRINTF(positional.c_str(), "world", "hello");
+    EXPECT_LOGS_LIKE_SNPRINTF("%ls", L"wide");
+    EXPECT_LOGS_LIKE_SNPRINTF("%.1Lf", 1.25L);
+}
+
+TEST_F(AsyncConsoleLogger, writes_messages_from_each_thread_in_order)
+{
+    int const nthreads{4};
+    int const nmessages{500};
+
+    logger = std::make_unique<ml::AsyncConsoleLogger>(1024 * 1024, out.fd, err.fd);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t != nthreads; ++t)
+    {
+        threads.emplace_back([this, t]
+            {
+                for (int m = 0; m != nmessages; ++m)
+                    logger->log("thread", ml::Severity::informational, "%d %d", t, m);
+            });
+    }
+    for (auto& thread : threads)
+        thread.join();
+    logger->flush();
+
+    std::vector<int> next(nthreads, 0);
+    for (auto const& line : out.lines())
+    {
+        int t, m;
+        ASSERT_THAT(sscanf(without_timestamp(line).c_str(), "thread: %d %d", &t, &m), Eq(2));
+        EXPECT_THAT(m, Eq(next[t]++));
+    }
+
+    EXPECT_THAT(next, Each(Eq(nmessages)));
+    EXPECT_THAT(logger->dropped(), Eq(0u));
+}
+
+TEST_F(AsyncConsoleLogger, writes_messages_from_threads_that_have_exited)
+{
+    std::thread{[this] { logger->log(ml::Severity::informational, "goodbye", "thread"); }}.join();
+
+    EXPECT_THAT(last_message(), Eq("thread: goodbye"));
+}
+
+TEST_F(AsyncConsoleLogger, writes_pending_messages_when_destroyed)
+{
+    for (int i = 0; i != 100; ++i)
+        logger->log("component", ml::Severity::informational, "%d", i);
+    logger.reset();
+
+    EXPECT_THAT(out.lines().size(), Eq(100u));
+}
+
+TEST_F(AsyncConsoleLogger, drops_and_counts_messages_when_the_writer_falls_behind)
+{
+    int pipe_fds[2];
+    ASSERT_THAT(pipe(pipe_fds), Eq(0));
+    fcntl(pipe_fds[1], F_SETPIPE_SZ, 4096);
+
+    logger = std::make_unique<ml::AsyncConsoleLogger>(8192, pipe_fds[1], err.fd);
+
+    // More than the pipe holds, so the writer blocks until we read
+    logger->log(ml::Severity::informational, std::string(6000, 'x'), "big");
+
+    int const nmessages{1000};
+    for (int i = 0; i != nmessages; ++i)
+        logger->log("small", ml::Severity::informational, "message %d", i);
+
+    std::string output;
+    std::thread reader{[&]
+        {
+            char buffer[4096];
+            ssize_t n;
+            while ((n = read(pipe_fds[0], buffer, sizeof buffer)) > 0)
+                output.append(buffer, n);
+        }};
+
+    logger->flush();
+    close(pipe_fds[1]);
+    reader.join();
+    close(pipe_fds[0]);
+
+    auto const dropped = logger->dropped();
+    EXPECT_THAT(dropped, Gt(0u));
+
+    std::istringstream in{output};
+    unsigned written{0};
+    for (std::string line; std::getline(in, line);)
+        if (line.find("small: message") != std::string::npos)
+            ++written;
+    EXPECT_THAT(written, Eq(nmessages - dropped));
+
+    // Drops are reported as the writer finds them, so may be split over lines
+    unsigned long long reported{0};
+    for (auto const& line : err.lines())
+    {
+        unsigned long long n;
+        ASSERT_THAT(sscanf(without_timestamp(line).c_str(), "<WARNING> logging: %llu messages dropped", &n), Eq(1));
+        reported += n;
+    }
+    EXPECT_THAT(reported, Eq(dropped));
+}
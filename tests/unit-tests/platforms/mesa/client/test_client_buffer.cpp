@@ -24,6 +24,7 @@
 #include "mir/test/doubles/mock_egl.h"
 
 #include <sys/mman.h>
+#include <unistd.h>
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
@@ -76,6 +77,30 @@ struct MesaClientBufferTest : public Test
 
 };
 
+// A pipe's read end polls readable once something is written: a stand-in
+// for a sync_file fence that signals on demand
+struct FakeFence
+{
+    FakeFence()
+    {
+        int fds[2];
+        if (pipe(fds) == 0)
+        {
+            fence = mir::Fd{fds[0]};
+            signaller = mir::Fd{fds[1]};
+        }
+    }
+
+    void signal()
+    {
+        char const c{0};
+        EXPECT_THAT(write(signaller, &c, 1), Eq(1));
+    }
+
+    mir::Fd fence;
+    mir::Fd signaller;
+};
+
 }
 
 TEST_F(MesaClientBufferTest, width_and_height)
@@ -192,6 +217,55 @@ TEST_F(MesaClientBufferTest, packs_empty_update_msg)
     EXPECT_THAT(msg.fd_items, Eq(0)); 
 }
 
+TEST_F(MesaClientBufferTest, writes_wait_for_server_release_fence)
+{
+    mclg::ClientBuffer buffer(buffer_file_ops, package, size, pf);
+    FakeFence release;
+
+    MirBufferPackage update{};
+    update.flags = mir_buffer_flag_fenced;
+    update.fd[0] = dup(release.fence);
+    update.fd_items = 1;
+    buffer.update_from(update);
+
+    EXPECT_TRUE(buffer.wait_for_access(mir_read, std::chrono::milliseconds{0}));
+    EXPECT_FALSE(buffer.wait_for_access(mir_read_write, std::chrono::milliseconds{0}));
+
+    release.signal();
+
+    EXPECT_TRUE(buffer.wait_for_access(mir_read_write, std::chrono::milliseconds{0}));
+    EXPECT_THAT(buffer.fence(), Eq(mir::Fd::invalid));
+}
+
+TEST_F(MesaClientBufferTest, packs_write_fence_in_update_msg)
+{
+    mclg::ClientBuffer buffer(buffer_file_ops, package, size, pf);
+    FakeFence acquire;
+    buffer.associate_fence(acquire.fence, mir_read_write);
+
+    MirBufferPackage msg{};
+    buffer.fill_update_msg(msg);
+
+    ASSERT_THAT(msg.fd_items, Eq(1));
+    mir::Fd const sent{msg.fd[0]};
+    EXPECT_THAT(msg.flags & mir_buffer_flag_fenced, Ne(0u));
+    EXPECT_THAT(static_cast<int>(sent), Ne(static_cast<int>(acquire.fence)));
+    EXPECT_THAT(buffer.fence(), Eq(mir::Fd::invalid));
+}
+
+TEST_F(MesaClientBufferTest, does_not_pack_read_fence_in_update_msg)
+{
+    mclg::ClientBuffer buffer(buffer_file_ops, package, size, pf);
+    FakeFence read;
+    buffer.associate_fence(read.fence, mir_read);
+
+    MirBufferPackage msg{};
+    buffer.fill_update_msg(msg);
+
+    EXPECT_THAT(msg.fd_items, Eq(0));
+    EXPECT_THAT(msg.flags & mir_buffer_flag_fenced, Eq(0u));
+}
+
 TEST_F(MesaClientBufferTest, suggests_dma_import)
 {
     static EGLint expected_image_attrs[] =
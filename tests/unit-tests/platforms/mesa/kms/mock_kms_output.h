@@ -58,6 +58,7 @@ struct MockKMSOutput : public graphics::mesa::KMSOutput
     }
     MOCK_METHOD1(schedule_page_flip_thunk, bool(graphics::mesa::FBHandle const*));
     MOCK_METHOD0(wait_for_page_flip, void());
+    MOCK_METHOD1(set_variable_refresh, void(bool));
 
     MOCK_CONST_METHOD0(last_frame, graphics::Frame());
 
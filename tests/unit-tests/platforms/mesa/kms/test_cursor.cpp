@@ -121,7 +121,8 @@ struct StubKMSDisplayConfiguration : public mgm::KMSDisplayConfiguration
                 mir_subpixel_arrangement_unknown,
                 {},
                 mir_output_gamma_unsupported,
-                {}
+                {},
+                false
             },
             {
                 mg::DisplayConfigurationOutputId{1},
@@ -146,7 +147,8 @@ struct StubKMSDisplayConfiguration : public mgm::KMSDisplayConfiguration
                 mir_subpixel_arrangement_unknown,
                 {},
                 mir_output_gamma_unsupported,
-                {}
+                {},
+                false
             },
             {
                 mg::DisplayConfigurationOutputId{2},
@@ -171,7 +173,8 @@ struct StubKMSDisplayConfiguration : public mgm::KMSDisplayConfiguration
                 mir_subpixel_arrangement_unknown,
                 {},
                 mir_output_gamma_unsupported,
-                {}
+                {},
+                false
             }}}
     {
         update();
@@ -269,7 +272,8 @@ struct StubCursorImage : public mg::CursorImage
 
     static void const* image_data;
 };
-void const* StubCursorImage::image_data = reinterpret_cast<void*>(&StubCursorImage::image_data);
+uint32_t const stub_cursor_pixels[64 * 64]{};
+void const* StubCursorImage::image_data = stub_cursor_pixels;
 
 // Those new cap flags are currently only available in drm/drm.h but not in
 // libdrm/drm.h nor in xf86drm.h. Additionally drm/drm.h is current c++ unfriendly
@@ -408,6 +412,32 @@ TEST_F(MesaCursorTest, show_cursor_writes_to_bo)
     cursor.show(image);
 }
 
+TEST_F(MesaCursorTest, show_cursor_does_not_rewrite_bo_with_the_same_image)
+{
+    using namespace testing;
+
+    StubCursorImage image;
+
+    EXPECT_CALL(mock_gbm, gbm_bo_write(_, _, _)).Times(1);
+    EXPECT_CALL(*output_container.outputs[0], set_cursor(_)).Times(AtLeast(2));
+
+    cursor.show(image);
+    cursor.show(image);
+}
+
+TEST_F(MesaCursorTest, show_cursor_rewrites_bo_with_a_new_image)
+{
+    using namespace testing;
+
+    StubCursorImage image;
+
+    EXPECT_CALL(mock_gbm, gbm_bo_write(_, _, _)).Times(3);
+
+    cursor.show(image);
+    cursor.show(SinglePixelCursorImage());
+    cursor.show(image);
+}
+
 // When we upload our 1x1 cursor we should upload a single white pixel and then transparency filling a 64x64 buffer.
 MATCHER_P(ContainsASingleWhitePixel, buffersize, "")
 {
@@ -127,6 +127,8 @@ public:
             platform->gbm,
             platform->vt,
             platform->bypass_option(),
+            mgm::VariableRefreshOption::prohibited,
+            mgm::RendererOption::gl,
             std::make_shared<mg::CloneDisplayConfigurationPolicy>(),
             std::make_shared<mtd::StubGLConfig>(),
             null_report);
@@ -554,6 +556,8 @@ TEST_F(MesaDisplayTest, successful_creation_of_display_reports_successful_setup_
                         platform->gbm,
                         platform->vt,
                         platform->bypass_option(),
+                        mgm::VariableRefreshOption::prohibited,
+                        mgm::RendererOption::gl,
                         std::make_shared<mg::CloneDisplayConfigurationPolicy>(),
                         std::make_shared<mtd::StubGLConfig>(),
                         mock_report);
@@ -820,6 +824,8 @@ TEST_F(MesaDisplayTest, respects_gl_config)
         platform->gbm,
         platform->vt,
         platform->bypass_option(),
+        mgm::VariableRefreshOption::prohibited,
+        mgm::RendererOption::gl,
         std::make_shared<mg::CloneDisplayConfigurationPolicy>(),
         mir::test::fake_shared(mock_gl_config),
         null_report};
@@ -850,6 +856,8 @@ TEST_F(MesaDisplayTest, supports_as_low_as_15bit_colour)
         platform->gbm,
         platform->vt,
         platform->bypass_option(),
+        mgm::VariableRefreshOption::prohibited,
+        mgm::RendererOption::gl,
         std::make_shared<mg::CloneDisplayConfigurationPolicy>(),
         mir::test::fake_shared(stub_gl_config),
         null_report};
@@ -152,6 +152,7 @@ TEST_F(MesaDisplayBufferTest, unrotated_view_area_is_untouched)
 {
     graphics::mesa::DisplayBuffer db(
         graphics::mesa::BypassOption::allowed,
+        graphics::mesa::VariableRefreshOption::prohibited,
         null_display_report(),
         {mock_kms_output},
         make_output_surface(),
@@ -165,6 +166,7 @@ TEST_F(MesaDisplayBufferTest, bypass_buffer_is_held_for_full_frame)
 {
     graphics::mesa::DisplayBuffer db(
         graphics::mesa::BypassOption::allowed,
+        graphics::mesa::VariableRefreshOption::prohibited,
         null_display_report(),
         {mock_kms_output},
         make_output_surface(),
@@ -189,6 +191,7 @@ TEST_F(MesaDisplayBufferTest, predictive_bypass_is_throttled)
 {
     graphics::mesa::DisplayBuffer db(
         graphics::mesa::BypassOption::allowed,
+        graphics::mesa::VariableRefreshOption::prohibited,
         null_display_report(),
         {mock_kms_output},
         make_output_surface(),
@@ -215,6 +218,7 @@ TEST_F(MesaDisplayBufferTest, frames_requiring_gl_are_not_throttled)
 
     graphics::mesa::DisplayBuffer db(
         graphics::mesa::BypassOption::allowed,
+        graphics::mesa::VariableRefreshOption::prohibited,
         null_display_report(),
         {mock_kms_output},
         make_output_surface(),
@@ -235,6 +239,7 @@ TEST_F(MesaDisplayBufferTest, bypass_buffer_only_referenced_once_by_db)
 {
     graphics::mesa::DisplayBuffer db(
         graphics::mesa::BypassOption::allowed,
+        graphics::mesa::VariableRefreshOption::prohibited,
         null_display_report(),
         {mock_kms_output},
         make_output_surface(),
@@ -256,6 +261,7 @@ TEST_F(MesaDisplayBufferTest, untransformed_with_bypassable_list_can_bypass)
 {
     graphics::mesa::DisplayBuffer db(
         graphics::mesa::BypassOption::allowed,
+        graphics::mesa::VariableRefreshOption::prohibited,
         null_display_report(),
         {mock_kms_output},
         make_output_surface(),
@@ -274,6 +280,7 @@ TEST_F(MesaDisplayBufferTest, failed_bypass_falls_back_gracefully)
 
     graphics::mesa::DisplayBuffer db(
         graphics::mesa::BypassOption::allowed,
+        graphics::mesa::VariableRefreshOption::prohibited,
         null_display_report(),
         {mock_kms_output},
         make_output_surface(),
@@ -299,6 +306,7 @@ TEST_F(MesaDisplayBufferTest, skips_bypass_because_of_lagging_resize)
 
     graphics::mesa::DisplayBuffer db(
         graphics::mesa::BypassOption::allowed,
+        graphics::mesa::VariableRefreshOption::prohibited,
         null_display_report(),
         {mock_kms_output},
         make_output_surface(),
@@ -312,6 +320,7 @@ TEST_F(MesaDisplayBufferTest, rotated_cannot_bypass)
 {
     graphics::mesa::DisplayBuffer db(
         graphics::mesa::BypassOption::allowed,
+        graphics::mesa::VariableRefreshOption::prohibited,
         null_display_report(),
         {mock_kms_output},
         make_output_surface(),
@@ -330,6 +339,7 @@ TEST_F(MesaDisplayBufferTest, fullscreen_software_buffer_cannot_bypass)
 
     graphics::mesa::DisplayBuffer db(
         graphics::mesa::BypassOption::allowed,
+        graphics::mesa::VariableRefreshOption::prohibited,
         null_display_report(),
         {mock_kms_output},
         make_output_surface(),
@@ -348,6 +358,7 @@ TEST_F(MesaDisplayBufferTest, fullscreen_software_buffer_not_used_as_gbm_bo)
 
     graphics::mesa::DisplayBuffer db(
         graphics::mesa::BypassOption::allowed,
+        graphics::mesa::VariableRefreshOption::prohibited,
         null_display_report(),
         {mock_kms_output},
         make_output_surface(),
@@ -366,6 +377,7 @@ TEST_F(MesaDisplayBufferTest, transformation_not_implemented_internally)
 
     graphics::mesa::DisplayBuffer db(
         graphics::mesa::BypassOption::allowed,
+        graphics::mesa::VariableRefreshOption::prohibited,
         null_display_report(),
         {mock_kms_output},
         make_output_surface(),
@@ -386,6 +398,7 @@ TEST_F(MesaDisplayBufferTest, clone_mode_first_flip_flips_but_no_wait)
 
     graphics::mesa::DisplayBuffer db(
         graphics::mesa::BypassOption::allowed,
+        graphics::mesa::VariableRefreshOption::prohibited,
         null_display_report(),
         {mock_kms_output, mock_kms_output},
         make_output_surface(),
@@ -405,6 +418,7 @@ TEST_F(MesaDisplayBufferTest, single_mode_first_post_flips_with_wait)
 
     graphics::mesa::DisplayBuffer db(
         graphics::mesa::BypassOption::allowed,
+        graphics::mesa::VariableRefreshOption::prohibited,
         null_display_report(),
         {mock_kms_output},
         make_output_surface(),
@@ -432,6 +446,7 @@ TEST_F(MesaDisplayBufferTest, clone_mode_waits_for_page_flip_on_second_flip)
 
     graphics::mesa::DisplayBuffer db(
         graphics::mesa::BypassOption::allowed,
+        graphics::mesa::VariableRefreshOption::prohibited,
         null_display_report(),
         {mock_kms_output, mock_kms_output},
         make_output_surface(),
@@ -454,6 +469,7 @@ TEST_F(MesaDisplayBufferTest, skips_bypass_because_of_incompatible_list)
 
     graphics::mesa::DisplayBuffer db(
         graphics::mesa::BypassOption::allowed,
+        graphics::mesa::VariableRefreshOption::prohibited,
         null_display_report(),
         {mock_kms_output},
         make_output_surface(),
@@ -479,6 +495,7 @@ TEST_F(MesaDisplayBufferTest, skips_bypass_because_of_incompatible_bypass_buffer
 
     graphics::mesa::DisplayBuffer db(
         graphics::mesa::BypassOption::allowed,
+        graphics::mesa::VariableRefreshOption::prohibited,
         null_display_report(),
         {mock_kms_output},
         make_output_surface(),
@@ -495,6 +512,7 @@ TEST_F(MesaDisplayBufferTest, buffer_requiring_migration_is_ineligable_for_bypas
 
     graphics::mesa::DisplayBuffer db(
         graphics::mesa::BypassOption::allowed,
+        graphics::mesa::VariableRefreshOption::prohibited,
         null_display_report(),
         {mock_kms_output},
         make_output_surface(),
@@ -503,3 +521,51 @@ TEST_F(MesaDisplayBufferTest, buffer_requiring_migration_is_ineligable_for_bypas
 
     EXPECT_FALSE(db.overlay(bypassable_list));
 }
+
+TEST_F(MesaDisplayBufferTest, refresh_follows_bypassed_frames_when_variable_refresh_is_allowed)
+{
+    graphics::mesa::DisplayBuffer db(
+        graphics::mesa::BypassOption::allowed,
+        graphics::mesa::VariableRefreshOption::allowed,
+        null_display_report(),
+        {mock_kms_output},
+        make_output_surface(),
+        display_area,
+        {});
+
+    {
+        InSequence s;
+        EXPECT_CALL(*mock_kms_output, set_variable_refresh(true));
+        EXPECT_CALL(*mock_kms_output, schedule_page_flip_thunk(_))
+            .WillOnce(Return(true));
+        EXPECT_CALL(*mock_kms_output, set_variable_refresh(false));
+        EXPECT_CALL(*mock_kms_output, schedule_page_flip_thunk(_))
+            .WillOnce(Return(true));
+    }
+
+    ASSERT_TRUE(db.overlay(bypassable_list));
+    db.post();
+
+    // Back to compositing
+    graphics::RenderableList const composited_list{fake_software_renderable};
+    ASSERT_FALSE(db.overlay(composited_list));
+    db.swap_buffers();
+    db.post();
+}
+
+TEST_F(MesaDisplayBufferTest, refresh_rate_is_fixed_unless_variable_refresh_is_allowed)
+{
+    graphics::mesa::DisplayBuffer db(
+        graphics::mesa::BypassOption::allowed,
+        graphics::mesa::VariableRefreshOption::prohibited,
+        null_display_report(),
+        {mock_kms_output},
+        make_output_surface(),
+        display_area,
+        {});
+
+    EXPECT_CALL(*mock_kms_output, set_variable_refresh(_)).Times(0);
+
+    ASSERT_TRUE(db.overlay(bypassable_list));
+    db.post();
+}
@@ -300,7 +300,8 @@ TEST_F(MesaDisplayConfigurationTest, configuration_is_read_correctly)
             mir_subpixel_arrangement_unknown,
             {},
             mir_output_gamma_unsupported,
-            {}
+            {},
+            false
         },
         {
             mg::DisplayConfigurationOutputId{0},
@@ -322,7 +323,8 @@ TEST_F(MesaDisplayConfigurationTest, configuration_is_read_correctly)
             mir_subpixel_arrangement_unknown,
             {},
             mir_output_gamma_unsupported,
-            {}
+            {},
+            false
         },
         {
             mg::DisplayConfigurationOutputId{0},
@@ -344,7 +346,8 @@ TEST_F(MesaDisplayConfigurationTest, configuration_is_read_correctly)
             mir_subpixel_arrangement_unknown,
             {},
             mir_output_gamma_unsupported,
-            {}
+            {},
+            false
         }
     };
 
@@ -577,7 +580,8 @@ TEST_F(MesaDisplayConfigurationTest, returns_updated_configuration)
             mir_subpixel_arrangement_unknown,
             {},
             mir_output_gamma_unsupported,
-            {}
+            {},
+            false
         },
         {
             mg::DisplayConfigurationOutputId{0},
@@ -599,7 +603,8 @@ TEST_F(MesaDisplayConfigurationTest, returns_updated_configuration)
             mir_subpixel_arrangement_unknown,
             {},
             mir_output_gamma_unsupported,
-            {}
+            {},
+            false
         },
     };
 
@@ -625,7 +630,8 @@ TEST_F(MesaDisplayConfigurationTest, returns_updated_configuration)
             mir_subpixel_arrangement_unknown,
             {},
             mir_output_gamma_unsupported,
-            {}
+            {},
+            false
         },
         {
             mg::DisplayConfigurationOutputId{0},
@@ -647,7 +653,8 @@ TEST_F(MesaDisplayConfigurationTest, returns_updated_configuration)
             mir_subpixel_arrangement_unknown,
             {},
             mir_output_gamma_unsupported,
-            {}
+            {},
+            false
         },
     };
 
@@ -794,7 +801,8 @@ TEST_F(MesaDisplayConfigurationTest, new_monitor_matches_hardware_state)
             mir_subpixel_arrangement_unknown,
             {},
             mir_output_gamma_unsupported,
-            {}
+            {},
+            false
         },
     };
 
@@ -822,7 +830,8 @@ TEST_F(MesaDisplayConfigurationTest, new_monitor_matches_hardware_state)
             mir_subpixel_arrangement_unknown,
             {},
             mir_output_gamma_unsupported,
-            {}
+            {},
+            false
         },
     };
 
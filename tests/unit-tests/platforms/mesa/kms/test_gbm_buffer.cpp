@@ -27,6 +27,8 @@
 #include "src/platforms/mesa/server/gbm_buffer.h"
 #include "src/platforms/mesa/include/native_buffer.h"
 #include "src/platforms/mesa/server/buffer_allocator.h"
+#include "src/platforms/mesa/server/native_fence_ops.h"
+#include "src/platforms/common/server/buffer_texture_binder.h"
 #include "mir/graphics/buffer_properties.h"
 #include "mir/test/doubles/null_emergency_cleanup.h"
 #include "src/server/report/null_report_factory.h"
@@ -37,6 +39,7 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
+#include <fcntl.h>
 #include <cstdint>
 #include <stdexcept>
 
@@ -46,6 +49,26 @@ namespace geom=mir::geometry;
 namespace mtd=mir::test::doubles;
 namespace mtf=mir_test_framework;
 
+namespace
+{
+struct MockFenceOps : mgm::NativeFenceOps
+{
+    MOCK_METHOD1(wait_in_command_stream, bool(mir::Fd const&));
+    MOCK_METHOD0(fence_for_issued_commands, mir::Fd());
+    MOCK_METHOD2(merge, mir::Fd(mir::Fd const&, mir::Fd const&));
+};
+
+struct StubTextureBinder : mg::common::BufferTextureBinder
+{
+    void gl_bind_to_texture() override {}
+};
+
+mir::Fd fake_fence()
+{
+    return mir::Fd{::open("/dev/null", O_RDONLY)};
+}
+}
+
 class GBMBufferTest : public ::testing::Test
 {
 protected:
@@ -87,6 +110,18 @@ protected:
         return dynamic_cast<mir::renderer::gl::TextureSource*>(buffer->native_buffer_base());
     }
 
+    std::unique_ptr<mgm::GBMBuffer> buffer_with_fence_ops()
+    {
+        return std::make_unique<mgm::GBMBuffer>(
+            std::shared_ptr<gbm_bo>{mock_gbm.fake_gbm.bo, [](gbm_bo*){}},
+            GBM_BO_USE_RENDERING,
+            std::make_unique<StubTextureBinder>(),
+            fence_ops);
+    }
+
+    std::shared_ptr<testing::NiceMock<MockFenceOps>> const fence_ops{
+        std::make_shared<testing::NiceMock<MockFenceOps>>()};
+
     ::testing::NiceMock<mtd::MockDRM> mock_drm;
     ::testing::NiceMock<mtd::MockGBM> mock_gbm;
     ::testing::NiceMock<mtd::MockEGL> mock_egl;
@@ -238,3 +273,105 @@ TEST_F(GBMBufferTest, gl_bind_to_texture_uses_egl_image)
         as_texture_source(buffer)->gl_bind_to_texture();
     });
 }
+
+TEST_F(GBMBufferTest, binding_waits_for_acquire_fence_in_every_context)
+{
+    using namespace testing;
+
+    auto const fence = fake_fence();
+    auto const buffer = buffer_with_fence_ops();
+    buffer->set_acquire_fence(fence);
+
+    EXPECT_CALL(*fence_ops, wait_in_command_stream(Eq(fence)))
+        .Times(2);
+
+    buffer->gl_bind_to_texture();
+    buffer->gl_bind_to_texture();
+}
+
+TEST_F(GBMBufferTest, binding_does_not_wait_once_acquire_fence_is_cleared)
+{
+    using namespace testing;
+
+    auto const buffer = buffer_with_fence_ops();
+    buffer->set_acquire_fence(fake_fence());
+    buffer->set_acquire_fence(mir::Fd{});
+
+    EXPECT_CALL(*fence_ops, wait_in_command_stream(Eq(mir::Fd::invalid)));
+
+    buffer->gl_bind_to_texture();
+}
+
+TEST_F(GBMBufferTest, is_not_secured_for_render_if_acquire_fence_does_not_signal_in_time)
+{
+    using namespace testing;
+
+    auto const fence = fake_fence();
+    auto const buffer = buffer_with_fence_ops();
+    buffer->set_acquire_fence(fence);
+
+    EXPECT_CALL(*fence_ops, wait_in_command_stream(Eq(fence)))
+        .WillOnce(Return(false))
+        .WillOnce(Return(true));
+
+    EXPECT_FALSE(buffer->secure_for_render());
+    EXPECT_TRUE(buffer->secure_for_render());
+}
+
+TEST_F(GBMBufferTest, release_fences_from_each_render_are_merged_and_taken_once)
+{
+    using namespace testing;
+
+    auto const first = fake_fence();
+    auto const second = fake_fence();
+    auto const merged = fake_fence();
+    auto const buffer = buffer_with_fence_ops();
+
+    EXPECT_CALL(*fence_ops, fence_for_issued_commands())
+        .WillOnce(Return(first))
+        .WillOnce(Return(second));
+    EXPECT_CALL(*fence_ops, merge(Eq(mir::Fd::invalid), Eq(first)))
+        .WillOnce(Return(first));
+    EXPECT_CALL(*fence_ops, merge(Eq(first), Eq(second)))
+        .WillOnce(Return(merged));
+
+    buffer->rendering_finished();
+    buffer->rendering_finished();
+
+    EXPECT_THAT(static_cast<int>(buffer->take_release_fence()), Eq(static_cast<int>(merged)));
+    EXPECT_THAT(static_cast<int>(buffer->take_release_fence()), Eq(static_cast<int>(mir::Fd::invalid)));
+}
+
+TEST_F(GBMBufferTest, rendering_without_native_fence_support_leaves_no_release_fence)
+{
+    using namespace testing;
+
+    auto const buffer = buffer_with_fence_ops();
+
+    ON_CALL(*fence_ops, fence_for_issued_commands())
+        .WillByDefault(Return(mir::Fd{}));
+    EXPECT_CALL(*fence_ops, merge(_, _))
+        .Times(0);
+
+    buffer->rendering_finished();
+
+    EXPECT_THAT(static_cast<int>(buffer->take_release_fence()), Eq(static_cast<int>(mir::Fd::invalid)));
+}
+
+TEST_F(GBMBufferTest, submission_discards_release_fence_not_taken_before)
+{
+    using namespace testing;
+
+    auto const stale = fake_fence();
+    auto const buffer = buffer_with_fence_ops();
+
+    ON_CALL(*fence_ops, fence_for_issued_commands())
+        .WillByDefault(Return(stale));
+    ON_CALL(*fence_ops, merge(_, _))
+        .WillByDefault(Return(stale));
+
+    buffer->rendering_finished();
+    buffer->set_acquire_fence(fake_fence());
+
+    EXPECT_THAT(static_cast<int>(buffer->take_release_fence()), Eq(static_cast<int>(mir::Fd::invalid)));
+}
@@ -18,7 +18,10 @@
 
 #include "src/platforms/mesa/server/ipc_operations.h"
 #include "src/platforms/mesa/server/drm_authentication.h"
+#include "src/platforms/mesa/server/gbm_buffer.h"
+#include "src/platforms/mesa/server/native_fence_ops.h"
 #include "src/platforms/mesa/include/native_buffer.h"
+#include "src/platforms/common/server/buffer_texture_binder.h"
 #include "mir/graphics/platform_ipc_package.h"
 #include "mir/graphics/platform_operation_message.h"
 #include "mir_toolkit/mesa/platform_operation.h"
@@ -29,8 +32,10 @@
 #include "mir/test/doubles/mock_buffer_ipc_message.h"
 #include "mir/test/doubles/fd_matcher.h"
 #include "mir/test/doubles/mock_drm.h"
+#include "mir/test/doubles/mock_gbm.h"
 #include <gtest/gtest.h>
 
+#include <fcntl.h>
 #include <cstring>
 
 namespace mg = mir::graphics;
@@ -48,6 +53,20 @@ struct MockDRMOperations : public mgm::DRMAuthentication
     MOCK_METHOD0(authenticated_fd, mir::Fd());
 };
 
+struct StubFenceOps : public mgm::NativeFenceOps
+{
+    bool wait_in_command_stream(mir::Fd const& fence) override { waited_on = fence; return true; }
+    mir::Fd fence_for_issued_commands() override { return mir::Fd{::open("/dev/null", O_RDONLY)}; }
+    mir::Fd merge(mir::Fd const&, mir::Fd const& second) override { return second; }
+
+    int waited_on{mir::Fd::invalid};
+};
+
+struct StubTextureBinder : public mg::common::BufferTextureBinder
+{
+    void gl_bind_to_texture() override {}
+};
+
 struct IpcOperations : public ::testing::Test
 {
     IpcOperations()
@@ -75,6 +94,13 @@ struct IpcOperations : public ::testing::Test
     geom::Stride dummy_stride{4390};
     geom::Size dummy_size{123, 345};
     ::testing::NiceMock<mtd::MockDRM> mock_drm;
+    ::testing::NiceMock<mtd::MockGBM> mock_gbm;
+    std::shared_ptr<StubFenceOps> const fence_ops{std::make_shared<StubFenceOps>()};
+    mgm::GBMBuffer gbm_buffer{
+        std::shared_ptr<gbm_bo>{mock_gbm.fake_gbm.bo, [](gbm_bo*){}},
+        GBM_BO_USE_RENDERING,
+        std::make_unique<StubTextureBinder>(),
+        fence_ops};
 };
 }
 
@@ -97,6 +123,55 @@ TEST_F(IpcOperations, packs_buffer_correctly)
     ipc_ops.pack_buffer(mock_buffer_msg, mock_buffer, mg::BufferIpcMsgType::update_msg);
 }
 
+TEST_F(IpcOperations, packs_release_fence_with_returned_buffer)
+{
+    using namespace testing;
+
+    gbm_buffer.rendering_finished();
+
+    mtd::MockBufferIpcMessage mock_buffer_msg;
+    EXPECT_CALL(mock_buffer_msg, pack_flags(mir_buffer_flag_fenced));
+    EXPECT_CALL(mock_buffer_msg, pack_fd(Ne(mir::Fd::invalid)));
+
+    ipc_ops.pack_buffer(mock_buffer_msg, gbm_buffer, mg::BufferIpcMsgType::update_msg);
+}
+
+TEST_F(IpcOperations, packs_nothing_with_returned_buffer_that_was_not_rendered)
+{
+    using namespace testing;
+
+    mtd::MockBufferIpcMessage mock_buffer_msg;
+    EXPECT_CALL(mock_buffer_msg, pack_flags(_)).Times(0);
+    EXPECT_CALL(mock_buffer_msg, pack_fd(_)).Times(0);
+
+    ipc_ops.pack_buffer(mock_buffer_msg, gbm_buffer, mg::BufferIpcMsgType::update_msg);
+}
+
+TEST_F(IpcOperations, takes_acquire_fence_from_fenced_submission)
+{
+    using namespace testing;
+
+    mir::Fd const fence{::open("/dev/null", O_RDONLY)};
+    NiceMock<mtd::MockBufferIpcMessage> fenced_msg;
+    ON_CALL(fenced_msg, flags())
+        .WillByDefault(Return(mir_buffer_flag_fenced));
+    ON_CALL(fenced_msg, fds())
+        .WillByDefault(Return(std::vector<mir::Fd>{fence}));
+
+    ipc_ops.unpack_buffer(fenced_msg, gbm_buffer);
+    gbm_buffer.gl_bind_to_texture();
+
+    // The message's fds are closed along with it, so the buffer keeps its own
+    EXPECT_THAT(fence_ops->waited_on, Ne(mir::Fd::invalid));
+    EXPECT_THAT(fence_ops->waited_on, Ne(static_cast<int>(fence)));
+
+    NiceMock<mtd::MockBufferIpcMessage> unfenced_msg;
+    ipc_ops.unpack_buffer(unfenced_msg, gbm_buffer);
+    gbm_buffer.gl_bind_to_texture();
+
+    EXPECT_THAT(fence_ops->waited_on, Eq(mir::Fd::invalid));
+}
+
 TEST_F(IpcOperations, calls_drm_auth_magic_for_auth_magic_operation)
 {
     using namespace testing;
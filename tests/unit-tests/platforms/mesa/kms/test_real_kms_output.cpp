@@ -19,12 +19,14 @@
 #include "src/platforms/mesa/server/kms/real_kms_output.h"
 #include "src/platforms/mesa/server/kms/page_flipper.h"
 #include "mir/fatal.h"
+#include "mir/graphics/display_configuration.h"
 
 #include "mir/test/fake_shared.h"
 
 #include "mir/test/doubles/mock_drm.h"
 #include "mir/test/doubles/mock_gbm.h"
 
+#include <cstring>
 #include <stdexcept>
 
 #include <gtest/gtest.h>
@@ -148,6 +150,27 @@ public:
         mock_drm.prepare(drm_device);
     }
 
+    void setup_variable_refresh_properties(uint64_t vrr_capable)
+    {
+        connector_prop_values[0] = vrr_capable;
+        connector_props = {1, connector_prop_ids, connector_prop_values};
+        crtc_props = {1, crtc_prop_ids, crtc_prop_values};
+
+        vrr_capable_prop.prop_id = connector_prop_ids[0];
+        strncpy(vrr_capable_prop.name, "vrr_capable", DRM_PROP_NAME_LEN);
+        vrr_enabled_prop.prop_id = crtc_prop_ids[0];
+        strncpy(vrr_enabled_prop.name, "VRR_ENABLED", DRM_PROP_NAME_LEN);
+
+        ON_CALL(mock_drm, drmModeObjectGetProperties(_, connector_ids[0], DRM_MODE_OBJECT_CONNECTOR))
+            .WillByDefault(Return(&connector_props));
+        ON_CALL(mock_drm, drmModeObjectGetProperties(_, crtc_ids[0], DRM_MODE_OBJECT_CRTC))
+            .WillByDefault(Return(&crtc_props));
+        ON_CALL(mock_drm, drmModeGetProperty(_, connector_prop_ids[0]))
+            .WillByDefault(Return(&vrr_capable_prop));
+        ON_CALL(mock_drm, drmModeGetProperty(_, crtc_prop_ids[0]))
+            .WillByDefault(Return(&vrr_enabled_prop));
+    }
+
     void append_fb_id(uint32_t fb_id)
     {
         EXPECT_CALL(mock_drm, drmModeAddFB2(_,_,_,_,_,_,_,_,_))
@@ -173,6 +196,15 @@ public:
     std::vector<uint32_t> const connector_ids;
     std::vector<uint32_t> possible_encoder_ids1;
     std::vector<uint32_t> possible_encoder_ids2;
+
+    uint32_t connector_prop_ids[1]{50};
+    uint64_t connector_prop_values[1]{0};
+    uint32_t crtc_prop_ids[1]{51};
+    uint64_t crtc_prop_values[1]{0};
+    drmModeObjectProperties connector_props{};
+    drmModeObjectProperties crtc_props{};
+    drmModePropertyRes vrr_capable_prop{};
+    drmModePropertyRes vrr_enabled_prop{};
 };
 
 }
@@ -305,6 +337,30 @@ TEST_F(RealKMSOutputTest, set_crtc_failure_is_handled_gracefully)
     }, std::runtime_error);
 }
 
+TEST_F(RealKMSOutputTest, setting_crtc_counts_as_a_frame_shown)
+{
+    using namespace testing;
+
+    uint32_t const fb_id{67};
+
+    setup_outputs_connected_crtc();
+    append_fb_id(fb_id);
+
+    mgm::RealKMSOutput output{
+        drm_fd,
+        mg::kms::get_connector(drm_fd, connector_ids[0]),
+        mt::fake_shared(mock_page_flipper)};
+
+    auto fb = output.fb_for(fake_bo);
+    auto const before = output.last_frame();
+
+    EXPECT_TRUE(output.set_crtc(*fb));
+
+    auto const after = output.last_frame();
+    EXPECT_THAT(after.msc, Eq(before.msc + 1));
+    EXPECT_THAT(after.ust.nanoseconds, Gt(before.ust.nanoseconds));
+}
+
 TEST_F(RealKMSOutputTest, clear_crtc_gets_crtc_if_none_is_current)
 {
     using namespace testing;
@@ -522,3 +578,167 @@ TEST_F(RealKMSOutputTest, drm_set_gamma_failure_does_not_throw)
 
     EXPECT_NO_THROW(output.set_gamma(gamma););
 }
+
+TEST_F(RealKMSOutputTest, reports_whether_connected_monitor_can_vary_its_refresh_rate)
+{
+    setup_outputs_connected_crtc();
+    setup_variable_refresh_properties(1);
+
+    mgm::RealKMSOutput output{
+        drm_fd,
+        mg::kms::get_connector(drm_fd, connector_ids[0]),
+        mt::fake_shared(null_page_flipper)};
+
+    mg::DisplayConfigurationOutput conf_output{};
+    output.update_from_hardware_state(conf_output);
+
+    EXPECT_TRUE(conf_output.variable_refresh_capable);
+}
+
+TEST_F(RealKMSOutputTest, enables_variable_refresh_on_crtc_of_capable_output_once)
+{
+    uint32_t const fb_id{67};
+
+    setup_outputs_connected_crtc();
+    setup_variable_refresh_properties(1);
+
+    {
+        InSequence s;
+        EXPECT_CALL(mock_drm, drmModeObjectSetProperty(
+            drm_fd, crtc_ids[0], DRM_MODE_OBJECT_CRTC, crtc_prop_ids[0], 1));
+        EXPECT_CALL(mock_drm, drmModeObjectSetProperty(
+            drm_fd, crtc_ids[0], DRM_MODE_OBJECT_CRTC, crtc_prop_ids[0], 0));
+    }
+
+    mgm::RealKMSOutput output{
+        drm_fd,
+        mg::kms::get_connector(drm_fd, connector_ids[0]),
+        mt::fake_shared(null_page_flipper)};
+
+    append_fb_id(fb_id);
+    auto fb = output.fb_for(fake_bo);
+    EXPECT_TRUE(output.set_crtc(*fb));
+
+    output.set_variable_refresh(true);
+    output.set_variable_refresh(true);
+    output.set_variable_refresh(false);
+    output.set_variable_refresh(false);
+}
+
+TEST_F(RealKMSOutputTest, disables_variable_refresh_before_letting_go_of_crtc)
+{
+    uint32_t const fb_id{67};
+
+    setup_outputs_connected_crtc();
+    setup_variable_refresh_properties(1);
+
+    mgm::RealKMSOutput output{
+        drm_fd,
+        mg::kms::get_connector(drm_fd, connector_ids[0]),
+        mt::fake_shared(null_page_flipper)};
+
+    append_fb_id(fb_id);
+    auto fb = output.fb_for(fake_bo);
+    EXPECT_TRUE(output.set_crtc(*fb));
+    output.set_variable_refresh(true);
+
+    EXPECT_CALL(mock_drm, drmModeObjectSetProperty(
+        drm_fd, crtc_ids[0], DRM_MODE_OBJECT_CRTC, crtc_prop_ids[0], 0));
+
+    output.reset();
+}
+
+TEST_F(RealKMSOutputTest, leaves_refresh_rate_of_incapable_output_alone)
+{
+    uint32_t const fb_id{67};
+
+    setup_outputs_connected_crtc();
+    setup_variable_refresh_properties(0);
+
+    EXPECT_CALL(mock_drm, drmModeObjectSetProperty(_, _, _, _, _)).Times(0);
+
+    mgm::RealKMSOutput output{
+        drm_fd,
+        mg::kms::get_connector(drm_fd, connector_ids[0]),
+        mt::fake_shared(null_page_flipper)};
+
+    append_fb_id(fb_id);
+    auto fb = output.fb_for(fake_bo);
+    EXPECT_TRUE(output.set_crtc(*fb));
+
+    output.set_variable_refresh(true);
+}
+
+TEST_F(RealKMSOutputTest, stops_asking_for_variable_refresh_the_kernel_refuses_until_reconfigured)
+{
+    uint32_t const fb_id{67};
+
+    setup_outputs_connected_crtc();
+    setup_variable_refresh_properties(1);
+
+    EXPECT_CALL(mock_drm, drmModeObjectSetProperty(_, _, _, _, _))
+        .WillOnce(Return(-EINVAL));
+
+    mgm::RealKMSOutput output{
+        drm_fd,
+        mg::kms::get_connector(drm_fd, connector_ids[0]),
+        mt::fake_shared(null_page_flipper)};
+
+    append_fb_id(fb_id);
+    auto fb = output.fb_for(fake_bo);
+    EXPECT_TRUE(output.set_crtc(*fb));
+
+    output.set_variable_refresh(true);
+    output.set_variable_refresh(false);
+    output.set_variable_refresh(true);
+
+    Mock::VerifyAndClearExpectations(&mock_drm);
+
+    // What the monitor supports hasn't changed, only whether we're trying
+    mg::DisplayConfigurationOutput conf_output{};
+    output.update_from_hardware_state(conf_output);
+    EXPECT_TRUE(conf_output.variable_refresh_capable);
+
+    EXPECT_CALL(mock_drm, drmModeObjectSetProperty(
+        drm_fd, crtc_ids[0], DRM_MODE_OBJECT_CRTC, crtc_prop_ids[0], 1));
+    EXPECT_CALL(mock_drm, drmModeObjectSetProperty(
+        drm_fd, crtc_ids[0], DRM_MODE_OBJECT_CRTC, crtc_prop_ids[0], 0))
+        .Times(AnyNumber());
+
+    output.configure(geom::Displacement{}, 0);
+    output.set_variable_refresh(true);
+}
+
+TEST_F(RealKMSOutputTest, retries_disabling_variable_refresh_the_kernel_refused_to_disable)
+{
+    uint32_t const fb_id{67};
+
+    setup_outputs_connected_crtc();
+    setup_variable_refresh_properties(1);
+
+    mgm::RealKMSOutput output{
+        drm_fd,
+        mg::kms::get_connector(drm_fd, connector_ids[0]),
+        mt::fake_shared(null_page_flipper)};
+
+    append_fb_id(fb_id);
+    auto fb = output.fb_for(fake_bo);
+    EXPECT_TRUE(output.set_crtc(*fb));
+    output.set_variable_refresh(true);
+
+    {
+        InSequence s;
+        EXPECT_CALL(mock_drm, drmModeObjectSetProperty(
+            drm_fd, crtc_ids[0], DRM_MODE_OBJECT_CRTC, crtc_prop_ids[0], 0))
+            .WillOnce(Return(-EBUSY));
+        EXPECT_CALL(mock_drm, drmModeObjectSetProperty(
+            drm_fd, crtc_ids[0], DRM_MODE_OBJECT_CRTC, crtc_prop_ids[0], 0))
+            .WillOnce(Return(0));
+    }
+
+    output.set_variable_refresh(false);
+    output.set_variable_refresh(false);
+
+    // The CRTC is forgotten here, but the one still varying its refresh isn't
+    output.reset();
+}
@@ -35,6 +35,9 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
+#include <string>
+#include <vector>
+
 namespace mg = mir::graphics;
 namespace mgn = mir::graphics::nested;
 namespace mgnd = mgn::detail;
@@ -149,6 +152,46 @@ struct MockNestedBuffer : StubNestedBuffer
 };
 
 
+struct RecordingHostConnection : mtd::StubHostConnection
+{
+    using mtd::StubHostConnection::StubHostConnection;
+
+    std::unique_ptr<mgn::HostChain> create_chain() const override
+    {
+        ++chains_created;
+        return mtd::StubHostConnection::create_chain();
+    }
+
+    std::unique_ptr<mgn::HostSurfaceSpec> create_surface_spec() override
+    {
+        struct RecordingSpec : mgn::HostSurfaceSpec
+        {
+            RecordingSpec(std::vector<std::string>& layers) : layers(layers) { layers.clear(); }
+            void add_chain(mgn::HostChain&, geom::Displacement disp, geom::Size size) override
+            {
+                add("chain", disp, size);
+            }
+            void add_stream(mgn::HostStream&, geom::Displacement disp, geom::Size size) override
+            {
+                add("stream", disp, size);
+            }
+            MirWindowSpec* handle() override { return nullptr; }
+
+            void add(std::string const& kind, geom::Displacement disp, geom::Size size)
+            {
+                layers.push_back(kind +
+                    " +" + std::to_string(disp.dx.as_int()) + "+" + std::to_string(disp.dy.as_int()) +
+                    " " + std::to_string(size.width.as_int()) + "x" + std::to_string(size.height.as_int()));
+            }
+            std::vector<std::string>& layers;
+        };
+        return std::make_unique<RecordingSpec>(spec_layers);
+    }
+
+    std::vector<std::string> spec_layers;
+    int mutable chains_created{0};
+};
+
 struct NestedDisplayBuffer : Test
 {
     NestedDisplayBuffer()
@@ -417,19 +460,19 @@ TEST_F(NestedDisplayBuffer, rejects_list_containing_buffers_with_different_size_
     EXPECT_FALSE(display_buffer->overlay(list));
 }
 
-/* Once we have synchronous MirWindow scene updates, we can probably
- * passthrough more than one renderable if needed
- */
-TEST_F(NestedDisplayBuffer, rejects_list_containing_multiple_onscreen_renderables)
+TEST_F(NestedDisplayBuffer, passes_through_multiple_onscreen_renderables_in_one_spec)
 {
-    StubNestedBuffer nested_buffer; 
-    geom::Rectangle small_rect { {0, 0}, { 5, 5 }};
+    RecordingHostConnection recording_connection{mt::fake_shared(host_surface)};
+    StubNestedBuffer nested_buffer1;
+    StubNestedBuffer nested_buffer2;
+    geom::Rectangle small_rect { {10, 20}, { 5, 5 }};
     mg::RenderableList list = {
-        std::make_shared<mtd::StubRenderable>(mt::fake_shared(nested_buffer), rectangle),
-        std::make_shared<mtd::StubRenderable>(mt::fake_shared(nested_buffer), small_rect) };
+        std::make_shared<mtd::StubRenderable>(mt::fake_shared(nested_buffer1), rectangle),
+        std::make_shared<mtd::StubRenderable>(mt::fake_shared(nested_buffer2), small_rect) };
 
-    auto display_buffer = create_display_buffer(host_connection);
-    EXPECT_FALSE(display_buffer->overlay(list));
+    auto display_buffer = create_display_buffer(mt::fake_shared(recording_connection));
+    EXPECT_TRUE(display_buffer->overlay(list));
+    EXPECT_THAT(recording_connection.spec_layers, ElementsAre("chain +0+0 1024x768", "chain +10+20 5x5"));
 }
 
 TEST_F(NestedDisplayBuffer, accepts_list_containing_multiple_renderables_with_fullscreen_on_top)
@@ -481,3 +524,72 @@ TEST_F(NestedDisplayBuffer, coordinates_clients_interval_setting_with_host)
     EXPECT_TRUE(display_buffer->overlay(
       { std::make_shared<mtd::IntervalZeroRenderable>(std::make_shared<StubNestedBuffer>(), rectangle) }));
 }
+
+TEST_F(NestedDisplayBuffer, overlays_top_of_scene_it_cannot_overlay_in_full)
+{
+    RecordingHostConnection recording_connection{mt::fake_shared(host_surface)};
+    StubNestedBuffer nested_buffer;
+    mtd::StubBuffer foreign_buffer(std::make_shared<FunkyBuffer>());
+    geom::Rectangle small_rect { {10, 20}, { 5, 5 }};
+    auto const composited = std::make_shared<mtd::StubRenderable>(mt::fake_shared(foreign_buffer), rectangle);
+    mg::RenderableList list = {
+        composited,
+        std::make_shared<mtd::StubRenderable>(mt::fake_shared(nested_buffer), small_rect) };
+
+    auto display_buffer = create_display_buffer(mt::fake_shared(recording_connection));
+    EXPECT_FALSE(display_buffer->overlay(list));
+    EXPECT_THAT(display_buffer->overlay_top(list), ElementsAre(composited));
+    EXPECT_THAT(recording_connection.spec_layers, IsEmpty());
+
+    display_buffer->swap_buffers();
+    EXPECT_THAT(recording_connection.spec_layers, ElementsAre("stream +0+0 1024x768", "chain +10+20 5x5"));
+}
+
+TEST_F(NestedDisplayBuffer, partial_overlay_stops_at_first_renderable_it_cannot_pass_through)
+{
+    StubNestedBuffer nested_buffer1;
+    StubNestedBuffer nested_buffer2;
+    mtd::StubBuffer foreign_buffer(std::make_shared<FunkyBuffer>());
+    geom::Rectangle small_rect { {10, 20}, { 5, 5 }};
+    mg::RenderableList list = {
+        std::make_shared<mtd::StubRenderable>(mt::fake_shared(nested_buffer1), small_rect),
+        std::make_shared<mtd::StubRenderable>(mt::fake_shared(foreign_buffer), small_rect),
+        std::make_shared<mtd::StubRenderable>(mt::fake_shared(nested_buffer2), small_rect) };
+
+    auto display_buffer = create_display_buffer(host_connection);
+    EXPECT_THAT(display_buffer->overlay_top(list), ElementsAre(list[0], list[1]));
+}
+
+TEST_F(NestedDisplayBuffer, partial_overlay_respects_passthrough_option)
+{
+    StubNestedBuffer nested_buffer;
+    geom::Rectangle small_rect { {10, 20}, { 5, 5 }};
+    mg::RenderableList list =
+        { std::make_shared<mtd::StubRenderable>(mt::fake_shared(nested_buffer), small_rect) };
+
+    auto display_buffer = create_display_buffer(host_connection, mgn::PassthroughOption::disabled);
+    EXPECT_THAT(display_buffer->overlay_top(list), ElementsAreArray(list));
+}
+
+TEST_F(NestedDisplayBuffer, keeps_a_chain_per_renderable_across_frames)
+{
+    RecordingHostConnection recording_connection{mt::fake_shared(host_surface)};
+    auto nested_buffer1 = std::make_shared<StubNestedBuffer>();
+    auto nested_buffer2 = std::make_shared<StubNestedBuffer>();
+    geom::Rectangle small_rect { {10, 20}, { 5, 5 }};
+    auto const bottom = std::make_shared<mtd::StubRenderable>(nested_buffer1, rectangle);
+    auto const top = std::make_shared<mtd::StubRenderable>(nested_buffer2, small_rect);
+    mg::RenderableList list = { bottom, top };
+
+    auto display_buffer = create_display_buffer(mt::fake_shared(recording_connection));
+    for (int frame = 0; frame != 3; ++frame)
+    {
+        EXPECT_TRUE(display_buffer->overlay(list));
+        nested_buffer1->trigger();
+        nested_buffer2->trigger();
+        bottom->set_buffer(nested_buffer1 = std::make_shared<StubNestedBuffer>());
+        top->set_buffer(nested_buffer2 = std::make_shared<StubNestedBuffer>());
+    }
+
+    EXPECT_THAT(recording_connection.chains_created, Eq(2));
+}
@@ -0,0 +1,287 @@
+/*
+ * Copyright © 2017 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/renderers/sw/renderer.h"
+#include "src/renderers/sw/blend.h"
+#include "mir/renderer/sw/pixel_target.h"
+#include "mir/thread/basic_thread_pool.h"
+
+#include "mir/test/doubles/stub_buffer.h"
+#include "mir/test/doubles/stub_renderable.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <cstring>
+#include <random>
+
+namespace mg = mir::graphics;
+namespace mrs = mir::renderer::software;
+namespace mtd = mir::test::doubles;
+namespace geom = mir::geometry;
+using namespace testing;
+
+namespace
+{
+unsigned mul255(unsigned x, unsigned y)
+{
+    return (x * y + 127) / 255;
+}
+
+struct FakePixelTarget : mrs::PixelTarget
+{
+    FakePixelTarget(geom::Size size) :
+        size{size},
+        pixels(size.width.as_int() * size.height.as_int(), 0xdeadbeef)
+    {
+    }
+
+    Pixels back_buffer() override
+    {
+        return {reinterpret_cast<unsigned char*>(pixels.data()), size,
+                geom::Stride{size.width.as_int() * 4}, mir_pixel_format_argb_8888, age};
+    }
+
+    void swap_buffers(geom::Rectangles const& damage) override
+    {
+        ++swaps;
+        last_damage = damage;
+        age = 1;
+    }
+
+    uint32_t& at(int x, int y)
+    {
+        return pixels[y * size.width.as_int() + x];
+    }
+
+    geom::Size const size;
+    std::vector<uint32_t> pixels;
+    unsigned age{0};
+    int swaps{0};
+    geom::Rectangles last_damage;
+};
+
+struct Renderable : mtd::StubRenderable
+{
+    Renderable(std::shared_ptr<mtd::StubBuffer> const& buffer, geom::Rectangle const& rect) :
+        StubRenderable(buffer, rect)
+    {
+    }
+
+    float alpha() const override { return opacity; }
+    bool shaped() const override { return has_alpha; }
+
+    float opacity{1.0f};
+    bool has_alpha{false};
+};
+
+std::shared_ptr<mtd::StubBuffer> filled_buffer(geom::Size size, MirPixelFormat format, uint32_t pixel)
+{
+    auto const buffer = std::make_shared<mtd::StubBuffer>(
+        mg::BufferProperties{size, format, mg::BufferUsage::software});
+    std::vector<uint32_t> pixels(size.width.as_int() * size.height.as_int(), pixel);
+    buffer->write(reinterpret_cast<unsigned char const*>(pixels.data()), pixels.size() * 4);
+    return buffer;
+}
+
+struct SoftwareRenderer : Test
+{
+    geom::Rectangle const screen{{0, 0}, {256, 192}};
+    FakePixelTarget target{screen.size};
+    mrs::Renderer renderer{target, std::make_shared<mir::thread::BasicThreadPool>(2), 4};
+
+    SoftwareRenderer()
+    {
+        renderer.set_viewport(screen);
+    }
+
+    std::shared_ptr<Renderable> renderable(geom::Rectangle const& rect, uint32_t pixel,
+                                           MirPixelFormat format = mir_pixel_format_argb_8888)
+    {
+        return std::make_shared<Renderable>(filled_buffer(rect.size, format, pixel), rect);
+    }
+};
+}
+
+TEST(SoftwareRendererBlending, premultiplied_blend_matches_reference)
+{
+    std::mt19937 random;
+    std::vector<uint8_t> src(4 * 37), dst(4 * 37);
+    for (auto& c : dst)
+        c = random();
+    for (size_t i = 0; i != src.size(); i += 4)
+    {
+        src[i + 3] = random();
+        for (int c = 0; c != 3; ++c)
+            src[i + c] = random() % (src[i + 3] + 1);
+    }
+
+    for (unsigned alpha : {255u, 200u, 0u})
+    {
+        auto expected = dst;
+        for (size_t i = 0; i != src.size(); i += 4)
+        {
+            auto const inverse = 255 - mul255(src[i + 3], alpha);
+            for (int c = 0; c != 4; ++c)
+                expected[i + c] = mul255(src[i + c], alpha) + mul255(dst[i + c], inverse);
+        }
+
+        auto actual = dst;
+        mrs::blend_premultiplied(src.data(), actual.data(), 37, alpha);
+
+        EXPECT_THAT(actual, ContainerEq(expected)) << "alpha=" << alpha << " kernels=" << mrs::blend_kernels();
+    }
+}
+
+TEST(SoftwareRendererBlending, constant_blend_matches_reference)
+{
+    std::mt19937 random;
+    std::vector<uint8_t> src(4 * 37), dst(4 * 37);
+    for (auto& c : src)
+        c = random();
+    for (auto& c : dst)
+        c = random();
+
+    for (unsigned alpha : {255u, 128u, 1u})
+    {
+        auto expected = dst;
+        for (size_t i = 0; i != src.size(); ++i)
+            expected[i] = mul255(src[i], alpha) + mul255(dst[i], 255 - alpha);
+
+        auto actual = dst;
+        mrs::blend_constant(src.data(), actual.data(), 37, alpha);
+
+        EXPECT_THAT(actual, ContainerEq(expected)) << "alpha=" << alpha << " kernels=" << mrs::blend_kernels();
+    }
+}
+
+TEST_F(SoftwareRenderer, draws_opaque_renderables_over_cleared_background)
+{
+    renderer.render({renderable({{10, 20}, {100, 50}}, 0xff123456)});
+
+    EXPECT_THAT(target.at(10, 20), Eq(0xff123456));
+    EXPECT_THAT(target.at(109, 69), Eq(0xff123456));
+    EXPECT_THAT(target.at(9, 20), Eq(0u));
+    EXPECT_THAT(target.at(110, 69), Eq(0u));
+    EXPECT_THAT(target.at(255, 191), Eq(0u));
+    EXPECT_THAT(target.swaps, Eq(1));
+}
+
+TEST_F(SoftwareRenderer, swaps_red_and_blue_of_abgr_buffers)
+{
+    renderer.render({renderable(screen, 0xff112233, mir_pixel_format_abgr_8888)});
+
+    EXPECT_THAT(target.at(0, 0), Eq(0xff332211));
+}
+
+TEST_F(SoftwareRenderer, draws_later_renderables_on_top)
+{
+    renderer.render({renderable(screen, 0xff0000ff), renderable({{64, 64}, {64, 64}}, 0xff00ff00)});
+
+    EXPECT_THAT(target.at(0, 0), Eq(0xff0000ffu));
+    EXPECT_THAT(target.at(64, 64), Eq(0xff00ff00u));
+    EXPECT_THAT(target.at(127, 127), Eq(0xff00ff00u));
+    EXPECT_THAT(target.at(128, 127), Eq(0xff0000ffu));
+}
+
+TEST_F(SoftwareRenderer, blends_shaped_renderables_as_premultiplied)
+{
+    auto const shaped = renderable(screen, 0x80400000);
+    shaped->has_alpha = true;
+
+    renderer.render({renderable(screen, 0xff0000ff), shaped});
+
+    EXPECT_THAT(target.at(100, 100), Eq(0xff40007fu));
+}
+
+TEST_F(SoftwareRenderer, fades_translucent_renderables_ignoring_their_alpha_channel)
+{
+    auto const faded = renderable(screen, 0x00ff0000);
+    faded->opacity = 0.5f;
+
+    renderer.render({renderable(screen, 0xff0000ff), faded});
+
+    EXPECT_THAT(target.at(100, 100), Eq(0x7f80007fu));
+}
+
+TEST_F(SoftwareRenderer, does_not_swap_unchanged_frames)
+{
+    mg::RenderableList const scene{renderable(screen, 0xff0000ff)};
+
+    renderer.render(scene);
+    renderer.render(scene);
+
+    EXPECT_THAT(target.swaps, Eq(1));
+}
+
+TEST_F(SoftwareRenderer, redraws_only_the_tiles_that_changed)
+{
+    auto const background = renderable(screen, 0xff0000ff);
+    auto const before = renderable({{0, 0}, {10, 10}}, 0xff00ff00);
+    renderer.render({background, before});
+
+    // Anything outside the damaged tiles should be left alone
+    target.at(255, 191) = 0x12345678;
+
+    auto const after = std::make_shared<Renderable>(
+        std::dynamic_pointer_cast<mtd::StubBuffer>(before->buffer()), geom::Rectangle{{20, 0}, {10, 10}});
+    renderer.render({background, after});
+
+    EXPECT_THAT(target.swaps, Eq(2));
+    EXPECT_THAT(target.at(0, 0), Eq(0xff0000ffu));
+    EXPECT_THAT(target.at(20, 0), Eq(0xff00ff00u));
+    EXPECT_THAT(target.at(255, 191), Eq(0x12345678u));
+}
+
+TEST_F(SoftwareRenderer, redraws_the_damage_of_frames_an_older_buffer_missed)
+{
+    auto const background = renderable(screen, 0xff0000ff);
+    auto const square = renderable({{200, 150}, {10, 10}}, 0xff00ff00);
+    renderer.render({background});
+    renderer.render({background, square});
+
+    // The buffer drawn next last held the first frame
+    target.at(200, 150) = 0x12345678;
+    target.age = 2;
+    renderer.render({background, square, renderable({{0, 0}, {10, 10}}, 0xffff0000)});
+
+    EXPECT_THAT(target.at(200, 150), Eq(0xff00ff00u));
+    EXPECT_THAT(target.at(0, 0), Eq(0xffff0000u));
+}
+
+TEST_F(SoftwareRenderer, redraws_everything_into_undefined_buffers)
+{
+    auto const background = renderable(screen, 0xff0000ff);
+    renderer.render({background});
+
+    target.at(255, 191) = 0x12345678;
+    target.age = 0;
+    renderer.render({background, renderable({{0, 0}, {10, 10}}, 0xffff0000)});
+
+    EXPECT_THAT(target.at(255, 191), Eq(0xff0000ffu));
+}
+
+TEST_F(SoftwareRenderer, reports_damage_from_restacking)
+{
+    auto const a = renderable({{0, 0}, {10, 10}}, 0xffff0000);
+    auto const b = renderable({{5, 5}, {10, 10}}, 0xff00ff00);
+    renderer.render({a, b});
+    renderer.render({b, a});
+
+    EXPECT_THAT(target.swaps, Eq(2));
+    EXPECT_THAT(target.at(5, 5), Eq(0xffff0000u));
+    EXPECT_THAT(target.last_damage.bounding_rectangle(), Eq(geom::Rectangle{{0, 0}, {15, 15}}));
+}
@@ -225,3 +225,57 @@ TEST_F(GLPixelBufferTest, returns_data_from_rgba_buffer_texture)
     EXPECT_EQ(width - 1,
               static_cast<uint32_t const*>(data)[width * height - 1]);
 }
+
+TEST_F(GLPixelBufferTest, downscales_on_the_gpu_to_fit_the_requested_size)
+{
+    using namespace testing;
+    GLuint const tex{10};
+    GLuint const scaled_tex{11};
+    uint32_t const width{20};
+    uint32_t const height{mock_buffer.size().height.as_uint32_t() * width / mock_buffer.size().width.as_uint32_t()};
+
+    EXPECT_CALL(mock_gl, glGenTextures(_,_))
+        .WillOnce(SetArgPointee<1>(tex))
+        .WillOnce(SetArgPointee<1>(scaled_tex));
+    EXPECT_CALL(mock_gl, glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, _));
+    {
+        InSequence s;
+
+        EXPECT_CALL(mock_buffer, gl_bind_to_texture());
+        EXPECT_CALL(mock_gl, glFramebufferTexture2D(_,_,_,scaled_tex,0));
+        EXPECT_CALL(mock_gl, glViewport(0, 0, width, height));
+        EXPECT_CALL(mock_gl, glDrawArrays(GL_TRIANGLE_STRIP, 0, 4));
+        EXPECT_CALL(mock_gl, glReadPixels(0, 0, width, height,
+                                          GL_BGRA_EXT, GL_UNSIGNED_BYTE, _))
+            .WillOnce(FillPixels());
+    }
+
+    ms::GLPixelBuffer pixels{std::move(context)};
+
+    pixels.fill_from(mock_buffer, geom::Size{width, 0});
+    auto data = static_cast<uint32_t const*>(pixels.as_argb_8888());
+
+    EXPECT_EQ((geom::Size{width, height}), pixels.size());
+    EXPECT_EQ(geom::Stride{width * 4}, pixels.stride());
+
+    /* The scaling pass already put the rows in order */
+    EXPECT_EQ(0, data[0]);
+    EXPECT_EQ(width * height - 1, data[width * height - 1]);
+}
+
+TEST_F(GLPixelBufferTest, does_not_scale_up_buffers_smaller_than_the_requested_size)
+{
+    using namespace testing;
+    uint32_t const width{mock_buffer.size().width.as_uint32_t()};
+    uint32_t const height{mock_buffer.size().height.as_uint32_t()};
+
+    EXPECT_CALL(mock_gl, glDrawArrays(_,_,_))
+        .Times(0);
+    EXPECT_CALL(mock_gl, glReadPixels(0, 0, width, height, _, GL_UNSIGNED_BYTE, _));
+
+    ms::GLPixelBuffer pixels{std::move(context)};
+
+    pixels.fill_from(mock_buffer, geom::Size{width * 2, height * 2});
+
+    EXPECT_EQ(mock_buffer.size(), pixels.size());
+}
@@ -840,6 +840,33 @@ TEST_F(SurfaceStack, occludes_surface_when_unregistering_all_compositors_that_re
     stack.unregister_compositor(compositor_id3);
 }
 
+TEST_F(SurfaceStack, surface_can_be_raised_from_a_visibility_change_caused_by_unregistering_a_compositor)
+{
+    using namespace testing;
+
+    mc::CompositorID const compositor_id2{&compositor_id};
+
+    stack.register_compositor(compositor_id);
+    stack.register_compositor(compositor_id2);
+
+    auto const mock_surface = std::make_shared<NiceMock<MockConfigureSurface>>();
+    stack.add_surface(mock_surface, default_params.input_mode);
+    stack.add_surface(stub_surface1, default_params.input_mode);
+
+    stack.scene_elements_for(compositor_id).front()->occluded();
+    stack.scene_elements_for(compositor_id2).front()->rendered();
+
+    std::weak_ptr<ms::Surface> const weak_surface{mock_surface};
+    EXPECT_CALL(*mock_surface, configure(mir_window_attrib_visibility, mir_window_visibility_occluded))
+        .WillOnce(InvokeWithoutArgs([&]{ stack.raise(weak_surface); return 0; }));
+
+    stack.unregister_compositor(compositor_id2);
+
+    auto const elements = stack.scene_elements_for(compositor_id);
+    ASSERT_THAT(elements.size(), Eq(2u));
+    EXPECT_THAT(elements.front(), SceneElementForStream(stub_buffer_stream1));
+}
+
 TEST_F(SurfaceStack, observer_can_trigger_state_change_within_notification)
 {
     using namespace ::testing;
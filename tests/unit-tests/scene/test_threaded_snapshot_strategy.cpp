@@ -49,6 +49,7 @@ public:
     ~MockPixelBuffer() noexcept {}
 
     MOCK_METHOD1(fill_from, void(mg::Buffer& buffer));
+    MOCK_METHOD2(fill_from, void(mg::Buffer& buffer, geom::Size const& max_size));
     MOCK_METHOD0(as_argb_8888, void const*());
     MOCK_CONST_METHOD0(size, geom::Size());
     MOCK_CONST_METHOD0(stride, geom::Stride());
@@ -100,6 +101,31 @@ TEST_F(ThreadedSnapshotStrategyTest, takes_snapshot)
     EXPECT_EQ(pixels, snapshot.pixels);
 }
 
+TEST_F(ThreadedSnapshotStrategyTest, passes_requested_size_to_pixel_buffer)
+{
+    using namespace testing;
+
+    geom::Size const max_size{256, 0};
+
+    NiceMock<MockPixelBuffer> pixel_buffer;
+
+    EXPECT_CALL(pixel_buffer, fill_from(Ref(*buffer_access.stub_compositor_buffer), max_size));
+
+    ms::ThreadedSnapshotStrategy strategy{mt::fake_shared(pixel_buffer)};
+
+    mt::Signal snapshot_taken;
+
+    strategy.take_snapshot_of(
+        mt::fake_shared(buffer_access),
+        max_size,
+        [&](ms::Snapshot const&)
+        {
+            snapshot_taken.raise();
+        });
+
+    EXPECT_TRUE(snapshot_taken.wait_for(std::chrono::seconds{5}));
+}
+
 TEST_F(ThreadedSnapshotStrategyTest, names_snapshot_thread)
 {
     using namespace testing;
@@ -469,3 +469,130 @@ TEST(TimeoutApplicationNotRespondingDetector, sends_pings_on_schedule_as_session
 
     EXPECT_THAT(ping_count, Ge(duration / cycle_time));
 }
+
+TEST(TimeoutApplicationNotRespondingDetector, does_not_ping_sessions_it_keeps_hearing_from)
+{
+    using namespace testing;
+    using namespace std::literals::chrono_literals;
+
+    mtd::FakeAlarmFactory fake_alarms;
+
+    ms::TimeoutApplicationNotRespondingDetector detector{fake_alarms, 1s};
+
+    NiceMock<mtd::MockSceneSession> busy_session, idle_session;
+    int busy_pings{0}, idle_pings{0};
+
+    detector.register_session(&busy_session, [&busy_pings]() { ++busy_pings; });
+    detector.register_session(&idle_session, [&idle_pings]() { ++idle_pings; });
+
+    auto const busy_session_activity = detector.activity_recorder(&busy_session);
+    for (int i = 0; i != 20; ++i)
+    {
+        busy_session_activity();
+        fake_alarms.advance_by(500ms);
+    }
+
+    EXPECT_THAT(busy_pings, Eq(0));
+    EXPECT_THAT(idle_pings, Gt(0));
+}
+
+TEST(TimeoutApplicationNotRespondingDetector, pings_session_once_quiet_for_a_whole_period)
+{
+    using namespace testing;
+    using namespace std::literals::chrono_literals;
+
+    mtd::FakeAlarmFactory fake_alarms;
+
+    ms::TimeoutApplicationNotRespondingDetector detector{fake_alarms, 1s};
+
+    NiceMock<mtd::MockSceneSession> session;
+    bool pinged{false};
+
+    detector.register_session(&session, [&pinged]() { pinged = true; });
+
+    fake_alarms.advance_by(500ms);
+    detector.activity_recorder(&session)();
+
+    // Not quiet for the whole of the first period...
+    fake_alarms.advance_by(501ms);
+    EXPECT_FALSE(pinged);
+
+    // ...but quiet for the whole of the second
+    fake_alarms.advance_by(1001ms);
+    EXPECT_TRUE(pinged);
+}
+
+TEST(TimeoutApplicationNotRespondingDetector, activity_from_unresponsive_session_marks_it_responsive)
+{
+    using namespace testing;
+    using namespace std::literals::chrono_literals;
+
+    mtd::FakeAlarmFactory fake_alarms;
+
+    ms::TimeoutApplicationNotRespondingDetector detector{fake_alarms, 1s};
+
+    NiceMock<mtd::MockSceneSession> session;
+    bool session_unresponsive{false};
+
+    auto observer = std::make_shared<NiceMock<MockObserver>>();
+    ON_CALL(*observer, session_unresponsive(_))
+        .WillByDefault(Invoke([&session_unresponsive](auto /*session*/)
+    {
+        session_unresponsive = true;
+    }));
+    ON_CALL(*observer, session_now_responsive(_))
+        .WillByDefault(Invoke([&session_unresponsive](auto /*session*/)
+    {
+        session_unresponsive = false;
+    }));
+    detector.register_observer(observer);
+
+    detector.register_session(&session, [](){});
+
+    fake_alarms.advance_smoothly_by(2002ms);
+    EXPECT_TRUE(session_unresponsive);
+
+    detector.activity_recorder(&session)();
+    EXPECT_FALSE(session_unresponsive);
+}
+
+TEST(TimeoutApplicationNotRespondingDetector, activity_after_a_ping_counts_as_a_reply)
+{
+    using namespace testing;
+    using namespace std::literals::chrono_literals;
+
+    mtd::FakeAlarmFactory fake_alarms;
+
+    ms::TimeoutApplicationNotRespondingDetector detector{fake_alarms, 1s};
+
+    NiceMock<mtd::MockSceneSession> session;
+    auto observer = std::make_shared<NiceMock<MockObserver>>();
+    EXPECT_CALL(*observer, session_unresponsive(_))
+        .Times(0);
+    detector.register_observer(observer);
+
+    int pings{0};
+    detector.register_session(&session, [&pings]() { ++pings; });
+
+    fake_alarms.advance_by(1001ms);
+    ASSERT_THAT(pings, Eq(1));
+
+    detector.activity_recorder(&session)();
+    fake_alarms.advance_by(1001ms);
+
+    EXPECT_THAT(pings, Eq(1));
+}
+
+TEST(TimeoutApplicationNotRespondingDetector, has_no_activity_recorder_for_unregistered_session)
+{
+    using namespace testing;
+    using namespace std::literals::chrono_literals;
+
+    mtd::FakeAlarmFactory fake_alarms;
+
+    ms::TimeoutApplicationNotRespondingDetector detector{fake_alarms, 1s};
+
+    NiceMock<mtd::MockSceneSession> session;
+
+    EXPECT_FALSE(detector.activity_recorder(&session));
+}
@@ -18,6 +18,7 @@
 
 #include "mir/shared_library_prober.h"
 
+#include "mir/test/doubles/mock_shared_library_prober_report.h"
 #include "mir_test_framework/executable_path.h"
 
 #include <stdlib.h>
@@ -30,19 +31,11 @@
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
+namespace mtd = mir::test::doubles;
 namespace mtf = mir_test_framework;
 
 namespace
 {
-class MockSharedLibraryProberReport : public mir::SharedLibraryProberReport
-{
-public:
-    MOCK_METHOD1(probing_path, void(boost::filesystem::path const&));
-    MOCK_METHOD2(probing_failed, void(boost::filesystem::path const&, std::exception const&));
-    MOCK_METHOD1(loading_library, void(boost::filesystem::path const&));
-    MOCK_METHOD2(loading_failed, void(boost::filesystem::path const&, std::exception const&));
-};
-
 class SharedLibraryProber : public testing::Test
 {
 public:
@@ -67,7 +60,7 @@ public:
 
     std::string const library_path;
     std::string temporary_directory;
-    testing::NiceMock<MockSharedLibraryProberReport> null_report;
+    testing::NiceMock<mtd::MockSharedLibraryProberReport> null_report;
 };
 
 }
@@ -122,7 +115,7 @@ TEST_F(SharedLibraryProber, path_with_no_shared_libraries_returns_empty_list)
 TEST_F(SharedLibraryProber, logs_start_of_probe)
 {
     using namespace testing;
-    testing::NiceMock<MockSharedLibraryProberReport> report;
+    testing::NiceMock<mtd::MockSharedLibraryProberReport> report;
 
     EXPECT_CALL(report, probing_path(testing::Eq(library_path)));
 
@@ -132,7 +125,7 @@ TEST_F(SharedLibraryProber, logs_start_of_probe)
 TEST_F(SharedLibraryProber, logs_for_nonexistent_path)
 {
     using namespace testing;
-    NiceMock<MockSharedLibraryProberReport> report;
+    NiceMock<mtd::MockSharedLibraryProberReport> report;
 
     EXPECT_CALL(report, probing_path(testing::Eq("/yo/dawg/I/heard/you/liked/slashes")));
 
@@ -143,7 +136,7 @@ TEST_F(SharedLibraryProber, logs_for_nonexistent_path)
 TEST_F(SharedLibraryProber, logs_failure_for_nonexistent_path)
 {
     using namespace testing;
-    NiceMock<MockSharedLibraryProberReport> report;
+    NiceMock<mtd::MockSharedLibraryProberReport> report;
 
     EXPECT_CALL(report, probing_failed(Eq("/yo/dawg/I/heard/you/liked/slashes"), _));
 
@@ -155,7 +148,7 @@ TEST_F(SharedLibraryProber, logs_failure_for_nonexistent_path)
 TEST_F(SharedLibraryProber, logs_no_libraries_for_path_without_libraries)
 {
     using namespace testing;
-    NiceMock<MockSharedLibraryProberReport> report;
+    NiceMock<mtd::MockSharedLibraryProberReport> report;
 
     EXPECT_CALL(report, loading_library(_)).Times(0);
 
@@ -175,7 +168,7 @@ MATCHER_P(FilenameMatches, matcher, "")
 TEST_F(SharedLibraryProber, logs_each_library_probed)
 {
     using namespace testing;
-    NiceMock<MockSharedLibraryProberReport> report;
+    NiceMock<mtd::MockSharedLibraryProberReport> report;
 
     auto const dso_filename_regex = ".*\\.so(\\..*)?";
 
@@ -193,7 +186,7 @@ TEST_F(SharedLibraryProber, logs_each_library_probed)
 TEST_F(SharedLibraryProber, logs_failure_for_load_failure)
 {
     using namespace testing;
-    NiceMock<MockSharedLibraryProberReport> report;
+    NiceMock<mtd::MockSharedLibraryProberReport> report;
 
     std::unordered_map<std::string, bool> probing_map;
 
@@ -226,7 +219,7 @@ TEST_F(SharedLibraryProber, logs_failure_for_load_failure)
 TEST_F(SharedLibraryProber, does_not_log_failure_on_success)
 {
     using namespace testing;
-    NiceMock<MockSharedLibraryProberReport> report;
+    NiceMock<mtd::MockSharedLibraryProberReport> report;
 
     std::unordered_map<std::string, bool> probing_map;
 
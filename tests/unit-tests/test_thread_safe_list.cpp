@@ -19,6 +19,9 @@
 #include "mir/thread_safe_list.h"
 #include "mir/test/signal.h"
 
+#include <atomic>
+#include <thread>
+
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
 
@@ -157,3 +160,78 @@ TEST_F(ThreadSafeListTest, clears_all_elements)
 
     EXPECT_THAT(elements_seen, Eq(0));
 }
+
+TEST_F(ThreadSafeListTest, remove_waits_for_element_in_use_in_different_thread)
+{
+    using namespace testing;
+
+    list.add(element1);
+
+    mir::test::Signal element_in_use;
+    std::atomic<bool> call_finished{false};
+
+    std::thread t{
+        [&]
+        {
+            list.for_each(
+                [&] (Element const&)
+                {
+                    element_in_use.raise();
+                    std::this_thread::sleep_for(std::chrono::milliseconds{50});
+                    call_finished = true;
+                });
+        }};
+
+    element_in_use.wait_for(std::chrono::seconds{3});
+    list.remove(element1);
+
+    EXPECT_TRUE(call_finished);
+
+    t.join();
+}
+
+TEST_F(ThreadSafeListTest, can_remove_element_while_iterating_same_element_in_nested_iteration)
+{
+    using namespace testing;
+
+    list.add(element1);
+    list.add(element2);
+
+    int elements_seen = 0;
+
+    list.for_each(
+        [&] (Element const&)
+        {
+            list.for_each(
+                [&] (Element const& element)
+                {
+                    list.remove(element);
+                    ++elements_seen;
+                });
+        });
+
+    EXPECT_THAT(elements_seen, Eq(2));
+}
+
+TEST_F(ThreadSafeListTest, element_added_while_iterating_is_seen_by_next_iteration)
+{
+    using namespace testing;
+
+    list.add(element1);
+
+    int elements_seen = 0;
+
+    list.for_each(
+        [&] (Element const&)
+        {
+            list.add(element2);
+            ++elements_seen;
+        });
+
+    EXPECT_THAT(elements_seen, Eq(1));
+
+    elements_seen = 0;
+    list.for_each([&] (Element const&) { ++elements_seen; });
+
+    EXPECT_THAT(elements_seen, Eq(2));
+}
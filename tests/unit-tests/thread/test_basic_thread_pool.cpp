@@ -220,3 +220,126 @@ TEST_F(BasicThreadPool, can_shrink)
     EXPECT_TRUE(task2.was_called());
     EXPECT_THAT(task2.thread_name(), Ne(expected_name));
 }
+
+TEST_F(BasicThreadPool, idle_thread_keeps_serving_its_id)
+{
+    using namespace testing;
+    mth::BasicThreadPool p{1};
+
+    int id1, id2;
+
+    TestTask task1{expected_name};
+    p.run(std::ref(task1), &id1).wait();
+
+    // The only thread is idle, but it is kept for id1
+    TestTask task2;
+    p.run(std::ref(task2), &id2).wait();
+
+    TestTask task3;
+    p.run(std::ref(task3), &id1).wait();
+
+    EXPECT_THAT(task2.thread_name(), Ne(expected_name));
+    EXPECT_THAT(task3.thread_name(), Eq(expected_name));
+}
+
+TEST_F(BasicThreadPool, shrinking_frees_idle_threads_for_any_id)
+{
+    using namespace testing;
+    mth::BasicThreadPool p{1};
+
+    int id1, id2;
+
+    TestTask task1{expected_name};
+    p.run(std::ref(task1), &id1).wait();
+
+    // Keeps the one thread we asked for, but no longer for id1
+    p.shrink();
+
+    TestTask task2;
+    p.run(std::ref(task2), &id2).wait();
+
+    EXPECT_THAT(task2.thread_name(), Eq(expected_name));
+}
+
+TEST_F(BasicThreadPool, runs_task_after_its_dependencies)
+{
+    using namespace testing;
+    mth::BasicThreadPool p{default_num_threads};
+
+    TestTask task1;
+    task1.block_on_execution();
+    std::shared_future<void> future1 = p.run(std::ref(task1));
+
+    TestTask task2;
+    std::shared_future<void> future2 = p.run(std::ref(task2));
+    future2.wait();
+
+    TestTask task3;
+    auto future3 = p.run_after({future1, future2}, std::ref(task3));
+
+    EXPECT_THAT(future3.wait_for(std::chrono::milliseconds{50}), Eq(std::future_status::timeout));
+    EXPECT_FALSE(task3.was_called());
+
+    task1.unblock();
+    future3.wait();
+
+    EXPECT_TRUE(task3.was_called());
+}
+
+TEST_F(BasicThreadPool, runs_task_after_ready_dependencies_at_once)
+{
+    using namespace testing;
+    mth::BasicThreadPool p{default_num_threads};
+
+    TestTask task1;
+    std::shared_future<void> future1 = p.run(std::ref(task1));
+    future1.wait();
+
+    TestTask task2;
+    auto future2 = p.run_after({future1}, std::ref(task2));
+    future2.wait();
+
+    EXPECT_TRUE(task2.was_called());
+}
+
+TEST_F(BasicThreadPool, runs_dependent_task_on_preferred_thread)
+{
+    using namespace testing;
+    mth::BasicThreadPool p{default_num_threads};
+    int const preferred{0};
+
+    TestTask task1{expected_name};
+    task1.block_on_execution();
+    auto future1 = p.run(std::ref(task1), &preferred);
+
+    TestTask task2;
+    std::shared_future<void> future2 = p.run(std::ref(task2));
+
+    TestTask task3;
+    auto future3 = p.run_after({future2}, std::ref(task3), &preferred);
+
+    task1.unblock();
+    future1.wait();
+    future3.wait();
+
+    EXPECT_TRUE(task3.was_called());
+    EXPECT_THAT(task3.thread_name(), Eq(expected_name));
+}
+
+TEST_F(BasicThreadPool, skips_task_whose_dependency_failed)
+{
+    using namespace testing;
+    mth::BasicThreadPool p{default_num_threads};
+
+    std::shared_future<void> future1 = p.run([]{ throw std::runtime_error{"failed"}; });
+
+    TestTask task2;
+    auto future2 = p.run_after({future1}, std::ref(task2));
+
+    TestTask task3;
+    auto future3 = p.run_after({future2.share()}, std::ref(task3));
+
+    EXPECT_THROW(future3.get(), std::runtime_error);
+    EXPECT_FALSE(task2.was_called());
+    EXPECT_FALSE(task3.was_called());
+}